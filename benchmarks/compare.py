@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark json reports.
+
+Prints the throughput of every benchmark present in both reports, and
+exits with status 1 if one of them lost more than the threshold.
+Throughput is FLOP/s when the benchmark reports it, bytes_per_second
+otherwise, 1/real_time as a last resort.
+
+usage: compare.py baseline.json contender.json [--threshold 0.05]
+"""
+import argparse
+import json
+import sys
+
+
+def throughputs(path):
+    with open(path) as f:
+        report = json.load(f)
+    result = {}
+    for b in report["benchmarks"]:
+        # keep the mean of repeated runs, skip the other aggregates
+        if b.get("run_type") == "aggregate" and b.get("aggregate_name") != "mean":
+            continue
+        name = b.get("run_name", b["name"])
+        if "FLOP/s" in b:
+            result[name] = ("FLOP/s", b["FLOP/s"])
+        elif "bytes_per_second" in b:
+            result[name] = ("B/s", b["bytes_per_second"])
+        else:
+            result[name] = ("1/s", 1.0 / b["real_time"])
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative loss counted as a regression")
+    args = parser.parse_args()
+
+    old = throughputs(args.baseline)
+    new = throughputs(args.contender)
+    regressions = 0
+    for name in sorted(old.keys() & new.keys()):
+        unit, before = old[name]
+        _, after = new[name]
+        change = after / before - 1.0
+        flag = ""
+        if change < -args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:48} {before:12.4g} {after:12.4g} {unit:6} "
+              f"{change:+8.1%}{flag}")
+    for name in sorted(old.keys() - new.keys()):
+        print(f"{name:48} missing from {args.contender}")
+    print(f"{regressions} regression(s) over {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
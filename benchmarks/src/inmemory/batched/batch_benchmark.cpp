@@ -0,0 +1,127 @@
+/**
+ * \file batch_benchmark.cpp
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Throughput of the batched small-matrix operations, against a loop
+ * of calls on separate matrices.
+ * \details
+ *  Each case runs a batch of 4096 nxn matrices; items_per_second counts
+ *  matrices.
+ */
+#include "BatchFactorizations.h"
+#include "Lu.h"
+#include "Matrix.h"
+#include "MatrixBatch.h"
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+constexpr int batchSize = 4096;
+
+double sampleEntry(int b, int i, int j, int n) {
+  return (i == j ? n : 0.0) + ((b * 5 + i * 7 + j * 3) % 11) / 11.0;
+}
+
+MatrixBatch<double> sampleBatch(int n, int m) {
+  MatrixBatch<double> a(batchSize, n, m);
+  for (int b = 0; b < batchSize; b++)
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < m; j++)
+        a.get(b, i, j) = sampleEntry(b, i, j, n);
+  return a;
+}
+
+std::vector<Matrix<double>> sampleMatrices(int n, int m) {
+  std::vector<Matrix<double>> a;
+  for (int b = 0; b < batchSize; b++) {
+    Matrix<double> x(n, m);
+    for (int i = 0; i < n; i++)
+      for (int j = 0; j < m; j++)
+        x.get(i, j) = sampleEntry(b, i, j, n);
+    a.push_back(std::move(x));
+  }
+  return a;
+}
+
+void BatchGemm(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const MatrixBatch<double> a = sampleBatch(n, n), b = sampleBatch(n, n);
+  MatrixBatch<double> c(batchSize, n, n);
+  for (auto _ : state) {
+    multiply(a, b, c);
+    benchmark::DoNotOptimize(c.pack(0));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void LoopGemm(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::vector<Matrix<double>> a = sampleMatrices(n, n);
+  const std::vector<Matrix<double>> b = sampleMatrices(n, n);
+  for (auto _ : state) {
+    for (int k = 0; k < batchSize; k++) {
+      Matrix<double> c = a[k] * b[k];
+      benchmark::DoNotOptimize(c.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void BatchLuSolve(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const MatrixBatch<double> a = sampleBatch(n, n), b = sampleBatch(n, 1);
+  for (auto _ : state) {
+    MatrixBatch<double> x = BatchLuFactorization<double>(a).solve(b);
+    benchmark::DoNotOptimize(x.pack(0));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void LoopLuSolve(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const std::vector<Matrix<double>> a = sampleMatrices(n, n);
+  const std::vector<Matrix<double>> b = sampleMatrices(n, 1);
+  for (auto _ : state) {
+    for (int k = 0; k < batchSize; k++) {
+      Matrix<double> x = LuFactorization<double>(a[k]).solve(b[k]);
+      benchmark::DoNotOptimize(x.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void BatchCholeskySolve(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const MatrixBatch<double> g = sampleBatch(n, n), b = sampleBatch(n, 1);
+  const MatrixBatch<double> a = g * g.transpose();
+  for (auto _ : state) {
+    MatrixBatch<double> x = BatchCholeskyFactorization<double>(a).solve(b);
+    benchmark::DoNotOptimize(x.pack(0));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void BatchTranspose(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const MatrixBatch<double> a = sampleBatch(n, n + 1);
+  for (auto _ : state) {
+    MatrixBatch<double> t = a.transpose();
+    benchmark::DoNotOptimize(t.pack(0));
+  }
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+} // namespace
+
+BENCHMARK(BatchGemm)->DenseRange(2, 8, 2);
+BENCHMARK(LoopGemm)->DenseRange(2, 8, 2);
+BENCHMARK(BatchLuSolve)->DenseRange(2, 8, 2);
+BENCHMARK(LoopLuSolve)->DenseRange(2, 8, 2);
+BENCHMARK(BatchCholeskySolve)->DenseRange(2, 8, 2);
+BENCHMARK(BatchTranspose)->DenseRange(2, 8, 2);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,199 @@
+/**
+ * \file matrix_benchmark.cpp
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Throughput of the dense matrix hot paths.
+ * \details
+ *  Each case sweeps square sizes and element types. FLOP/s counts a
+ *  multiply-add as two operations; bytes_per_second counts the bytes read
+ *  plus the bytes written, once.
+ */
+#include "Matrix.h"
+#include "Parallel.h"
+#include "SMatrix.h"
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <type_traits>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+template <typename E> Matrix<E> sample(int n, int m) {
+  Matrix<E> a(n, m);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < m; j++)
+      a.get(i, j) = static_cast<E>((i * 7 + j * 3) % 11);
+  return a;
+}
+
+void setFlops(benchmark::State &state, double perIteration) {
+  state.counters["FLOP/s"] = benchmark::Counter(
+      perIteration, benchmark::Counter::kIsIterationInvariantRate,
+      benchmark::Counter::OneK::kIs1000);
+}
+
+template <typename E> void setBytes(benchmark::State &state, long entries) {
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          entries * static_cast<long>(sizeof(E)));
+}
+
+template <typename E, bool Parallel> void Gemm(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n, n), b = sample<E>(n, n);
+  linopt::parallel::ScopedPolicy policy(Parallel ? linopt::parallel::par
+                                                 : linopt::parallel::seq);
+  for (auto _ : state) {
+    Matrix<E> c = a * b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  setFlops(state, 2.0 * n * n * n);
+  setBytes<E>(state, 3L * n * n);
+}
+
+template <typename E> void Transpose(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n, n + 3);
+  for (auto _ : state) {
+    Matrix<E> t = a.transpose();
+    benchmark::DoNotOptimize(t.data());
+  }
+  setBytes<E>(state, 2L * n * (n + 3));
+}
+
+template <typename E> void InplaceTranspose(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  Matrix<E> a = sample<E>(n, n);
+  for (auto _ : state) {
+    a.inplaceTranspose();
+    benchmark::ClobberMemory();
+  }
+  setBytes<E>(state, 2L * n * n);
+}
+
+template <typename E> void Add(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n, n), b = sample<E>(n, n);
+  for (auto _ : state) {
+    Matrix<E> c = a + b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  setFlops(state, 1.0 * n * n);
+  setBytes<E>(state, 3L * n * n);
+}
+
+template <typename E> void ScaleAdd(benchmark::State &state) {
+  // a fused expression: a single pass however many terms
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n, n), b = sample<E>(n, n);
+  for (auto _ : state) {
+    Matrix<E> c = a * E(3) - b;
+    benchmark::DoNotOptimize(c.data());
+  }
+  setFlops(state, 2.0 * n * n);
+  setBytes<E>(state, 3L * n * n);
+}
+
+template <typename E> void CombineRows(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  Matrix<E> a = sample<E>(n, n);
+  // averages keep the entries bounded however many iterations run
+  E half = std::is_floating_point_v<E> ? E(0.5) : E(1);
+  benchmark::DoNotOptimize(half);
+  for (auto _ : state) {
+    for (int i = 1; i < n; i++)
+      a.combineRows(i, half, i - 1, half, i);
+    benchmark::ClobberMemory();
+  }
+  setFlops(state, 3.0 * (n - 1) * n);
+  setBytes<E>(state, 3L * (n - 1) * n);
+}
+
+template <typename E> void MultiplyRow(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  Matrix<E> a = sample<E>(n, n);
+  E one = E(1);
+  benchmark::DoNotOptimize(one); // not folded away as a multiply by 1
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++)
+      a.multiplyRow(i, one);
+    benchmark::ClobberMemory();
+  }
+  setFlops(state, 1.0 * n * n);
+  setBytes<E>(state, 2L * n * n);
+}
+
+template <typename E> void MultiplyColumn(benchmark::State &state) {
+  // strided: one entry per row
+  const int n = static_cast<int>(state.range(0));
+  Matrix<E> a = sample<E>(n, n);
+  E one = E(1);
+  benchmark::DoNotOptimize(one);
+  for (auto _ : state) {
+    for (int j = 0; j < n; j++)
+      a.multiplyColumn(j, one);
+    benchmark::ClobberMemory();
+  }
+  setFlops(state, 1.0 * n * n);
+  setBytes<E>(state, 2L * n * n);
+}
+
+template <typename E> void FillColumn(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  Matrix<E> a = sample<E>(n, n);
+  for (auto _ : state) {
+    for (int j = 0; j < n; j++)
+      a.fillColumn(j, E(1));
+    benchmark::ClobberMemory();
+  }
+  setBytes<E>(state, 1L * n * n);
+}
+
+template <typename E, int N> void SmallGemm(benchmark::State &state) {
+  SMatrix<E, N, N> a = SMatrix<E, N, N>::block(sample<E>(N, N), 0, 0);
+  const SMatrix<E, N, N> b = a.transpose();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    SMatrix<E, N, N> c = a * b;
+    benchmark::DoNotOptimize(c);
+  }
+  setFlops(state, 2.0 * N * N * N);
+}
+
+template <typename E, int N> void SmallInverse(benchmark::State &state) {
+  SMatrix<E, N, N> a = SMatrix<E, N, N>::identity() * E(N);
+  a(0, N - 1) = E(1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    SMatrix<E, N, N> inv = a.inverse();
+    benchmark::DoNotOptimize(inv);
+  }
+}
+
+} // namespace
+
+BENCHMARK(Gemm<float, true>)->RangeMultiplier(2)->Range(64, 1024);
+BENCHMARK(Gemm<double, true>)->RangeMultiplier(2)->Range(64, 1024);
+BENCHMARK(Gemm<int, true>)->RangeMultiplier(2)->Range(64, 512);
+BENCHMARK(Gemm<double, false>)->RangeMultiplier(2)->Range(64, 512);
+BENCHMARK(Transpose<float>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(Transpose<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(InplaceTranspose<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(Add<float>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(Add<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(Add<int>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(ScaleAdd<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(CombineRows<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(MultiplyRow<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(MultiplyColumn<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(FillColumn<double>)->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK(SmallGemm<float, 4>);
+BENCHMARK(SmallGemm<double, 3>);
+BENCHMARK(SmallGemm<double, 4>);
+BENCHMARK(SmallGemm<double, 6>);
+BENCHMARK(SmallInverse<double, 3>);
+BENCHMARK(SmallInverse<double, 4>);
+BENCHMARK(SmallInverse<double, 6>);
+
+BENCHMARK_MAIN();
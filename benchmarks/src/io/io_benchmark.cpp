@@ -0,0 +1,92 @@
+/**
+ * \file io_benchmark.cpp
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Throughput of the text and binary (.lmf) matrix formats.
+ * \details
+ *  Streams are in memory, so that the cases measure formatting and
+ *  parsing rather than the disk. bytes_per_second counts the entries
+ *  moved, in their in-memory size.
+ */
+#include "Lmf.h"
+#include "Matrix.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+template <typename E> Matrix<E> sample(int n) {
+  Matrix<E> a(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      a.get(i, j) = static_cast<E>((i * 7 + j * 3) % 101) / E(7);
+  return a;
+}
+
+template <typename E> void setBytes(benchmark::State &state, int n) {
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * n *
+                          n * static_cast<long>(sizeof(E)));
+}
+
+template <typename E> void TextWrite(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n);
+  for (auto _ : state) {
+    std::ostringstream os;
+    os << a;
+    benchmark::DoNotOptimize(os.str().data());
+  }
+  setBytes<E>(state, n);
+}
+
+template <typename E> void TextRead(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  std::ostringstream os;
+  os << sample<E>(n);
+  const std::string text = os.str();
+  Matrix<E> b(n, n);
+  for (auto _ : state) {
+    std::istringstream is(text);
+    is >> b;
+    benchmark::DoNotOptimize(b.data());
+  }
+  setBytes<E>(state, n);
+}
+
+template <typename E> void LmfWrite(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  const Matrix<E> a = sample<E>(n);
+  for (auto _ : state) {
+    std::ostringstream os;
+    linopt::io::write(os, a);
+    benchmark::DoNotOptimize(os.str().data());
+  }
+  setBytes<E>(state, n);
+}
+
+template <typename E> void LmfRead(benchmark::State &state) {
+  const int n = static_cast<int>(state.range(0));
+  std::ostringstream os;
+  linopt::io::write(os, sample<E>(n));
+  const std::string bytes = os.str();
+  for (auto _ : state) {
+    std::istringstream is(bytes);
+    Matrix<E> b = linopt::io::read<E>(is);
+    benchmark::DoNotOptimize(b.data());
+  }
+  setBytes<E>(state, n);
+}
+
+} // namespace
+
+BENCHMARK(TextWrite<double>)->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(TextRead<double>)->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(TextRead<int>)->RangeMultiplier(4)->Range(64, 1024);
+BENCHMARK(LmfWrite<float>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(LmfWrite<double>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(LmfRead<float>)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(LmfRead<double>)->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1 @@
+#include "DiskMatrix.h"
@@ -0,0 +1,291 @@
+/**
+ * \file DiskMatrix.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the memory-mapped, out-of-core matrix class.
+ * \details
+ *  A DiskMatrix<E> maps an .lmf file (\sa Lmf.h) and reads and writes its
+ *  entries in place: only the pages actually touched are resident, so the
+ *  matrix may be much larger than the available memory. Entries are laid
+ *  out exactly as in a \sa linopt::inmemory::Matrix<E> (row-major, padded
+ *  rows), so the in-memory kernels run directly on tiles of the mapping.
+ *
+ *  The out-of-core operations (\sa multiply, \sa transpose, \sa add, ...)
+ *  sweep their operands tile by tile, prefetching the next tiles and
+ *  dropping the finished ones with madvise, so that the resident set stays
+ *  within a given memory budget.
+ */
+#ifndef LINOPT_ERC_DISK_MATRIX_DISKMATRIX_H
+#define LINOPT_ERC_DISK_MATRIX_DISKMATRIX_H
+
+#include <cstddef>
+#include <string>
+
+#include "Lmf.h"
+#include "Mapping.h"
+#include "Matrix.h"
+
+namespace linopt::disk {
+
+/**
+ * \brief Default memory budget of the out-of-core operations, in bytes.
+ */
+inline constexpr std::size_t defaultBudget = std::size_t(256) << 20;
+
+/**
+ * \brief A non-owning view of a rectangular block of a matrix.
+ */
+template <typename E> struct Tile {
+  /**
+   * \brief Pointer to entry (0,0) of the block.
+   */
+  E *data;
+  int rows;
+  int cols;
+  /**
+   * \brief Row stride of the underlying matrix, in elements.
+   */
+  int stride;
+
+  E &operator()(int r, int c) const {
+    return data[static_cast<std::size_t>(r) * stride + c];
+  }
+};
+
+/**
+ * \brief A matrix stored in a memory-mapped .lmf file.
+ *
+ * The file must hold entries of type E in the host byte order. Stores are
+ * written back to the file by the kernel, or explicitly by \sa flush.
+ * Opening a checksummed file for writing clears its checksum flag.
+ */
+template <typename E> class DiskMatrix {
+private:
+  Mapping mapping;
+  std::string filePath;
+  int rows = 0, columns = 0, rowStride = 0;
+  /**
+   * \brief Offset of entry (0,0) from the start of the file, in bytes.
+   */
+  std::size_t offset = 0;
+
+  /**
+   * \brief Parses and validates the header of the mapped file.
+   */
+  void attach();
+
+  /**
+   * \brief Offset of entry (r,c) from the start of the file, in bytes.
+   */
+  std::size_t byteOffset(int r, int c) const;
+
+  void checkTile(int r0, int c0, int h, int w) const;
+  void checkWritable() const;
+
+public:
+  /**
+   * \brief Type of the entries.
+   */
+  using value_type = E;
+
+  /**
+   * \brief Maps the existing .lmf file at path.
+   *
+   * Throws a runtime_error if the file cannot be mapped, is malformed,
+   * holds another entry type or was written in the other byte order.
+   * \param path: path of the file.
+   * \param access: whether entries may be modified.
+   */
+  DiskMatrix(const std::string &path, Access access = Access::readWrite);
+
+  /**
+   * \brief Creates an nxm .lmf file at path, pre-filled with zeros, and maps it.
+   * \param path: path of the file, overwritten if it exists.
+   * \param n: number of rows.
+   * \param m: number of columns.
+   * \return the writable disk matrix.
+   */
+  static DiskMatrix<E> create(const std::string &path, int n, int m);
+
+  /**
+   * \brief Creates an .lmf file at path holding a copy of src, and maps it.
+   */
+  static DiskMatrix<E> create(const std::string &path,
+                              const inmemory::Matrix<E> &src);
+
+  DiskMatrix(DiskMatrix<E> &&) = default;
+  DiskMatrix<E> &operator=(DiskMatrix<E> &&) = default;
+
+  /**
+   * \brief Get the number of rows in the matrix.
+   */
+  int getN() const;
+
+  /**
+   * \brief Get the number of columns in the matrix.
+   */
+  int getM() const;
+
+  /**
+   * \brief Get the row stride of the mapped buffer, in elements.
+   */
+  int stride() const;
+
+  /**
+   * \brief Path of the mapped file.
+   */
+  const std::string &path() const;
+
+  /**
+   * \brief Whether entries may be modified.
+   */
+  bool isWritable() const;
+
+  /**
+   * \brief Raw access to the mapped entries, \sa inmemory::Matrix::data.
+   *
+   * Throws a runtime_error if the matrix is read-only.
+   */
+  E *data();
+
+  /**
+   * \brief Raw read-only access to the mapped entries.
+   */
+  const E *data() const;
+
+  /**
+   * \brief Checked access to entry (r,c).
+   *
+   * Throws a runtime_error if out of bounds or if the matrix is read-only.
+   */
+  E &get(int r, int c);
+
+  /**
+   * \brief Checked read-only access to entry (r,c).
+   */
+  const E &get(int r, int c) const;
+
+  /**
+   * \brief Unchecked read-only access to entry (r,c).
+   */
+  const E &coeff(int r, int c) const {
+    return data()[static_cast<std::size_t>(r) * rowStride + c];
+  }
+
+  /**
+   * \brief View of the h x w block whose entry (0,0) is (r0,c0).
+   */
+  Tile<E> tile(int r0, int c0, int h, int w);
+
+  /**
+   * \brief Read-only view of the h x w block whose entry (0,0) is (r0,c0).
+   */
+  Tile<const E> tile(int r0, int c0, int h, int w) const;
+
+  /**
+   * \brief Copies the h x w block whose entry (0,0) is (r0,c0) into memory.
+   */
+  inmemory::Matrix<E> read(int r0, int c0, int h, int w) const;
+
+  /**
+   * \brief Copies the whole matrix into memory.
+   */
+  inmemory::Matrix<E> toMatrix() const;
+
+  /**
+   * \brief Overwrites the block whose entry (0,0) is (r0,c0) with src.
+   */
+  void write(int r0, int c0, const inmemory::Matrix<E> &src);
+
+  /**
+   * \brief Hints the kernel about the use of rows [r0, r1).
+   */
+  void advise(Advice advice, int r0, int r1) const;
+
+  /**
+   * \brief Hints the kernel about the use of an h x w block.
+   *
+   * Narrow blocks are advised row by row, so that the pages holding the
+   * other columns are left alone.
+   */
+  void adviseTile(Advice advice, int r0, int c0, int h, int w) const;
+
+  /**
+   * \brief Writes every modified entry back to the file.
+   */
+  void flush() const;
+
+  /**
+   * \brief Calls body(r0, r1) on consecutive bands of at most height rows.
+   *
+   * The next band is prefetched while body runs, and each band is dropped
+   * from the resident set once done.
+   */
+  template <typename F> void sweepRows(int height, F &&body) const;
+
+  /**
+   * \brief Calls body(r0, r1, c0, c1) on the h x w tiles, row of tiles by
+   * row of tiles, prefetching the next tile and dropping finished ones.
+   */
+  template <typename F> void sweepTiles(int h, int w, F &&body) const;
+};
+
+/**
+ * \brief Out-of-core product a*b, written to a new .lmf file at path.
+ *
+ * Streams square tiles of a, b and the result through the packed gemm
+ * kernel, three tiles at a time within budget bytes.
+ * \param a: left operand.
+ * \param b: right operand.
+ * \param path: path of the result file.
+ * \param budget: memory budget, in bytes.
+ * \return the product.
+ */
+template <typename E>
+DiskMatrix<E> multiply(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                       const std::string &path,
+                       std::size_t budget = defaultBudget);
+
+/**
+ * \brief Out-of-core transpose of a, written to a new .lmf file at path.
+ */
+template <typename E>
+DiskMatrix<E> transpose(const DiskMatrix<E> &a, const std::string &path,
+                        std::size_t budget = defaultBudget);
+
+/**
+ * \brief Out-of-core elementwise op(a(i,j), b(i,j)), written to a new .lmf
+ * file at path.
+ */
+template <typename E, typename Op>
+DiskMatrix<E> elementwise(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                          const std::string &path, Op op,
+                          std::size_t budget = defaultBudget);
+
+/**
+ * \brief Out-of-core sum a+b, \sa elementwise.
+ */
+template <typename E>
+DiskMatrix<E> add(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                  const std::string &path, std::size_t budget = defaultBudget);
+
+/**
+ * \brief Out-of-core difference a-b, \sa elementwise.
+ */
+template <typename E>
+DiskMatrix<E> subtract(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                       const std::string &path,
+                       std::size_t budget = defaultBudget);
+
+/**
+ * \brief Out-of-core product s*a, written to a new .lmf file at path.
+ */
+template <typename E, typename S>
+DiskMatrix<E> scale(const DiskMatrix<E> &a, const S &s,
+                    const std::string &path,
+                    std::size_t budget = defaultBudget);
+
+} // namespace linopt::disk
+
+#include "DiskMatrix.tpp"
+#endif
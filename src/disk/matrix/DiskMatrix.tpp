@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Gemm.h"
+#include "Parallel.h"
+#include "Transpose.h"
+
+namespace linopt::disk {
+
+namespace detail {
+
+/**
+ * \brief Side of the square tiles such that operands tiles fit in budget.
+ *
+ * Tile rows are whole pages when the budget allows it, whole cache lines
+ * otherwise.
+ */
+template <typename E> int tileSide(std::size_t budget, int operands) {
+  const double side = std::sqrt(static_cast<double>(budget) /
+                                (static_cast<double>(operands) * sizeof(E)));
+  const int page = std::max(1, static_cast<int>(pageSize() / sizeof(E)));
+  const int line =
+      std::max(1, static_cast<int>(inmemory::cacheLineSize / sizeof(E)));
+  const int granule = side >= page ? page : line;
+  return std::max(granule, static_cast<int>(side) / granule * granule);
+}
+
+/**
+ * \brief Height of the row bands such that operands bands fit in budget.
+ */
+template <typename E>
+int bandHeight(std::size_t budget, int stride, int operands) {
+  const std::size_t row = static_cast<std::size_t>(stride) * sizeof(E);
+  return static_cast<int>(
+      std::clamp<std::size_t>(budget / (operands * row), 1, 1 << 30));
+}
+
+/**
+ * \brief Writes op(a(i,j), b(i,j)) (op(a(i,j)) if b is null) into r, band
+ * by band.
+ */
+template <typename E, typename Op>
+void mapRows(const DiskMatrix<E> &a, const DiskMatrix<E> *b, DiskMatrix<E> &r,
+             Op op, std::size_t budget) {
+  const int operands = b == nullptr ? 2 : 3;
+  const int height = bandHeight<E>(budget, a.stride(), operands);
+  if (b != nullptr)
+    b->advise(Advice::sequential, 0, b->getN());
+  const int m = a.getM();
+  E *out = r.data();
+  a.sweepRows(height, [&](int r0, int r1) {
+    if (b != nullptr && r1 < b->getN())
+      b->advise(Advice::willNeed, r1, std::min(b->getN(), r1 + height));
+    parallel::parallelFor(
+        r0, r1, static_cast<long>(r1 - r0) * m, [&](int i0, int i1) {
+          for (int i = i0; i < i1; i++) {
+            E *row = out + static_cast<std::size_t>(i) * r.stride();
+            for (int j = 0; j < m; j++) {
+              if constexpr (std::is_invocable_v<Op, const E &, const E &>)
+                row[j] = op(a.coeff(i, j), b->coeff(i, j));
+              else
+                row[j] = op(a.coeff(i, j));
+            }
+          }
+        });
+    if (b != nullptr)
+      b->advise(Advice::dontNeed, r0, r1);
+    r.advise(Advice::dontNeed, r0, r1);
+  });
+}
+
+} // namespace detail
+
+template <typename E>
+DiskMatrix<E>::DiskMatrix(const std::string &path, Access access)
+    : mapping(path, access), filePath(path) {
+  attach();
+}
+
+template <typename E>
+DiskMatrix<E> DiskMatrix<E>::create(const std::string &path, int n, int m) {
+  if (n < 1 || m < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+  const io::LmfHeader header =
+      io::makeHeader<E>(n, m, inmemory::paddedStride<E>(m));
+  {
+    const Mapping created = Mapping::create(path, header.fileBytes());
+    std::memcpy(created.data(), &header, sizeof(header));
+  }
+  return DiskMatrix<E>(path, Access::readWrite);
+}
+
+template <typename E>
+DiskMatrix<E> DiskMatrix<E>::create(const std::string &path,
+                                    const inmemory::Matrix<E> &src) {
+  DiskMatrix<E> d = create(path, src.getN(), src.getM());
+  // same padding as the in-memory matrix: a single contiguous copy
+  std::copy(src.data(),
+            src.data() + static_cast<std::size_t>(src.getN()) * src.stride(),
+            d.data());
+  return d;
+}
+
+template <typename E> void DiskMatrix<E>::attach() {
+  if (mapping.size() < sizeof(io::LmfHeader))
+    throw std::runtime_error("Invalid lmf file: truncated header.");
+  io::LmfHeader header = io::decodeHeader(mapping.data());
+  io::checkElementType<E>(header);
+  if (header.endianness != io::nativeEndianness())
+    throw std::runtime_error("Cannot map an lmf file of the other byte order.");
+  if (header.headerSize % alignof(E) != 0)
+    throw std::runtime_error("Invalid lmf file: misaligned payload.");
+  // fileBytes() is checked: a header whose size wraps was rejected above
+  if (mapping.size() < header.fileBytes())
+    throw std::runtime_error("Invalid lmf file: truncated payload.");
+  rows = static_cast<int>(header.rows);
+  columns = static_cast<int>(header.cols);
+  rowStride = static_cast<int>(header.rowStride);
+  offset = header.headerSize;
+  if (mapping.isWritable() && (header.flags & io::lmfHasChecksum)) {
+    // entries are about to change behind the checksum's back
+    header.flags &= ~io::lmfHasChecksum;
+    std::memcpy(mapping.data() + offsetof(io::LmfHeader, flags),
+                &header.flags, sizeof(header.flags));
+  }
+}
+
+template <typename E>
+std::size_t DiskMatrix<E>::byteOffset(int r, int c) const {
+  return offset +
+         (static_cast<std::size_t>(r) * rowStride + c) * sizeof(E);
+}
+
+template <typename E>
+void DiskMatrix<E>::checkTile(int r0, int c0, int h, int w) const {
+  if (r0 < 0 || c0 < 0 || h < 0 || w < 0 || r0 + h > rows ||
+      c0 + w > columns)
+    throw std::runtime_error("Out of bounds tile access.");
+}
+
+template <typename E> void DiskMatrix<E>::checkWritable() const {
+  if (!mapping.isWritable())
+    throw std::runtime_error("Read-only disk matrix " + filePath + ".");
+}
+
+template <typename E> int DiskMatrix<E>::getN() const { return rows; }
+
+template <typename E> int DiskMatrix<E>::getM() const { return columns; }
+
+template <typename E> int DiskMatrix<E>::stride() const { return rowStride; }
+
+template <typename E> const std::string &DiskMatrix<E>::path() const {
+  return filePath;
+}
+
+template <typename E> bool DiskMatrix<E>::isWritable() const {
+  return mapping.isWritable();
+}
+
+template <typename E> E *DiskMatrix<E>::data() {
+  checkWritable();
+  return reinterpret_cast<E *>(mapping.data() + offset);
+}
+
+template <typename E> const E *DiskMatrix<E>::data() const {
+  return reinterpret_cast<const E *>(mapping.data() + offset);
+}
+
+template <typename E> E &DiskMatrix<E>::get(int r, int c) {
+  checkTile(r, c, 1, 1);
+  return data()[static_cast<std::size_t>(r) * rowStride + c];
+}
+
+template <typename E> const E &DiskMatrix<E>::get(int r, int c) const {
+  checkTile(r, c, 1, 1);
+  return coeff(r, c);
+}
+
+template <typename E>
+Tile<E> DiskMatrix<E>::tile(int r0, int c0, int h, int w) {
+  checkTile(r0, c0, h, w);
+  return {data() + static_cast<std::size_t>(r0) * rowStride + c0, h, w,
+          rowStride};
+}
+
+template <typename E>
+Tile<const E> DiskMatrix<E>::tile(int r0, int c0, int h, int w) const {
+  checkTile(r0, c0, h, w);
+  return {data() + static_cast<std::size_t>(r0) * rowStride + c0, h, w,
+          rowStride};
+}
+
+template <typename E>
+inmemory::Matrix<E> DiskMatrix<E>::read(int r0, int c0, int h, int w) const {
+  checkTile(r0, c0, h, w);
+  inmemory::Matrix<E> r(h, w);
+  for (int i = 0; i < h; i++) {
+    const E *source = &coeff(r0 + i, c0);
+    std::copy(source, source + w,
+              r.data() + static_cast<std::size_t>(i) * r.stride());
+  }
+  return r;
+}
+
+template <typename E> inmemory::Matrix<E> DiskMatrix<E>::toMatrix() const {
+  inmemory::Matrix<E> r = inmemory::Matrix<E>::uninitialized(rows, columns);
+  if (r.stride() == rowStride) {
+    std::copy(data(), data() + static_cast<std::size_t>(rows) * rowStride,
+              r.data());
+    return r;
+  }
+  for (int i = 0; i < rows; i++) {
+    E *row = r.data() + static_cast<std::size_t>(i) * r.stride();
+    std::copy(&coeff(i, 0), &coeff(i, 0) + columns, row);
+    std::fill(row + columns, row + r.stride(), E());
+  }
+  return r;
+}
+
+template <typename E>
+void DiskMatrix<E>::write(int r0, int c0, const inmemory::Matrix<E> &src) {
+  checkTile(r0, c0, src.getN(), src.getM());
+  Tile<E> t = tile(r0, c0, src.getN(), src.getM());
+  for (int i = 0; i < t.rows; i++) {
+    const E *row = src.data() + static_cast<std::size_t>(i) * src.stride();
+    std::copy(row, row + t.cols, &t(i, 0));
+  }
+}
+
+template <typename E>
+void DiskMatrix<E>::advise(Advice advice, int r0, int r1) const {
+  r0 = std::max(r0, 0);
+  r1 = std::min(r1, rows);
+  if (r0 < r1)
+    mapping.advise(byteOffset(r0, 0), byteOffset(r1, 0) - byteOffset(r0, 0),
+                   advice);
+}
+
+template <typename E>
+void DiskMatrix<E>::adviseTile(Advice advice, int r0, int c0, int h,
+                               int w) const {
+  if (h <= 0 || w <= 0)
+    return;
+  const std::size_t rowBytes = static_cast<std::size_t>(rowStride) * sizeof(E);
+  if (h > 1 && rowBytes > 2 * pageSize() && 2 * w < rowStride) {
+    // rows span several pages: leave those of the other columns alone
+    for (int i = r0; i < r0 + h; i++)
+      mapping.advise(byteOffset(i, c0), w * sizeof(E), advice);
+  } else {
+    mapping.advise(byteOffset(r0, c0),
+                   byteOffset(r0 + h - 1, c0 + w) - byteOffset(r0, c0),
+                   advice);
+  }
+}
+
+template <typename E> void DiskMatrix<E>::flush() const {
+  mapping.flush(0, mapping.size());
+}
+
+template <typename E>
+template <typename F>
+void DiskMatrix<E>::sweepRows(int height, F &&body) const {
+  height = std::max(height, 1);
+  advise(Advice::sequential, 0, rows);
+  advise(Advice::willNeed, 0, height);
+  for (int r0 = 0; r0 < rows; r0 += height) {
+    const int r1 = std::min(rows, r0 + height);
+    advise(Advice::willNeed, r1, r1 + height);
+    body(r0, r1);
+    advise(Advice::dontNeed, r0, r1);
+  }
+}
+
+template <typename E>
+template <typename F>
+void DiskMatrix<E>::sweepTiles(int h, int w, F &&body) const {
+  h = std::max(h, 1);
+  w = std::max(w, 1);
+  for (int r0 = 0; r0 < rows; r0 += h) {
+    const int r1 = std::min(rows, r0 + h);
+    for (int c0 = 0; c0 < columns; c0 += w) {
+      const int c1 = std::min(columns, c0 + w);
+      if (c1 < columns)
+        adviseTile(Advice::willNeed, r0, c1, r1 - r0,
+                   std::min(w, columns - c1));
+      else if (r1 < rows)
+        adviseTile(Advice::willNeed, r1, 0, std::min(h, rows - r1),
+                   std::min(w, columns));
+      body(r0, r1, c0, c1);
+      adviseTile(Advice::dontNeed, r0, c0, r1 - r0, c1 - c0);
+    }
+  }
+}
+
+template <typename E>
+DiskMatrix<E> multiply(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                       const std::string &path, std::size_t budget) {
+  if (a.getM() != b.getN())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  const int n = a.getN(), k = a.getM(), m = b.getM();
+  DiskMatrix<E> c = DiskMatrix<E>::create(path, n, m);
+  const int t = detail::tileSide<E>(budget, 3);
+  E *out = c.data();
+  for (int i0 = 0; i0 < n; i0 += t) {
+    const int h = std::min(t, n - i0);
+    for (int j0 = 0; j0 < m; j0 += t) {
+      const int w = std::min(t, m - j0);
+      for (int p0 = 0; p0 < k; p0 += t) {
+        const int d = std::min(t, k - p0);
+        if (p0 + d < k) {
+          const int next = std::min(t, k - p0 - d);
+          a.adviseTile(Advice::willNeed, i0, p0 + d, h, next);
+          b.adviseTile(Advice::willNeed, p0 + d, j0, next, w);
+        }
+        inmemory::kernels::parallelGemm(
+            h, w, d, &a.coeff(i0, p0), a.stride(), &b.coeff(p0, j0),
+            b.stride(), out + static_cast<std::size_t>(i0) * c.stride() + j0,
+            c.stride(),
+            p0 == 0 ? inmemory::kernels::GemmUpdate::overwrite
+                    : inmemory::kernels::GemmUpdate::accumulate);
+        a.adviseTile(Advice::dontNeed, i0, p0, h, d);
+        b.adviseTile(Advice::dontNeed, p0, j0, d, w);
+      }
+      c.adviseTile(Advice::dontNeed, i0, j0, h, w);
+    }
+  }
+  return c;
+}
+
+template <typename E>
+DiskMatrix<E> transpose(const DiskMatrix<E> &a, const std::string &path,
+                        std::size_t budget) {
+  DiskMatrix<E> r = DiskMatrix<E>::create(path, a.getM(), a.getN());
+  const int t = detail::tileSide<E>(budget, 2);
+  E *out = r.data();
+  a.sweepTiles(t, t, [&](int r0, int r1, int c0, int c1) {
+    inmemory::kernels::parallelTranspose(
+        r1 - r0, c1 - c0, &a.coeff(r0, c0), a.stride(),
+        out + static_cast<std::size_t>(c0) * r.stride() + r0, r.stride());
+    r.adviseTile(Advice::dontNeed, c0, r0, c1 - c0, r1 - r0);
+  });
+  return r;
+}
+
+template <typename E, typename Op>
+DiskMatrix<E> elementwise(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                          const std::string &path, Op op,
+                          std::size_t budget) {
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    throw std::runtime_error("Invalid dimensions for elementwise operation.");
+  DiskMatrix<E> r = DiskMatrix<E>::create(path, a.getN(), a.getM());
+  detail::mapRows(a, &b, r, op, budget);
+  return r;
+}
+
+template <typename E>
+DiskMatrix<E> add(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                  const std::string &path, std::size_t budget) {
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    throw std::runtime_error("Invalid dimensions for matrix addition.");
+  return elementwise(a, b, path, std::plus<E>(), budget);
+}
+
+template <typename E>
+DiskMatrix<E> subtract(const DiskMatrix<E> &a, const DiskMatrix<E> &b,
+                       const std::string &path, std::size_t budget) {
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    throw std::runtime_error("Invalid dimensions for matrix subtraction.");
+  return elementwise(a, b, path, std::minus<E>(), budget);
+}
+
+template <typename E, typename S>
+DiskMatrix<E> scale(const DiskMatrix<E> &a, const S &s,
+                    const std::string &path, std::size_t budget) {
+  DiskMatrix<E> r = DiskMatrix<E>::create(path, a.getN(), a.getM());
+  detail::mapRows(a, static_cast<const DiskMatrix<E> *>(nullptr), r,
+                  [&s](const E &x) { return static_cast<E>(s * x); }, budget);
+  return r;
+}
+
+} // namespace linopt::disk
@@ -0,0 +1,133 @@
+#include "Mapping.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace linopt::disk {
+
+namespace {
+
+std::runtime_error systemError(const std::string &what,
+                               const std::string &path) {
+  return std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+int toNative(Advice advice) {
+  switch (advice) {
+  case Advice::sequential:
+    return MADV_SEQUENTIAL;
+  case Advice::random:
+    return MADV_RANDOM;
+  case Advice::willNeed:
+    return MADV_WILLNEED;
+  case Advice::dontNeed:
+    return MADV_DONTNEED;
+  default:
+    return MADV_NORMAL;
+  }
+}
+
+} // namespace
+
+std::size_t pageSize() {
+  static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+Mapping::Mapping(const std::string &path, Access access)
+    : writable(access == Access::readWrite) {
+  fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+  if (fd < 0)
+    throw systemError("Could not open", path);
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    const std::runtime_error error = systemError("Could not stat", path);
+    release();
+    throw error;
+  }
+  bytes = static_cast<std::size_t>(status.st_size);
+  if (bytes == 0) {
+    release();
+    throw std::runtime_error("Could not map " + path + ": empty file.");
+  }
+  void *p = ::mmap(nullptr, bytes, PROT_READ | (writable ? PROT_WRITE : 0),
+                   MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    const std::runtime_error error = systemError("Could not map", path);
+    release();
+    throw error;
+  }
+  base = static_cast<char *>(p);
+}
+
+Mapping Mapping::create(const std::string &path, std::size_t size) {
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    throw systemError("Could not create", path);
+  const bool sized = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+  const int error = errno;
+  ::close(fd);
+  if (!sized) {
+    errno = error;
+    throw systemError("Could not resize", path);
+  }
+  return Mapping(path, Access::readWrite);
+}
+
+Mapping::Mapping(Mapping &&other) noexcept
+    : fd(std::exchange(other.fd, -1)), base(std::exchange(other.base, nullptr)),
+      bytes(std::exchange(other.bytes, 0)), writable(other.writable) {}
+
+Mapping &Mapping::operator=(Mapping &&other) noexcept {
+  if (this != &other) {
+    release();
+    fd = std::exchange(other.fd, -1);
+    base = std::exchange(other.base, nullptr);
+    bytes = std::exchange(other.bytes, 0);
+    writable = other.writable;
+  }
+  return *this;
+}
+
+Mapping::~Mapping() { release(); }
+
+void Mapping::release() {
+  if (base != nullptr)
+    ::munmap(base, bytes);
+  if (fd >= 0)
+    ::close(fd);
+  base = nullptr;
+  fd = -1;
+  bytes = 0;
+}
+
+void Mapping::advise(std::size_t offset, std::size_t length,
+                     Advice advice) const {
+  if (base == nullptr || offset >= bytes || length == 0)
+    return;
+  const std::size_t page = pageSize();
+  const std::size_t begin = offset / page * page;
+  const std::size_t end = std::min(bytes, offset + length);
+  ::madvise(base + begin, end - begin, toNative(advice));
+}
+
+void Mapping::flush(std::size_t offset, std::size_t length) const {
+  if (base == nullptr || !writable || offset >= bytes || length == 0)
+    return;
+  const std::size_t page = pageSize();
+  const std::size_t begin = offset / page * page;
+  const std::size_t end = std::min(bytes, offset + length);
+  if (::msync(base + begin, end - begin, MS_SYNC) != 0)
+    throw std::runtime_error(std::string("Could not flush mapping: ") +
+                             std::strerror(errno));
+}
+
+} // namespace linopt::disk
@@ -0,0 +1,136 @@
+/**
+ * \file Mapping.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the memory mapping of a whole file.
+ * \details
+ *  A thin RAII wrapper over POSIX mmap/madvise/msync. The mapping is
+ *  shared: stores go to the page cache and reach the file on flush() or
+ *  when the kernel writes them back.
+ */
+#ifndef LINOPT_ERC_DISK_MATRIX_MAPPING_H
+#define LINOPT_ERC_DISK_MATRIX_MAPPING_H
+
+#include <cstddef>
+#include <string>
+
+namespace linopt::disk {
+
+/**
+ * \brief How a file is opened.
+ */
+enum class Access { readOnly, readWrite };
+
+/**
+ * \brief Expected access pattern of a range of a mapping, \sa Mapping::advise.
+ */
+enum class Advice {
+  /**
+   * \brief No particular pattern (default read-ahead).
+   */
+  normal,
+  /**
+   * \brief Read once, front to back: aggressive read-ahead.
+   */
+  sequential,
+  /**
+   * \brief Scattered accesses: no read-ahead.
+   */
+  random,
+  /**
+   * \brief The range will be needed soon: start reading it in.
+   */
+  willNeed,
+  /**
+   * \brief The range is done with: drop it from the process' resident set.
+   */
+  dontNeed
+};
+
+/**
+ * \brief Size of a memory page, in bytes.
+ */
+std::size_t pageSize();
+
+/**
+ * \brief A shared memory mapping of a whole file.
+ */
+class Mapping {
+private:
+  int fd = -1;
+  char *base = nullptr;
+  std::size_t bytes = 0;
+  bool writable = false;
+
+  void release();
+
+public:
+  /**
+   * \brief An empty mapping.
+   */
+  Mapping() = default;
+
+  /**
+   * \brief Maps the existing file at path.
+   *
+   * Throws a runtime_error if the file cannot be opened or mapped.
+   * \param path: path of the file.
+   * \param access: whether the mapping may be written to.
+   */
+  Mapping(const std::string &path, Access access);
+
+  /**
+   * \brief Creates (or truncates) the file at path with the given size and
+   * maps it for writing.
+   *
+   * The file is extended with ftruncate: its content reads as zeros and
+   * takes no disk space until written.
+   * \param path: path of the file.
+   * \param size: size of the file, in bytes.
+   * \return the mapping.
+   */
+  static Mapping create(const std::string &path, std::size_t size);
+
+  Mapping(const Mapping &) = delete;
+  Mapping &operator=(const Mapping &) = delete;
+  Mapping(Mapping &&other) noexcept;
+  Mapping &operator=(Mapping &&other) noexcept;
+
+  /**
+   * \brief Unmaps the file; pending stores still reach it.
+   */
+  ~Mapping();
+
+  /**
+   * \brief First byte of the mapping (page aligned).
+   */
+  char *data() const { return base; }
+
+  /**
+   * \brief Size of the mapping, in bytes.
+   */
+  std::size_t size() const { return bytes; }
+
+  /**
+   * \brief Whether the mapping may be written to.
+   */
+  bool isWritable() const { return writable; }
+
+  /**
+   * \brief Tells the kernel how the bytes [offset, offset+length) will be used.
+   *
+   * The range is widened to whole pages. Advice is only a hint: failures are
+   * ignored.
+   */
+  void advise(std::size_t offset, std::size_t length, Advice advice) const;
+
+  /**
+   * \brief Writes the modified pages of [offset, offset+length) back to the
+   * file and waits for completion.
+   */
+  void flush(std::size_t offset, std::size_t length) const;
+};
+
+} // namespace linopt::disk
+
+#endif
@@ -0,0 +1 @@
+#include "BatchFactorizations.h"
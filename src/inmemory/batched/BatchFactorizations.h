@@ -0,0 +1,165 @@
+/**
+ * \file BatchFactorizations.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the batched LU and Cholesky factorizations.
+ * \details
+ *  Small matrices are too small for the blocked factorizations of
+ *  Lu.h and Cholesky.h to pay off. These ones run the unblocked algorithms
+ *  on whole packs of a \sa MatrixBatch: every step is applied to the lanes
+ *  matrices of a pack at once, with the lanes as the vector dimension, and
+ *  the packs are spread over the thread pool. Row interchanges differ from
+ *  one matrix to the next and are the only per-matrix work.
+ */
+#ifndef LINOPT_ERC_INMEMORY_BATCHED_BATCHFACTORIZATIONS_H
+#define LINOPT_ERC_INMEMORY_BATCHED_BATCHFACTORIZATIONS_H
+
+#include <vector>
+
+#include "MatrixBatch.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief The factorizations P_b*A_b = L_b*U_b of a batch of square matrices.
+ *
+ * Partial pivoting, as in \sa LuFactorization. Singular matrices are
+ * factored nonetheless and flagged, \sa isSingular.
+ */
+template <typename E> class BatchLuFactorization {
+private:
+  /**
+   * \brief L below the diagonal (its unit diagonal implied), U on and above.
+   */
+  MatrixBatch<E> lu;
+  /**
+   * \brief Interleaved like the entries: step k of matrix b swapped rows k
+   * and pivotRows[(b/lanes*n + k)*lanes + b%lanes].
+   */
+  std::vector<int> pivotRows;
+  /**
+   * \brief One flag per matrix (not a vector<bool>: packs are written
+   * concurrently).
+   */
+  std::vector<char> singular;
+
+  void factor();
+
+public:
+  /**
+   * \brief Factors a copy of a.
+   *
+   * Throws a runtime_error if the matrices are not square.
+   */
+  explicit BatchLuFactorization(const MatrixBatch<E> &a);
+
+  /**
+   * \brief Factors a in place, without copying it.
+   */
+  explicit BatchLuFactorization(MatrixBatch<E> &&a);
+
+  /**
+   * \brief Get the number of rows (and columns) of each matrix.
+   */
+  int size() const { return lu.getN(); }
+
+  /**
+   * \brief Get the number of matrices.
+   */
+  int batchSize() const { return lu.size(); }
+
+  /**
+   * \brief The packed factors: L strictly below the diagonal, U on and above.
+   */
+  const MatrixBatch<E> &factors() const { return lu; }
+
+  /**
+   * \brief Row swapped with row k at step k of the factorization of matrix b.
+   */
+  int pivot(int b, int k) const;
+
+  /**
+   * \brief Whether U_b has a zero on its diagonal.
+   */
+  bool isSingular(int b) const;
+
+  /**
+   * \brief Solves A_b*X_b = B_b for every matrix of the batch.
+   *
+   * Throws a runtime_error if the batch sizes or the number of rows of B
+   * don't match, or if a matrix is singular.
+   * \param b: the right hand sides, one batch of nxr matrices.
+   * \return X.
+   */
+  MatrixBatch<E> solve(const MatrixBatch<E> &b) const;
+
+  /**
+   * \brief Overwrites B with the solution of A_b*X_b = B_b, \sa solve.
+   */
+  void solveInPlace(MatrixBatch<E> &b) const;
+};
+
+/**
+ * \brief The factorizations A_b = L_b*L_b^T of a batch of symmetric
+ * positive definite matrices.
+ *
+ * Only the lower triangles are read.
+ */
+template <typename E> class BatchCholeskyFactorization {
+private:
+  /**
+   * \brief The L_b, zero above the diagonal.
+   */
+  MatrixBatch<E> l;
+
+  void factor();
+
+public:
+  /**
+   * \brief Factors a copy of a.
+   *
+   * Throws a runtime_error if the matrices are not square or one of them
+   * is not positive definite.
+   */
+  explicit BatchCholeskyFactorization(const MatrixBatch<E> &a);
+
+  /**
+   * \brief Factors a in place, without copying it.
+   */
+  explicit BatchCholeskyFactorization(MatrixBatch<E> &&a);
+
+  /**
+   * \brief Get the number of rows (and columns) of each matrix.
+   */
+  int size() const { return l.getN(); }
+
+  /**
+   * \brief Get the number of matrices.
+   */
+  int batchSize() const { return l.size(); }
+
+  /**
+   * \brief The lower triangular factors L_b.
+   */
+  const MatrixBatch<E> &lower() const { return l; }
+
+  /**
+   * \brief Solves A_b*X_b = B_b for every matrix of the batch.
+   *
+   * Throws a runtime_error if the batch sizes or the number of rows of B
+   * don't match.
+   * \param b: the right hand sides, one batch of nxr matrices.
+   * \return X.
+   */
+  MatrixBatch<E> solve(const MatrixBatch<E> &b) const;
+
+  /**
+   * \brief Overwrites B with the solution of A_b*X_b = B_b, \sa solve.
+   */
+  void solveInPlace(MatrixBatch<E> &b) const;
+};
+
+} // namespace linopt::inmemory
+
+#include "BatchFactorizations.tpp"
+#endif
@@ -0,0 +1,317 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Checks that b holds one right hand side batch per factored matrix.
+ */
+template <typename E>
+void checkBatchSystem(const MatrixBatch<E> &factors, const MatrixBatch<E> &b) {
+  if (b.size() != factors.size() || b.getN() != factors.getN())
+    throw std::runtime_error("Invalid dimensions for linear system.");
+}
+
+/**
+ * \brief 1/d, or 0 where d is 0: the padding lanes of the last pack hold
+ * zero matrices, which must neither trap nor spread NaNs.
+ */
+template <typename E> E safeInverse(E d) { return d == E() ? E() : E(1) / d; }
+
+} // namespace detail
+
+template <typename E>
+BatchLuFactorization<E>::BatchLuFactorization(const MatrixBatch<E> &a)
+    : lu(a) {
+  factor();
+}
+
+template <typename E>
+BatchLuFactorization<E>::BatchLuFactorization(MatrixBatch<E> &&a)
+    : lu(std::move(a)) {
+  factor();
+}
+
+template <typename E> void BatchLuFactorization<E>::factor() {
+  using std::abs;
+  constexpr int L = MatrixBatch<E>::lanes;
+  const int n = lu.getN();
+  if (n != lu.getM())
+    throw std::runtime_error("LU factorization of a non square matrix.");
+  LINOPT_METRICS_SCOPE("batchLu", n, 0, 0, 2.0 * lu.size() * n * n * n / 3,
+                       static_cast<double>(lu.size()) * n * n * sizeof(E));
+  pivotRows.assign(static_cast<std::size_t>(lu.packs()) * n * L, 0);
+  singular.assign(lu.size(), 0);
+  const long work = static_cast<long>(lu.packs()) * n * n * n * L / 3;
+  parallel::parallelFor(0, lu.packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      E *a = lu.pack(p);
+      int *pivots = pivotRows.data() + static_cast<std::size_t>(p) * n * L;
+      auto at = [&](int i, int j) {
+        return a + (static_cast<std::size_t>(i) * n + j) * L;
+      };
+      bool zeroPivot[L] = {};
+      for (int k = 0; k < n; k++) {
+        int best[L];
+        E largest[L];
+        for (int l = 0; l < L; l++) {
+          best[l] = k;
+          largest[l] = abs(at(k, k)[l]);
+        }
+        for (int i = k + 1; i < n; i++) {
+          const E *aik = at(i, k);
+          for (int l = 0; l < L; l++)
+            if (abs(aik[l]) > largest[l]) {
+              largest[l] = abs(aik[l]);
+              best[l] = i;
+            }
+        }
+        // the interchanges are the only per-matrix work
+        for (int l = 0; l < L; l++) {
+          pivots[k * L + l] = best[l];
+          if (best[l] != k)
+            for (int j = 0; j < n; j++)
+              std::swap(at(k, j)[l], at(best[l], j)[l]);
+        }
+        E inverse[L];
+        for (int l = 0; l < L; l++) {
+          zeroPivot[l] = zeroPivot[l] || at(k, k)[l] == E();
+          inverse[l] = detail::safeInverse(at(k, k)[l]);
+        }
+        for (int i = k + 1; i < n; i++) {
+          E *ai = at(i, 0);
+          const E *ak = at(k, 0);
+          for (int l = 0; l < L; l++)
+            ai[k * L + l] *= inverse[l];
+          for (int j = k + 1; j < n; j++)
+            for (int l = 0; l < L; l++)
+              ai[j * L + l] -= ai[k * L + l] * ak[j * L + l];
+        }
+      }
+      for (int l = 0; l < L && p * L + l < lu.size(); l++)
+        singular[p * L + l] = zeroPivot[l];
+    }
+  });
+}
+
+template <typename E> int BatchLuFactorization<E>::pivot(int b, int k) const {
+  constexpr int L = MatrixBatch<E>::lanes;
+  if (b < 0 || b >= lu.size())
+    throw std::runtime_error("Invalid batch index.");
+  if (k < 0 || k >= size())
+    throw std::runtime_error("Invalid pivot index.");
+  return pivotRows[(static_cast<std::size_t>(b / L) * size() + k) * L +
+                   b % L];
+}
+
+template <typename E> bool BatchLuFactorization<E>::isSingular(int b) const {
+  if (b < 0 || b >= lu.size())
+    throw std::runtime_error("Invalid batch index.");
+  return singular[b] != 0;
+}
+
+template <typename E>
+MatrixBatch<E> BatchLuFactorization<E>::solve(const MatrixBatch<E> &b) const {
+  MatrixBatch<E> x(b);
+  solveInPlace(x);
+  return x;
+}
+
+template <typename E>
+void BatchLuFactorization<E>::solveInPlace(MatrixBatch<E> &b) const {
+  constexpr int L = MatrixBatch<E>::lanes;
+  detail::checkBatchSystem(lu, b);
+  for (int k = 0; k < lu.size(); k++)
+    if (singular[k])
+      throw std::runtime_error("Singular matrix " + std::to_string(k) +
+                               " in the batch.");
+  const int n = size(), r = b.getM();
+  const long work = static_cast<long>(b.packs()) * n * n * r * L;
+  LINOPT_METRICS_SCOPE("batchLuSolve", n, r, 0, 2.0 * b.size() * n * n * r,
+                       (static_cast<double>(n) * n + 2.0 * n * r) * b.size() *
+                           sizeof(E));
+  parallel::parallelFor(0, b.packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      const E *a = lu.pack(p);
+      const int *pivots =
+          pivotRows.data() + static_cast<std::size_t>(p) * n * L;
+      E *x = b.pack(p);
+      auto lhs = [&](int i, int j) {
+        return a + (static_cast<std::size_t>(i) * n + j) * L;
+      };
+      auto rhs = [&](int i, int j) {
+        return x + (static_cast<std::size_t>(i) * r + j) * L;
+      };
+      for (int k = 0; k < n; k++)
+        for (int l = 0; l < L; l++)
+          if (pivots[k * L + l] != k)
+            for (int j = 0; j < r; j++)
+              std::swap(rhs(k, j)[l], rhs(pivots[k * L + l], j)[l]);
+      // L*Y = P*B, unit diagonal
+      for (int i = 1; i < n; i++)
+        for (int k = 0; k < i; k++) {
+          const E *lik = lhs(i, k);
+          for (int j = 0; j < r; j++)
+            for (int l = 0; l < L; l++)
+              rhs(i, j)[l] -= lik[l] * rhs(k, j)[l];
+        }
+      // U*X = Y
+      for (int i = n - 1; i >= 0; i--) {
+        for (int k = i + 1; k < n; k++) {
+          const E *uik = lhs(i, k);
+          for (int j = 0; j < r; j++)
+            for (int l = 0; l < L; l++)
+              rhs(i, j)[l] -= uik[l] * rhs(k, j)[l];
+        }
+        E inverse[L];
+        for (int l = 0; l < L; l++)
+          inverse[l] = detail::safeInverse(lhs(i, i)[l]);
+        for (int j = 0; j < r; j++)
+          for (int l = 0; l < L; l++)
+            rhs(i, j)[l] *= inverse[l];
+      }
+    }
+  });
+}
+
+template <typename E>
+BatchCholeskyFactorization<E>::BatchCholeskyFactorization(
+    const MatrixBatch<E> &a)
+    : l(a) {
+  factor();
+}
+
+template <typename E>
+BatchCholeskyFactorization<E>::BatchCholeskyFactorization(MatrixBatch<E> &&a)
+    : l(std::move(a)) {
+  factor();
+}
+
+template <typename E> void BatchCholeskyFactorization<E>::factor() {
+  using std::sqrt;
+  constexpr int L = MatrixBatch<E>::lanes;
+  const int n = l.getN();
+  if (n != l.getM())
+    throw std::runtime_error("Cholesky factorization of a non square matrix.");
+  LINOPT_METRICS_SCOPE("batchCholesky", n, 0, 0,
+                       static_cast<double>(l.size()) * n * n * n / 3,
+                       static_cast<double>(l.size()) * n * n * sizeof(E));
+  const int count = l.size();
+  std::vector<char> failed(count, 0);
+  const long work = static_cast<long>(l.packs()) * n * n * n * L / 6;
+  parallel::parallelFor(0, l.packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      E *a = l.pack(p);
+      auto at = [&](int i, int j) {
+        return a + (static_cast<std::size_t>(i) * n + j) * L;
+      };
+      // left-looking: column j from the columns on its left
+      for (int j = 0; j < n; j++) {
+        E d[L];
+        for (int l = 0; l < L; l++)
+          d[l] = at(j, j)[l];
+        for (int k = 0; k < j; k++) {
+          const E *ljk = at(j, k);
+          for (int l = 0; l < L; l++)
+            d[l] -= ljk[l] * ljk[l];
+        }
+        E inverse[L];
+        for (int l = 0; l < L; l++) {
+          const bool positive = d[l] > E();
+          if (!positive && p * L + l < count)
+            failed[p * L + l] = 1;
+          at(j, j)[l] = positive ? sqrt(d[l]) : E();
+          inverse[l] = detail::safeInverse(at(j, j)[l]);
+        }
+        for (int i = j + 1; i < n; i++) {
+          E *lij = at(i, j);
+          for (int k = 0; k < j; k++) {
+            const E *lik = at(i, k);
+            const E *ljk = at(j, k);
+            for (int l = 0; l < L; l++)
+              lij[l] -= lik[l] * ljk[l];
+          }
+          for (int l = 0; l < L; l++)
+            lij[l] *= inverse[l];
+          E *lji = at(j, i);
+          for (int l = 0; l < L; l++)
+            lji[l] = E();
+        }
+      }
+    }
+  });
+  for (int b = 0; b < count; b++)
+    if (failed[b])
+      throw std::runtime_error("Matrix " + std::to_string(b) +
+                               " of the batch is not positive definite.");
+}
+
+template <typename E>
+MatrixBatch<E>
+BatchCholeskyFactorization<E>::solve(const MatrixBatch<E> &b) const {
+  MatrixBatch<E> x(b);
+  solveInPlace(x);
+  return x;
+}
+
+template <typename E>
+void BatchCholeskyFactorization<E>::solveInPlace(MatrixBatch<E> &b) const {
+  constexpr int L = MatrixBatch<E>::lanes;
+  detail::checkBatchSystem(l, b);
+  const int n = size(), r = b.getM();
+  const long work = static_cast<long>(b.packs()) * n * n * r * L;
+  LINOPT_METRICS_SCOPE("batchCholeskySolve", n, r, 0, 2.0 * b.size() * n * n * r,
+                       (static_cast<double>(n) * n + 2.0 * n * r) * b.size() *
+                           sizeof(E));
+  parallel::parallelFor(0, b.packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      const E *a = l.pack(p);
+      E *x = b.pack(p);
+      auto lhs = [&](int i, int j) {
+        return a + (static_cast<std::size_t>(i) * n + j) * L;
+      };
+      auto rhs = [&](int i, int j) {
+        return x + (static_cast<std::size_t>(i) * r + j) * L;
+      };
+      // L*Y = B
+      for (int i = 0; i < n; i++) {
+        for (int k = 0; k < i; k++) {
+          const E *lik = lhs(i, k);
+          for (int j = 0; j < r; j++)
+            for (int l = 0; l < L; l++)
+              rhs(i, j)[l] -= lik[l] * rhs(k, j)[l];
+        }
+        E inverse[L];
+        for (int l = 0; l < L; l++)
+          inverse[l] = detail::safeInverse(lhs(i, i)[l]);
+        for (int j = 0; j < r; j++)
+          for (int l = 0; l < L; l++)
+            rhs(i, j)[l] *= inverse[l];
+      }
+      // L^T*X = Y: row i of L^T is column i of L
+      for (int i = n - 1; i >= 0; i--) {
+        for (int k = i + 1; k < n; k++) {
+          const E *lki = lhs(k, i);
+          for (int j = 0; j < r; j++)
+            for (int l = 0; l < L; l++)
+              rhs(i, j)[l] -= lki[l] * rhs(k, j)[l];
+        }
+        E inverse[L];
+        for (int l = 0; l < L; l++)
+          inverse[l] = detail::safeInverse(lhs(i, i)[l]);
+        for (int j = 0; j < r; j++)
+          for (int l = 0; l < L; l++)
+            rhs(i, j)[l] *= inverse[l];
+      }
+    }
+  });
+}
+
+} // namespace linopt::inmemory
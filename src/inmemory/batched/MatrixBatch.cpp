@@ -0,0 +1 @@
+#include "MatrixBatch.h"
@@ -0,0 +1,172 @@
+/**
+ * \file MatrixBatch.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::inmemory::MatrixBatch<E> container and
+ * the batched products and transposes.
+ * \details
+ *  Many independent nxm matrices stored interleaved in a single aligned
+ *  buffer. The batch is cut into packs of \sa MatrixBatch::lanes matrices
+ *  (one cache line of E); inside a pack, entry (r,c) of the lanes matrices
+ *  is contiguous. A kernel then processes a whole pack with the loops of a
+ *  single small matrix, each scalar operation becoming a vector operation
+ *  across the lanes, and packs are spread over the thread pool.
+ *  The factorizations live in BatchFactorizations.h.
+ */
+#ifndef LINOPT_ERC_INMEMORY_BATCHED_MATRIXBATCH_H
+#define LINOPT_ERC_INMEMORY_BATCHED_MATRIXBATCH_H
+
+#include <algorithm>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "Gemm.h"
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief count matrices of nxm entries of type E, interleaved.
+ *
+ * Entry (r,c) of matrix b lives at pack(b/lanes)[(r*m+c)*lanes + b%lanes].
+ * The lanes of the last pack past size() are padding and hold E().
+ */
+template <typename E> class MatrixBatch {
+public:
+  /**
+   * \brief Type of the entries.
+   */
+  using value_type = E;
+
+  /**
+   * \brief Number of matrices in a pack: one cache line of entries.
+   */
+  static constexpr int lanes =
+      static_cast<int>(std::max<std::size_t>(1, cacheLineSize / sizeof(E)));
+
+private:
+  int count = 0;
+  int rows = 0;
+  int columns = 0;
+  std::vector<E, AlignedAllocator<E>> buffer;
+
+  std::size_t index(int b, int r, int c) const {
+    return ((static_cast<std::size_t>(b / lanes) * rows + r) * columns + c) *
+               lanes +
+           b % lanes;
+  }
+
+public:
+  /**
+   * \brief Constructs count nxm matrices filled with E().
+   * \param count: number of matrices in the batch.
+   * \param n: number of rows of each matrix.
+   * \param m: number of columns of each matrix.
+   */
+  MatrixBatch(int count, int n, int m);
+
+  /**
+   * \brief Get the number of matrices.
+   */
+  int size() const { return count; }
+
+  /**
+   * \brief Get the number of rows of each matrix.
+   */
+  int getN() const { return rows; }
+
+  /**
+   * \brief Get the number of columns of each matrix.
+   */
+  int getM() const { return columns; }
+
+  /**
+   * \brief Get the number of packs, lanes matrices each.
+   */
+  int packs() const { return (count + lanes - 1) / lanes; }
+
+  /**
+   * \brief Raw access to pack p: n*m*lanes entries, aligned on 64 bytes.
+   */
+  E *pack(int p) {
+    return buffer.data() + static_cast<std::size_t>(p) * rows * columns * lanes;
+  }
+
+  /**
+   * \brief Raw read-only access to pack p.
+   */
+  const E *pack(int p) const {
+    return buffer.data() + static_cast<std::size_t>(p) * rows * columns * lanes;
+  }
+
+  /**
+   * \brief Entry (r,c) of matrix b.
+   *
+   * Does bounds-checking.
+   */
+  E &get(int b, int r, int c);
+
+  /**
+   * \brief Entry (r,c) of matrix b, read-only.
+   *
+   * Does bounds-checking.
+   */
+  const E &get(int b, int r, int c) const;
+
+  /**
+   * \brief Unchecked entry access.
+   */
+  const E &coeff(int b, int r, int c) const { return buffer[index(b, r, c)]; }
+
+  /**
+   * \brief Copy of matrix b.
+   *
+   * Throws a runtime_error if b is out of range.
+   */
+  Matrix<E> matrix(int b) const;
+
+  /**
+   * \brief Overwrites matrix b with x.
+   *
+   * Throws a runtime_error if b is out of range or the dimensions don't
+   * match.
+   * \return a reference to the batch.
+   */
+  template <typename X>
+  MatrixBatch &set(int b, const MatrixExpression<X> &x);
+
+  /**
+   * \brief Fills every matrix with E(e).
+   */
+  MatrixBatch &fill(E e);
+
+  /**
+   * \brief The batch of the transposes.
+   */
+  MatrixBatch transpose() const;
+
+  bool operator==(const MatrixBatch &other) const = default;
+};
+
+/**
+ * \brief Computes c_b = a_b*b_b, c_b += a_b*b_b or c_b -= a_b*b_b for every
+ * matrix of the batches, depending on update.
+ *
+ * If the batch sizes or the dimensions are not appropriate, a
+ * runtime_error is thrown. c may be a or b.
+ */
+template <typename E>
+void multiply(const MatrixBatch<E> &a, const MatrixBatch<E> &b,
+              MatrixBatch<E> &c,
+              kernels::GemmUpdate update = kernels::GemmUpdate::overwrite);
+
+/**
+ * \brief The batch of the products a_b*b_b, \sa multiply.
+ */
+template <typename E>
+MatrixBatch<E> operator*(const MatrixBatch<E> &a, const MatrixBatch<E> &b);
+
+} // namespace linopt::inmemory
+
+#include "MatrixBatch.tpp"
+#endif
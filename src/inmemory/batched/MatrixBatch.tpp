@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief C += A*B (C -= A*B if subtract) for one pack of L nxk by kxm
+ * products.
+ *
+ * The innermost loop runs over the lanes: L independent multiply-adds on
+ * contiguous entries, which the compiler turns into vector instructions.
+ */
+template <typename E, int L>
+void packGemm(int n, int m, int k, const E *a, const E *b, E *c,
+              bool subtract) {
+  for (int i = 0; i < n; i++) {
+    E *ci = c + static_cast<std::size_t>(i) * m * L;
+    for (int p = 0; p < k; p++) {
+      const E *aip = a + (static_cast<std::size_t>(i) * k + p) * L;
+      const E *bp = b + static_cast<std::size_t>(p) * m * L;
+      for (int j = 0; j < m; j++) {
+        E *cij = ci + static_cast<std::size_t>(j) * L;
+        const E *bpj = bp + static_cast<std::size_t>(j) * L;
+        if (subtract)
+          for (int l = 0; l < L; l++)
+            cij[l] -= aip[l] * bpj[l];
+        else
+          for (int l = 0; l < L; l++)
+            cij[l] += aip[l] * bpj[l];
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+template <typename E>
+MatrixBatch<E>::MatrixBatch(int count, int n, int m)
+    : count(count), rows(n), columns(m) {
+  if (count < 1)
+    throw std::runtime_error("Invalid batch size (<1).");
+  if (n < 1 || m < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+  buffer.assign(static_cast<std::size_t>(packs()) * n * m * lanes, E());
+}
+
+template <typename E> E &MatrixBatch<E>::get(int b, int r, int c) {
+  if (b < 0 || b >= count)
+    throw std::runtime_error("Invalid batch index.");
+  if (r < 0 || r >= rows || c < 0 || c >= columns)
+    throw std::runtime_error("Invalid index pair.");
+  return buffer[index(b, r, c)];
+}
+
+template <typename E> const E &MatrixBatch<E>::get(int b, int r, int c) const {
+  if (b < 0 || b >= count)
+    throw std::runtime_error("Invalid batch index.");
+  if (r < 0 || r >= rows || c < 0 || c >= columns)
+    throw std::runtime_error("Invalid index pair.");
+  return buffer[index(b, r, c)];
+}
+
+template <typename E> Matrix<E> MatrixBatch<E>::matrix(int b) const {
+  if (b < 0 || b >= count)
+    throw std::runtime_error("Invalid batch index.");
+  Matrix<E> a(rows, columns);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < columns; j++)
+      a.get(i, j) = buffer[index(b, i, j)];
+  return a;
+}
+
+template <typename E>
+template <typename X>
+MatrixBatch<E> &MatrixBatch<E>::set(int b, const MatrixExpression<X> &x) {
+  const X &expression = x.derived();
+  if (b < 0 || b >= count)
+    throw std::runtime_error("Invalid batch index.");
+  if (expression.getN() != rows || expression.getM() != columns)
+    throw std::runtime_error("Invalid dimensions for matrix assignment.");
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < columns; j++)
+      buffer[index(b, i, j)] = expression.coeff(i, j);
+  return *this;
+}
+
+template <typename E> MatrixBatch<E> &MatrixBatch<E>::fill(E e) {
+  const int last = count - (packs() - 1) * lanes;
+  const std::size_t entries = static_cast<std::size_t>(rows) * columns;
+  const long work = static_cast<long>(buffer.size());
+  parallel::parallelFor(0, packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      // padding lanes of the last pack stay E()
+      const int used = p == packs() - 1 ? last : lanes;
+      E *d = pack(p);
+      for (std::size_t t = 0; t < entries; t++)
+        std::fill(d + t * lanes, d + t * lanes + used, e);
+    }
+  });
+  return *this;
+}
+
+template <typename E> MatrixBatch<E> MatrixBatch<E>::transpose() const {
+  LINOPT_METRICS_SCOPE("batchTranspose", rows, columns, 0, 0,
+                       2.0 * buffer.size() * sizeof(E));
+  MatrixBatch<E> t(count, columns, rows);
+  const long work = static_cast<long>(buffer.size());
+  parallel::parallelFor(0, packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      const E *s = pack(p);
+      E *d = t.pack(p);
+      // the lanes of an entry move together, one cache line at a time
+      for (int i = 0; i < rows; i++)
+        for (int j = 0; j < columns; j++) {
+          const std::size_t from = static_cast<std::size_t>(i) * columns + j;
+          const std::size_t to = static_cast<std::size_t>(j) * rows + i;
+          std::copy(s + from * lanes, s + (from + 1) * lanes, d + to * lanes);
+        }
+    }
+  });
+  return t;
+}
+
+template <typename E>
+void multiply(const MatrixBatch<E> &a, const MatrixBatch<E> &b,
+              MatrixBatch<E> &c, kernels::GemmUpdate update) {
+  if (a.size() != b.size() || a.size() != c.size())
+    throw std::runtime_error("Invalid batch sizes for matrix multiplication.");
+  if (a.getM() != b.getN() || a.getN() != c.getN() || b.getM() != c.getM())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  if (&c == &a || &c == &b) {
+    // the product would overwrite its own operand: compute it aside
+    const MatrixBatch<E> p = a * b;
+    const std::size_t total = static_cast<std::size_t>(c.packs()) *
+                              c.getN() * c.getM() * MatrixBatch<E>::lanes;
+    const E *s = p.pack(0);
+    E *d = c.pack(0);
+    for (std::size_t t = 0; t < total; t++) {
+      if (update == kernels::GemmUpdate::overwrite)
+        d[t] = s[t];
+      else if (update == kernels::GemmUpdate::accumulate)
+        d[t] += s[t];
+      else
+        d[t] -= s[t];
+    }
+    return;
+  }
+  constexpr int L = MatrixBatch<E>::lanes;
+  const int n = a.getN(), m = b.getM(), k = a.getM();
+  LINOPT_METRICS_SCOPE("batchGemm", n, m, k, 2.0 * a.size() * n * m * k,
+                       (static_cast<double>(n) * k + static_cast<double>(k) * m +
+                        static_cast<double>(n) * m) *
+                           a.size() * sizeof(E));
+  const std::size_t entries = static_cast<std::size_t>(n) * m * L;
+  const long work = static_cast<long>(c.packs()) * n * m * k * L;
+  parallel::parallelFor(0, c.packs(), work, [&](int p0, int p1) {
+    for (int p = p0; p < p1; p++) {
+      if (update == kernels::GemmUpdate::overwrite)
+        std::fill(c.pack(p), c.pack(p) + entries, E());
+      detail::packGemm<E, L>(n, m, k, a.pack(p), b.pack(p), c.pack(p),
+                             update == kernels::GemmUpdate::subtract);
+    }
+  });
+}
+
+template <typename E>
+MatrixBatch<E> operator*(const MatrixBatch<E> &a, const MatrixBatch<E> &b) {
+  MatrixBatch<E> c(a.size(), a.getN(), b.getM());
+  multiply(a, b, c);
+  return c;
+}
+
+} // namespace linopt::inmemory
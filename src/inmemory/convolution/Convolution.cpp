@@ -0,0 +1,66 @@
+#include "Convolution.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace linopt::inmemory {
+
+namespace {
+/**
+ * \brief Smallest FFT length along a dimension: a 128x128 complex<double>
+ * tile (256 KiB) still sits in a core's L2 cache.
+ */
+constexpr int minimumFftLength = 128;
+
+/**
+ * \brief Cost of one multiply-add of the FFT engine relative to the direct
+ * one, whose axpy loops vectorize fully.
+ */
+constexpr double fftPenalty = 6.0;
+} // namespace
+
+namespace detail {
+
+int fftLength(int image, int kernel) {
+  const unsigned wanted =
+      std::max<unsigned>(minimumFftLength, std::bit_ceil(4u * kernel));
+  // a single tile needs no more than the full convolution
+  return static_cast<int>(
+      std::min(wanted, std::bit_ceil(static_cast<unsigned>(image + kernel - 1))));
+}
+
+ConvolutionWindow convolutionWindow(int n, int m, int p, int q,
+                                    ConvolutionMode mode) {
+  switch (mode) {
+  case ConvolutionMode::full:
+    return {0, 0, n + p - 1, m + q - 1};
+  case ConvolutionMode::same:
+    return {(p - 1) / 2, (q - 1) / 2, n, m};
+  default:
+    if (p > n || q > m)
+      throw std::runtime_error("Kernel larger than the image in valid mode.");
+    return {p - 1, q - 1, n - p + 1, m - q + 1};
+  }
+}
+
+} // namespace detail
+
+ConvolutionMethod chooseConvolutionMethod(int n, int m, int p, int q,
+                                          ConvolutionMode mode) {
+  const detail::ConvolutionWindow w =
+      detail::convolutionWindow(n, m, p, q, mode);
+  const double direct = static_cast<double>(w.outN) * w.outM * p * q;
+  const int fn = detail::fftLength(n, p), fm = detail::fftLength(m, q);
+  const double tiles = std::ceil(static_cast<double>(n) / (fn - p + 1)) *
+                       std::ceil(static_cast<double>(m) / (fm - q + 1));
+  const double size = static_cast<double>(fn) * fm;
+  // a forward and an inverse transform, 2.5*size*log2(size) multiply-adds
+  // each, and the pointwise product
+  const double fft = tiles * size * (5 * std::log2(size) + 4);
+  return fftPenalty * fft < direct ? ConvolutionMethod::fft
+                                   : ConvolutionMethod::direct;
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1,94 @@
+/**
+ * \file Convolution.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the 2D convolution and correlation of matrices.
+ * \details
+ *  Two engines compute the same result:
+ *  - direct: the image is copied once into a zero-bordered buffer, then
+ *    every kernel entry adds a scaled, shifted image row to each output
+ *    row. The inner loop is a branch-free axpy over contiguous entries,
+ *    which the compiler vectorizes; output rows are spread over the thread
+ *    pool. O(n*m*p*q) for an nxm image and a pxq kernel.
+ *  - fft: overlap-add. The image is cut into tiles which, padded with the
+ *    kernel size, fill a power of two sized FFT; each tile is transformed,
+ *    multiplied by the transform of the kernel (computed once) and
+ *    transformed back, and the results are added at their offsets. Tile
+ *    rows are spread over the thread pool, even ones first then odd ones,
+ *    so that concurrent tiles never overlap. O(n*m*log(tile)) whatever the
+ *    kernel size. Integer matrices are transformed in double and the
+ *    result rounded.
+ *
+ *  \sa ConvolutionMethod::automatic picks the cheaper one from the sizes.
+ */
+#ifndef LINOPT_ERC_INMEMORY_CONVOLUTION_CONVOLUTION_H
+#define LINOPT_ERC_INMEMORY_CONVOLUTION_CONVOLUTION_H
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Part of the full convolution returned, as in numpy and scipy.
+ */
+enum class ConvolutionMode {
+  /**
+   * \brief (n+p-1)x(m+q-1): every position where the kernel overlaps the image.
+   */
+  full,
+  /**
+   * \brief nxm, centered on the full result.
+   */
+  same,
+  /**
+   * \brief (n-p+1)x(m-q+1): the kernel entirely inside the image.
+   */
+  valid
+};
+
+/**
+ * \brief Engine computing the convolution, \sa Convolution.h.
+ */
+enum class ConvolutionMethod { automatic, direct, fft };
+
+/**
+ * \brief The engine \sa ConvolutionMethod::automatic picks for these sizes.
+ * \param n, m: dimensions of the image.
+ * \param p, q: dimensions of the kernel.
+ * \param mode: part of the result computed.
+ * \return direct or fft.
+ */
+ConvolutionMethod chooseConvolutionMethod(int n, int m, int p, int q,
+                                          ConvolutionMode mode);
+
+/**
+ * \brief The 2D convolution of image by kernel:
+ * c(i,j) = sum over (a,b) of kernel(a,b)*image(i-a,j-b).
+ *
+ * Throws a runtime_error in valid mode if the kernel is larger than the
+ * image in either dimension.
+ * \param image: the nxm input.
+ * \param kernel: the pxq filter.
+ * \param mode: part of the full result returned.
+ * \param method: engine, chosen from the sizes by default.
+ */
+template <typename E>
+Matrix<E> convolve(const Matrix<E> &image, const Matrix<E> &kernel,
+                   ConvolutionMode mode = ConvolutionMode::same,
+                   ConvolutionMethod method = ConvolutionMethod::automatic);
+
+/**
+ * \brief The 2D cross-correlation of image by kernel:
+ * c(i,j) = sum over (a,b) of kernel(a,b)*image(i+a,j+b), \sa convolve.
+ *
+ * The convolution by the kernel rotated by 180 degrees.
+ */
+template <typename E>
+Matrix<E> correlate(const Matrix<E> &image, const Matrix<E> &kernel,
+                    ConvolutionMode mode = ConvolutionMode::same,
+                    ConvolutionMethod method = ConvolutionMethod::automatic);
+
+} // namespace linopt::inmemory
+
+#include "Convolution.tpp"
+#endif
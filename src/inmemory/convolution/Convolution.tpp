@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Metrics.h"
+#include "Parallel.h"
+#include "Workspace.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Length of the FFTs along a dimension: a power of two at least
+ * 128 and at least four times the kernel, so that overlap-add tiles are
+ * at least three times as long as their overlap, capped at the full
+ * convolution's length (Convolution.cpp).
+ */
+int fftLength(int image, int kernel);
+
+/**
+ * \brief Rows [i0, i0+outN) and columns [j0, j0+outM) of the full
+ * convolution make up the result of a mode.
+ */
+struct ConvolutionWindow {
+  int i0, j0, outN, outM;
+};
+
+/**
+ * \brief The window of mode, \sa ConvolutionWindow.
+ *
+ * Throws a runtime_error if the valid window is empty.
+ */
+ConvolutionWindow convolutionWindow(int n, int m, int p, int q,
+                                    ConvolutionMode mode);
+
+/**
+ * \brief In-place radix-2 complex FFT of a fixed power of two length.
+ */
+template <typename R> class Fft {
+private:
+  int length;
+  /**
+   * \brief exp(-2*pi*i*k/length), k < length/2.
+   */
+  std::vector<std::complex<R>> twiddles;
+  std::vector<int> reversed;
+
+public:
+  explicit Fft(int length) : length(length), reversed(length, 0) {
+    for (int k = 0; k < length / 2; k++)
+      twiddles.push_back(std::polar(R(1), -2 * std::numbers::pi_v<R> * k /
+                                              static_cast<R>(length)));
+    for (int i = 1, j = 0; i < length; i++) {
+      int bit = length >> 1;
+      for (; j & bit; bit >>= 1)
+        j ^= bit;
+      j ^= bit;
+      reversed[i] = j;
+    }
+  }
+
+  int size() const { return length; }
+
+  /**
+   * \brief x <- F*x, or the unscaled inverse transform if inverse.
+   */
+  void operator()(std::complex<R> *x, bool inverse) const {
+    for (int i = 0; i < length; i++)
+      if (i < reversed[i])
+        std::swap(x[i], x[reversed[i]]);
+    for (int half = 1; half < length; half *= 2) {
+      const int step = length / (2 * half);
+      for (int s = 0; s < length; s += 2 * half)
+        for (int k = 0; k < half; k++) {
+          const std::complex<R> w =
+              inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+          const std::complex<R> t = w * x[s + k + half];
+          x[s + k + half] = x[s + k] - t;
+          x[s + k] += t;
+        }
+    }
+  }
+};
+
+/**
+ * \brief 2D transform of the rows x columns row-major buffer x, of which
+ * only the first nonzeroRows rows may be nonzero.
+ * \param column: scratch of rows entries.
+ */
+template <typename R>
+void fft2D(const Fft<R> &rowFft, const Fft<R> &columnFft, std::complex<R> *x,
+           int nonzeroRows, bool inverse, std::complex<R> *column) {
+  const int rows = columnFft.size(), columns = rowFft.size();
+  // the transform of a zero row is zero
+  for (int i = 0; i < nonzeroRows; i++)
+    rowFft(x + static_cast<std::size_t>(i) * columns, inverse);
+  for (int j = 0; j < columns; j++) {
+    for (int i = 0; i < rows; i++)
+      column[i] = x[static_cast<std::size_t>(i) * columns + j];
+    columnFft(column, inverse);
+    for (int i = 0; i < rows; i++)
+      x[static_cast<std::size_t>(i) * columns + j] = column[i];
+  }
+}
+
+template <typename E> E fromReal(double x) {
+  if constexpr (std::is_integral_v<E>)
+    return static_cast<E>(std::llround(x));
+  else
+    return static_cast<E>(x);
+}
+
+template <typename E>
+Matrix<E> directConvolution(const Matrix<E> &image, const Matrix<E> &kernel,
+                            const ConvolutionWindow &w) {
+  const int n = image.getN(), m = image.getM();
+  const int p = kernel.getN(), q = kernel.getM();
+  LINOPT_METRICS_SCOPE("convolutionDirect", n, m, p,
+                       2.0 * w.outN * w.outM * p * q,
+                       (static_cast<double>(n) * m +
+                        static_cast<double>(w.outN) * w.outM) *
+                           sizeof(E));
+  // zero borders of p-1 rows and q-1 columns: no bounds checks below
+  const int pn = n + 2 * (p - 1), pm = m + 2 * (q - 1);
+  const auto padded = memory::Workspace::local().borrow<E>(
+      static_cast<std::size_t>(pn) * pm);
+  std::fill(padded.begin(), padded.end(), E());
+  for (int i = 0; i < n; i++)
+    std::copy(image.data() + static_cast<std::size_t>(i) * image.stride(),
+              image.data() + static_cast<std::size_t>(i) * image.stride() + m,
+              padded.data() + static_cast<std::size_t>(i + p - 1) * pm + q -
+                  1);
+  Matrix<E> out(w.outN, w.outM);
+  const long work = static_cast<long>(w.outN) * w.outM * p * q;
+  parallel::parallelFor(0, w.outN, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      E *o = out.data() + static_cast<std::size_t>(i) * out.stride();
+      for (int a = 0; a < p; a++) {
+        // out(i, j) += kernel(a, b) * image(i0+i-a, j0+j-b)
+        const E *row = padded.data() +
+                       static_cast<std::size_t>(w.i0 + i - a + p - 1) * pm +
+                       w.j0 + q - 1;
+        for (int b = 0; b < q; b++) {
+          const E k = kernel.get(a, b);
+          if (k == E())
+            continue;
+          const E *s = row - b;
+          for (int j = 0; j < w.outM; j++)
+            o[j] += k * s[j];
+        }
+      }
+    }
+  });
+  return out;
+}
+
+template <typename E>
+Matrix<E> fftConvolution(const Matrix<E> &image, const Matrix<E> &kernel,
+                         const ConvolutionWindow &w) {
+  using R = std::conditional_t<std::is_floating_point_v<E>, E, double>;
+  using C = std::complex<R>;
+  const int n = image.getN(), m = image.getM();
+  const int p = kernel.getN(), q = kernel.getM();
+  const int fn = fftLength(n, p), fm = fftLength(m, q);
+  // tile + kernel - 1 entries fit in a transform: no wrap around
+  const int tn = fn - p + 1, tm = fm - q + 1;
+  const int tileRows = (n + tn - 1) / tn, tileColumns = (m + tm - 1) / tm;
+  const std::size_t size = static_cast<std::size_t>(fn) * fm;
+  LINOPT_METRICS_SCOPE("convolutionFft", n, m, p,
+                       10.0 * tileRows * tileColumns * size *
+                           std::log2(static_cast<double>(size)),
+                       (static_cast<double>(n) * m +
+                        static_cast<double>(w.outN) * w.outM) *
+                           sizeof(E));
+  const Fft<R> rowFft(fm), columnFft(fn);
+  std::vector<C> spectrum(size), column(fn);
+  for (int a = 0; a < p; a++)
+    for (int b = 0; b < q; b++)
+      spectrum[static_cast<std::size_t>(a) * fm + b] =
+          static_cast<R>(kernel.get(a, b));
+  fft2D(rowFft, columnFft, spectrum.data(), p, false, column.data());
+  const R scale = R(1) / static_cast<R>(size);
+  for (C &s : spectrum)
+    s *= scale; // folds in the normalization of the inverse transform
+
+  const int fullM = m + q - 1;
+  std::vector<R> full(static_cast<std::size_t>(n + p - 1) * fullM, R());
+  const long work = static_cast<long>(tileRows) * tileColumns * size *
+                    static_cast<long>(std::log2(static_cast<double>(size)));
+  // a tile row overlaps the next one only (tn >= p-1): even tile rows
+  // never touch each other, nor do odd ones
+  for (int parity = 0; parity < 2; parity++) {
+    const int count = (tileRows - parity + 1) / 2;
+    parallel::parallelFor(0, count, work / 2, [&](int t0, int t1) {
+      std::vector<C> tile(size), scratch(fn);
+      for (int t = t0; t < t1; t++) {
+        const int r0 = (2 * t + parity) * tn, h = std::min(tn, n - r0);
+        for (int c = 0; c < tileColumns; c++) {
+          const int c0 = c * tm, wd = std::min(tm, m - c0);
+          std::fill(tile.begin(), tile.end(), C());
+          for (int i = 0; i < h; i++) {
+            const E *s = image.data() +
+                         static_cast<std::size_t>(r0 + i) * image.stride() + c0;
+            C *d = tile.data() + static_cast<std::size_t>(i) * fm;
+            for (int j = 0; j < wd; j++)
+              d[j] = static_cast<R>(s[j]);
+          }
+          fft2D(rowFft, columnFft, tile.data(), h, false, scratch.data());
+          for (std::size_t k = 0; k < size; k++)
+            tile[k] *= spectrum[k];
+          fft2D(rowFft, columnFft, tile.data(), fn, true, scratch.data());
+          for (int i = 0; i < h + p - 1; i++) {
+            R *d = full.data() + static_cast<std::size_t>(r0 + i) * fullM + c0;
+            const C *s = tile.data() + static_cast<std::size_t>(i) * fm;
+            for (int j = 0; j < wd + q - 1; j++)
+              d[j] += s[j].real();
+          }
+        }
+      }
+    });
+  }
+
+  Matrix<E> out(w.outN, w.outM);
+  for (int i = 0; i < w.outN; i++) {
+    const R *s = full.data() + static_cast<std::size_t>(w.i0 + i) * fullM + w.j0;
+    E *d = out.data() + static_cast<std::size_t>(i) * out.stride();
+    for (int j = 0; j < w.outM; j++)
+      d[j] = fromReal<E>(s[j]);
+  }
+  return out;
+}
+
+} // namespace detail
+
+template <typename E>
+Matrix<E> convolve(const Matrix<E> &image, const Matrix<E> &kernel,
+                   ConvolutionMode mode, ConvolutionMethod method) {
+  const int n = image.getN(), m = image.getM();
+  const int p = kernel.getN(), q = kernel.getM();
+  const detail::ConvolutionWindow w =
+      detail::convolutionWindow(n, m, p, q, mode);
+  if (method == ConvolutionMethod::automatic)
+    method = chooseConvolutionMethod(n, m, p, q, mode);
+  if (method == ConvolutionMethod::fft)
+    return detail::fftConvolution(image, kernel, w);
+  return detail::directConvolution(image, kernel, w);
+}
+
+template <typename E>
+Matrix<E> correlate(const Matrix<E> &image, const Matrix<E> &kernel,
+                    ConvolutionMode mode, ConvolutionMethod method) {
+  const int p = kernel.getN(), q = kernel.getM();
+  Matrix<E> rotated(p, q);
+  for (int a = 0; a < p; a++)
+    for (int b = 0; b < q; b++)
+      rotated.get(p - 1 - a, q - 1 - b) = kernel.get(a, b);
+  return convolve(image, rotated, mode, method);
+}
+
+} // namespace linopt::inmemory
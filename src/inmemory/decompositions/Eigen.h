@@ -0,0 +1,72 @@
+/**
+ * \file Eigen.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the dense symmetric eigensolver.
+ * \details
+ *  The matrix is first reduced to a tridiagonal T = Q^T*a*Q by Householder
+ *  reflections. The eigenpairs of T are computed by divide and conquer:
+ *  T is split in two halves coupled by a rank one term, the halves are
+ *  solved recursively (concurrently), and the rank one update of their
+ *  eigendecompositions is solved through the secular equation, with
+ *  deflation of the negligible and clustered components and eigenvectors
+ *  recomputed from the eigenvalues (Gu and Eisenstat) so that they stay
+ *  orthogonal. Small subproblems are solved by the implicit QL algorithm.
+ */
+#ifndef LINOPT_ERC_INMEMORY_DECOMPOSITIONS_EIGEN_H
+#define LINOPT_ERC_INMEMORY_DECOMPOSITIONS_EIGEN_H
+
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Eigendecomposition a = vectors*diag(values)*vectors^T.
+ */
+template <typename E> struct EigenDecomposition {
+  /**
+   * \brief Eigenvalues, in increasing order.
+   */
+  std::vector<E> values;
+  /**
+   * \brief Orthonormal eigenvectors, one per column.
+   */
+  Matrix<E> vectors;
+};
+
+/**
+ * \brief All the eigenpairs of a symmetric matrix.
+ *
+ * Only the lower triangle of a is read. Throws a runtime_error if a is not
+ * square.
+ */
+template <typename E>
+EigenDecomposition<E> symmetricEigen(const Matrix<E> &a);
+
+/**
+ * \brief All the eigenvalues of a symmetric matrix, in increasing order.
+ *
+ * Cheaper than \sa symmetricEigen: O(n^2) after the reduction.
+ */
+template <typename E> std::vector<E> symmetricEigenvalues(const Matrix<E> &a);
+
+namespace detail {
+
+/**
+ * \brief Eigenpairs of the symmetric tridiagonal matrix with diagonal d
+ * and off-diagonal e (n-1 entries), by divide and conquer.
+ *
+ * d is overwritten by the eigenvalues in increasing order, e is destroyed,
+ * q (nxn) receives the eigenvectors.
+ */
+template <typename E>
+void tridiagonalEigen(int n, E *d, E *e, Matrix<E> &q);
+
+} // namespace detail
+
+} // namespace linopt::inmemory
+
+#include "Eigen.tpp"
+#endif
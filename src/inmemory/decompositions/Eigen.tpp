@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "Parallel.h"
+#include "ThreadPool.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Subproblems up to this size are solved by implicit QL.
+ */
+inline constexpr int eigenLeafSize = 32;
+
+/**
+ * \brief Reduces the symmetric a (lower triangle read) to tridiagonal form
+ * in place.
+ *
+ * On return d and e hold the tridiagonal, the Householder vectors are
+ * below the subdiagonal of a and their factors in tau.
+ */
+template <typename E>
+void tridiagonalize(Matrix<E> &a, std::vector<E> &d, std::vector<E> &e,
+                    std::vector<E> &tau) {
+  using std::sqrt;
+  const int n = a.getN();
+  const std::size_t ld = a.stride();
+  E *x = a.data();
+  for (int i = 0; i < n; i++)
+    for (int j = i + 1; j < n; j++)
+      x[i * ld + j] = x[j * ld + i];
+  d.assign(n, E(0));
+  e.assign(std::max(n - 1, 0), E(0));
+  tau.assign(std::max(n - 2, 0), E(0));
+  std::vector<E> v(n), p(n);
+  for (int k = 0; k + 2 < n; k++) {
+    const int k1 = k + 1;
+    const E alpha = x[k1 * ld + k];
+    E s(0);
+    for (int i = k1 + 1; i < n; i++)
+      s += x[i * ld + k] * x[i * ld + k];
+    if (s == E(0)) {
+      e[k] = alpha;
+      continue;
+    }
+    const E norm = sqrt(alpha * alpha + s);
+    const E beta = alpha >= E(0) ? -norm : norm;
+    const E t = (beta - alpha) / beta;
+    const E scale = E(1) / (alpha - beta);
+    v[k1] = E(1);
+    for (int i = k1 + 1; i < n; i++)
+      v[i] = x[i * ld + k] *= scale;
+    e[k] = beta;
+    tau[k] = t;
+    // A22 <- H*A22*H = A22 - v*w^T - w*v^T, w = p - (tau/2)(p.v) v,
+    // p = tau*A22*v
+    const long work = 2L * (n - k1) * (n - k1);
+    parallel::parallelFor(k1, n, work, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++) {
+        const E *row = x + i * ld;
+        E sum(0);
+        for (int j = k1; j < n; j++)
+          sum += row[j] * v[j];
+        p[i] = t * sum;
+      }
+    });
+    E pv(0);
+    for (int i = k1; i < n; i++)
+      pv += p[i] * v[i];
+    const E half = t * pv / 2;
+    for (int i = k1; i < n; i++)
+      p[i] -= half * v[i];
+    parallel::parallelFor(k1, n, work, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++) {
+        E *row = x + i * ld;
+        const E vi = v[i], wi = p[i];
+        for (int j = k1; j < n; j++)
+          row[j] -= vi * p[j] + wi * v[j];
+      }
+    });
+  }
+  for (int i = 0; i < n; i++)
+    d[i] = x[i * ld + i];
+  if (n >= 2)
+    e[n - 2] = x[(n - 1) * ld + n - 2];
+}
+
+/**
+ * \brief Forms Q = H_0*H_1*...*H_{n-3} from the output of
+ * \sa tridiagonalize.
+ */
+template <typename E>
+Matrix<E> tridiagonalBasis(const Matrix<E> &a, const std::vector<E> &tau) {
+  const int n = a.getN();
+  Matrix<E> q(n, n);
+  const std::size_t ld = q.stride();
+  E *y = q.data();
+  for (int i = 0; i < n; i++)
+    y[i * ld + i] = E(1);
+  std::vector<E> v(n), w(n);
+  for (int k = n - 3; k >= 0; k--) {
+    if (tau[k] == E(0))
+      continue;
+    const int k1 = k + 1;
+    v[k1] = E(1);
+    for (int i = k1 + 1; i < n; i++)
+      v[i] = a.coeff(i, k);
+    // Q22 <- H_k*Q22: w = Q22^T*v, Q22 -= tau*v*w^T
+    std::fill(w.begin() + k1, w.end(), E(0));
+    for (int i = k1; i < n; i++) {
+      const E vi = v[i];
+      const E *row = y + i * ld;
+      for (int j = k1; j < n; j++)
+        w[j] += vi * row[j];
+    }
+    const E t = tau[k];
+    parallel::parallelFor(k1, n, 2L * (n - k1) * (n - k1),
+                          [&](int i0, int i1) {
+                            for (int i = i0; i < i1; i++) {
+                              E *row = y + i * ld;
+                              const E f = t * v[i];
+                              for (int j = k1; j < n; j++)
+                                row[j] -= f * w[j];
+                            }
+                          });
+  }
+  return q;
+}
+
+/**
+ * \brief Implicit QL iterations on the tridiagonal (d, e), accumulating
+ * the rotations into the columns of z when not null.
+ */
+template <typename E> void tridiagonalQl(int n, E *d, E *e, Matrix<E> *z) {
+  using std::abs;
+  using std::hypot;
+  const E eps = std::numeric_limits<E>::epsilon();
+  std::vector<E> off(n, E(0));
+  std::copy(e, e + std::max(n - 1, 0), off.begin());
+  for (int l = 0; l < n; l++) {
+    for (int iteration = 0;; iteration++) {
+      int m = l;
+      for (; m < n - 1; m++)
+        if (abs(off[m]) <= eps * (abs(d[m]) + abs(d[m + 1])))
+          break;
+      if (m == l)
+        break;
+      if (iteration == 60)
+        throw std::runtime_error("No convergence of the QL iterations.");
+      E g = (d[l + 1] - d[l]) / (2 * off[l]);
+      E r = hypot(g, E(1));
+      g = d[m] - d[l] + off[l] / (g + (g >= E(0) ? r : -r));
+      E s(1), c(1), p(0);
+      bool underflow = false;
+      for (int i = m - 1; i >= l; i--) {
+        const E f = s * off[i], b = c * off[i];
+        off[i + 1] = r = hypot(f, g);
+        if (r == E(0)) {
+          d[i + 1] -= p;
+          off[m] = E(0);
+          underflow = true;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+        if (z != nullptr)
+          for (int k = 0; k < z->getN(); k++) {
+            E *row = z->data() + static_cast<std::size_t>(k) * z->stride();
+            const E zi = row[i], zj = row[i + 1];
+            row[i + 1] = s * zi + c * zj;
+            row[i] = c * zi - s * zj;
+          }
+      }
+      if (underflow)
+        continue;
+      d[l] -= p;
+      off[l] = g;
+      off[m] = E(0);
+    }
+  }
+}
+
+/**
+ * \brief Sorts the eigenvalues d increasingly, the columns of q with them.
+ */
+template <typename E> void sortEigenpairs(int n, E *d, Matrix<E> &q) {
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int x, int y) { return d[x] < d[y]; });
+  const std::vector<E> values(d, d + n);
+  for (int k = 0; k < n; k++)
+    d[k] = values[order[k]];
+  std::vector<E> row(n);
+  for (int i = 0; i < q.getN(); i++) {
+    E *qi = &q.get(i, 0);
+    for (int k = 0; k < n; k++)
+      row[k] = qi[order[k]];
+    std::copy(row.begin(), row.end(), qi);
+  }
+}
+
+/**
+ * \brief Eigenpairs of diag(d) + rho*z*z^T, rho > 0, d increasing and
+ * strictly separated, ||z|| = 1, no z_i negligible.
+ *
+ * lambda receives the eigenvalues, u (kxk) the eigenvectors.
+ */
+template <typename E>
+void secularEigen(int k, const E *d, const E *z, E rho, E *lambda,
+                  Matrix<E> &u) {
+  using std::sqrt;
+  // diff(j, i) = d_i - lambda_j, computed from the nearest pole so that
+  // it keeps its relative accuracy
+  Matrix<E> diff(k, k);
+  parallel::parallelFor(0, k, 100L * k * k, [&](int j0, int j1) {
+    std::vector<E> delta(k);
+    for (int j = j0; j < j1; j++) {
+      int origin = j;
+      E lo(0), hi;
+      if (j < k - 1) {
+        const E mid = (d[j + 1] - d[j]) / 2;
+        E f(1);
+        for (int i = 0; i < k; i++)
+          f += rho * z[i] * z[i] / ((d[i] - d[j]) - mid);
+        if (f >= E(0)) {
+          hi = mid;
+        } else {
+          origin = j + 1;
+          lo = -mid;
+          hi = E(0);
+        }
+      } else {
+        hi = rho;
+      }
+      for (int i = 0; i < k; i++)
+        delta[i] = d[i] - d[origin];
+      for (int iteration = 0; iteration < 200; iteration++) {
+        const E mu = (lo + hi) / 2;
+        if (mu == lo || mu == hi)
+          break;
+        E f(1);
+        for (int i = 0; i < k; i++)
+          f += rho * z[i] * z[i] / (delta[i] - mu);
+        if (f > E(0))
+          hi = mu;
+        else
+          lo = mu;
+      }
+      const E mu = (lo + hi) / 2;
+      lambda[j] = d[origin] + mu;
+      E *row = diff.data() + static_cast<std::size_t>(j) * diff.stride();
+      for (int i = 0; i < k; i++)
+        row[i] = delta[i] - mu;
+    }
+  });
+  // z recomputed from the eigenvalues (Loewner): the eigenvectors of the
+  // perturbed problem it defines exactly are numerically orthogonal
+  std::vector<E> zHat(k);
+  parallel::parallelFor(0, k, 2L * k * k, [&](int i0, int i1) {
+    for (int i = i0; i < i1; i++) {
+      E product = -diff.coeff(k - 1, i) / rho;
+      for (int j = 0; j < i; j++)
+        product *= -diff.coeff(j, i) / (d[j] - d[i]);
+      for (int j = i; j < k - 1; j++)
+        product *= -diff.coeff(j, i) / (d[j + 1] - d[i]);
+      const E magnitude = sqrt(std::max(product, E(0)));
+      zHat[i] = z[i] >= E(0) ? magnitude : -magnitude;
+    }
+  });
+  parallel::parallelFor(0, k, 3L * k * k, [&](int j0, int j1) {
+    for (int j = j0; j < j1; j++) {
+      E norm(0);
+      for (int i = 0; i < k; i++) {
+        const E x = zHat[i] / diff.coeff(j, i);
+        u.get(i, j) = x;
+        norm += x * x;
+      }
+      norm = sqrt(norm);
+      for (int i = 0; i < k; i++)
+        u.get(i, j) /= norm;
+    }
+  });
+}
+
+/**
+ * \brief Eigenpairs of blockdiag(q1, q2)*(diag(d) + rho*z*z^T)*
+ * blockdiag(q1, q2)^T, written to d and q.
+ */
+template <typename E>
+void mergeEigen(int n, E *d, std::vector<E> z, E rho, Matrix<E> &q) {
+  using std::abs;
+  using std::hypot;
+  using std::sqrt;
+  const bool negated = rho < E(0);
+  if (negated) {
+    // diag(d) + rho*z*z^T = -(diag(-d) + |rho|*z*z^T)
+    for (int i = 0; i < n; i++)
+      d[i] = -d[i];
+    rho = -rho;
+  }
+  E norm(0);
+  for (E x : z)
+    norm += x * x;
+  norm = sqrt(norm);
+  for (E &x : z)
+    x /= norm;
+  rho *= norm * norm;
+  // sorted copies: ds and the matching columns of q
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int x, int y) { return d[x] < d[y]; });
+  std::vector<E> ds(n), zs(n);
+  Matrix<E> qs(n, n);
+  E largest(0);
+  for (int k = 0; k < n; k++) {
+    ds[k] = d[order[k]];
+    zs[k] = z[order[k]];
+    largest = std::max(largest, abs(ds[k]));
+  }
+  for (int i = 0; i < n; i++)
+    for (int k = 0; k < n; k++)
+      qs.get(i, k) = q.coeff(i, order[k]);
+  const E tol = 8 * std::numeric_limits<E>::epsilon() * std::max(largest, rho);
+  // deflation: negligible components of z, then clustered eigenvalues
+  std::vector<bool> deflated(n, false);
+  int previous = -1;
+  for (int j = 0; j < n; j++) {
+    if (rho * abs(zs[j]) <= tol) {
+      deflated[j] = true;
+      continue;
+    }
+    if (previous >= 0) {
+      const E r = hypot(zs[previous], zs[j]);
+      const E c = zs[j] / r, s = zs[previous] / r;
+      if (abs((ds[j] - ds[previous]) * c * s) <= tol) {
+        // rotate the pair so that the first z component vanishes
+        const E dp = c * c * ds[previous] + s * s * ds[j];
+        const E dj = s * s * ds[previous] + c * c * ds[j];
+        ds[previous] = dp;
+        ds[j] = dj;
+        zs[previous] = E(0);
+        zs[j] = r;
+        for (int i = 0; i < n; i++) {
+          const E x = qs.coeff(i, previous), y = qs.coeff(i, j);
+          qs.get(i, previous) = c * x - s * y;
+          qs.get(i, j) = s * x + c * y;
+        }
+        deflated[previous] = true;
+      }
+    }
+    previous = j;
+  }
+  std::vector<int> kept;
+  for (int j = 0; j < n; j++)
+    if (!deflated[j])
+      kept.push_back(j);
+  const int k = static_cast<int>(kept.size());
+  std::vector<E> values(ds);
+  if (k > 0) {
+    std::vector<E> dk(k), zk(k), lambda(k);
+    E zNorm(0);
+    for (int t = 0; t < k; t++) {
+      dk[t] = ds[kept[t]];
+      zk[t] = zs[kept[t]];
+      zNorm += zk[t] * zk[t];
+    }
+    // deflation removed some weight from z
+    zNorm = sqrt(zNorm);
+    for (E &x : zk)
+      x /= zNorm;
+    Matrix<E> u(k, k);
+    secularEigen(k, dk.data(), zk.data(), rho * zNorm * zNorm, lambda.data(),
+                 u);
+    Matrix<E> qk(n, k);
+    for (int i = 0; i < n; i++)
+      for (int t = 0; t < k; t++)
+        qk.get(i, t) = qs.coeff(i, kept[t]);
+    const Matrix<E> updated = qk * u;
+    for (int t = 0; t < k; t++)
+      values[kept[t]] = lambda[t];
+    for (int i = 0; i < n; i++)
+      for (int t = 0; t < k; t++)
+        qs.get(i, kept[t]) = updated.coeff(i, t);
+  }
+  for (int i = 0; i < n; i++)
+    d[i] = negated ? -values[i] : values[i];
+  q = std::move(qs);
+  sortEigenpairs(n, d, q);
+}
+
+template <typename E>
+void tridiagonalEigen(int n, E *d, E *e, Matrix<E> &q) {
+  if (n <= eigenLeafSize) {
+    q = Matrix<E>(n, n);
+    for (int i = 0; i < n; i++)
+      q.get(i, i) = E(1);
+    tridiagonalQl(n, d, e, &q);
+    sortEigenpairs(n, d, q);
+    return;
+  }
+  // T = blockdiag(T1, T2) + b*v*v^T, v = e_{m-1} + e_m
+  const int m = n / 2;
+  const E b = e[m - 1];
+  d[m - 1] -= b;
+  d[m] -= b;
+  Matrix<E> q1(1, 1), q2(1, 1);
+  if (parallel::shouldParallelize(static_cast<long>(n) * n * n)) {
+    parallel::TaskGroup group(parallel::ThreadPool::shared());
+    const parallel::ExecutionPolicy policy = parallel::currentPolicy();
+    group.run([&, policy] {
+      parallel::ScopedPolicy scope(policy);
+      tridiagonalEigen(n - m, d + m, e + m, q2);
+    });
+    tridiagonalEigen(m, d, e, q1);
+    group.wait();
+  } else {
+    tridiagonalEigen(m, d, e, q1);
+    tridiagonalEigen(n - m, d + m, e + m, q2);
+  }
+  q = Matrix<E>(n, n);
+  std::vector<E> z(n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < m; j++)
+      q.get(i, j) = q1.coeff(i, j);
+    z[i] = q1.coeff(m - 1, i);
+  }
+  for (int i = 0; i < n - m; i++) {
+    for (int j = 0; j < n - m; j++)
+      q.get(m + i, m + j) = q2.coeff(i, j);
+    z[m + i] = q2.coeff(0, i);
+  }
+  mergeEigen(n, d, std::move(z), b, q);
+}
+
+} // namespace detail
+
+template <typename E>
+EigenDecomposition<E> symmetricEigen(const Matrix<E> &a) {
+  if (a.getN() != a.getM())
+    throw std::runtime_error("Eigendecomposition of a non square matrix.");
+  const int n = a.getN();
+  Matrix<E> h(a);
+  std::vector<E> d, e, tau;
+  detail::tridiagonalize(h, d, e, tau);
+  Matrix<E> z(1, 1);
+  detail::tridiagonalEigen(n, d.data(), e.data(), z);
+  return {std::move(d), detail::tridiagonalBasis(h, tau) * z};
+}
+
+template <typename E> std::vector<E> symmetricEigenvalues(const Matrix<E> &a) {
+  if (a.getN() != a.getM())
+    throw std::runtime_error("Eigendecomposition of a non square matrix.");
+  Matrix<E> h(a);
+  std::vector<E> d, e, tau;
+  detail::tridiagonalize(h, d, e, tau);
+  detail::tridiagonalQl<E>(a.getN(), d.data(), e.data(), nullptr);
+  std::sort(d.begin(), d.end());
+  return d;
+}
+
+} // namespace linopt::inmemory
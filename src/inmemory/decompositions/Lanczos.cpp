@@ -0,0 +1 @@
+#include "Lanczos.h"
@@ -0,0 +1,103 @@
+/**
+ * \file Lanczos.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the thick-restart Lanczos eigensolver.
+ * \details
+ *  Computes a few extreme eigenpairs of a symmetric operator known only
+ *  through its products with vectors. A Krylov basis of basisSize vectors
+ *  is built with full reorthogonalization; the Ritz pairs of the projected
+ *  matrix are tested against the tolerance, and if they have not converged
+ *  the basis is restarted from the wanted Ritz vectors (thick restart, Wu
+ *  and Simon) rather than from a single vector, so the converging
+ *  directions are not lost. Memory is basisSize+1 vectors of size n.
+ */
+#ifndef LINOPT_ERC_INMEMORY_DECOMPOSITIONS_LANCZOS_H
+#define LINOPT_ERC_INMEMORY_DECOMPOSITIONS_LANCZOS_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief End of the spectrum \sa lanczos looks for.
+ */
+enum class EigenTarget { largest, smallest, largestMagnitude };
+
+/**
+ * \brief Parameters of \sa lanczos.
+ */
+struct LanczosOptions {
+  EigenTarget target = EigenTarget::largest;
+  /**
+   * \brief Number of basis vectors, 0 for max(2*count + 10, 20).
+   */
+  int basisSize = 0;
+  /**
+   * \brief An eigenpair has converged when ||a*x - theta*x|| is at most
+   * tolerance times the largest Ritz value magnitude.
+   */
+  double tolerance = 1e-10;
+  int maxRestarts = 500;
+  /**
+   * \brief Seed of the random starting vector.
+   */
+  std::uint64_t seed = 0;
+};
+
+/**
+ * \brief Eigenpairs found by \sa lanczos.
+ */
+template <typename E> struct LanczosResult {
+  /**
+   * \brief Eigenvalues, most wanted first.
+   */
+  std::vector<E> values;
+  /**
+   * \brief Orthonormal eigenvectors, one per column.
+   */
+  Matrix<E> vectors;
+  bool converged = false;
+  int restarts = 0;
+  /**
+   * \brief Number of operator products.
+   */
+  int products = 0;
+};
+
+/**
+ * \brief count extreme eigenpairs of a symmetric nxn operator.
+ *
+ * Throws a runtime_error unless 1 <= count < n.
+ * \param multiply: callable (x, y) overwriting y with a*x, x and y of n
+ * entries.
+ */
+template <typename E>
+LanczosResult<E>
+lanczos(int n, int count,
+        const std::function<void(const E *, E *)> &multiply,
+        const LanczosOptions &options = {});
+
+/**
+ * \brief \sa lanczos on a dense symmetric matrix.
+ */
+template <typename E>
+LanczosResult<E> lanczos(const Matrix<E> &a, int count,
+                         const LanczosOptions &options = {});
+
+/**
+ * \brief \sa lanczos on a sparse symmetric matrix.
+ */
+template <typename E>
+LanczosResult<E> lanczos(const SparseMatrix<E> &a, int count,
+                         const LanczosOptions &options = {});
+
+} // namespace linopt::inmemory
+
+#include "Lanczos.tpp"
+#endif
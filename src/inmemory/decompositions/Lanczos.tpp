@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "Eigen.h"
+#include "Gemm.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Removes from w (n entries) its components along the rows 0 to
+ * rows-1 of v, twice (classical Gram-Schmidt with reorthogonalization).
+ * \return the components removed, rows entries.
+ */
+template <typename E>
+std::vector<E> orthogonalize(const Matrix<E> &v, int rows, E *w) {
+  const int n = v.getM();
+  std::vector<E> h(rows, E(0)), pass(rows);
+  for (int twice = 0; twice < 2; twice++) {
+    parallel::parallelFor(0, rows, 2L * rows * n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++) {
+        const E *vi = &v.coeff(i, 0);
+        E s(0);
+        for (int c = 0; c < n; c++)
+          s += vi[c] * w[c];
+        pass[i] = s;
+      }
+    });
+    parallel::parallelFor(0, n, 2L * rows * n, [&](int c0, int c1) {
+      for (int i = 0; i < rows; i++) {
+        const E *vi = &v.coeff(i, 0);
+        const E f = pass[i];
+        for (int c = c0; c < c1; c++)
+          w[c] -= f * vi[c];
+      }
+    });
+    for (int i = 0; i < rows; i++)
+      h[i] += pass[i];
+  }
+  return h;
+}
+
+template <typename E> E vectorNorm(int n, const E *w) {
+  using std::sqrt;
+  E s(0);
+  for (int c = 0; c < n; c++)
+    s += w[c] * w[c];
+  return sqrt(s);
+}
+
+} // namespace detail
+
+template <typename E>
+LanczosResult<E>
+lanczos(int n, int count,
+        const std::function<void(const E *, E *)> &multiply,
+        const LanczosOptions &options) {
+  using std::abs;
+  if (count < 1 || count >= n)
+    throw std::runtime_error("Invalid number of eigenpairs.");
+  const int m = std::clamp(options.basisSize > 0
+                               ? options.basisSize
+                               : std::max(2 * count + 10, 20),
+                           count + 1, n);
+  const E eps = std::numeric_limits<E>::epsilon();
+  std::mt19937_64 generator(options.seed);
+  std::normal_distribution<double> normal;
+  auto randomVector = [&](E *w) {
+    for (int c = 0; c < n; c++)
+      w[c] = static_cast<E>(normal(generator));
+  };
+  // basis vectors are the rows of v, row m being the next one
+  Matrix<E> v(m + 1, n), t(m, m);
+  randomVector(&v.get(0, 0));
+  {
+    const E norm = detail::vectorNorm(n, &v.coeff(0, 0));
+    for (int c = 0; c < n; c++)
+      v.get(0, c) /= norm;
+  }
+  LanczosResult<E> result{{}, Matrix<E>(n, count)};
+  int start = 0;
+  for (;;) {
+    E beta(0), scale(0);
+    for (int j = start; j < m; j++) {
+      E *w = &v.get(j + 1, 0);
+      multiply(&v.coeff(j, 0), w);
+      result.products++;
+      // column j of v^T*a*v, exactly: no three term recurrence assumed
+      const std::vector<E> h = detail::orthogonalize(v, j + 1, w);
+      for (int i = 0; i <= j; i++) {
+        t.get(i, j) = t.get(j, i) = h[i];
+        scale = std::max(scale, abs(h[i]));
+      }
+      beta = detail::vectorNorm(n, w);
+      if (beta <= eps * std::max(scale, E(1)) * n) {
+        // invariant subspace: carry on from a random orthogonal direction
+        beta = E(0);
+        if (j + 1 == m)
+          break;
+        randomVector(w);
+        detail::orthogonalize(v, j + 1, w);
+        const E norm = detail::vectorNorm(n, w);
+        for (int c = 0; c < n; c++)
+          w[c] /= norm;
+        continue;
+      }
+      for (int c = 0; c < n; c++)
+        w[c] /= beta;
+    }
+    const EigenDecomposition<E> ritz = symmetricEigen(t);
+    std::vector<int> order(m);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int x, int y) {
+      switch (options.target) {
+      case EigenTarget::largest:
+        return ritz.values[x] > ritz.values[y];
+      case EigenTarget::smallest:
+        return ritz.values[x] < ritz.values[y];
+      default:
+        return abs(ritz.values[x]) > abs(ritz.values[y]);
+      }
+    });
+    E largest(0);
+    for (E theta : ritz.values)
+      largest = std::max(largest, abs(theta));
+    bool converged = true;
+    for (int k = 0; k < count; k++)
+      if (abs(beta * ritz.vectors.coeff(m - 1, order[k])) >
+          E(options.tolerance) * std::max(largest, eps))
+        converged = false;
+    const bool last = converged || result.restarts == options.maxRestarts;
+    // the kept Ritz vectors: y^T*v, on the gemm kernel
+    const int kept =
+        last ? count : std::min(m - 1, count + (m - count) / 2);
+    Matrix<E> yt(kept, m);
+    for (int k = 0; k < kept; k++)
+      for (int i = 0; i < m; i++)
+        yt.get(k, i) = ritz.vectors.coeff(i, order[k]);
+    Matrix<E> x(kept, n);
+    kernels::parallelGemm(kept, n, m, yt.data(), yt.stride(), v.data(),
+                          v.stride(), x.data(), x.stride(),
+                          kernels::GemmUpdate::overwrite);
+    if (last) {
+      result.converged = converged;
+      for (int k = 0; k < count; k++)
+        result.values.push_back(ritz.values[order[k]]);
+      result.vectors = x.transpose();
+      return result;
+    }
+    // restart: v = [ritz vectors, residual direction], t = diag(theta)
+    std::copy(&v.coeff(m, 0), &v.coeff(m, 0) + n, &v.get(kept, 0));
+    for (int k = 0; k < kept; k++)
+      std::copy(&x.coeff(k, 0), &x.coeff(k, 0) + n, &v.get(k, 0));
+    t = Matrix<E>(m, m);
+    for (int k = 0; k < kept; k++)
+      t.get(k, k) = ritz.values[order[k]];
+    start = kept;
+    result.restarts++;
+  }
+}
+
+template <typename E>
+LanczosResult<E> lanczos(const Matrix<E> &a, int count,
+                         const LanczosOptions &options) {
+  if (a.getN() != a.getM())
+    throw std::runtime_error("Eigendecomposition of a non square matrix.");
+  const int n = a.getN();
+  return lanczos<E>(
+      n, count,
+      [&a, n](const E *x, E *y) {
+        parallel::parallelFor(0, n, 2L * n * n, [&](int i0, int i1) {
+          for (int i = i0; i < i1; i++) {
+            const E *row = &a.coeff(i, 0);
+            E s(0);
+            for (int j = 0; j < n; j++)
+              s += row[j] * x[j];
+            y[i] = s;
+          }
+        });
+      },
+      options);
+}
+
+template <typename E>
+LanczosResult<E> lanczos(const SparseMatrix<E> &a, int count,
+                         const LanczosOptions &options) {
+  if (a.getN() != a.getM())
+    throw std::runtime_error("Eigendecomposition of a non square matrix.");
+  return lanczos<E>(
+      a.getN(), count, [&a](const E *x, E *y) { a.multiply(x, y); },
+      options);
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1 @@
+#include "Sketch.h"
@@ -0,0 +1,115 @@
+/**
+ * \file Sketch.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the random sketching operators.
+ * \details
+ *  A sketch is a random dxk matrix Omega (k much smaller than d) that
+ *  roughly preserves norms: a*Omega compresses the d columns of a into k,
+ *  Omega^T*a compresses its d rows. Three kinds are provided:
+ *  - gaussian: independent N(0, 1/k) entries, dense;
+ *  - sparseSign: sparsity entries +-1/sqrt(sparsity) per row, at random
+ *    columns, applied in O(sparsity) per input entry;
+ *  - srht: subsampled randomized Hadamard transform, random signs then a
+ *    fast Walsh-Hadamard transform then k sampled coordinates, applied in
+ *    O(d log d) per row without storing Omega.
+ *
+ *  \sa applyRows applies the sketch to a block of rows, so that the
+ *  sketch of a matrix too large for memory is computed a block at a time.
+ */
+#ifndef LINOPT_ERC_INMEMORY_DECOMPOSITIONS_SKETCH_H
+#define LINOPT_ERC_INMEMORY_DECOMPOSITIONS_SKETCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Kinds of \sa Sketch.
+ */
+enum class SketchKind { gaussian, sparseSign, srht };
+
+/**
+ * \brief A random dxk sketching matrix Omega.
+ */
+template <typename E> class Sketch {
+private:
+  SketchKind sketchKind;
+  int d, k;
+  /**
+   * \brief Omega, gaussian sketches only.
+   */
+  std::vector<E> dense;
+  /**
+   * \brief Column and sign of each nonzero, sparsity per row of Omega
+   * (sparse sign), or sampled coordinates and signs of the rows (srht).
+   */
+  std::vector<int> columns;
+  std::vector<E> signs;
+  int sparsity;
+  /**
+   * \brief Power of two at least d, srht only.
+   */
+  int padded = 1;
+
+public:
+  /**
+   * \brief Draws a sketch.
+   *
+   * Throws a runtime_error unless 1 <= k and 1 <= d.
+   * \param kind: distribution of the sketch.
+   * \param inputDimension: d.
+   * \param sketchDimension: k.
+   * \param seed: seed of the random generator, same seed same sketch.
+   * \param sparsity: nonzeros per row of sparse sign sketches.
+   */
+  Sketch(SketchKind kind, int inputDimension, int sketchDimension,
+         std::uint64_t seed = 0, int sparsity = 8);
+
+  SketchKind kind() const;
+  int inputDimension() const;
+  int sketchDimension() const;
+
+  /**
+   * \brief out = rows*Omega for count rows of d entries.
+   * \param rows: first row, rows being stride entries apart.
+   * \param out: first row of the result, rows being ldo entries apart.
+   */
+  void applyRows(const E *rows, int count, int stride, E *out,
+                 int ldo) const;
+
+  /**
+   * \brief Computes a*Omega, a with d columns.
+   */
+  Matrix<E> applyRight(const Matrix<E> &a) const;
+
+  /**
+   * \brief Computes Omega^T*a, a with d rows.
+   */
+  Matrix<E> applyLeft(const Matrix<E> &a) const;
+
+  /**
+   * \brief Omega, as a dense dxk matrix.
+   */
+  Matrix<E> toMatrix() const;
+};
+
+namespace detail {
+
+/**
+ * \brief In place unnormalized fast Walsh-Hadamard transform of n entries,
+ * n a power of two.
+ *
+ * Each entry is a row of width contiguous values, transformed together.
+ */
+template <typename E> void walshHadamard(E *x, int n, int width = 1);
+
+} // namespace detail
+
+} // namespace linopt::inmemory
+
+#include "Sketch.tpp"
+#endif
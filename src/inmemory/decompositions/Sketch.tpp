@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "Gemm.h"
+#include "Parallel.h"
+#include "Transpose.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+template <typename E> void walshHadamard(E *x, int n, int width) {
+  for (int h = 1; h < n; h *= 2)
+    for (int i = 0; i < n; i += 2 * h)
+      for (int j = i; j < i + h; j++) {
+        E *u = x + static_cast<std::size_t>(j) * width;
+        E *v = u + static_cast<std::size_t>(h) * width;
+        for (int c = 0; c < width; c++) {
+          const E s = u[c], t = v[c];
+          u[c] = s + t;
+          v[c] = s - t;
+        }
+      }
+}
+
+} // namespace detail
+
+template <typename E>
+Sketch<E>::Sketch(SketchKind kind, int inputDimension, int sketchDimension,
+                  std::uint64_t seed, int sparsity)
+    : sketchKind(kind), d(inputDimension), k(sketchDimension),
+      sparsity(std::clamp(sparsity, 1, std::max(1, sketchDimension))) {
+  using std::sqrt;
+  if (d < 1 || k < 1)
+    throw std::runtime_error("Invalid sketch dimension (<1).");
+  std::mt19937_64 generator(seed);
+  std::bernoulli_distribution coin;
+  const E scale = E(1) / sqrt(E(k));
+  switch (kind) {
+  case SketchKind::gaussian: {
+    std::normal_distribution<double> normal;
+    dense.resize(static_cast<std::size_t>(d) * k);
+    for (E &x : dense)
+      x = static_cast<E>(normal(generator)) * scale;
+    break;
+  }
+  case SketchKind::sparseSign: {
+    // sparsity distinct columns per row
+    const E value = E(1) / sqrt(E(this->sparsity));
+    std::vector<int> pool(k);
+    std::iota(pool.begin(), pool.end(), 0);
+    for (int r = 0; r < d; r++) {
+      for (int t = 0; t < this->sparsity; t++) {
+        std::uniform_int_distribution<int> pick(t, k - 1);
+        std::swap(pool[t], pool[pick(generator)]);
+        columns.push_back(pool[t]);
+        signs.push_back(coin(generator) ? value : -value);
+      }
+    }
+    break;
+  }
+  case SketchKind::srht: {
+    while (padded < d)
+      padded *= 2;
+    if (k > padded)
+      throw std::runtime_error("Sketch dimension above the padded input.");
+    for (int r = 0; r < d; r++)
+      signs.push_back(coin(generator) ? E(1) : E(-1));
+    std::vector<int> pool(padded);
+    std::iota(pool.begin(), pool.end(), 0);
+    for (int t = 0; t < k; t++) {
+      std::uniform_int_distribution<int> pick(t, padded - 1);
+      std::swap(pool[t], pool[pick(generator)]);
+    }
+    columns.assign(pool.begin(), pool.begin() + k);
+    break;
+  }
+  }
+}
+
+template <typename E> SketchKind Sketch<E>::kind() const { return sketchKind; }
+
+template <typename E> int Sketch<E>::inputDimension() const { return d; }
+
+template <typename E> int Sketch<E>::sketchDimension() const { return k; }
+
+template <typename E>
+void Sketch<E>::applyRows(const E *rows, int count, int stride, E *out,
+                          int ldo) const {
+  switch (sketchKind) {
+  case SketchKind::gaussian:
+    kernels::parallelGemm(count, k, d, rows, stride, dense.data(), k, out, ldo,
+                          kernels::GemmUpdate::overwrite);
+    return;
+  case SketchKind::sparseSign:
+    parallel::parallelFor(
+        0, count, static_cast<long>(count) * d * sparsity, [&](int i0, int i1) {
+          for (int i = i0; i < i1; i++) {
+            const E *row = rows + static_cast<std::size_t>(i) * stride;
+            E *o = out + static_cast<std::size_t>(i) * ldo;
+            std::fill(o, o + k, E(0));
+            for (int j = 0; j < d; j++) {
+              const E x = row[j];
+              for (int t = 0; t < sparsity; t++)
+                o[columns[j * sparsity + t]] += signs[j * sparsity + t] * x;
+            }
+          }
+        });
+    return;
+  case SketchKind::srht: {
+    using std::sqrt;
+    // H/sqrt(padded) is orthogonal: sqrt(padded/k) keeps norms on average
+    const E scale = E(1) / sqrt(E(k));
+    const long work = static_cast<long>(count) * padded *
+                      std::max(1, static_cast<int>(std::log2(padded)));
+    parallel::parallelFor(0, count, work, [&](int i0, int i1) {
+      std::vector<E> buffer(padded);
+      for (int i = i0; i < i1; i++) {
+        const E *row = rows + static_cast<std::size_t>(i) * stride;
+        for (int j = 0; j < d; j++)
+          buffer[j] = signs[j] * row[j];
+        std::fill(buffer.begin() + d, buffer.end(), E(0));
+        detail::walshHadamard(buffer.data(), padded);
+        E *o = out + static_cast<std::size_t>(i) * ldo;
+        for (int t = 0; t < k; t++)
+          o[t] = scale * buffer[columns[t]];
+      }
+    });
+    return;
+  }
+  }
+}
+
+template <typename E>
+Matrix<E> Sketch<E>::applyRight(const Matrix<E> &a) const {
+  if (a.getM() != d)
+    throw std::runtime_error("Invalid dimensions for sketch.");
+  Matrix<E> r(a.getN(), k);
+  applyRows(a.data(), a.getN(), a.stride(), r.data(), r.stride());
+  return r;
+}
+
+template <typename E>
+Matrix<E> Sketch<E>::applyLeft(const Matrix<E> &a) const {
+  if (a.getN() != d)
+    throw std::runtime_error("Invalid dimensions for sketch.");
+  const int m = a.getM();
+  const std::size_t lda = a.stride();
+  Matrix<E> r(k, m);
+  const std::size_t ldr = r.stride();
+  // columns of a are independent: strips of them never share a cache line
+  const int strip = std::max(1, static_cast<int>(cacheLineSize / sizeof(E)));
+  const int strips = (m + strip - 1) / strip;
+  switch (sketchKind) {
+  case SketchKind::gaussian: {
+    // Omega^T is only k x d
+    std::vector<E> omegaT(static_cast<std::size_t>(k) * d);
+    kernels::transpose(d, k, dense.data(), k, omegaT.data(), d);
+    kernels::parallelGemm(k, m, d, omegaT.data(), d, a.data(),
+                          static_cast<int>(lda), r.data(),
+                          static_cast<int>(ldr),
+                          kernels::GemmUpdate::overwrite);
+    break;
+  }
+  case SketchKind::sparseSign:
+    // row j of a is added to the sparsity rows of r picked by row j of Omega
+    parallel::parallelFor(
+        0, strips, static_cast<long>(m) * d * sparsity, [&](int s0, int s1) {
+          const int c0 = s0 * strip, c1 = std::min(m, s1 * strip);
+          for (int j = 0; j < d; j++) {
+            const E *row = a.data() + j * lda;
+            for (int t = 0; t < sparsity; t++) {
+              const E sign = signs[j * sparsity + t];
+              E *o = r.data() + columns[j * sparsity + t] * ldr;
+              for (int c = c0; c < c1; c++)
+                o[c] += sign * row[c];
+            }
+          }
+        });
+    break;
+  case SketchKind::srht: {
+    using std::sqrt;
+    // the transform of a strip of columns at once, butterflies on its rows
+    const E scale = E(1) / sqrt(E(k));
+    const long work = static_cast<long>(m) * padded *
+                      std::max(1, static_cast<int>(std::log2(padded)));
+    parallel::parallelFor(0, strips, work, [&](int s0, int s1) {
+      std::vector<E> buffer(static_cast<std::size_t>(padded) * strip);
+      for (int s = s0; s < s1; s++) {
+        const int c0 = s * strip, width = std::min(m, c0 + strip) - c0;
+        for (int j = 0; j < d; j++) {
+          const E *row = a.data() + j * lda + c0;
+          E *b = buffer.data() + static_cast<std::size_t>(j) * width;
+          for (int c = 0; c < width; c++)
+            b[c] = signs[j] * row[c];
+        }
+        std::fill(buffer.begin() + static_cast<std::size_t>(d) * width,
+                  buffer.begin() + static_cast<std::size_t>(padded) * width,
+                  E(0));
+        detail::walshHadamard(buffer.data(), padded, width);
+        for (int t = 0; t < k; t++) {
+          const E *b =
+              buffer.data() + static_cast<std::size_t>(columns[t]) * width;
+          E *o = r.data() + t * ldr + c0;
+          for (int c = 0; c < width; c++)
+            o[c] = scale * b[c];
+        }
+      }
+    });
+    break;
+  }
+  }
+  return r;
+}
+
+template <typename E> Matrix<E> Sketch<E>::toMatrix() const {
+  Matrix<E> identity(d, d);
+  for (int i = 0; i < d; i++)
+    identity.get(i, i) = E(1);
+  return applyRight(identity);
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1 @@
+#include "Svd.h"
@@ -0,0 +1,102 @@
+/**
+ * \file Svd.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the singular value decompositions.
+ * \details
+ *  \sa svd computes the thin decomposition of a matrix held in memory by
+ *  one-sided Jacobi rotations. \sa randomizedSvd computes a truncated
+ *  decomposition from a few passes over the rows of the matrix: a sketch
+ *  a*Omega spans about the same range as the leading singular vectors,
+ *  power iterations (a*a^T)^q sharpen it, and the small projection Q^T*a on
+ *  its orthonormal basis Q is decomposed exactly.
+ *
+ *  The randomized functions take any row source: a \sa Matrix, or a matrix
+ *  too large for memory offering getN(), getM(), stride(), a contiguous
+ *  coeff(r, c) and sweepRows(height, body(r0, r1)) like a
+ *  \sa linopt::disk::DiskMatrix. Each pass then reads the rows once, a
+ *  block of blockRows rows at a time.
+ */
+#ifndef LINOPT_ERC_INMEMORY_DECOMPOSITIONS_SVD_H
+#define LINOPT_ERC_INMEMORY_DECOMPOSITIONS_SVD_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+#include "Sketch.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief A (thin or truncated) decomposition a ~ u*diag(s)*v^T.
+ */
+template <typename E> struct Svd {
+  /**
+   * \brief Left singular vectors, one per column.
+   */
+  Matrix<E> u;
+  /**
+   * \brief Singular values, in decreasing order.
+   */
+  std::vector<E> s;
+  /**
+   * \brief Right singular vectors, one per column.
+   */
+  Matrix<E> v;
+};
+
+/**
+ * \brief Parameters of \sa randomizedSvd and \sa rangeFinder.
+ */
+struct RandomizedSvdOptions {
+  /**
+   * \brief Extra sketch columns beyond the rank.
+   */
+  int oversampling = 10;
+  /**
+   * \brief Number of power iterations, each two more passes over a.
+   */
+  int powerIterations = 2;
+  /**
+   * \brief Distribution of the sketch.
+   */
+  SketchKind sketch = SketchKind::gaussian;
+  std::uint64_t seed = 0;
+  /**
+   * \brief Rows of a read at a time.
+   */
+  int blockRows = 1024;
+};
+
+/**
+ * \brief Thin singular value decomposition of an mxn matrix.
+ *
+ * u is m x min(m,n), v is n x min(m,n).
+ */
+template <typename E> Svd<E> svd(const Matrix<E> &a);
+
+/**
+ * \brief An orthonormal basis Q (m x size) approximately spanning the
+ * leading left singular vectors of a.
+ */
+template <typename Source>
+Matrix<typename Source::value_type>
+rangeFinder(const Source &a, int size,
+            const RandomizedSvdOptions &options = {});
+
+/**
+ * \brief Truncated singular value decomposition of rank rank.
+ *
+ * Reads a in 2 + 2*powerIterations passes.
+ * Throws a runtime_error unless 1 <= rank <= min(m,n).
+ */
+template <typename Source>
+Svd<typename Source::value_type>
+randomizedSvd(const Source &a, int rank,
+              const RandomizedSvdOptions &options = {});
+
+} // namespace linopt::inmemory
+
+#include "Svd.tpp"
+#endif
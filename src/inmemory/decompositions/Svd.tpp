@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "Gemm.h"
+#include "Parallel.h"
+#include "Qr.h"
+#include "Transpose.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Orthogonalizes the rows of w (count rows of length, ld apart) by
+ * one-sided Jacobi rotations, applying them to the rows of vt too.
+ *
+ * Pairs are visited in round-robin order: the count/2 rotations of a round
+ * touch distinct rows and run in parallel.
+ */
+template <typename E>
+void jacobiRotations(int count, int length, E *w, std::size_t ld, E *vt,
+                     std::size_t ldv) {
+  using std::abs;
+  using std::sqrt;
+  const E eps = std::numeric_limits<E>::epsilon();
+  const int players = count + count % 2;
+  std::vector<int> order(players);
+  std::iota(order.begin(), order.end(), 0);
+  for (int sweep = 0; sweep < 60; sweep++) {
+    std::atomic<bool> rotated = false;
+    for (int round = 0; round < players - 1; round++) {
+      parallel::parallelFor(
+          0, players / 2, static_cast<long>(players) * (length + count),
+          [&](int k0, int k1) {
+            for (int k = k0; k < k1; k++) {
+              int p = order[k], q = order[players - 1 - k];
+              if (p >= count || q >= count)
+                continue; // bye
+              if (p > q)
+                std::swap(p, q);
+              E *wp = w + p * ld, *wq = w + q * ld;
+              E alpha(0), beta(0), gamma(0);
+              for (int i = 0; i < length; i++) {
+                alpha += wp[i] * wp[i];
+                beta += wq[i] * wq[i];
+                gamma += wp[i] * wq[i];
+              }
+              if (gamma == E(0) || abs(gamma) <= eps * sqrt(alpha * beta))
+                continue;
+              rotated = true;
+              const E zeta = (beta - alpha) / (2 * gamma);
+              const E t = (zeta >= E(0) ? E(1) : E(-1)) /
+                          (abs(zeta) + sqrt(E(1) + zeta * zeta));
+              const E c = E(1) / sqrt(E(1) + t * t), s = c * t;
+              for (int i = 0; i < length; i++) {
+                const E x = wp[i], y = wq[i];
+                wp[i] = c * x - s * y;
+                wq[i] = s * x + c * y;
+              }
+              E *vp = vt + p * ldv, *vq = vt + q * ldv;
+              for (int i = 0; i < count; i++) {
+                const E x = vp[i], y = vq[i];
+                vp[i] = c * x - s * y;
+                vq[i] = s * x + c * y;
+              }
+            }
+          });
+      // circle method: the first player stays, the others rotate
+      std::rotate(order.begin() + 1, order.end() - 1, order.end());
+    }
+    if (!rotated)
+      break;
+  }
+}
+
+/**
+ * \brief Runs body(r0, r1, rows, stride) over blocks of rows of a.
+ */
+template <typename Source, typename F>
+void forRowBlocks(const Source &a, int height, F &&body) {
+  height = std::max(height, 1);
+  if constexpr (requires { a.sweepRows(height, [](int, int) {}); }) {
+    a.sweepRows(height, [&](int r0, int r1) {
+      body(r0, r1, &a.coeff(r0, 0), a.stride());
+    });
+  } else {
+    for (int r0 = 0; r0 < a.getN(); r0 += height) {
+      const int r1 = std::min(a.getN(), r0 + height);
+      body(r0, r1, &a.coeff(r0, 0), a.stride());
+    }
+  }
+}
+
+/**
+ * \brief y = a*z, one pass over the rows of a.
+ */
+template <typename Source, typename E>
+void multiplyRows(const Source &a, const Matrix<E> &z, Matrix<E> &y,
+                  int height) {
+  forRowBlocks(a, height, [&](int r0, int r1, const E *rows, int stride) {
+    kernels::parallelGemm(r1 - r0, z.getM(), a.getM(), rows, stride, z.data(),
+                          z.stride(), &y.get(r0, 0), y.stride(),
+                          kernels::GemmUpdate::overwrite);
+  });
+}
+
+/**
+ * \brief q^T*a, one pass over the rows of a.
+ */
+template <typename Source, typename E>
+Matrix<E> projectRows(const Source &a, const Matrix<E> &q, int height) {
+  const int l = q.getM();
+  Matrix<E> r(l, a.getM());
+  std::vector<E> qt;
+  forRowBlocks(a, height, [&](int r0, int r1, const E *rows, int stride) {
+    const int h = r1 - r0;
+    qt.resize(static_cast<std::size_t>(l) * h);
+    kernels::transpose(h, l, &q.coeff(r0, 0), q.stride(), qt.data(), h);
+    kernels::parallelGemm(l, a.getM(), h, qt.data(), h, rows, stride,
+                          r.data(), r.stride(),
+                          kernels::GemmUpdate::accumulate);
+  });
+  return r;
+}
+
+template <typename E> Matrix<E> orthonormalBasis(Matrix<E> &&y) {
+  return QrFactorization<E>(std::move(y)).thinQ();
+}
+
+template <typename E>
+Matrix<E> leadingColumns(const Matrix<E> &a, int count) {
+  Matrix<E> r(a.getN(), count);
+  for (int i = 0; i < a.getN(); i++)
+    std::copy(&a.coeff(i, 0), &a.coeff(i, 0) + count, &r.get(i, 0));
+  return r;
+}
+
+} // namespace detail
+
+template <typename E> Svd<E> svd(const Matrix<E> &a) {
+  using std::sqrt;
+  const int m = a.getN(), n = a.getM();
+  if (m < n) {
+    Svd<E> t = svd(a.transpose());
+    return {std::move(t.v), std::move(t.s), std::move(t.u)};
+  }
+  // the columns of a, as the rows of w, are rotated until orthogonal
+  Matrix<E> w = a.transpose();
+  Matrix<E> vt(n, n);
+  for (int i = 0; i < n; i++)
+    vt.get(i, i) = E(1);
+  detail::jacobiRotations(n, m, w.data(), w.stride(), vt.data(), vt.stride());
+  std::vector<E> norms(n);
+  for (int i = 0; i < n; i++) {
+    E s(0);
+    for (int j = 0; j < m; j++)
+      s += w.coeff(i, j) * w.coeff(i, j);
+    norms[i] = sqrt(s);
+  }
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int x, int y) { return norms[x] > norms[y]; });
+  Svd<E> r{Matrix<E>(m, n), std::vector<E>(n), Matrix<E>(n, n)};
+  for (int k = 0; k < n; k++) {
+    const int i = order[k];
+    r.s[k] = norms[i];
+    const E inverse = norms[i] > E(0) ? E(1) / norms[i] : E(0);
+    for (int j = 0; j < m; j++)
+      r.u.get(j, k) = w.coeff(i, j) * inverse;
+    for (int j = 0; j < n; j++)
+      r.v.get(j, k) = vt.coeff(i, j);
+  }
+  return r;
+}
+
+template <typename Source>
+Matrix<typename Source::value_type>
+rangeFinder(const Source &a, int size, const RandomizedSvdOptions &options) {
+  typedef typename Source::value_type E;
+  const int m = a.getN(), n = a.getM();
+  if (size < 1 || size > std::min(m, n))
+    throw std::runtime_error("Invalid range finder size.");
+  const Sketch<E> sketch(options.sketch, n, size, options.seed);
+  Matrix<E> y(m, size);
+  detail::forRowBlocks(a, options.blockRows,
+                       [&](int r0, int r1, const E *rows, int stride) {
+                         sketch.applyRows(rows, r1 - r0, stride, &y.get(r0, 0),
+                                          y.stride());
+                       });
+  Matrix<E> q = detail::orthonormalBasis(std::move(y));
+  for (int i = 0; i < options.powerIterations; i++) {
+    // re-orthonormalized at each half step, not to lose the small directions
+    Matrix<E> z = detail::orthonormalBasis(
+        detail::projectRows(a, q, options.blockRows).transpose());
+    Matrix<E> ya(m, size);
+    detail::multiplyRows(a, z, ya, options.blockRows);
+    q = detail::orthonormalBasis(std::move(ya));
+  }
+  return q;
+}
+
+template <typename Source>
+Svd<typename Source::value_type>
+randomizedSvd(const Source &a, int rank, const RandomizedSvdOptions &options) {
+  typedef typename Source::value_type E;
+  const int m = a.getN(), n = a.getM();
+  if (rank < 1 || rank > std::min(m, n))
+    throw std::runtime_error("Invalid rank for truncated svd.");
+  const int size = std::min(std::min(m, n), rank + options.oversampling);
+  const Matrix<E> q = rangeFinder(a, size, options);
+  // a ~ q*(q^T*a), and q^T*a is small
+  Svd<E> b = svd(detail::projectRows(a, q, options.blockRows));
+  const Matrix<E> u = q * detail::leadingColumns(b.u, rank);
+  b.s.resize(rank);
+  return {u, std::move(b.s), detail::leadingColumns(b.v, rank)};
+}
+
+} // namespace linopt::inmemory
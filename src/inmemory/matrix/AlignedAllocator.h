@@ -0,0 +1,108 @@
+/**
+ * \file AlignedAllocator.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::inmemory::AlignedAllocator<T, A> allocator.
+ * \details
+ *  Standard-conforming allocator returning storage aligned on an A byte
+ *  boundary. It backs the contiguous buffer of \sa linopt::inmemory::Matrix<E>
+ *  so that every (padded) row starts on a cache line.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_ALIGNEDALLOCATOR_H
+#define LINOPT_ERC_INMEMORY_MATRIX_ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "Metrics.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Size in bytes of a cache line, also the alignment of matrix rows.
+ */
+inline constexpr std::size_t cacheLineSize = 64;
+
+/**
+ * \brief Smallest row stride (in elements) that is >= m and keeps every
+ * row of a row-major buffer of T aligned on an A byte boundary.
+ * \param m: the number of logical entries in a row.
+ * \return the padded row length, in elements.
+ */
+template <typename T, std::size_t A = cacheLineSize>
+constexpr std::size_t paddedStride(std::size_t m) {
+  const std::size_t quantum = A / std::gcd(A, sizeof(T));
+  return (m + quantum - 1) / quantum * quantum;
+}
+
+/**
+ * \brief Allocator handing out A-byte aligned blocks of T.
+ *
+ * Stateless: all instances compare equal. Value-less construction
+ * default-initializes, so that resizing a buffer of arithmetic entries
+ * does not write to it.
+ */
+template <typename T, std::size_t A = cacheLineSize> class AlignedAllocator {
+  static_assert((A & (A - 1)) == 0, "Alignment must be a power of two.");
+
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = AlignedAllocator<U, A>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, A> &) noexcept {}
+
+  /**
+   * \brief Allocates uninitialized storage for n objects of type T.
+   * \param n: the number of objects.
+   * \return pointer to the first object, aligned on A bytes.
+   */
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    T *p = static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(A)));
+    LINOPT_METRICS_ALLOCATE(n * sizeof(T));
+    return p;
+  }
+
+  /**
+   * \brief Releases storage obtained from allocate.
+   */
+  void deallocate(T *p, [[maybe_unused]] std::size_t n) noexcept {
+    LINOPT_METRICS_DEALLOCATE(n * sizeof(T));
+    ::operator delete(p, std::align_val_t(A));
+  }
+
+  /**
+   * \brief Default-initializes *p (no-op for trivial types).
+   */
+  template <typename U>
+  void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(p)) U;
+  }
+
+  /**
+   * \brief Constructs *p from args.
+   */
+  template <typename U, typename... Args>
+  void construct(U *p, Args &&...args) {
+    ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, A> &) const noexcept {
+    return true;
+  }
+};
+
+} // namespace linopt::inmemory
+#endif
@@ -0,0 +1,95 @@
+#include "Gemm.h"
+
+#include <atomic>
+
+namespace linopt::inmemory::kernels {
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINOPT_GEMM_X86 1
+#endif
+
+Isa detectedIsa() {
+  static const Isa isa = [] {
+#ifdef LINOPT_GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+      return Isa::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      return Isa::avx2;
+#endif
+    return Isa::scalar;
+  }();
+  return isa;
+}
+
+namespace {
+std::atomic<Isa> &activeIsaSlot() {
+  static std::atomic<Isa> isa{detectedIsa()};
+  return isa;
+}
+} // namespace
+
+Isa activeIsa() { return activeIsaSlot().load(std::memory_order_relaxed); }
+
+void setActiveIsa(Isa isa) {
+  if (static_cast<int>(isa) > static_cast<int>(detectedIsa()))
+    isa = detectedIsa();
+  activeIsaSlot().store(isa, std::memory_order_relaxed);
+}
+
+// One precompiled driver per element type and instruction set. The register
+// tile is 6 rows by two vector registers: 12 accumulators, leaving room for
+// the broadcast A entries and the B sliver in the 16 (AVX2) or 32 (AVX-512)
+// vector registers.
+#ifdef LINOPT_GEMM_X86
+#define LINOPT_GEMM_VARIANTS(T, NR_AVX2, NR_AVX512)                            \
+  namespace {                                                                  \
+  void gemmScalar(int m, int n, int k, const T *a, int lda, const T *b,        \
+                  int ldb, T *c, int ldc, GemmUpdate update) {                 \
+    detail::gemmBlocked<T, 4, 2 * 16 / sizeof(T), 16>(m, n, k, a, lda, b, ldb, \
+                                                      c, ldc, update);         \
+  }                                                                            \
+  [[gnu::target("avx2,fma"), gnu::flatten]] void                               \
+  gemmAvx2(int m, int n, int k, const T *a, int lda, const T *b, int ldb,      \
+           T *c, int ldc, GemmUpdate update) {                                 \
+    detail::gemmBlocked<T, 6, NR_AVX2, 32>(m, n, k, a, lda, b, ldb, c, ldc,    \
+                                           update);                            \
+  }                                                                            \
+  [[gnu::target("avx512f,avx512dq,fma"), gnu::flatten]] void                   \
+  gemmAvx512(int m, int n, int k, const T *a, int lda, const T *b, int ldb,    \
+             T *c, int ldc, GemmUpdate update) {                               \
+    detail::gemmBlocked<T, 6, NR_AVX512, 64>(m, n, k, a, lda, b, ldb, c,       \
+                                             ldc, update);                     \
+  }                                                                            \
+  }                                                                            \
+  template <>                                                                  \
+  void gemm<T>(int m, int n, int k, const T *a, int lda, const T *b, int ldb,  \
+               T *c, int ldc, GemmUpdate update) {                             \
+    switch (activeIsa()) {                                                     \
+    case Isa::avx512:                                                          \
+      gemmAvx512(m, n, k, a, lda, b, ldb, c, ldc, update);                     \
+      break;                                                                   \
+    case Isa::avx2:                                                            \
+      gemmAvx2(m, n, k, a, lda, b, ldb, c, ldc, update);                       \
+      break;                                                                   \
+    default:                                                                   \
+      gemmScalar(m, n, k, a, lda, b, ldb, c, ldc, update);                     \
+    }                                                                          \
+  }
+#else
+#define LINOPT_GEMM_VARIANTS(T, NR_AVX2, NR_AVX512)                            \
+  template <>                                                                  \
+  void gemm<T>(int m, int n, int k, const T *a, int lda, const T *b, int ldb,  \
+               T *c, int ldc, GemmUpdate update) {                             \
+    detail::gemmBlocked<T, 4, 4>(m, n, k, a, lda, b, ldb, c, ldc, update);     \
+  }
+#endif
+
+// the per-type helpers are overloads of one another (they differ by T)
+LINOPT_GEMM_VARIANTS(float, 16, 32)
+LINOPT_GEMM_VARIANTS(double, 8, 16)
+LINOPT_GEMM_VARIANTS(int, 16, 32)
+LINOPT_GEMM_VARIANTS(long, 8, 16)
+LINOPT_GEMM_VARIANTS(long long, 8, 16)
+
+} // namespace linopt::inmemory::kernels
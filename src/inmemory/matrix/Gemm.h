@@ -0,0 +1,112 @@
+/**
+ * \file Gemm.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the general matrix multiplication kernels.
+ * \details
+ *  The kernels work on raw row-major buffers (pointer + row stride), the
+ *  layout exposed by \sa linopt::inmemory::Matrix<E>::data() and
+ *  \sa linopt::inmemory::Matrix<E>::stride(). They pack panels of the
+ *  operands into contiguous, cache-sized blocks and run a register-tiled
+ *  micro-kernel on them. float, double and the 32/64-bit signed integer
+ *  types use precompiled micro-kernels selected at runtime for the best
+ *  instruction set of the host (AVX-512, AVX2 or plain scalar code);
+ *  any other E goes through the generic, portable template.
+ *  \sa linopt::inmemory::kernels::parallelGemm splits the product into 2D
+ *  tiles of C run on the shared thread pool when the execution policy
+ *  allows it.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_GEMM_H
+#define LINOPT_ERC_INMEMORY_MATRIX_GEMM_H
+
+namespace linopt::inmemory::kernels {
+
+/**
+ * \brief How the product is merged into the destination block C.
+ */
+enum class GemmUpdate {
+  overwrite,  ///< C = A*B
+  accumulate, ///< C = C + A*B
+  subtract    ///< C = C - A*B
+};
+
+/**
+ * \brief Instruction sets the precompiled micro-kernels are built for.
+ */
+enum class Isa { scalar, avx2, avx512 };
+
+/**
+ * \brief The best instruction set supported by the host cpu.
+ * \return the detected instruction set, computed once.
+ */
+Isa detectedIsa();
+
+/**
+ * \brief The instruction set currently used by the precompiled kernels.
+ * \return the active instruction set, \sa detectedIsa() unless overridden.
+ */
+Isa activeIsa();
+
+/**
+ * \brief Overrides the instruction set used by the precompiled kernels.
+ *
+ * Mostly useful to test or benchmark the slower paths. Requests for an
+ * instruction set the host does not support are clamped to \sa detectedIsa().
+ * \param isa: the instruction set to use from now on.
+ */
+void setActiveIsa(Isa isa);
+
+/**
+ * \brief Computes the m x n block C (update) A*B, where A is m x k and B is k x n.
+ *
+ * All blocks are row-major. C must not overlap A or B.
+ * \param m: number of rows of A and C.
+ * \param n: number of columns of B and C.
+ * \param k: number of columns of A, rows of B.
+ * \param a: pointer to entry (0,0) of A.
+ * \param lda: row stride of A, in elements.
+ * \param b: pointer to entry (0,0) of B.
+ * \param ldb: row stride of B, in elements.
+ * \param c: pointer to entry (0,0) of C.
+ * \param ldc: row stride of C, in elements.
+ * \param update: how A*B is merged into C.
+ */
+template <typename E>
+void gemm(int m, int n, int k, const E *a, int lda, const E *b, int ldb, E *c,
+          int ldc, GemmUpdate update = GemmUpdate::overwrite);
+
+/**
+ * \brief Same as \sa gemm, with C split into 2D tiles computed in parallel.
+ *
+ * Falls back to a single \sa gemm call unless the current
+ * \sa linopt::parallel::ExecutionPolicy is parallel and m*n*k reaches its
+ * threshold.
+ */
+template <typename E>
+void parallelGemm(int m, int n, int k, const E *a, int lda, const E *b,
+                  int ldb, E *c, int ldc,
+                  GemmUpdate update = GemmUpdate::overwrite);
+
+// precompiled, runtime dispatched micro-kernels (Gemm.cpp)
+template <>
+void gemm<float>(int m, int n, int k, const float *a, int lda, const float *b,
+                 int ldb, float *c, int ldc, GemmUpdate update);
+template <>
+void gemm<double>(int m, int n, int k, const double *a, int lda,
+                  const double *b, int ldb, double *c, int ldc,
+                  GemmUpdate update);
+template <>
+void gemm<int>(int m, int n, int k, const int *a, int lda, const int *b,
+               int ldb, int *c, int ldc, GemmUpdate update);
+template <>
+void gemm<long>(int m, int n, int k, const long *a, int lda, const long *b,
+                int ldb, long *c, int ldc, GemmUpdate update);
+template <>
+void gemm<long long>(int m, int n, int k, const long long *a, int lda,
+                     const long long *b, int ldb, long long *c, int ldc,
+                     GemmUpdate update);
+
+} // namespace linopt::inmemory::kernels
+
+#include "Gemm.tpp"
+#endif
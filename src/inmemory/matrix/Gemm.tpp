@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "AlignedAllocator.h"
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory::kernels {
+namespace detail {
+
+/**
+ * \brief Cache blocking parameters of the packed gemm driver.
+ *
+ * kc columns of A / rows of B are packed at a time so that an mr x kc
+ * sliver of A and a kc x nr sliver of B stay in L1, an mc x kc block of A
+ * stays in L2 and a kc x nc panel of B in L3.
+ */
+inline constexpr int gemmKc = 256;
+inline constexpr int gemmMc = 96;
+inline constexpr int gemmNc = 2048;
+
+/**
+ * \brief Below this many multiply-adds packing does not pay off.
+ */
+inline constexpr long gemmSmallWork = 32L * 32 * 32;
+
+template <typename E>
+inline void storeTile(E *c, int ldc, const E *acc, int accStride, int mr,
+                      int nr, GemmUpdate update) {
+  for (int i = 0; i < mr; i++) {
+    E *ci = c + static_cast<std::size_t>(i) * ldc;
+    const E *ai = acc + i * accStride;
+    switch (update) {
+    case GemmUpdate::overwrite:
+      for (int j = 0; j < nr; j++)
+        ci[j] = ai[j];
+      break;
+    case GemmUpdate::accumulate:
+      for (int j = 0; j < nr; j++)
+        ci[j] = ci[j] + ai[j];
+      break;
+    case GemmUpdate::subtract:
+      for (int j = 0; j < nr; j++)
+        ci[j] = ci[j] - ai[j];
+      break;
+    }
+  }
+}
+
+/**
+ * \brief Register-tiled MR x NR micro-kernel on packed slivers.
+ *
+ * pa holds kc columns of MR entries, pb kc rows of NR entries. The fixed
+ * trip counts let the compiler keep acc in vector registers.
+ */
+template <typename E, int MR, int NR>
+[[gnu::always_inline]] inline void microKernel(int kc, const E *pa,
+                                               const E *pb, E *c, int ldc,
+                                               int mr, int nr,
+                                               GemmUpdate update) {
+  E acc[MR][NR];
+  for (int i = 0; i < MR; i++)
+    for (int j = 0; j < NR; j++)
+      acc[i][j] = E();
+  for (int p = 0; p < kc; p++) {
+    const E *ap = pa + p * MR;
+    const E *bp = pb + p * NR;
+    for (int i = 0; i < MR; i++) {
+      const E ai = ap[i];
+      for (int j = 0; j < NR; j++)
+        acc[i][j] += ai * bp[j];
+    }
+  }
+  storeTile(c, ldc, &acc[0][0], NR, mr, nr, update);
+}
+
+/**
+ * \brief Micro-kernel on explicit vector registers of VB bytes.
+ *
+ * NR must be a multiple of the VB / sizeof(E) lanes. Only used for
+ * arithmetic E, from functions compiled for an instruction set whose
+ * registers are VB bytes wide.
+ */
+template <typename E, int MR, int NR, int VB>
+[[gnu::always_inline]] inline void microKernelVec(int kc, const E *pa,
+                                                  const E *pb, E *c, int ldc,
+                                                  int mr, int nr,
+                                                  GemmUpdate update) {
+  typedef E V [[gnu::vector_size(VB)]];
+  constexpr int lanes = VB / static_cast<int>(sizeof(E));
+  constexpr int nv = NR / lanes;
+  static_assert(nv * lanes == NR, "NR must be a multiple of the lanes.");
+  V acc[MR][nv] = {};
+  for (int p = 0; p < kc; p++) {
+    V bv[nv];
+    for (int v = 0; v < nv; v++)
+      __builtin_memcpy(&bv[v], pb + p * NR + v * lanes, VB);
+    const E *ap = pa + p * MR;
+    for (int i = 0; i < MR; i++) {
+      const E ai = ap[i];
+      for (int v = 0; v < nv; v++)
+        acc[i][v] += ai * bv[v];
+    }
+  }
+  E tile[MR * NR];
+  for (int i = 0; i < MR; i++)
+    for (int v = 0; v < nv; v++)
+      __builtin_memcpy(tile + i * NR + v * lanes, &acc[i][v], VB);
+  storeTile(c, ldc, tile, NR, mr, nr, update);
+}
+
+/**
+ * \brief Packs the mc x kc block of A into MR-row slivers, zero padded.
+ */
+template <typename E, int MR>
+inline void packA(int mc, int kc, const E *a, int lda, E *pa) {
+  for (int ir = 0; ir < mc; ir += MR) {
+    const int mr = std::min(MR, mc - ir);
+    for (int p = 0; p < kc; p++) {
+      for (int i = 0; i < mr; i++)
+        pa[i] = a[static_cast<std::size_t>(ir + i) * lda + p];
+      for (int i = mr; i < MR; i++)
+        pa[i] = E();
+      pa += MR;
+    }
+  }
+}
+
+/**
+ * \brief Packs the kc x nc panel of B into NR-column slivers, zero padded.
+ */
+template <typename E, int NR>
+inline void packB(int kc, int nc, const E *b, int ldb, E *pb) {
+  for (int jr = 0; jr < nc; jr += NR) {
+    const int nr = std::min(NR, nc - jr);
+    for (int p = 0; p < kc; p++) {
+      const E *bp = b + static_cast<std::size_t>(p) * ldb + jr;
+      for (int j = 0; j < nr; j++)
+        pb[j] = bp[j];
+      for (int j = nr; j < NR; j++)
+        pb[j] = E();
+      pb += NR;
+    }
+  }
+}
+
+/**
+ * \brief Straightforward i-k-j product for blocks too small to be packed.
+ */
+template <typename E>
+[[gnu::always_inline]] inline void gemmSmall(int m, int n, int k, const E *a,
+                                             int lda, const E *b, int ldb,
+                                             E *c, int ldc,
+                                             GemmUpdate update) {
+  for (int i = 0; i < m; i++) {
+    E *ci = c + static_cast<std::size_t>(i) * ldc;
+    if (update == GemmUpdate::overwrite)
+      std::fill(ci, ci + n, E());
+    const E *ai = a + static_cast<std::size_t>(i) * lda;
+    for (int p = 0; p < k; p++) {
+      const E aip = update == GemmUpdate::subtract ? E() - ai[p] : ai[p];
+      const E *bp = b + static_cast<std::size_t>(p) * ldb;
+      for (int j = 0; j < n; j++)
+        ci[j] += aip * bp[j];
+    }
+  }
+}
+
+/**
+ * \brief Packed, cache-blocked gemm driver (Goto/BLIS loop nest).
+ *
+ * Instantiated once per element type and register tile. The precompiled
+ * kernels of Gemm.cpp inline it into functions built for a given
+ * instruction set and pass the width VB of its vector registers, in bytes;
+ * VB == 0 selects the portable micro-kernel.
+ */
+template <typename E, int MR, int NR, int VB = 0>
+[[gnu::always_inline]] inline void gemmBlocked(int m, int n, int k,
+                                               const E *a, int lda,
+                                               const E *b, int ldb, E *c,
+                                               int ldc, GemmUpdate update) {
+  if (m <= 0 || n <= 0)
+    return;
+  if (k <= 0) {
+    if (update == GemmUpdate::overwrite)
+      for (int i = 0; i < m; i++)
+        std::fill(c + static_cast<std::size_t>(i) * ldc,
+                  c + static_cast<std::size_t>(i) * ldc + n, E());
+    return;
+  }
+  if (static_cast<long>(m) * n * k <= gemmSmallWork) {
+    gemmSmall(m, n, k, a, lda, b, ldb, c, ldc, update);
+    return;
+  }
+  constexpr int mcMax = (gemmMc + MR - 1) / MR * MR;
+  constexpr int ncMax = (gemmNc + NR - 1) / NR * NR;
+  const int kcMax = std::min(gemmKc, k);
+  const int ncCap = std::min(ncMax, (n + NR - 1) / NR * NR);
+  const int mcCap = std::min(mcMax, (m + MR - 1) / MR * MR);
+  // packing buffers are reused across calls on the same thread
+  thread_local std::vector<E, AlignedAllocator<E>> packedA, packedB;
+  if (packedA.size() < static_cast<std::size_t>(mcCap) * kcMax)
+    packedA.resize(static_cast<std::size_t>(mcCap) * kcMax);
+  if (packedB.size() < static_cast<std::size_t>(kcMax) * ncCap)
+    packedB.resize(static_cast<std::size_t>(kcMax) * ncCap);
+  E *pa = packedA.data();
+  E *pb = packedB.data();
+
+  for (int jc = 0; jc < n; jc += ncMax) {
+    const int nc = std::min(ncMax, n - jc);
+    for (int pc = 0; pc < k; pc += gemmKc) {
+      const int kc = std::min(gemmKc, k - pc);
+      // only the first k-block may overwrite C, the others add to it
+      const GemmUpdate step =
+          pc == 0 || update == GemmUpdate::subtract ? update
+                                                    : GemmUpdate::accumulate;
+      packB<E, NR>(kc, nc, b + static_cast<std::size_t>(pc) * ldb + jc, ldb,
+                   pb);
+      for (int ic = 0; ic < m; ic += mcMax) {
+        const int mc = std::min(mcMax, m - ic);
+        packA<E, MR>(mc, kc, a + static_cast<std::size_t>(ic) * lda + pc, lda,
+                     pa);
+        for (int jr = 0; jr < nc; jr += NR) {
+          const int nr = std::min(NR, nc - jr);
+          for (int ir = 0; ir < mc; ir += MR) {
+            const int mr = std::min(MR, mc - ir);
+            const E *sa = pa + static_cast<std::size_t>(ir) * kc;
+            const E *sb = pb + static_cast<std::size_t>(jr) * kc;
+            E *sc = c + static_cast<std::size_t>(ic + ir) * ldc + jc + jr;
+            if constexpr (VB > 0)
+              microKernelVec<E, MR, NR, VB>(kc, sa, sb, sc, ldc, mr, nr, step);
+            else
+              microKernel<E, MR, NR>(kc, sa, sb, sc, ldc, mr, nr, step);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace detail
+
+template <typename E>
+void gemm(int m, int n, int k, const E *a, int lda, const E *b, int ldb, E *c,
+          int ldc, GemmUpdate update) {
+  detail::gemmBlocked<E, 4, 4>(m, n, k, a, lda, b, ldb, c, ldc, update);
+}
+
+template <typename E>
+void parallelGemm(int m, int n, int k, const E *a, int lda, const E *b,
+                  int ldb, E *c, int ldc, GemmUpdate update) {
+  LINOPT_METRICS_SCOPE("gemm", m, n, k, 2.0 * m * n * k,
+                       (static_cast<double>(m) * k + static_cast<double>(k) * n +
+                        static_cast<double>(m) * n) *
+                           sizeof(E));
+  parallel::parallelFor2D(
+      m, n, detail::gemmMc, 256, static_cast<long>(m) * n * k,
+      [&](int r0, int r1, int c0, int c1) {
+        gemm<E>(r1 - r0, c1 - c0, k, a + static_cast<std::size_t>(r0) * lda,
+                lda, b + c0, ldb, c + static_cast<std::size_t>(r0) * ldc + c0,
+                ldc, update);
+      });
+}
+
+} // namespace linopt::inmemory::kernels
@@ -2,11 +2,20 @@
  * \file Matrix.h
  * \author mk8bk
  * \date 14/08/2024
- * \brief Declares the \sa linopt::inmemory::Matrix<E> class.
+ * \brief Declares the \sa linopt::inmemory::Matrix<E, A> class.
  * \details
  *  This class models an in-memory dense matrix. It provides an
  *  easy to use api. It provides methods to access and modify the
  *  matrix entries.
+ *  The entries live in a single contiguous, row-major, 64-byte aligned
+ *  buffer; each row is padded so that the next one starts on a cache line.
+ *  Bulk operations (arithmetic, transpose, fill) run on the shared thread
+ *  pool when the current \sa linopt::parallel::ExecutionPolicy asks for it.
+ *  Elementwise arithmetic (+, -, scalar *) is lazy, see MatrixExpression.h:
+ *  it is evaluated in one fused pass when assigned to a matrix.
+ *  The buffer comes from the allocator A, \sa AlignedAllocator by default;
+ *  \sa linopt::memory::ResourceAllocator draws it from a memory resource
+ *  (huge pages, pools, arenas, see MemoryResource.h).
  */
 #ifndef LINOPT_ERC_INMEMORY_MATRIX_MATRIX_H
 #define LINOPT_ERC_INMEMORY_MATRIX_MATRIX_H
@@ -14,24 +23,88 @@
 #include <ostream>
 #include <vector>
 
+#include "AlignedAllocator.h"
+#include "Gemm.h"
+#include "MatrixExpression.h"
+#include "MatrixView.h"
+#include "Transpose.h"
+
 namespace linopt::inmemory {
 /**
- * \brief The Matrix<E> class stores nxm entries of type E.
+ * \brief The Matrix<E, A> class stores nxm entries of type E.
  *
  * This class handles dense matrices.
  * The type E must model a commutative ring, that is: for e1, e2 of type E,
  * e1 * e2, e1+e2 must be well defined and of type E.
+ * The allocator A must hand out 64-byte aligned storage for E and
+ * default-initialize (\sa AlignedAllocator::construct).
  *
  */
-template <typename E = double> class Matrix {
+template <typename E, typename A>
+class Matrix : public MatrixExpression<Matrix<E, A>> {
 private:
   /**
-   * \brief The undelying matrix entries are stored in an stl vector
-   * of vectors. It is never jagged *ie:* each vector row has the same size.
+   * \brief Number of rows. 0 only for a moved-from matrix.
+   */
+  int rows = 0;
+
+  /**
+   * \brief Number of (logical) columns.
+   */
+  int columns = 0;
+
+  /**
+   * \brief Distance, in elements, between the starts of two consecutive rows.
+   * Always >= columns; the padding entries hold E().
+   */
+  int rowStride = 0;
+
+  /**
+   * \brief The underlying matrix entries, stored row-major in a single
+   * aligned buffer of rows*rowStride elements. Entry (r,c) lives at
+   * buffer[r*rowStride+c].
+   */
+  std::vector<E, A> buffer;
+
+  /**
+   * \brief Capacity to reserve for an nxm matrix.
+   *
+   * Includes the padded layout of the transpose when it is at most an
+   * eighth larger, so that \sa inplaceTranspose() does not reallocate.
+   */
+  static size_t capacityFor(int n, int m);
+
+  /**
+   * \brief Tag selecting the constructor that leaves the entries uninitialized.
+   */
+  struct Uninitialized {};
+
+  /**
+   * \brief Constructs an nxm matrix whose entries are to be written by the caller.
+   *
+   * The entries of a trivially constructible E are left uninitialized.
+   */
+  Matrix(int n, int m, Uninitialized, const A &allocator);
+
+  /**
+   * \brief Evaluates x into this matrix, which must already have x's dimensions.
+   *
+   * Op is void for a plain assignment, otherwise entry (i,j) becomes
+   * Op()(entry, x(i,j)). x must not alias this matrix.
    */
-  std::vector<std::vector<E>> data;
+  template <typename Op, typename X> void evaluate(const X &x);
 
 public:
+  /**
+   * \brief Type of the entries.
+   */
+  using value_type = E;
+
+  /**
+   * \brief Type of the allocator of the entry buffer.
+   */
+  using allocator_type = A;
+
   /**
    * \brief Get the number of rows in the matrix.
    * \return n: the number of rows in the matrix.
@@ -44,14 +117,45 @@ public:
    */
   int getM() const;
 
+  /**
+   * \brief Get the row stride of the underlying buffer.
+   *
+   * Entry (r,c) is located at data()[r*stride()+c]. The stride is a multiple
+   * of the number of elements in a cache line (when sizeof(E) allows it),
+   * so that each row is 64-byte aligned.
+   * \return the distance, in elements, between two consecutive rows.
+   */
+  int stride() const;
+
+  /**
+   * \brief Raw access to the contiguous, row-major entry buffer.
+   *
+   * The buffer holds getN()*stride() elements. The padding entries
+   * (columns getM() to stride()-1) must be left equal to E().
+   * \return pointer to entry (0,0), aligned on 64 bytes.
+   */
+  E *data();
+
+  /**
+   * \brief Raw read-only access to the contiguous, row-major entry buffer.
+   * \return pointer to entry (0,0), aligned on 64 bytes.
+   */
+  const E *data() const;
+
+  /**
+   * \brief Get the allocator of the entry buffer.
+   */
+  A getAllocator() const;
+
   /**
    * \brief constructs an nxm matrix.
    *
    * Pre-filled with E().
    * \param n: number of rows in the matrix.
    * \param m: number of columns in the matrix.
+   * \param allocator: allocator of the entry buffer.
    */
-  Matrix(int n, int m);
+  Matrix(int n, int m, const A &allocator = A());
 
   /**
    * \brief constructs an nxm matrix.
@@ -60,48 +164,85 @@ public:
    * \param e: default element copied in each entry.
    * \param n: number of rows in the matrix.
    * \param m: number of columns in the matrix.
+   * \param allocator: allocator of the entry buffer.
+   */
+  Matrix(int n, int m, E e, const A &allocator = A());
+
+  /**
+   * \brief Constructs an nxm matrix without initializing its buffer.
+   *
+   * For bulk loaders that overwrite the whole buffer, padding included
+   * (\sa data()): the entries of a trivially constructible E hold garbage
+   * until written.
+   * \param n: number of rows in the matrix.
+   * \param m: number of columns in the matrix.
+   * \param allocator: allocator of the entry buffer.
+   * \return the matrix.
    */
-  Matrix(int n, int m, E e);
+  static Matrix<E, A> uninitialized(int n, int m, const A &allocator = A());
 
   /**
    * \brief Copy constructor.
    * \param src: the matrix to be copied.
    */
-  Matrix(const Matrix<E> &src);
+  Matrix(const Matrix<E, A> &src);
 
   /**
    * \brief Move constructor.
    * \param src: the r-value matrix to be moved.
    */
-  Matrix(Matrix<E> &&src);
+  Matrix(Matrix<E, A> &&src);
 
   /**
    * \brief Move constructor.
    * \param il: the initializer_list to be used for ... initializing the matrix.
    *     It must not be jagged: each row must have the same length.
+   * \param allocator: allocator of the entry buffer.
+   */
+  Matrix(std::initializer_list<std::initializer_list<E>> il,
+         const A &allocator = A());
+
+  /**
+   * \brief Evaluates a matrix expression in one pass into a new matrix.
+   *
+   * Implicit, so that Matrix<E> m = a + b * 2; works.
+   * \param x: the expression to evaluate.
+   * \param allocator: allocator of the entry buffer.
    */
-  Matrix(std::initializer_list<std::initializer_list<E>> il);
+  template <typename X>
+  Matrix(const MatrixExpression<X> &x, const A &allocator = A());
 
   /**
    * \brief Copy assignment operator.
    * \param src: the matrix to be copied.
    * \return a reference to the matrix after assignment.
    */
-  Matrix<E> &operator=(const Matrix<E> &other);
+  Matrix<E, A> &operator=(const Matrix<E, A> &other);
 
   /**
    * \brief Move assignment operator.
    * \param src: the r-value matrix to be moved.
    * \return a reference to the matrix after assignment.
    */
-  Matrix<E> &operator=(Matrix<E> &&other);
+  Matrix<E, A> &operator=(Matrix<E, A> &&other);
+
+  /**
+   * \brief Expression assignment operator.
+   *
+   * The expression is evaluated directly into this matrix's buffer when the
+   * dimensions match and the expression does not read this matrix at
+   * transposed positions; otherwise into a new buffer.
+   * \param x: the expression to evaluate.
+   * \return a reference to the matrix after assignment.
+   */
+  template <typename X> Matrix<E, A> &operator=(const MatrixExpression<X> &x);
 
   /**
    * \brief Swap matrices. Constant time.
    * \param other: the matrix to swap with this matrix.
    * \return a reference to the matrix after the swap.
    */
-  void swap(Matrix<E> &other);
+  void swap(Matrix<E, A> &other);
 
   /**
    * \brief Matrix entry getter.
@@ -123,17 +264,80 @@ public:
    */
   E &get(int r, int c);
 
+  /**
+   * \brief Unchecked entry access, for expressions and kernels.
+   * \param r: the row index (starting at 0).
+   * \param c: the column index (starting at 0).
+   * \return constant reference to entry at position (r,c).
+   */
+  const E &coeff(int r, int c) const {
+    return buffer[static_cast<size_t>(r) * rowStride + c];
+  }
+
+  /**
+   * \brief Whether this matrix stores its entries at p.
+   */
+  bool refersTo(const void *p) const { return p == buffer.data(); }
+
+  /**
+   * \brief A matrix only reads entry (r,c) to produce entry (r,c): never an alias.
+   */
+  bool aliases(const void *) const { return false; }
+
+  /**
+   * \brief View of the hxw block whose top left entry is (r0,c0).
+   *
+   * No copy: writes through the view go to this matrix. Throws a
+   * runtime_error if the block is not inside the matrix.
+   * \return a \sa MatrixSpan over the block.
+   */
+  MatrixSpan<E> block(int r0, int c0, int h, int w);
+
+  /**
+   * \brief Read-only view of the hxw block whose top left entry is (r0,c0).
+   */
+  MatrixView<E> block(int r0, int c0, int h, int w) const;
+
+  /**
+   * \brief View of rows r0 to r1-1.
+   */
+  MatrixSpan<E> rowRange(int r0, int r1);
+
+  /**
+   * \brief Read-only view of rows r0 to r1-1.
+   */
+  MatrixView<E> rowRange(int r0, int r1) const;
+
+  /**
+   * \brief View of columns c0 to c1-1.
+   */
+  MatrixSpan<E> columnRange(int c0, int c1);
+
+  /**
+   * \brief Read-only view of columns c0 to c1-1.
+   */
+  MatrixView<E> columnRange(int c0, int c1) const;
+
   /**
    * \brief Transposes the matrix in-place.
+   *
+   * Square matrices swap cache-sized tiles. Other shapes follow the cycles
+   * of the transposition permutation inside the existing buffer, which
+   * only needs getN()*getM() bits of extra memory. Matrices are allocated
+   * with room for their padded transpose, except flat ones (a few rows)
+   * whose transpose pads many short rows: their transpose needs more than
+   * an eighth of extra memory, and is built in a new, larger buffer.
    * \return reference to this matrix after the transposition is performed.
    */
-  Matrix<E> &inplaceTranspose();
+  Matrix<E, A> &inplaceTranspose();
 
   /**
    * \brief Performs the transpose operation.
+   *
+   * Runs the cache-oblivious \sa linopt::inmemory::kernels::transpose kernel.
    * \return the transpose matrix.
    */
-  Matrix<E> transpose() const;
+  Matrix<E, A> transpose() const;
 
   /**
    * \brief Performs the operation: destinationRow=row1*factor1 + row2*factor2.
@@ -151,8 +355,8 @@ public:
    * \return a reference to the matrix after the operation is performed.
    */
   template <typename S>
-  Matrix<E> &combineRows(int row1, S factor1, int row2, S factor2,
-                         int destinationRow);
+  Matrix<E, A> &combineRows(int row1, S factor1, int row2, S factor2,
+                            int destinationRow);
 
   /**
    * \brief Performs the operation: destinationColumn=column1*factor1 + column2*factor2.
@@ -169,8 +373,8 @@ public:
    * \param destinationColumn: column position to be overwritten.
    * \return a reference to the matrix after the operation is performed.
    */
-  Matrix<E> &combineColumns(int column1, int factor1, int column2, int factor2,
-                            int destinationColumn);
+  Matrix<E, A> &combineColumns(int column1, int factor1, int column2,
+                               int factor2, int destinationColumn);
 
   /**
    * \brief Performs the operation: row = row*s.
@@ -184,7 +388,7 @@ public:
    * \param s: scalar to multiply by row.
    * \return a reference to the matrix after the operation is performed.
    */
-  template <typename S> Matrix<E> &multiplyRow(int row, S s);
+  template <typename S> Matrix<E, A> &multiplyRow(int row, S s);
 
   /**
    * \brief Performs the operation: column = column*s.
@@ -198,71 +402,33 @@ public:
    * \param s: scalar to multiply by row.
    * \return reference to the matrix after the operation is performed.
    */
-  template <typename S> Matrix<E> &multiplyColumn(int column, S s);
-
-  /**
-   * \brief Sums two matrices with matching dimensions.
-   *
-   * If the dimensions don't match, a runtime_error is thrown.
-   *
-   * \param other: reference to the matrix to be added to produce the return matrix.
-   * \return the sum of the two matrices.
-   */
-  Matrix<E> operator+(const Matrix<E> &other) const;
-
-  /**
-   * \brief Subtracts matrix other from this matrix.
-   *
-   * If the dimensions don't match, a runtime_error is thrown.
-   *
-   * \param other: reference the matrix to be subtracted to produce the return matrix.
-   * \return a new matrix: this - other.
-   */
-
-  Matrix<E> operator-(const Matrix<E> &other) const;
-
-  /**
-   * \brief Multiplies two matrices with appropriate dimensions.
-   *
-   * If the dimensions are not appropriate *ie*: this->getM()!=other.getN();
-   * a runtime_error is thrown.
-   *
-   * \param other: reference the matrix to be multiplied to the right to produce the return matrix.
-   * \return the product of the two matrices (*this * other).
-   */
-  Matrix<E> operator*(const Matrix<E> &other) const;
-
-  /**
-   * \brief Multiply each entry of the matrix by scalar s.
-   *
-   * The type S is a "scalar" type; *ie*: a type that can be multiplied by an entry of type E
-   * and yield a result of type E.
-   *
-   * Does not modify the calling matrix.
-   *
-   * \return matrix M st M.get(i,j)==s*this->get(i,j) for all valid (i,j).
-   */
-  template <typename S> Matrix<E> operator*(const S &s) const;
+  template <typename S> Matrix<E, A> &multiplyColumn(int column, S s);
 
   /**
-   * \brief Adds matrix other to this matrix inplace.
+   * \brief Adds matrix (expression) other to this matrix inplace.
    *
    * If the dimensions don't match, a runtime_error is thrown.
+   * Single pass over this matrix's buffer, no allocation unless other
+   * reads this matrix at transposed positions.
    *
-   * \param other: reference to the matrix to be added to this matrix.
+   * \param other: reference to the expression to be added to this matrix.
    * \return reference to this matrix after the addition is performed.
    */
-  Matrix<E> &operator+=(const Matrix<E> &other);
+  template <typename X>
+  Matrix<E, A> &operator+=(const MatrixExpression<X> &other);
 
   /**
-   * \brief Subtracts matrix other from this matrix inplace.
+   * \brief Subtracts matrix (expression) other from this matrix inplace.
    *
    * If the dimensions don't match, a runtime_error is thrown.
+   * Single pass over this matrix's buffer, no allocation unless other
+   * reads this matrix at transposed positions.
    *
-   * \param other: reference to the matrix to be subtracted from this matrix.
+   * \param other: reference to the expression to be subtracted from this matrix.
    * \return reference to this matrix after the subtraction is performed.
    */
-  Matrix<E> &operator-=(const Matrix<E> &other);
+  template <typename X>
+  Matrix<E, A> &operator-=(const MatrixExpression<X> &other);
 
   /**
    * \brief Multiplies this matrix with other (inplace).
@@ -271,11 +437,14 @@ public:
    * a runtime_error is thrown.
    *
    * The dimensions of the matrix will change, the number of rows is guaranteed not to be altered.
+   * The product is computed one row panel at a time and written back into
+   * this matrix's buffer, which is only reallocated if the padded result
+   * does not fit in it.
    *
    * \param other: reference to the matrix to be multiplied to the right.
    * \return reference to this matrix after the multiplication is performed.
    */
-  Matrix<E> &operator*=(const Matrix<E> &other);
+  Matrix<E, A> &operator*=(const Matrix<E, A> &other);
 
   /**
    * \brief Multiply each entry of the matrix by scalar s (inplace).
@@ -285,41 +454,28 @@ public:
    *
    * \return reference to this matrix after all entries are multiplied by s.
    */
-  template <typename S> Matrix<E> &operator*=(const S &s);
-
-  /**
-   * \brief Equality operator.
-   * \param other: const reference to other matrix to be compared.
-   * \return true iff the matrices have the same dimensions and
-   * each corresponding entry compares equal. false otherwise.
-   */
-  bool operator==(const Matrix<E> &other) const;
-
-  /**
-   * \brief Inequality operator.
-   * \param other: const reference to other matrix to be compared.
-   * \return false iff the matrices have the same dimensions and
-   * each corresponding entry compares equal. true otherwise.
-   */
-  bool operator!=(const Matrix<E> &other) const;
+  template <typename S>
+    requires(!isMatrixExpression<S>)
+  Matrix<E, A> &operator*=(const S &s);
 
   /**
    * \brief Output matrix to ostream using <<. Compatible with reading in using >>.
    */
-  template <typename T>
-  friend std::ostream &operator<<(std::ostream &os, const Matrix<T> &matrix);
+  template <typename T, typename B>
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const Matrix<T, B> &matrix);
 
   /**
    * \brief Read matrix from istream using >>. Compatible with output using <<.
    */
-  template <typename T>
-  friend std::istream &operator>>(std::istream &is, Matrix<T> &matrix);
+  template <typename T, typename B>
+  friend std::istream &operator>>(std::istream &is, Matrix<T, B> &matrix);
 
   /**
    * \brief Fill whole matrix with element E(e).
    * \return reference to the matrix after the operation is performed.
    */
-  Matrix<E> &fill(E e);
+  Matrix<E, A> &fill(E e);
 
   /**
    * \brief Fill matrix row with element E(e).
@@ -328,7 +484,7 @@ public:
    *
    * \return reference to the matrix after the operation is performed.
    */
-  Matrix<E> &fillRow(int row, E e);
+  Matrix<E, A> &fillRow(int row, E e);
 
   /**
    * \brief Fill matrix column with element E(e).
@@ -337,8 +493,8 @@ public:
    *
    * \return reference to the matrix after the operation is performed.
    */
-  Matrix<E> &fillColumn(int column, E e);
-}; // class Matrix<E>
+  Matrix<E, A> &fillColumn(int column, E e);
+}; // class Matrix<E, A>
 
 } // namespace linopt::inmemory
 
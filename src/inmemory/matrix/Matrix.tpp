@@ -1,256 +1,485 @@
+#include <algorithm>
 #include <istream>
+#include <memory>
 #include <ostream>
+#include <functional>
 #include <stdexcept>
+#include <type_traits>
+
+#include "Metrics.h"
+#include "Parallel.h"
+#include "Workspace.h"
 
 namespace linopt::inmemory {
 
-template <typename E> int Matrix<E>::getN() const { return data.size(); }
+template <typename E, typename A> int Matrix<E, A>::getN() const {
+  return rows;
+}
 
-template <typename E> int Matrix<E>::getM() const {
+template <typename E, typename A> int Matrix<E, A>::getM() const {
   if (getN() == 0)
     throw std::runtime_error("Invalid matrix dimension (<1).");
-  return data[0].size();
+  return columns;
+}
+
+template <typename E, typename A> int Matrix<E, A>::stride() const {
+  return rowStride;
+}
+
+template <typename E, typename A> E *Matrix<E, A>::data() {
+  return buffer.data();
+}
+
+template <typename E, typename A> const E *Matrix<E, A>::data() const {
+  return buffer.data();
 }
-template <typename E>
-Matrix<E>::Matrix(int n, int m) : data(n, std::vector<E>(m, E())) {
+
+template <typename E, typename A> A Matrix<E, A>::getAllocator() const {
+  return buffer.get_allocator();
+}
+
+template <typename E, typename A>
+size_t Matrix<E, A>::capacityFor(int n, int m) {
+  const size_t size = static_cast<size_t>(n) * paddedStride<E>(m);
+  const size_t transposed = static_cast<size_t>(m) * paddedStride<E>(n);
+  return transposed > size && transposed - size <= size / 8 ? transposed
+                                                            : size;
+}
+
+template <typename E, typename A>
+Matrix<E, A>::Matrix(int n, int m, const A &allocator)
+    : rows(n), columns(m), rowStride(static_cast<int>(paddedStride<E>(m))),
+      buffer(allocator) {
   if (n < 1 || m < 1)
     throw std::runtime_error("Invalid matrix dimension (<1).");
+  buffer.reserve(capacityFor(n, m));
+  buffer.assign(static_cast<size_t>(n) * rowStride, E());
+}
+template <typename E, typename A>
+Matrix<E, A>::Matrix(int n, int m, E e, const A &allocator)
+    : Matrix(n, m, allocator) {
+  fill(e);
 }
-template <typename E>
-Matrix<E>::Matrix(int n, int m, E e) : data(n, std::vector<E>(m, E(e))) {
+
+template <typename E, typename A>
+Matrix<E, A>::Matrix(int n, int m, Uninitialized, const A &allocator)
+    : rows(n), columns(m), rowStride(static_cast<int>(paddedStride<E>(m))),
+      buffer(allocator) {
   if (n < 1 || m < 1)
     throw std::runtime_error("Invalid matrix dimension (<1).");
+  buffer.reserve(capacityFor(n, m));
+  // default-initialization through the allocator: no pass over the memory
+  buffer.resize(static_cast<size_t>(n) * rowStride);
 }
 
-template <typename E>
-Matrix<E>::Matrix(std::initializer_list<std::initializer_list<E>> il) {
+template <typename E, typename A>
+Matrix<E, A> Matrix<E, A>::uninitialized(int n, int m, const A &allocator) {
+  return Matrix<E, A>(n, m, Uninitialized{}, allocator);
+}
+
+template <typename E, typename A>
+Matrix<E, A>::Matrix(std::initializer_list<std::initializer_list<E>> il,
+                     const A &allocator) {
   if (il.size() < 1 || il.begin()->size() < 1)
     throw std::runtime_error(
         "Invalid matrix dimension (<1) in initializer_list<E>.");
   size_t m = il.begin()->size();
-  for (const std::initializer_list<E> &row : il) {
+  for (const std::initializer_list<E> &row : il)
     if (row.size() != m)
       throw std::runtime_error(
           "Jagged initializer_list not allowed for matrix initialization.");
-    data.push_back(row);
+  Matrix<E, A>(il.size(), m, allocator).swap(*this);
+  E *dst = buffer.data();
+  for (const std::initializer_list<E> &row : il) {
+    std::copy(row.begin(), row.end(), dst);
+    dst += rowStride;
   }
 }
 
-// copy constructor
-template <typename E>
-Matrix<E>::Matrix(const Matrix<E> &src) : data(src.data) {}
+template <typename E, typename A>
+template <typename X>
+Matrix<E, A>::Matrix(const MatrixExpression<X> &x, const A &allocator)
+    : Matrix(x.derived().getN(), x.derived().getM(), Uninitialized{},
+             allocator) {
+  evaluate<void>(x.derived());
+}
+
+// copy constructor: a single allocation, a single contiguous copy
+template <typename E, typename A>
+Matrix<E, A>::Matrix(const Matrix<E, A> &src)
+    : rows(src.rows), columns(src.columns), rowStride(src.rowStride),
+      buffer(std::allocator_traits<A>::select_on_container_copy_construction(
+          src.buffer.get_allocator())) {
+  buffer.reserve(capacityFor(rows, columns));
+  buffer.assign(src.buffer.begin(), src.buffer.end());
+}
 
 // move constructor
-template <typename E> Matrix<E>::Matrix(Matrix<E> &&src) {
-  data.swap(src.data);
-}
+template <typename E, typename A>
+Matrix<E, A>::Matrix(Matrix<E, A> &&src) { swap(src); }
 
 // copy assignment operator
-template <typename E> Matrix<E> &Matrix<E>::operator=(const Matrix<E> &other) {
-  data = other.data; // expensive copy
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::operator=(const Matrix<E, A> &other) {
+  if (this == &other)
+    return *this;
+  rows = other.rows;
+  columns = other.columns;
+  rowStride = other.rowStride;
+  buffer = other.buffer; // expensive copy, reuses capacity when possible
   return *this;
 }
 
 // move assignment operator
-template <typename E> Matrix<E> &Matrix<E>::operator=(Matrix<E> &&other) {
-  data.swap(other.data); // inexpensive, constant time exchange
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::operator=(Matrix<E, A> &&other) {
+  swap(other); // inexpensive, constant time exchange
   return *this;
 }
 
+template <typename E, typename A>
+template <typename X>
+Matrix<E, A> &Matrix<E, A>::operator=(const MatrixExpression<X> &x) {
+  const X &expression = x.derived();
+  if (rows == expression.getN() && columns == expression.getM() &&
+      !expression.aliases(data())) {
+    evaluate<void>(expression);
+  } else {
+    Matrix<E, A> r(expression, getAllocator());
+    swap(r);
+  }
+  return *this;
+}
+
+template <typename E, typename A>
+template <typename Op, typename X>
+void Matrix<E, A>::evaluate(const X &x) {
+  const long work = static_cast<long>(rows) * columns;
+  if constexpr (std::is_void_v<Op> &&
+                std::is_same_v<X, TransposeExpression<Matrix<E, A>>>) {
+    // plain transpose of a matrix: blocked kernel instead of strided reads
+    const Matrix<E, A> &source = x.nested();
+    kernels::parallelTranspose(source.rows, source.columns, source.data(),
+                               source.rowStride, data(), rowStride);
+    for (int i = 0; i < rows; i++)
+      std::fill(data() + static_cast<size_t>(i) * rowStride + columns,
+                data() + static_cast<size_t>(i + 1) * rowStride, E());
+    return;
+  }
+  // the operands of the expression are unknown here: only the destination
+  // is counted
+  LINOPT_METRICS_SCOPE("elementwise", rows, columns, 0, work,
+                       static_cast<double>(work) * sizeof(E));
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      E *d = data() + static_cast<size_t>(i) * rowStride;
+      if constexpr (std::is_void_v<Op>) {
+        for (int j = 0; j < columns; j++)
+          d[j] = x.coeff(i, j);
+        std::fill(d + columns, d + rowStride, E());
+      } else {
+        for (int j = 0; j < columns; j++)
+          d[j] = Op()(d[j], x.coeff(i, j));
+      }
+    }
+  });
+}
+
 // constant time swap
-template <typename E> void Matrix<E>::swap(Matrix<E> &other) {
-  data.swap(other.data);
+template <typename E, typename A> void Matrix<E, A>::swap(Matrix<E, A> &other) {
+  std::swap(rows, other.rows);
+  std::swap(columns, other.columns);
+  std::swap(rowStride, other.rowStride);
+  buffer.swap(other.buffer);
 }
 
-template <typename E> const E &Matrix<E>::get(int r, int c) const {
-  if (r >= getN() || r < 0 || c < 0 || c >= getM())
+template <typename E, typename A>
+const E &Matrix<E, A>::get(int r, int c) const {
+  if (r >= rows || r < 0 || c < 0 || c >= columns)
     throw std::runtime_error("Invalid index pair.");
-  return data[r][c];
+  return buffer[static_cast<size_t>(r) * rowStride + c];
 }
-template <typename E> E &Matrix<E>::get(int r, int c) {
-  if (r >= getN() || r < 0 || c < 0 || c >= getM())
+template <typename E, typename A> E &Matrix<E, A>::get(int r, int c) {
+  if (r >= rows || r < 0 || c < 0 || c >= columns)
     throw std::runtime_error("Invalid index pair.");
-  return data[r][c];
+  return buffer[static_cast<size_t>(r) * rowStride + c];
 }
 
-template <typename E>
-Matrix<E> Matrix<E>::operator+(const Matrix<E> &other) const {
-  if (getN() != other.getN() || getM() != other.getM())
+template <typename E, typename A>
+template <typename X>
+Matrix<E, A> &Matrix<E, A>::operator+=(const MatrixExpression<X> &other) {
+  const X &x = other.derived();
+  if (getN() != x.getN() || getM() != x.getM())
     throw std::runtime_error("Invalid dimensions for matrix addition.");
-  Matrix<E> r(getN(), getM());
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < getM(); j++)
-      r.get(i, j) = data[i][j] + other.get(i, j);
-  return r;
+  if (x.aliases(data()))
+    evaluate<std::plus<>>(Matrix<E, A>(x));
+  else
+    evaluate<std::plus<>>(x);
+  return *this;
 }
 
-template <typename E>
-Matrix<E> Matrix<E>::operator-(const Matrix<E> &other) const {
-  if (getN() != other.getN() || getM() != other.getM())
+template <typename E, typename A>
+template <typename X>
+Matrix<E, A> &Matrix<E, A>::operator-=(const MatrixExpression<X> &other) {
+  const X &x = other.derived();
+  if (getN() != x.getN() || getM() != x.getM())
     throw std::runtime_error("Invalid dimensions for matrix subtraction.");
-  Matrix<E> r(getN(), getM());
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < getM(); j++)
-      r.get(i, j) = data[i][j] - other.get(i, j);
-  return r;
+  if (x.aliases(data()))
+    evaluate<std::minus<>>(Matrix<E, A>(x));
+  else
+    evaluate<std::minus<>>(x);
+  return *this;
 }
 
-template <typename E>
-Matrix<E> Matrix<E>::operator*(const Matrix<E> &other) const {
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::operator*=(const Matrix<E, A> &other) {
   if (getM() != other.getN())
     throw std::runtime_error("Invalid dimensions for matrix multiplication.");
-  Matrix<E> r(getN(), other.getM());
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < other.getM(); j++)
-      for (int k = 0; k < getM(); k++)
-        r.get(i, j) += data[i][k] * other.get(k, j);
-  return r;
+  if (this == &other) {
+    // the right operand is overwritten as the product is written back
+    Matrix<E, A> copy(other);
+    return *this *= copy;
+  }
+  const int p = other.columns;
+  const int newStride = static_cast<int>(paddedStride<E>(p));
+  // one gemm row panel per thread when the product runs in parallel
+  const long work = static_cast<long>(rows) * p * columns;
+  const int threads = parallel::shouldParallelize(work)
+                          ? parallel::ThreadPool::shared().size() + 1
+                          : 1;
+  const int panel = std::min(rows, kernels::detail::gemmMc * threads);
+  // padding columns of the scratch panel stay E() and are copied along
+  const auto scratch = memory::Workspace::local().borrow<E>(
+      static_cast<size_t>(panel) * newStride);
+  std::fill(scratch.begin(), scratch.end(), E());
+  // Row i of the product only depends on row i of this matrix. When the
+  // padded rows shrink, writing row panels top-down never touches rows that
+  // are yet to be read; when they grow, the same holds bottom-up.
+  const int oldStride = rowStride;
+  auto multiplyPanel = [&](int i0) {
+    const int ih = std::min(panel, rows - i0);
+    kernels::parallelGemm<E>(
+        ih, p, columns, buffer.data() + static_cast<size_t>(i0) * oldStride,
+        oldStride, other.data(), other.rowStride, scratch.data(), newStride);
+    std::copy(scratch.begin(),
+              scratch.begin() + static_cast<size_t>(ih) * newStride,
+              buffer.begin() + static_cast<size_t>(i0) * newStride);
+  };
+  if (newStride <= oldStride) {
+    for (int i0 = 0; i0 < rows; i0 += panel)
+      multiplyPanel(i0);
+    buffer.resize(static_cast<size_t>(rows) * newStride);
+  } else {
+    buffer.resize(static_cast<size_t>(rows) * newStride);
+    for (int i0 = (rows - 1) / panel * panel; i0 >= 0; i0 -= panel)
+      multiplyPanel(i0);
+  }
+  columns = p;
+  rowStride = newStride;
+  return *this;
 }
 
-template <typename E> Matrix<E> &Matrix<E>::operator+=(const Matrix<E> &other) {
-  *this = *this + other;
+template <typename E, typename A> Matrix<E, A> &Matrix<E, A>::fill(E e) {
+  const long work = static_cast<long>(rows) * columns;
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      E *d = data() + static_cast<size_t>(i) * rowStride;
+      std::fill(d, d + columns, e);
+    }
+  });
   return *this;
 }
 
-template <typename E> Matrix<E> &Matrix<E>::operator-=(const Matrix<E> &other) {
-  *this = *this - other;
+template <typename E, typename A>
+template <typename S>
+  requires(!isMatrixExpression<S>)
+Matrix<E, A> &Matrix<E, A>::operator*=(const S &s) {
+  const long work = static_cast<long>(rows) * columns;
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      E *d = data() + static_cast<size_t>(i) * rowStride;
+      for (int j = 0; j < columns; j++)
+        d[j] *= s;
+    }
+  });
   return *this;
 }
 
-template <typename E> Matrix<E> &Matrix<E>::operator*=(const Matrix<E> &other) {
-  *this = *this * other;
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::inplaceTranspose() {
+  LINOPT_METRICS_SCOPE("inplaceTranspose", rows, columns, 0, 0,
+                       2.0 * rows * columns * sizeof(E));
+  if (getM() == getN()) {
+    kernels::squareTranspose(rows, data(), rowStride);
+    return *this;
+  }
+  // 1. squeeze out the row padding: rows*columns dense entries
+  // (std::move requires distinct ranges: nothing to do without padding)
+  for (int i = 1; i < rows && columns != rowStride; i++)
+    std::move(buffer.begin() + static_cast<size_t>(i) * rowStride,
+              buffer.begin() + static_cast<size_t>(i) * rowStride + columns,
+              buffer.begin() + static_cast<size_t>(i) * columns);
+  // 2. permute the dense entries along the cycles of the transposition
+  kernels::cycleTranspose(rows, columns, data());
+  // 3. spread the columns x rows result out to its own padded stride,
+  // last row first since every row moves towards the end of the buffer
+  const int newStride = static_cast<int>(paddedStride<E>(rows));
+  const size_t newSize = static_cast<size_t>(columns) * newStride;
+  // within the capacity reserved at allocation, but for flat matrices
+  if (newSize > buffer.size())
+    buffer.resize(newSize);
+  for (int j = columns - 1; j >= 0; j--) {
+    auto source = buffer.begin() + static_cast<size_t>(j) * rows;
+    auto destination = buffer.begin() + static_cast<size_t>(j) * newStride;
+    if (source != destination)
+      std::move_backward(source, source + rows, destination + rows);
+    std::fill(destination + rows, destination + newStride, E());
+  }
+  buffer.resize(newSize);
+  std::swap(rows, columns);
+  rowStride = newStride;
   return *this;
 }
 
-template <typename E> bool Matrix<E>::operator==(const Matrix<E> &other) const {
-  if (getN() != other.getN() || getM() != other.getM())
-    return false;
-  // hopefully not too expensive
-  return data == other.data;
+template <typename E, typename A> Matrix<E, A> Matrix<E, A>::transpose() const {
+  Matrix<E, A> r(getM(), getN(), Uninitialized{}, getAllocator());
+  r.evaluate<void>(this->transposed());
+  return r;
 }
 
-template <typename E> bool Matrix<E>::operator!=(const Matrix<E> &other) const {
-  return !(*this == other);
+template <typename E, typename A>
+MatrixSpan<E> Matrix<E, A>::block(int r0, int c0, int h, int w) {
+  return MatrixSpan<E>(*this).block(r0, c0, h, w);
 }
 
-template <typename E> Matrix<E> &Matrix<E>::fill(E e) {
-  for (std::vector<E> &row : data)
-    std::fill(row.begin(), row.end(), e);
-  return *this;
+template <typename E, typename A>
+MatrixView<E> Matrix<E, A>::block(int r0, int c0, int h, int w) const {
+  return MatrixView<E>(*this).block(r0, c0, h, w);
 }
 
-template <typename E>
-template <typename S>
-Matrix<E> Matrix<E>::operator*(const S &s) const {
-  Matrix<E> r(getN(), getM());
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < getM(); j++)
-      r.get(i, j) = s * data[i][j];
-  return r;
+template <typename E, typename A>
+MatrixSpan<E> Matrix<E, A>::rowRange(int r0, int r1) {
+  return MatrixSpan<E>(*this).rowRange(r0, r1);
 }
 
-template <typename E>
-template <typename S>
-Matrix<E> &Matrix<E>::operator*=(const S &s) {
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < getM(); j++)
-      data[i][j] *= s;
-  return *this;
+template <typename E, typename A>
+MatrixView<E> Matrix<E, A>::rowRange(int r0, int r1) const {
+  return MatrixView<E>(*this).rowRange(r0, r1);
 }
 
-template <typename E> Matrix<E> &Matrix<E>::inplaceTranspose() {
-  if (getM() == getN()) {
-    // do it in place
-    for (int i = 0; i < getN(); i++)
-      for (int j = i; j < getM(); j++)
-        std::swap(data[i][j], data[j][i]);
-  } else {
-    *this = this->transpose();
-  }
-  return *this;
+template <typename E, typename A>
+MatrixSpan<E> Matrix<E, A>::columnRange(int c0, int c1) {
+  return MatrixSpan<E>(*this).columnRange(c0, c1);
 }
 
-template <typename E> Matrix<E> Matrix<E>::transpose() const {
-  Matrix<E> r(getM(), getN());
-  for (int i = 0; i < getN(); i++)
-    for (int j = 0; j < getM(); j++)
-      r.get(j, i) = data[i][j];
-  return r;
+template <typename E, typename A>
+MatrixView<E> Matrix<E, A>::columnRange(int c0, int c1) const {
+  return MatrixView<E>(*this).columnRange(c0, c1);
 }
 
-template <typename E>
+template <typename E, typename A>
 template <typename S>
-Matrix<E> &Matrix<E>::combineRows(int row1, S factor1, int row2, S factor2,
-                                  int destinationRow) {
-  if (row1 < 0 || row1 >= getN() || row2 < 0 || row2 >= getM())
+Matrix<E, A> &Matrix<E, A>::combineRows(int row1, S factor1, int row2,
+                                        S factor2, int destinationRow) {
+  if (row1 < 0 || row1 >= getN() || row2 < 0 || row2 >= getN() ||
+      destinationRow < 0 || destinationRow >= getN())
     throw std::runtime_error("Invalid row combination: bad index.");
-  for (int j = 0; j < getM(); j++)
-    data[destinationRow][j] = factor1 * data[row1][j] + factor2 * data[row2][j];
+  const E *a = data() + static_cast<size_t>(row1) * rowStride;
+  const E *b = data() + static_cast<size_t>(row2) * rowStride;
+  E *d = data() + static_cast<size_t>(destinationRow) * rowStride;
+  for (int j = 0; j < columns; j++)
+    d[j] = factor1 * a[j] + factor2 * b[j];
   return *this;
 }
-template <typename E>
-Matrix<E> &Matrix<E>::combineColumns(int column1, int factor1, int column2,
-                                     int factor2, int destinationColumn) {
-  if (column1 < 0 || column1 >= getM() || column2 < 0 || column2 >= getM())
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::combineColumns(int column1, int factor1,
+                                           int column2, int factor2,
+                                           int destinationColumn) {
+  if (column1 < 0 || column1 >= getM() || column2 < 0 || column2 >= getM() ||
+      destinationColumn < 0 || destinationColumn >= getM())
     throw std::runtime_error("Invalid column combination: bad index.");
-  for (int i = 0; i < getN(); i++)
-    data[i][destinationColumn] =
-        factor1 * data[i][column1] + factor2 * data[i][column2];
+  for (int i = 0; i < rows; i++) {
+    E *r = data() + static_cast<size_t>(i) * rowStride;
+    r[destinationColumn] = factor1 * r[column1] + factor2 * r[column2];
+  }
   return *this;
 }
 
-template <typename E>
+template <typename E, typename A>
 template <typename S>
-Matrix<E> &Matrix<E>::multiplyRow(int row, S s) {
+Matrix<E, A> &Matrix<E, A>::multiplyRow(int row, S s) {
   if (row < 0 || row >= getN())
     throw std::runtime_error("Invalid row multiplication: bad index.");
-  for (int j = 0; j < getM(); j++)
-    data[row][j] *= s;
+  E *d = data() + static_cast<size_t>(row) * rowStride;
+  for (int j = 0; j < columns; j++)
+    d[j] *= s;
   return *this;
 }
 
-template <typename E>
+template <typename E, typename A>
 template <typename S>
-Matrix<E> &Matrix<E>::multiplyColumn(int column, S s) {
+Matrix<E, A> &Matrix<E, A>::multiplyColumn(int column, S s) {
   if (column < 0 || column >= getM())
     throw std::runtime_error("Invalid column multiplication: bad index.");
-  for (int i = 0; i < getN(); i++)
-    data[i][column] *= s;
+  for (int i = 0; i < rows; i++)
+    buffer[static_cast<size_t>(i) * rowStride + column] *= s;
   return *this;
 }
 
-template <typename E>
-std::ostream &operator<<(std::ostream &os, const Matrix<E> &matrix) {
+template <typename L, typename R>
+Matrix<typename L::value_type, typename L::allocator_type>
+operator*(const MatrixExpression<L> &l, const MatrixExpression<R> &r) {
+  using E = typename L::value_type;
+  static_assert(std::is_same_v<E, typename R::value_type>,
+                "Matrix expressions must have the same entry type.");
+  if (l.derived().getM() != r.derived().getN())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  Matrix<E, typename L::allocator_type> c(
+      l.derived().getN(), r.derived().getM(), l.derived().getAllocator());
+  multiply(l, r, MatrixSpan<E>(c));
+  return c;
+}
+
+template <typename E, typename A>
+std::ostream &operator<<(std::ostream &os, const Matrix<E, A> &matrix) {
   os << matrix.getN() << ' ' << matrix.getM() << ' ';
-  for (int i = 0; i < matrix.getN(); i++)
+  for (int i = 0; i < matrix.getN(); i++) {
+    const E *row = matrix.data() + static_cast<size_t>(i) * matrix.stride();
     for (int j = 0; j < matrix.getM(); j++)
-      os << matrix.data[i][j] << ' ';
+      os << row[j] << ' ';
+  }
   return os;
 }
 
-template <typename E>
-std::istream &operator>>(std::istream &is, Matrix<E> &matrix) {
+template <typename E, typename A>
+std::istream &operator>>(std::istream &is, Matrix<E, A> &matrix) {
   int n = 0, m = 0;
   is >> n >> m;
-  matrix.data = std::vector<std::vector<E>>(n, std::vector<int>(m, E()));
-  for (int i = 0; i < matrix.getN(); i++)
-    for (int j = 0; j < matrix.getM(); j++)
-      is >> matrix.data[i][j];
+  Matrix<E, A> r(n, m, matrix.getAllocator());
+  for (int i = 0; i < n; i++) {
+    E *row = r.data() + static_cast<size_t>(i) * r.stride();
+    for (int j = 0; j < m; j++)
+      is >> row[j];
+  }
+  matrix.swap(r);
   return is;
 }
 
-template <typename E> Matrix<E> &Matrix<E>::fillRow(int row, E e) {
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::fillRow(int row, E e) {
   if (row < 0 || row >= getN())
     throw std::runtime_error("Invalid row fill: bad index.");
-  std::fill(data[row].begin(), data[row].end(), e);
+  E *d = data() + static_cast<size_t>(row) * rowStride;
+  std::fill(d, d + columns, e);
   return *this;
 }
 
-template <typename E> Matrix<E> &Matrix<E>::fillColumn(int column, E e) {
+template <typename E, typename A>
+Matrix<E, A> &Matrix<E, A>::fillColumn(int column, E e) {
   if (column < 0 || column >= getM())
     throw std::runtime_error("Invalid column fill: bad index.");
-  for (int i = 0; i < getN(); i++)
-    data[i][column] = E(e);
+  for (int i = 0; i < rows; i++)
+    buffer[static_cast<size_t>(i) * rowStride + column] = E(e);
   return *this;
 }
 
@@ -0,0 +1,280 @@
+/**
+ * \file MatrixExpression.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the lazy matrix expressions built by +, -, scalar * and transposed().
+ * \details
+ *  Elementwise arithmetic on matrices does not compute anything by itself:
+ *  it returns a lightweight expression object recording the operation and
+ *  its operands. The expression is evaluated in a single fused pass when
+ *  it is assigned to (or used to construct) a \sa linopt::inmemory::Matrix<E>,
+ *  so that a chain like a + b - c * 2.0 allocates nothing but its result.
+ *
+ *  Matrix operands are held by reference, sub-expressions by value: an
+ *  expression must not outlive the matrices it refers to. Store results in
+ *  a Matrix<E>, not in an auto variable.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_MATRIXEXPRESSION_H
+#define LINOPT_ERC_INMEMORY_MATRIX_MATRIXEXPRESSION_H
+
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "AlignedAllocator.h"
+
+namespace linopt::inmemory {
+
+template <typename E, typename A = AlignedAllocator<E>> class Matrix;
+template <typename X> class TransposeExpression;
+
+/**
+ * \brief CRTP base class of everything that can be evaluated into a matrix.
+ *
+ * A derived expression X provides:
+ * - value_type, the type of its entries;
+ * - allocator_type and allocator_type getAllocator() const, the allocator
+ *   of its first matrix operand (the default one if it has none), used for
+ *   the matrices it is evaluated into;
+ * - int getN() const and int getM() const, its dimensions;
+ * - value_type coeff(int r, int c) const, unchecked entry evaluation;
+ * - bool refersTo(const void *p) const, true iff a matrix operand stores its entries at p;
+ * - bool aliases(const void *p) const, true iff computing entry (r,c) may
+ *   read an entry other than (r,c) of the matrix stored at p.
+ */
+template <typename X> class MatrixExpression {
+public:
+  /**
+   * \brief The derived expression.
+   */
+  const X &derived() const { return static_cast<const X &>(*this); }
+
+  /**
+   * \brief Checked entry evaluation.
+   *
+   * Does bounds-checking.
+   * \param r: the row index (starting at 0).
+   * \param c: the column index (starting at 0).
+   * \return the value of entry (r,c) of the expression.
+   */
+  auto get(int r, int c) const {
+    if (r < 0 || r >= derived().getN() || c < 0 || c >= derived().getM())
+      throw std::runtime_error("Invalid index pair.");
+    return derived().coeff(r, c);
+  }
+
+  /**
+   * \brief Evaluates the expression.
+   * \return a new matrix holding the value of the expression, allocated
+   * by the allocator of its first matrix operand.
+   */
+  auto eval() const {
+    return Matrix<typename X::value_type, typename X::allocator_type>(
+        *this, derived().getAllocator());
+  }
+
+  /**
+   * \brief Lazy transpose of the expression.
+   * \return an expression whose entry (r,c) is entry (c,r) of this one.
+   */
+  TransposeExpression<X> transposed() const {
+    return TransposeExpression<X>(derived());
+  }
+};
+
+/**
+ * \brief true iff T is a matrix expression (a Matrix<E> included).
+ */
+template <typename T>
+inline constexpr bool isMatrixExpression =
+    std::is_base_of_v<MatrixExpression<std::remove_cvref_t<T>>,
+                      std::remove_cvref_t<T>>;
+
+/**
+ * \brief true iff T is a Matrix<E, A> (of any allocator).
+ */
+template <typename T> inline constexpr bool isMatrix = false;
+template <typename E, typename A>
+inline constexpr bool isMatrix<Matrix<E, A>> = true;
+
+namespace detail {
+/**
+ * \brief Matrices are captured by reference, expressions (temporaries) by value.
+ */
+template <typename X> struct OperandStorage {
+  using type = const X;
+};
+template <typename E, typename A> struct OperandStorage<Matrix<E, A>> {
+  using type = const Matrix<E, A> &;
+};
+} // namespace detail
+
+/**
+ * \brief Lazy elementwise binary operation Op(l(r,c), r(r,c)).
+ */
+template <typename L, typename R, typename Op>
+class BinaryExpression : public MatrixExpression<BinaryExpression<L, R, Op>> {
+private:
+  typename detail::OperandStorage<L>::type left;
+  typename detail::OperandStorage<R>::type right;
+
+public:
+  using value_type = typename L::value_type;
+  using allocator_type = typename L::allocator_type;
+  static_assert(std::is_same_v<value_type, typename R::value_type>,
+                "Matrix expressions must have the same entry type.");
+
+  BinaryExpression(const L &l, const R &r) : left(l), right(r) {}
+
+  allocator_type getAllocator() const { return left.getAllocator(); }
+  int getN() const { return left.getN(); }
+  int getM() const { return left.getM(); }
+  value_type coeff(int r, int c) const {
+    return Op()(left.coeff(r, c), right.coeff(r, c));
+  }
+  bool refersTo(const void *p) const {
+    return left.refersTo(p) || right.refersTo(p);
+  }
+  bool aliases(const void *p) const {
+    return left.aliases(p) || right.aliases(p);
+  }
+};
+
+/**
+ * \brief Lazy product of every entry by a scalar: s * x(r,c).
+ */
+template <typename X, typename S>
+class ScaleExpression : public MatrixExpression<ScaleExpression<X, S>> {
+private:
+  typename detail::OperandStorage<X>::type operand;
+  S s;
+
+public:
+  using value_type = typename X::value_type;
+  using allocator_type = typename X::allocator_type;
+
+  ScaleExpression(const X &x, const S &s) : operand(x), s(s) {}
+
+  allocator_type getAllocator() const { return operand.getAllocator(); }
+  int getN() const { return operand.getN(); }
+  int getM() const { return operand.getM(); }
+  value_type coeff(int r, int c) const { return s * operand.coeff(r, c); }
+  bool refersTo(const void *p) const { return operand.refersTo(p); }
+  bool aliases(const void *p) const { return operand.aliases(p); }
+};
+
+/**
+ * \brief Lazy transpose: entry (r,c) is entry (c,r) of the operand.
+ */
+template <typename X>
+class TransposeExpression : public MatrixExpression<TransposeExpression<X>> {
+private:
+  typename detail::OperandStorage<X>::type operand;
+
+public:
+  using value_type = typename X::value_type;
+  using allocator_type = typename X::allocator_type;
+
+  explicit TransposeExpression(const X &x) : operand(x) {}
+
+  /**
+   * \brief The expression being transposed.
+   */
+  const X &nested() const { return operand; }
+
+  allocator_type getAllocator() const { return operand.getAllocator(); }
+  int getN() const { return operand.getM(); }
+  int getM() const { return operand.getN(); }
+  value_type coeff(int r, int c) const { return operand.coeff(c, r); }
+  bool refersTo(const void *p) const { return operand.refersTo(p); }
+  // entry (r,c) reads (c,r): any use of the buffer is an alias
+  bool aliases(const void *p) const { return operand.refersTo(p); }
+};
+
+/**
+ * \brief Sums two matrix expressions with matching dimensions.
+ *
+ * If the dimensions don't match, a runtime_error is thrown.
+ *
+ * \return a lazy expression of the sum, evaluated on assignment.
+ */
+template <typename L, typename R>
+BinaryExpression<L, R, std::plus<>> operator+(const MatrixExpression<L> &l,
+                                              const MatrixExpression<R> &r) {
+  if (l.derived().getN() != r.derived().getN() ||
+      l.derived().getM() != r.derived().getM())
+    throw std::runtime_error("Invalid dimensions for matrix addition.");
+  return {l.derived(), r.derived()};
+}
+
+/**
+ * \brief Subtracts matrix expression r from l; dimensions must match.
+ *
+ * If the dimensions don't match, a runtime_error is thrown.
+ *
+ * \return a lazy expression of the difference, evaluated on assignment.
+ */
+template <typename L, typename R>
+BinaryExpression<L, R, std::minus<>> operator-(const MatrixExpression<L> &l,
+                                               const MatrixExpression<R> &r) {
+  if (l.derived().getN() != r.derived().getN() ||
+      l.derived().getM() != r.derived().getM())
+    throw std::runtime_error("Invalid dimensions for matrix subtraction.");
+  return {l.derived(), r.derived()};
+}
+
+/**
+ * \brief Multiply each entry of the expression by scalar s.
+ *
+ * The type S is a "scalar" type; *ie*: a type that can be multiplied by an entry of type E
+ * and yield a result of type E.
+ *
+ * \return a lazy expression M st M.get(i,j)==s*x.get(i,j) for all valid (i,j).
+ */
+template <typename X, typename S>
+  requires(!isMatrixExpression<S>)
+ScaleExpression<X, S> operator*(const MatrixExpression<X> &x, const S &s) {
+  return {x.derived(), s};
+}
+
+/**
+ * \brief Multiplies two expressions with appropriate dimensions.
+ *
+ * Matrices and views with contiguous rows are read in place, other
+ * operands are evaluated first, then the product runs on the gemm kernel.
+ * \return the product l * r, allocated by the allocator of l.
+ */
+template <typename L, typename R>
+Matrix<typename L::value_type, typename L::allocator_type>
+operator*(const MatrixExpression<L> &l, const MatrixExpression<R> &r);
+
+/**
+ * \brief Equality operator.
+ * \return true iff the expressions have the same dimensions and
+ * each corresponding entry compares equal. false otherwise.
+ */
+template <typename L, typename R>
+bool operator==(const MatrixExpression<L> &l, const MatrixExpression<R> &r) {
+  const L &a = l.derived();
+  const R &b = r.derived();
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    return false;
+  for (int i = 0; i < a.getN(); i++)
+    for (int j = 0; j < a.getM(); j++)
+      if (!(a.coeff(i, j) == b.coeff(i, j)))
+        return false;
+  return true;
+}
+
+/**
+ * \brief Inequality operator.
+ * \return false iff the expressions have the same dimensions and
+ * each corresponding entry compares equal. true otherwise.
+ */
+template <typename L, typename R>
+bool operator!=(const MatrixExpression<L> &l, const MatrixExpression<R> &r) {
+  return !(l == r);
+}
+
+} // namespace linopt::inmemory
+#endif
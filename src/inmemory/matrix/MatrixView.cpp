@@ -0,0 +1 @@
+#include "MatrixView.h"
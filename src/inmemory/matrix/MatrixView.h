@@ -0,0 +1,343 @@
+/**
+ * \file MatrixView.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the non-owning \sa linopt::inmemory::MatrixSpan<T> views.
+ * \details
+ *  A view refers to entries stored elsewhere, in a \sa Matrix<E> or in an
+ *  external buffer, through (start, rows, cols, row stride, column stride):
+ *  entry (r,c) lives at start[r*rowStride+c*columnStride]. Row ranges,
+ *  column ranges, blocks, every k-th row or column and transposes are all
+ *  views of the same entries, taken without copying anything.
+ *
+ *  MatrixSpan<E> writes through to the entries, MatrixView<E>, an alias of
+ *  MatrixSpan<const E>, only reads them. Views are matrix expressions
+ *  (\sa MatrixExpression.h): they mix with matrices in lazy arithmetic and
+ *  products, and spans can be assigned an expression, which is written into
+ *  the viewed entries.
+ *
+ *  A view must not outlive the storage it refers to; resizing or moving a
+ *  matrix (operator*=, inplaceTranspose, assignments of other dimensions)
+ *  leaves its views dangling.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_MATRIXVIEW_H
+#define LINOPT_ERC_INMEMORY_MATRIX_MATRIXVIEW_H
+
+#include <type_traits>
+
+#include "Gemm.h"
+#include "MatrixExpression.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Non-owning, possibly strided view of nxm entries of type T.
+ *
+ * T is E for a writable view, const E for a read-only one (\sa MatrixView).
+ * Copying a view is cheap and never copies entries; assigning to a writable
+ * view writes the entries, it never rebinds the view. Aliasing between
+ * views is tracked through the buffer they were taken from: views of the
+ * same matrix, or derived from the same external view, are assumed to
+ * overlap.
+ */
+template <typename T>
+class MatrixSpan : public MatrixExpression<MatrixSpan<T>> {
+public:
+  /**
+   * \brief Type of the entries.
+   */
+  using value_type = std::remove_const_t<T>;
+
+  /**
+   * \brief Views own no buffer: expressions over them evaluate with the
+   * default allocator.
+   */
+  using allocator_type = AlignedAllocator<value_type>;
+
+private:
+  using E = value_type;
+
+  /**
+   * \brief Entry (0,0).
+   */
+  T *start = nullptr;
+  int rows = 0;
+  int columns = 0;
+  int rowStride = 0;
+  int colStride = 1;
+  /**
+   * \brief Start of the buffer the view was taken from, for aliasing checks.
+   */
+  const void *origin = nullptr;
+
+  MatrixSpan(T *start, int n, int m, int rowStride, int colStride,
+             const void *origin);
+
+  template <typename U> friend class MatrixSpan;
+
+  /**
+   * \brief Pointer to entry (r,c), unchecked.
+   */
+  T *at(int r, int c) const {
+    return start + static_cast<long>(r) * rowStride +
+           static_cast<long>(c) * colStride;
+  }
+
+  /**
+   * \brief Writes Op()(entry, x(i,j)) (x(i,j) if Op is void) into each entry.
+   */
+  template <typename Op, typename X> void evaluate(const X &x);
+
+public:
+  /**
+   * \brief Wraps an external buffer.
+   * \param data: entry (0,0).
+   * \param n: number of rows.
+   * \param m: number of columns.
+   * \param rowStride: distance, in elements, between two rows.
+   * \param columnStride: distance, in elements, between two columns.
+   */
+  MatrixSpan(T *data, int n, int m, int rowStride, int columnStride = 1);
+
+  /**
+   * \brief View of the whole matrix a.
+   */
+  template <typename A> MatrixSpan(Matrix<E, A> &a);
+
+  /**
+   * \brief Read-only view of the whole matrix a.
+   */
+  template <typename A>
+    requires std::is_const_v<T>
+  MatrixSpan(const Matrix<E, A> &a);
+
+  /**
+   * \brief Read-only view of a writable one.
+   */
+  template <typename U>
+    requires(std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+  MatrixSpan(const MatrixSpan<U> &other);
+
+  MatrixSpan(const MatrixSpan &other) = default;
+
+  /**
+   * \brief Copies the entries of other into the viewed entries.
+   *
+   * If the dimensions don't match, a runtime_error is thrown.
+   */
+  MatrixSpan &operator=(const MatrixSpan &other)
+    requires(!std::is_const_v<T>);
+
+  /**
+   * \brief Evaluates x into the viewed entries.
+   *
+   * If the dimensions don't match, a runtime_error is thrown. An expression
+   * reading the buffer of this view is evaluated into a temporary first.
+   */
+  template <typename X>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &operator=(const MatrixExpression<X> &x);
+
+  /**
+   * \brief The default allocator, \sa allocator_type.
+   */
+  allocator_type getAllocator() const { return allocator_type(); }
+
+  /**
+   * \brief Get the number of rows in the view.
+   */
+  int getN() const { return rows; }
+
+  /**
+   * \brief Get the number of columns in the view.
+   */
+  int getM() const { return columns; }
+
+  /**
+   * \brief Distance, in elements, between the starts of two rows.
+   */
+  int stride() const { return rowStride; }
+
+  /**
+   * \brief Distance, in elements, between two entries of a row.
+   */
+  int columnStride() const { return colStride; }
+
+  /**
+   * \brief Pointer to entry (0,0).
+   */
+  T *data() const { return start; }
+
+  /**
+   * \brief Checked entry access.
+   *
+   * Does bounds-checking.
+   * \param r: the row index (starting at 0).
+   * \param c: the column index (starting at 0).
+   */
+  T &get(int r, int c) const;
+
+  /**
+   * \brief Unchecked entry access, for expressions and kernels.
+   */
+  const E &coeff(int r, int c) const { return *at(r, c); }
+
+  /**
+   * \brief Start of the buffer the view was taken from: the data() of its
+   * matrix, or the external buffer it (or the view it derives from) wraps.
+   */
+  const void *base() const { return origin; }
+
+  /**
+   * \brief Whether this view was taken from the buffer starting at p.
+   */
+  bool refersTo(const void *p) const { return p == origin; }
+
+  /**
+   * \brief A view may sit anywhere in its buffer: any use of it is an alias.
+   */
+  bool aliases(const void *p) const { return p == origin; }
+
+  /**
+   * \brief View of the hxw block whose top left entry is (r0,c0).
+   *
+   * Throws a runtime_error if the block is not inside the view.
+   */
+  MatrixSpan block(int r0, int c0, int h, int w) const;
+
+  /**
+   * \brief View of rows r0 to r1-1.
+   */
+  MatrixSpan rowRange(int r0, int r1) const;
+
+  /**
+   * \brief View of columns c0 to c1-1.
+   */
+  MatrixSpan columnRange(int c0, int c1) const;
+
+  /**
+   * \brief View of every rowStep-th row and columnStep-th column, starting
+   * with entry (0,0).
+   */
+  MatrixSpan strided(int rowStep, int columnStep) const;
+
+  /**
+   * \brief View of the transpose; writes go to the entries of this view.
+   */
+  MatrixSpan transposedView() const;
+
+  /**
+   * \brief Adds x to the viewed entries.
+   *
+   * If the dimensions don't match, a runtime_error is thrown.
+   */
+  template <typename X>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &operator+=(const MatrixExpression<X> &x);
+
+  /**
+   * \brief Subtracts x from the viewed entries.
+   *
+   * If the dimensions don't match, a runtime_error is thrown.
+   */
+  template <typename X>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &operator-=(const MatrixExpression<X> &x);
+
+  /**
+   * \brief Multiplies each viewed entry by scalar s.
+   */
+  template <typename S>
+    requires(!std::is_const_v<T> && !isMatrixExpression<S>)
+  MatrixSpan &operator*=(const S &s);
+
+  /**
+   * \brief Fills the view with E(e).
+   */
+  MatrixSpan &fill(E e)
+    requires(!std::is_const_v<T>);
+
+  /**
+   * \brief Fills row of the view with E(e).
+   *
+   * Does bounds-checking.
+   */
+  MatrixSpan &fillRow(int row, E e)
+    requires(!std::is_const_v<T>);
+
+  /**
+   * \brief Fills column of the view with E(e).
+   *
+   * Does bounds-checking.
+   */
+  MatrixSpan &fillColumn(int column, E e)
+    requires(!std::is_const_v<T>);
+
+  /**
+   * \brief Performs destinationRow = factor1*row1 + factor2*row2.
+   *
+   * Does bounds-checking. \sa Matrix<E>::combineRows.
+   */
+  template <typename S>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &combineRows(int row1, S factor1, int row2, S factor2,
+                          int destinationRow);
+
+  /**
+   * \brief Performs destinationColumn = factor1*column1 + factor2*column2.
+   *
+   * Does bounds-checking. \sa Matrix<E>::combineColumns.
+   */
+  template <typename S>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &combineColumns(int column1, S factor1, int column2, S factor2,
+                             int destinationColumn);
+
+  /**
+   * \brief Performs row = row*s.
+   *
+   * Does bounds-checking.
+   */
+  template <typename S>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &multiplyRow(int row, S s);
+
+  /**
+   * \brief Performs column = column*s.
+   *
+   * Does bounds-checking.
+   */
+  template <typename S>
+    requires(!std::is_const_v<T>)
+  MatrixSpan &multiplyColumn(int column, S s);
+}; // class MatrixSpan<T>
+
+/**
+ * \brief Read-only view of entries of type E.
+ */
+template <typename E> using MatrixView = MatrixSpan<const E>;
+
+/**
+ * \brief true iff T is a MatrixSpan (of any constness).
+ */
+template <typename T> inline constexpr bool isMatrixSpan = false;
+template <typename T> inline constexpr bool isMatrixSpan<MatrixSpan<T>> = true;
+
+/**
+ * \brief Computes c = a*b, c += a*b or c -= a*b, depending on update, into
+ * the entries viewed by c.
+ *
+ * Matrices and views whose rows are contiguous go to the gemm kernel in
+ * place; other operands are evaluated first. If the dimensions are not
+ * appropriate, a runtime_error is thrown.
+ */
+template <typename L, typename R>
+void multiply(const MatrixExpression<L> &a, const MatrixExpression<R> &b,
+              MatrixSpan<typename L::value_type> c,
+              kernels::GemmUpdate update = kernels::GemmUpdate::overwrite);
+
+} // namespace linopt::inmemory
+
+#include "MatrixView.tpp"
+#include "Matrix.h"
+#endif
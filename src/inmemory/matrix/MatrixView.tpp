@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Read-only view of x suitable for the gemm kernel: x itself when
+ * its rows are contiguous, otherwise x evaluated into storage.
+ */
+template <typename E, typename X>
+MatrixView<E> gemmOperand(const X &x, std::optional<Matrix<E>> &storage) {
+  if constexpr (isMatrix<X>) {
+    return MatrixView<E>(x);
+  } else {
+    if constexpr (isMatrixSpan<X>)
+      if (x.columnStride() == 1)
+        return MatrixView<E>(x);
+    storage.emplace(x);
+    return MatrixView<E>(*storage);
+  }
+}
+
+} // namespace detail
+
+template <typename T>
+MatrixSpan<T>::MatrixSpan(T *start, int n, int m, int rowStride,
+                          int colStride, const void *origin)
+    : start(start), rows(n), columns(m), rowStride(rowStride),
+      colStride(colStride), origin(origin) {}
+
+template <typename T>
+MatrixSpan<T>::MatrixSpan(T *data, int n, int m, int rowStride,
+                          int columnStride)
+    : MatrixSpan(data, n, m, rowStride, columnStride, data) {
+  if (n < 1 || m < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+  if (rowStride < 1 || columnStride < 1)
+    throw std::runtime_error("Invalid view stride (<1).");
+}
+
+template <typename T>
+template <typename A>
+MatrixSpan<T>::MatrixSpan(Matrix<E, A> &a)
+    : MatrixSpan(a.data(), a.getN(), a.getM(), a.stride(), 1, a.data()) {}
+
+template <typename T>
+template <typename A>
+  requires std::is_const_v<T>
+MatrixSpan<T>::MatrixSpan(const Matrix<E, A> &a)
+    : MatrixSpan(a.data(), a.getN(), a.getM(), a.stride(), 1, a.data()) {}
+
+template <typename T>
+template <typename U>
+  requires(std::is_same_v<const U, T> && !std::is_same_v<U, T>)
+MatrixSpan<T>::MatrixSpan(const MatrixSpan<U> &other)
+    : MatrixSpan(other.start, other.rows, other.columns, other.rowStride,
+                 other.colStride, other.origin) {}
+
+template <typename T>
+MatrixSpan<T> &MatrixSpan<T>::operator=(const MatrixSpan &other)
+  requires(!std::is_const_v<T>)
+{
+  return *this = static_cast<const MatrixExpression<MatrixSpan> &>(other);
+}
+
+template <typename T>
+template <typename X>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::operator=(const MatrixExpression<X> &x) {
+  const X &expression = x.derived();
+  if (rows != expression.getN() || columns != expression.getM())
+    throw std::runtime_error("Invalid dimensions for matrix assignment.");
+  if (expression.refersTo(origin))
+    evaluate<void>(Matrix<E>(expression));
+  else
+    evaluate<void>(expression);
+  return *this;
+}
+
+template <typename T>
+template <typename Op, typename X>
+void MatrixSpan<T>::evaluate(const X &x) {
+  const long work = static_cast<long>(rows) * columns;
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      T *d = at(i, 0);
+      if (colStride == 1) {
+        for (int j = 0; j < columns; j++) {
+          if constexpr (std::is_void_v<Op>)
+            d[j] = x.coeff(i, j);
+          else
+            d[j] = Op()(d[j], x.coeff(i, j));
+        }
+      } else {
+        for (int j = 0; j < columns; j++) {
+          T &e = d[static_cast<long>(j) * colStride];
+          if constexpr (std::is_void_v<Op>)
+            e = x.coeff(i, j);
+          else
+            e = Op()(e, x.coeff(i, j));
+        }
+      }
+    }
+  });
+}
+
+template <typename T> T &MatrixSpan<T>::get(int r, int c) const {
+  if (r < 0 || r >= rows || c < 0 || c >= columns)
+    throw std::runtime_error("Invalid index pair.");
+  return *at(r, c);
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::block(int r0, int c0, int h, int w) const {
+  if (h < 1 || w < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+  if (r0 < 0 || c0 < 0 || r0 + h > rows || c0 + w > columns)
+    throw std::runtime_error("Out of bounds block access.");
+  return MatrixSpan(at(r0, c0), h, w, rowStride, colStride, origin);
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::rowRange(int r0, int r1) const {
+  return block(r0, 0, r1 - r0, columns);
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::columnRange(int c0, int c1) const {
+  return block(0, c0, rows, c1 - c0);
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::strided(int rowStep, int columnStep) const {
+  if (rowStep < 1 || columnStep < 1)
+    throw std::runtime_error("Invalid view stride (<1).");
+  return MatrixSpan(start, (rows + rowStep - 1) / rowStep,
+                    (columns + columnStep - 1) / columnStep,
+                    rowStride * rowStep, colStride * columnStep, origin);
+}
+
+template <typename T> MatrixSpan<T> MatrixSpan<T>::transposedView() const {
+  return MatrixSpan(start, columns, rows, colStride, rowStride, origin);
+}
+
+template <typename T>
+template <typename X>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::operator+=(const MatrixExpression<X> &x) {
+  const X &expression = x.derived();
+  if (rows != expression.getN() || columns != expression.getM())
+    throw std::runtime_error("Invalid dimensions for matrix addition.");
+  if (expression.refersTo(origin))
+    evaluate<std::plus<>>(Matrix<E>(expression));
+  else
+    evaluate<std::plus<>>(expression);
+  return *this;
+}
+
+template <typename T>
+template <typename X>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::operator-=(const MatrixExpression<X> &x) {
+  const X &expression = x.derived();
+  if (rows != expression.getN() || columns != expression.getM())
+    throw std::runtime_error("Invalid dimensions for matrix subtraction.");
+  if (expression.refersTo(origin))
+    evaluate<std::minus<>>(Matrix<E>(expression));
+  else
+    evaluate<std::minus<>>(expression);
+  return *this;
+}
+
+template <typename T>
+template <typename S>
+  requires(!std::is_const_v<T> && !isMatrixExpression<S>)
+MatrixSpan<T> &MatrixSpan<T>::operator*=(const S &s) {
+  const long work = static_cast<long>(rows) * columns;
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++)
+      for (int j = 0; j < columns; j++)
+        *at(i, j) *= s;
+  });
+  return *this;
+}
+
+template <typename T>
+MatrixSpan<T> &MatrixSpan<T>::fill(E e)
+  requires(!std::is_const_v<T>)
+{
+  const long work = static_cast<long>(rows) * columns;
+  parallel::parallelFor(0, rows, work, [&](int r0, int r1) {
+    for (int i = r0; i < r1; i++) {
+      if (colStride == 1)
+        std::fill(at(i, 0), at(i, 0) + columns, e);
+      else
+        for (int j = 0; j < columns; j++)
+          *at(i, j) = e;
+    }
+  });
+  return *this;
+}
+
+template <typename T>
+MatrixSpan<T> &MatrixSpan<T>::fillRow(int row, E e)
+  requires(!std::is_const_v<T>)
+{
+  if (row < 0 || row >= rows)
+    throw std::runtime_error("Invalid row fill: bad index.");
+  for (int j = 0; j < columns; j++)
+    *at(row, j) = e;
+  return *this;
+}
+
+template <typename T>
+MatrixSpan<T> &MatrixSpan<T>::fillColumn(int column, E e)
+  requires(!std::is_const_v<T>)
+{
+  if (column < 0 || column >= columns)
+    throw std::runtime_error("Invalid column fill: bad index.");
+  for (int i = 0; i < rows; i++)
+    *at(i, column) = e;
+  return *this;
+}
+
+template <typename T>
+template <typename S>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::combineRows(int row1, S factor1, int row2,
+                                          S factor2, int destinationRow) {
+  if (row1 < 0 || row1 >= rows || row2 < 0 || row2 >= rows ||
+      destinationRow < 0 || destinationRow >= rows)
+    throw std::runtime_error("Invalid row combination: bad index.");
+  for (int j = 0; j < columns; j++)
+    *at(destinationRow, j) = factor1 * *at(row1, j) + factor2 * *at(row2, j);
+  return *this;
+}
+
+template <typename T>
+template <typename S>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::combineColumns(int column1, S factor1,
+                                             int column2, S factor2,
+                                             int destinationColumn) {
+  if (column1 < 0 || column1 >= columns || column2 < 0 ||
+      column2 >= columns || destinationColumn < 0 ||
+      destinationColumn >= columns)
+    throw std::runtime_error("Invalid column combination: bad index.");
+  for (int i = 0; i < rows; i++)
+    *at(i, destinationColumn) =
+        factor1 * *at(i, column1) + factor2 * *at(i, column2);
+  return *this;
+}
+
+template <typename T>
+template <typename S>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::multiplyRow(int row, S s) {
+  if (row < 0 || row >= rows)
+    throw std::runtime_error("Invalid row multiplication: bad index.");
+  for (int j = 0; j < columns; j++)
+    *at(row, j) *= s;
+  return *this;
+}
+
+template <typename T>
+template <typename S>
+  requires(!std::is_const_v<T>)
+MatrixSpan<T> &MatrixSpan<T>::multiplyColumn(int column, S s) {
+  if (column < 0 || column >= columns)
+    throw std::runtime_error("Invalid column multiplication: bad index.");
+  for (int i = 0; i < rows; i++)
+    *at(i, column) *= s;
+  return *this;
+}
+
+template <typename L, typename R>
+void multiply(const MatrixExpression<L> &a, const MatrixExpression<R> &b,
+              MatrixSpan<typename L::value_type> c,
+              kernels::GemmUpdate update) {
+  using E = typename L::value_type;
+  static_assert(std::is_same_v<E, typename R::value_type>,
+                "Matrix expressions must have the same entry type.");
+  if (a.derived().getM() != b.derived().getN() ||
+      a.derived().getN() != c.getN() || b.derived().getM() != c.getM())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  std::optional<Matrix<E>> sa, sb;
+  const MatrixView<E> x = detail::gemmOperand(a.derived(), sa);
+  const MatrixView<E> y = detail::gemmOperand(b.derived(), sb);
+  const bool overlaps = x.refersTo(c.base()) || y.refersTo(c.base());
+  if (c.columnStride() == 1 && !overlaps) {
+    kernels::parallelGemm<E>(x.getN(), y.getM(), x.getM(), x.data(),
+                             x.stride(), y.data(), y.stride(), c.data(),
+                             c.stride(), update);
+    return;
+  }
+  // c is strided or shares a buffer with an operand: product aside first
+  Matrix<E> p(x.getN(), y.getM());
+  kernels::parallelGemm<E>(x.getN(), y.getM(), x.getM(), x.data(), x.stride(),
+                           y.data(), y.stride(), p.data(), p.stride());
+  switch (update) {
+  case kernels::GemmUpdate::overwrite:
+    c = p;
+    break;
+  case kernels::GemmUpdate::accumulate:
+    c += p;
+    break;
+  case kernels::GemmUpdate::subtract:
+    c -= p;
+    break;
+  }
+}
+
+} // namespace linopt::inmemory
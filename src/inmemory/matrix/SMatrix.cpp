@@ -0,0 +1 @@
+#include "SMatrix.h"
@@ -0,0 +1,250 @@
+/**
+ * \file SMatrix.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::inmemory::SMatrix<E, N, M> class.
+ * \details
+ *  A dense matrix whose dimensions are template parameters, for the small
+ *  (3x3, 4x4, 6x6, ...) matrices used in tight loops: transforms,
+ *  covariance blocks. The entries live inline, in the object itself, so a
+ *  SMatrix is never allocated on the heap unless its owner is.
+ *
+ *  Everything but the conversions from and to \sa Matrix<E> is constexpr.
+ *  Loops run over compile-time bounds and are unrolled; dimension mismatches
+ *  are compile errors instead of runtime_errors.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_SMATRIX_H
+#define LINOPT_ERC_INMEMORY_MATRIX_SMATRIX_H
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Calls f(std::integral_constant<int, I>()) for I = 0 .. Count-1, as
+ * Count statements rather than a loop.
+ */
+template <int Count, typename F> constexpr void unroll(F &&f) {
+  [&]<int... I>(std::integer_sequence<int, I...>) {
+    (f(std::integral_constant<int, I>()), ...);
+  }(std::make_integer_sequence<int, Count>());
+}
+
+/**
+ * \brief Alignment of the storage of a SMatrix<E, N, M>: the largest power
+ * of two, up to a cache line, dividing its size.
+ */
+template <typename E, int N, int M> constexpr std::size_t smatrixAlignment() {
+  const std::size_t bytes = sizeof(E) * N * M;
+  std::size_t alignment = alignof(E);
+  while (alignment < cacheLineSize && bytes % (2 * alignment) == 0)
+    alignment *= 2;
+  return alignment;
+}
+
+} // namespace detail
+
+/**
+ * \brief The SMatrix<E, N, M> class stores NxM entries of type E inline.
+ *
+ * Same requirements on E as \sa Matrix<E>; inverse() additionally needs a
+ * division. Entries are stored row-major, without padding.
+ */
+template <typename E, int N, int M> class SMatrix {
+  static_assert(N >= 1 && M >= 1, "Invalid matrix dimension (<1).");
+
+private:
+  /**
+   * \brief Entry (r,c) lives at entries[r*M+c].
+   */
+  alignas(detail::smatrixAlignment<E, N, M>()) std::array<E, N * M> entries{};
+
+public:
+  /**
+   * \brief Type of the entries.
+   */
+  using value_type = E;
+
+  /**
+   * \brief Constructs a zero-filled matrix.
+   */
+  constexpr SMatrix() = default;
+
+  /**
+   * \brief Constructs a matrix from its rows, as in
+   * SMatrix<int, 2, 3> a{{1, 2, 3}, {4, 5, 6}}.
+   *
+   * The number of rows and of entries per row are checked at compile time.
+   */
+  template <std::size_t... L> constexpr SMatrix(const E (&...rows)[L]);
+
+  /**
+   * \brief Copies a dynamic matrix of the same dimensions.
+   *
+   * Throws a runtime_error if a is not NxM.
+   */
+  explicit SMatrix(const Matrix<E> &a);
+
+  /**
+   * \brief The identity matrix.
+   */
+  static constexpr SMatrix<E, N, M> identity()
+    requires(N == M);
+
+  /**
+   * \brief Copies the NxM block of a whose top left entry is (r0,c0).
+   *
+   * Throws a runtime_error if the block is not inside a.
+   */
+  static SMatrix<E, N, M> block(const Matrix<E> &a, int r0, int c0);
+
+  /**
+   * \brief Get the number of rows in the matrix.
+   */
+  static constexpr int getN() { return N; }
+
+  /**
+   * \brief Get the number of columns in the matrix.
+   */
+  static constexpr int getM() { return M; }
+
+  /**
+   * \brief Raw access to the row-major entries, N*M contiguous elements.
+   */
+  constexpr E *data() { return entries.data(); }
+
+  /**
+   * \brief Raw read-only access to the row-major entries.
+   */
+  constexpr const E *data() const { return entries.data(); }
+
+  /**
+   * \brief Entry setter/getter, bounds-checked at compile time.
+   */
+  template <int R, int C> constexpr E &get();
+
+  /**
+   * \brief Entry getter, bounds-checked at compile time.
+   */
+  template <int R, int C> constexpr const E &get() const;
+
+  /**
+   * \brief Unchecked entry access.
+   * \param r: the row index (starting at 0).
+   * \param c: the column index (starting at 0).
+   */
+  constexpr E &operator()(int r, int c) { return entries[r * M + c]; }
+
+  /**
+   * \brief Unchecked read-only entry access.
+   */
+  constexpr const E &coeff(int r, int c) const { return entries[r * M + c]; }
+
+  /**
+   * \brief Unchecked read-only entry access.
+   */
+  constexpr const E &operator()(int r, int c) const { return coeff(r, c); }
+
+  /**
+   * \brief Copies the matrix into a dynamic one.
+   */
+  Matrix<E> toMatrix() const;
+
+  /**
+   * \brief Copies the matrix into a, top left entry at (r0,c0).
+   *
+   * Throws a runtime_error if the block is not inside a.
+   */
+  void store(Matrix<E> &a, int r0, int c0) const;
+
+  /**
+   * \brief Get the transpose of the matrix.
+   */
+  constexpr SMatrix<E, M, N> transpose() const;
+
+  /**
+   * \brief Sum of the diagonal entries.
+   */
+  constexpr E trace() const
+    requires(N == M);
+
+  /**
+   * \brief Determinant of the matrix.
+   *
+   * Closed forms up to 4x4, exact for integer entries; Gaussian elimination
+   * with partial pivoting above.
+   */
+  constexpr E determinant() const
+    requires(N == M);
+
+  /**
+   * \brief Inverse of the matrix.
+   *
+   * Adjugate closed forms up to 4x4, Gauss-Jordan elimination with partial
+   * pivoting above. Throws a runtime_error if the matrix is singular.
+   */
+  constexpr SMatrix<E, N, M> inverse() const
+    requires(N == M);
+
+  constexpr SMatrix<E, N, M> &operator+=(const SMatrix<E, N, M> &other);
+
+  constexpr SMatrix<E, N, M> &operator-=(const SMatrix<E, N, M> &other);
+
+  constexpr SMatrix<E, N, M> &operator*=(const E &s);
+
+  /**
+   * \brief In place product with a square matrix.
+   */
+  constexpr SMatrix<E, N, M> &operator*=(const SMatrix<E, M, M> &other);
+
+  constexpr bool operator==(const SMatrix<E, N, M> &other) const = default;
+}; // class SMatrix<E, N, M>
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator+(const SMatrix<E, N, M> &a,
+                                     const SMatrix<E, N, M> &b);
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator-(const SMatrix<E, N, M> &a,
+                                     const SMatrix<E, N, M> &b);
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator-(const SMatrix<E, N, M> &a);
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator*(const SMatrix<E, N, M> &a,
+                                     const std::type_identity_t<E> &s);
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator*(const std::type_identity_t<E> &s,
+                                     const SMatrix<E, N, M> &a);
+
+/**
+ * \brief Matrix product, fully unrolled.
+ *
+ * Row i of the result is accumulated as the sum over k of a(i,k) times row k
+ * of b, so that the innermost statements run along contiguous rows.
+ * Mismatched inner dimensions are a compile error.
+ */
+template <typename E, int N, int K, int L, int M>
+constexpr SMatrix<E, N, M> operator*(const SMatrix<E, N, K> &a,
+                                     const SMatrix<E, L, M> &b);
+
+/**
+ * \brief Output in the format of \sa Matrix<E>, readable back into one.
+ */
+template <typename E, int N, int M>
+std::ostream &operator<<(std::ostream &os, const SMatrix<E, N, M> &a);
+
+} // namespace linopt::inmemory
+
+#include "SMatrix.tpp"
+#endif
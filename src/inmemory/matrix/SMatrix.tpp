@@ -0,0 +1,364 @@
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief |x|, usable in constant expressions.
+ */
+template <typename E> constexpr E magnitude(const E &x) {
+  return x < E(0) ? -x : x;
+}
+
+/**
+ * \brief Row of the entry of largest magnitude in column k, from row k down.
+ */
+template <typename E, int N>
+constexpr int pivotRow(const SMatrix<E, N, N> &a, int k) {
+  int p = k;
+  for (int i = k + 1; i < N; i++)
+    if (magnitude(a(i, k)) > magnitude(a(p, k)))
+      p = i;
+  return p;
+}
+
+/**
+ * \brief Swaps rows r1 and r2 of a.
+ */
+template <typename E, int N, int M>
+constexpr void swapRows(SMatrix<E, N, M> &a, int r1, int r2) {
+  for (int j = 0; j < M; j++) {
+    const E t = a(r1, j);
+    a(r1, j) = a(r2, j);
+    a(r2, j) = t;
+  }
+}
+
+} // namespace detail
+
+template <typename E, int N, int M>
+template <std::size_t... L>
+constexpr SMatrix<E, N, M>::SMatrix(const E (&...rows)[L]) {
+  static_assert(sizeof...(L) == N, "Invalid number of rows.");
+  static_assert(((L == M) && ...), "Invalid number of entries in a row.");
+  int i = 0;
+  (
+      [&](const E *row) {
+        for (int j = 0; j < M; j++)
+          entries[i * M + j] = row[j];
+        i++;
+      }(rows),
+      ...);
+}
+
+template <typename E, int N, int M>
+SMatrix<E, N, M>::SMatrix(const Matrix<E> &a) {
+  if (a.getN() != N || a.getM() != M)
+    throw std::runtime_error("Invalid dimensions for fixed-size matrix.");
+  *this = block(a, 0, 0);
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> SMatrix<E, N, M>::identity()
+  requires(N == M)
+{
+  SMatrix<E, N, M> r;
+  detail::unroll<N>([&](auto i) { r(i, i) = E(1); });
+  return r;
+}
+
+template <typename E, int N, int M>
+SMatrix<E, N, M> SMatrix<E, N, M>::block(const Matrix<E> &a, int r0, int c0) {
+  if (r0 < 0 || c0 < 0 || r0 + N > a.getN() || c0 + M > a.getM())
+    throw std::runtime_error("Out of bounds block access.");
+  SMatrix<E, N, M> r;
+  for (int i = 0; i < N; i++) {
+    const E *row = &a.coeff(r0 + i, c0);
+    for (int j = 0; j < M; j++)
+      r(i, j) = row[j];
+  }
+  return r;
+}
+
+template <typename E, int N, int M>
+template <int R, int C>
+constexpr E &SMatrix<E, N, M>::get() {
+  static_assert(R >= 0 && R < N && C >= 0 && C < M, "Invalid index pair.");
+  return entries[R * M + C];
+}
+
+template <typename E, int N, int M>
+template <int R, int C>
+constexpr const E &SMatrix<E, N, M>::get() const {
+  static_assert(R >= 0 && R < N && C >= 0 && C < M, "Invalid index pair.");
+  return entries[R * M + C];
+}
+
+template <typename E, int N, int M>
+Matrix<E> SMatrix<E, N, M>::toMatrix() const {
+  Matrix<E> r(N, M);
+  store(r, 0, 0);
+  return r;
+}
+
+template <typename E, int N, int M>
+void SMatrix<E, N, M>::store(Matrix<E> &a, int r0, int c0) const {
+  if (r0 < 0 || c0 < 0 || r0 + N > a.getN() || c0 + M > a.getM())
+    throw std::runtime_error("Out of bounds block access.");
+  for (int i = 0; i < N; i++) {
+    E *row = a.data() + static_cast<std::size_t>(r0 + i) * a.stride() + c0;
+    for (int j = 0; j < M; j++)
+      row[j] = coeff(i, j);
+  }
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, M, N> SMatrix<E, N, M>::transpose() const {
+  SMatrix<E, M, N> r;
+  detail::unroll<N>([&](auto i) {
+    detail::unroll<M>([&](auto j) { r(j, i) = coeff(i, j); });
+  });
+  return r;
+}
+
+template <typename E, int N, int M>
+constexpr E SMatrix<E, N, M>::trace() const
+  requires(N == M)
+{
+  E t = E();
+  detail::unroll<N>([&](auto i) { t += coeff(i, i); });
+  return t;
+}
+
+template <typename E, int N, int M>
+constexpr E SMatrix<E, N, M>::determinant() const
+  requires(N == M)
+{
+  const SMatrix<E, N, M> &a = *this;
+  if constexpr (N == 1) {
+    return a(0, 0);
+  } else if constexpr (N == 2) {
+    return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+  } else if constexpr (N == 3) {
+    return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) -
+           a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+           a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+  } else if constexpr (N == 4) {
+    // Laplace expansion along the 2x2 minors of the top and bottom rows
+    const E s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+    const E s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+    const E s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+    const E s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+    const E s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+    const E s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+    const E c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+    const E c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+    const E c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+    const E c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+    const E c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+    const E c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  } else {
+    SMatrix<E, N, M> u = a;
+    E det = E(1);
+    for (int k = 0; k < N; k++) {
+      const int p = detail::pivotRow(u, k);
+      if (u(p, k) == E(0))
+        return E(0);
+      if (p != k) {
+        detail::swapRows(u, p, k);
+        det = -det;
+      }
+      det *= u(k, k);
+      for (int i = k + 1; i < N; i++) {
+        const E l = u(i, k) / u(k, k);
+        for (int j = k + 1; j < N; j++)
+          u(i, j) -= l * u(k, j);
+      }
+    }
+    return det;
+  }
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> SMatrix<E, N, M>::inverse() const
+  requires(N == M)
+{
+  const SMatrix<E, N, M> &a = *this;
+  SMatrix<E, N, M> r;
+  if constexpr (N <= 4) {
+    E det = E();
+    if constexpr (N == 1) {
+      det = a(0, 0);
+      r(0, 0) = E(1);
+    } else if constexpr (N == 2) {
+      det = determinant();
+      r = SMatrix<E, N, M>{{a(1, 1), -a(0, 1)}, {-a(1, 0), a(0, 0)}};
+    } else if constexpr (N == 3) {
+      // adjugate: the transposed cofactors
+      r(0, 0) = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+      r(0, 1) = a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2);
+      r(0, 2) = a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1);
+      r(1, 0) = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+      r(1, 1) = a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0);
+      r(1, 2) = a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2);
+      r(2, 0) = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+      r(2, 1) = a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1);
+      r(2, 2) = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+      det = a(0, 0) * r(0, 0) + a(0, 1) * r(1, 0) + a(0, 2) * r(2, 0);
+    } else {
+      // same 2x2 minors as the determinant, each used several times
+      const E s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+      const E s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+      const E s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+      const E s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+      const E s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+      const E s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+      const E c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+      const E c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+      const E c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+      const E c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+      const E c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+      const E c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+      det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+      r(0, 0) = a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+      r(0, 1) = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+      r(0, 2) = a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+      r(0, 3) = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+      r(1, 0) = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+      r(1, 1) = a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+      r(1, 2) = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+      r(1, 3) = a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+      r(2, 0) = a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+      r(2, 1) = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+      r(2, 2) = a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+      r(2, 3) = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+      r(3, 0) = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+      r(3, 1) = a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+      r(3, 2) = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+      r(3, 3) = a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+    }
+    if (det == E(0))
+      throw std::runtime_error("Singular matrix.");
+    const E inv = E(1) / det;
+    detail::unroll<N * N>([&](auto k) { r.data()[k] *= inv; });
+    return r;
+  } else {
+    // Gauss-Jordan on [a | I]
+    SMatrix<E, N, M> u = a;
+    r = identity();
+    for (int k = 0; k < N; k++) {
+      const int p = detail::pivotRow(u, k);
+      if (u(p, k) == E(0))
+        throw std::runtime_error("Singular matrix.");
+      if (p != k) {
+        detail::swapRows(u, p, k);
+        detail::swapRows(r, p, k);
+      }
+      const E inv = E(1) / u(k, k);
+      for (int j = 0; j < N; j++) {
+        u(k, j) *= inv;
+        r(k, j) *= inv;
+      }
+      for (int i = 0; i < N; i++) {
+        if (i == k || u(i, k) == E(0))
+          continue;
+        const E l = u(i, k);
+        for (int j = 0; j < N; j++) {
+          u(i, j) -= l * u(k, j);
+          r(i, j) -= l * r(k, j);
+        }
+      }
+    }
+    return r;
+  }
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> &
+SMatrix<E, N, M>::operator+=(const SMatrix<E, N, M> &other) {
+  detail::unroll<N * M>([&](auto k) { entries[k] += other.entries[k]; });
+  return *this;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> &
+SMatrix<E, N, M>::operator-=(const SMatrix<E, N, M> &other) {
+  detail::unroll<N * M>([&](auto k) { entries[k] -= other.entries[k]; });
+  return *this;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> &SMatrix<E, N, M>::operator*=(const E &s) {
+  detail::unroll<N * M>([&](auto k) { entries[k] *= s; });
+  return *this;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> &
+SMatrix<E, N, M>::operator*=(const SMatrix<E, M, M> &other) {
+  *this = *this * other;
+  return *this;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator+(const SMatrix<E, N, M> &a,
+                                     const SMatrix<E, N, M> &b) {
+  SMatrix<E, N, M> r = a;
+  return r += b;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator-(const SMatrix<E, N, M> &a,
+                                     const SMatrix<E, N, M> &b) {
+  SMatrix<E, N, M> r = a;
+  return r -= b;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator-(const SMatrix<E, N, M> &a) {
+  SMatrix<E, N, M> r;
+  return r -= a;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator*(const SMatrix<E, N, M> &a,
+                                     const std::type_identity_t<E> &s) {
+  SMatrix<E, N, M> r = a;
+  return r *= s;
+}
+
+template <typename E, int N, int M>
+constexpr SMatrix<E, N, M> operator*(const std::type_identity_t<E> &s,
+                                     const SMatrix<E, N, M> &a) {
+  return a * s;
+}
+
+template <typename E, int N, int K, int L, int M>
+constexpr SMatrix<E, N, M> operator*(const SMatrix<E, N, K> &a,
+                                     const SMatrix<E, L, M> &b) {
+  static_assert(K == L, "Invalid dimensions for matrix multiplication.");
+  SMatrix<E, N, M> c;
+  detail::unroll<N>([&](auto i) {
+    detail::unroll<K>([&](auto k) {
+      const E aik = a(i, k);
+      detail::unroll<M>([&](auto j) { c(i, j) += aik * b(k, j); });
+    });
+  });
+  return c;
+}
+
+template <typename E, int N, int M>
+std::ostream &operator<<(std::ostream &os, const SMatrix<E, N, M> &a) {
+  os << N << ' ' << M << ' ';
+  for (int i = 0; i < N; i++)
+    for (int j = 0; j < M; j++)
+      os << a(i, j) << ' ';
+  return os;
+}
+
+} // namespace linopt::inmemory
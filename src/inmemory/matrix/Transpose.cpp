@@ -0,0 +1,150 @@
+#include "Transpose.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "Gemm.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINOPT_TRANSPOSE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace linopt::inmemory::kernels::detail {
+
+namespace {
+
+// The entries are moved as opaque 4 or 8 byte words: memcpy and the
+// intrinsics loads/stores may alias any type.
+template <int W>
+inline void transposeScalar(int rows, int cols, const char *src, int lds,
+                            char *dst, int ldd) {
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      std::memcpy(dst + (static_cast<std::size_t>(j) * ldd + i) * W,
+                  src + (static_cast<std::size_t>(i) * lds + j) * W, W);
+}
+
+#ifdef LINOPT_TRANSPOSE_X86
+// 8x8 tile of 32-bit words, entirely in ymm registers
+[[gnu::target("avx2")]] inline void tile32(const char *src, int lds,
+                                           char *dst, int ldd) {
+  __m256 r[8], t[8];
+  for (int i = 0; i < 8; i++)
+    r[i] = _mm256_loadu_ps(
+        reinterpret_cast<const float *>(src + static_cast<std::size_t>(i) * lds * 4));
+  for (int i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+  }
+  for (int i = 0; i < 8; i += 4) {
+    r[i] = _mm256_shuffle_ps(t[i], t[i + 2], 0x44);
+    r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], 0xEE);
+    r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0x44);
+    r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], 0xEE);
+  }
+  for (int i = 0; i < 4; i++) {
+    t[i] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x20);
+    t[i + 4] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x31);
+  }
+  for (int i = 0; i < 8; i++)
+    _mm256_storeu_ps(
+        reinterpret_cast<float *>(dst + static_cast<std::size_t>(i) * ldd * 4),
+        t[i]);
+}
+
+// 4x4 tile of 64-bit words
+[[gnu::target("avx2")]] inline void tile64(const char *src, int lds,
+                                           char *dst, int ldd) {
+  __m256d r[4], t[4];
+  for (int i = 0; i < 4; i++)
+    r[i] = _mm256_loadu_pd(reinterpret_cast<const double *>(
+        src + static_cast<std::size_t>(i) * lds * 8));
+  t[0] = _mm256_unpacklo_pd(r[0], r[1]);
+  t[1] = _mm256_unpackhi_pd(r[0], r[1]);
+  t[2] = _mm256_unpacklo_pd(r[2], r[3]);
+  t[3] = _mm256_unpackhi_pd(r[2], r[3]);
+  r[0] = _mm256_permute2f128_pd(t[0], t[2], 0x20);
+  r[1] = _mm256_permute2f128_pd(t[1], t[3], 0x20);
+  r[2] = _mm256_permute2f128_pd(t[0], t[2], 0x31);
+  r[3] = _mm256_permute2f128_pd(t[1], t[3], 0x31);
+  for (int i = 0; i < 4; i++)
+    _mm256_storeu_pd(reinterpret_cast<double *>(
+                         dst + static_cast<std::size_t>(i) * ldd * 8),
+                     r[i]);
+}
+
+template <int W>
+[[gnu::target("avx2"), gnu::flatten]] void
+transposeLeafAvx2(int rows, int cols, const char *src, int lds, char *dst,
+                  int ldd) {
+  constexpr int t = W == 4 ? 8 : 4;
+  const int rowsTiled = rows / t * t, colsTiled = cols / t * t;
+  for (int i = 0; i < rowsTiled; i += t)
+    for (int j = 0; j < colsTiled; j += t) {
+      const char *s = src + (static_cast<std::size_t>(i) * lds + j) * W;
+      char *d = dst + (static_cast<std::size_t>(j) * ldd + i) * W;
+      if constexpr (W == 4)
+        tile32(s, lds, d, ldd);
+      else
+        tile64(s, lds, d, ldd);
+    }
+  // ragged right and bottom edges
+  transposeScalar<W>(rowsTiled, cols - colsTiled,
+                     src + static_cast<std::size_t>(colsTiled) * W, lds,
+                     dst + static_cast<std::size_t>(colsTiled) * ldd * W, ldd);
+  transposeScalar<W>(rows - rowsTiled, cols,
+                     src + static_cast<std::size_t>(rowsTiled) * lds * W, lds,
+                     dst + static_cast<std::size_t>(rowsTiled) * W, ldd);
+}
+#endif
+
+template <int W>
+void transposeLeaf(int rows, int cols, const char *src, int lds, char *dst,
+                   int ldd) {
+#ifdef LINOPT_TRANSPOSE_X86
+  if (activeIsa() != Isa::scalar) {
+    transposeLeafAvx2<W>(rows, cols, src, lds, dst, ldd);
+    return;
+  }
+#endif
+  transposeScalar<W>(rows, cols, src, lds, dst, ldd);
+}
+
+// same recursion as transposeRecursive, on raw words, down to L1 sized leaves
+template <int W>
+void transposeWords(int rows, int cols, const char *src, int lds, char *dst,
+                    int ldd) {
+  constexpr long leaf = 4096 / W;
+  if (static_cast<long>(rows) * cols <= leaf || (rows <= 8 && cols <= 8)) {
+    transposeLeaf<W>(rows, cols, src, lds, dst, ldd);
+  } else if (rows >= cols) {
+    const int half = rows / 2 / 8 * 8 > 0 ? rows / 2 / 8 * 8 : rows / 2;
+    transposeWords<W>(half, cols, src, lds, dst, ldd);
+    transposeWords<W>(rows - half, cols,
+                      src + static_cast<std::size_t>(half) * lds * W, lds,
+                      dst + static_cast<std::size_t>(half) * W, ldd);
+  } else {
+    const int half = cols / 2 / 8 * 8 > 0 ? cols / 2 / 8 * 8 : cols / 2;
+    transposeWords<W>(rows, half, src, lds, dst, ldd);
+    transposeWords<W>(rows, cols - half,
+                      src + static_cast<std::size_t>(half) * W, lds,
+                      dst + static_cast<std::size_t>(half) * ldd * W, ldd);
+  }
+}
+
+} // namespace
+
+void transpose32(int rows, int cols, const void *src, int lds, void *dst,
+                 int ldd) {
+  transposeWords<4>(rows, cols, static_cast<const char *>(src), lds,
+                    static_cast<char *>(dst), ldd);
+}
+
+void transpose64(int rows, int cols, const void *src, int lds, void *dst,
+                 int ldd) {
+  transposeWords<8>(rows, cols, static_cast<const char *>(src), lds,
+                    static_cast<char *>(dst), ldd);
+}
+
+} // namespace linopt::inmemory::kernels::detail
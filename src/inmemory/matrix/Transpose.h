@@ -0,0 +1,75 @@
+/**
+ * \file Transpose.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the matrix transposition kernels.
+ * \details
+ *  Out-of-place transposition recursively halves the larger dimension
+ *  until a block (source and destination) fits in L1, so that it is cache
+ *  efficient whatever the cache sizes. For trivially copyable 4 and 8 byte
+ *  entries the blocks are transposed by 8x8 / 4x4 tiles held in AVX
+ *  registers when the host supports AVX2.
+ *
+ *  In-place transposition of a non-square matrix follows the cycles of the
+ *  transposition permutation, using one bit of bookkeeping per entry.
+ */
+#ifndef LINOPT_ERC_INMEMORY_MATRIX_TRANSPOSE_H
+#define LINOPT_ERC_INMEMORY_MATRIX_TRANSPOSE_H
+
+#include <cstddef>
+
+namespace linopt::inmemory::kernels {
+
+/**
+ * \brief Writes the transpose of the rows x cols block src into dst.
+ *
+ * Both blocks are row-major; dst is cols x rows. They must not overlap.
+ * \param rows: number of rows of src.
+ * \param cols: number of columns of src.
+ * \param src: pointer to entry (0,0) of src.
+ * \param lds: row stride of src, in elements.
+ * \param dst: pointer to entry (0,0) of dst.
+ * \param ldd: row stride of dst, in elements.
+ */
+template <typename E>
+void transpose(int rows, int cols, const E *src, int lds, E *dst, int ldd);
+
+/**
+ * \brief Same as \sa transpose, split over destination row blocks run in
+ * parallel when the current execution policy allows it.
+ */
+template <typename E>
+void parallelTranspose(int rows, int cols, const E *src, int lds, E *dst,
+                       int ldd);
+
+/**
+ * \brief Transposes the n x n block a in place.
+ * \param n: number of rows and columns.
+ * \param a: pointer to entry (0,0).
+ * \param lda: row stride, in elements.
+ */
+template <typename E> void squareTranspose(int n, E *a, int lda);
+
+/**
+ * \brief Transposes a dense (unpadded) rows x cols matrix in place.
+ *
+ * On return a holds the cols x rows transpose, still dense. Needs
+ * rows*cols bits of scratch memory.
+ * \param rows: number of rows.
+ * \param cols: number of columns.
+ * \param a: pointer to the rows*cols entries.
+ */
+template <typename E> void cycleTranspose(int rows, int cols, E *a);
+
+namespace detail {
+// precompiled kernels for 4 and 8 byte entries (Transpose.cpp)
+void transpose32(int rows, int cols, const void *src, int lds, void *dst,
+                 int ldd);
+void transpose64(int rows, int cols, const void *src, int lds, void *dst,
+                 int ldd);
+} // namespace detail
+
+} // namespace linopt::inmemory::kernels
+
+#include "Transpose.tpp"
+#endif
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory::kernels {
+namespace detail {
+
+/**
+ * \brief Blocks of at most this many entries are transposed directly.
+ */
+inline constexpr long transposeLeafEntries = 32L * 32;
+
+template <typename E>
+void transposeRecursive(int rows, int cols, const E *src, int lds, E *dst,
+                        int ldd) {
+  if (static_cast<long>(rows) * cols <= transposeLeafEntries) {
+    for (int i = 0; i < rows; i++) {
+      const E *s = src + static_cast<std::size_t>(i) * lds;
+      for (int j = 0; j < cols; j++)
+        dst[static_cast<std::size_t>(j) * ldd + i] = s[j];
+    }
+  } else if (rows >= cols) {
+    const int half = rows / 2;
+    transposeRecursive(half, cols, src, lds, dst, ldd);
+    transposeRecursive(rows - half, cols,
+                       src + static_cast<std::size_t>(half) * lds, lds,
+                       dst + half, ldd);
+  } else {
+    const int half = cols / 2;
+    transposeRecursive(rows, half, src, lds, dst, ldd);
+    transposeRecursive(rows, cols - half, src + half, lds,
+                       dst + static_cast<std::size_t>(half) * ldd, ldd);
+  }
+}
+
+template <typename E>
+inline constexpr bool transposeAsBits =
+    std::is_trivially_copyable_v<E> && (sizeof(E) == 4 || sizeof(E) == 8);
+
+} // namespace detail
+
+template <typename E>
+void transpose(int rows, int cols, const E *src, int lds, E *dst, int ldd) {
+  if (rows <= 0 || cols <= 0)
+    return;
+  if constexpr (detail::transposeAsBits<E>) {
+    if constexpr (sizeof(E) == 4)
+      detail::transpose32(rows, cols, src, lds, dst, ldd);
+    else
+      detail::transpose64(rows, cols, src, lds, dst, ldd);
+  } else {
+    detail::transposeRecursive(rows, cols, src, lds, dst, ldd);
+  }
+}
+
+template <typename E>
+void parallelTranspose(int rows, int cols, const E *src, int lds, E *dst,
+                       int ldd) {
+  LINOPT_METRICS_SCOPE("transpose", rows, cols, 0, 0,
+                       2.0 * rows * cols * sizeof(E));
+  // each task owns whole destination rows: no false sharing
+  parallel::parallelFor(
+      0, cols, static_cast<long>(rows) * cols, [&](int c0, int c1) {
+        transpose(rows, c1 - c0, src + c0, lds,
+                  dst + static_cast<std::size_t>(c0) * ldd, ldd);
+      });
+}
+
+template <typename E> void squareTranspose(int n, E *a, int lda) {
+  constexpr int tile = 32;
+  E above[tile * tile], below[tile * tile];
+  for (int i0 = 0; i0 < n; i0 += tile) {
+    const int ih = std::min(tile, n - i0);
+    for (int j0 = i0; j0 < n; j0 += tile) {
+      const int jw = std::min(tile, n - j0);
+      E *upper = a + static_cast<std::size_t>(i0) * lda + j0;
+      E *lower = a + static_cast<std::size_t>(j0) * lda + i0;
+      // both tiles are read before either is written: works on the diagonal
+      transpose(ih, jw, upper, lda, above, ih);
+      transpose(jw, ih, lower, lda, below, jw);
+      for (int i = 0; i < jw; i++)
+        std::copy(above + i * ih, above + (i + 1) * ih,
+                  lower + static_cast<std::size_t>(i) * lda);
+      if (j0 != i0)
+        for (int i = 0; i < ih; i++)
+          std::copy(below + i * jw, below + (i + 1) * jw,
+                    upper + static_cast<std::size_t>(i) * lda);
+    }
+  }
+}
+
+template <typename E> void cycleTranspose(int rows, int cols, E *a) {
+  const std::size_t count = static_cast<std::size_t>(rows) * cols;
+  if (rows <= 1 || cols <= 1)
+    return; // a row or a column: the dense layout of its transpose is the same
+  // entry (i,j), at k = i*cols+j, goes to j*rows+i; 0 and count-1 stay put
+  auto destination = [rows, cols](std::size_t k) {
+    return (k % cols) * rows + k / cols;
+  };
+  std::vector<bool> moved(count, false);
+  for (std::size_t start = 1; start + 1 < count; start++) {
+    if (moved[start])
+      continue;
+    E carried = std::move(a[start]);
+    std::size_t k = start;
+    do {
+      k = destination(k);
+      std::swap(carried, a[k]);
+      moved[k] = true;
+    } while (k != start);
+  }
+}
+
+} // namespace linopt::inmemory::kernels
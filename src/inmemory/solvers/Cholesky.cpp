@@ -0,0 +1 @@
+#include "Cholesky.h"
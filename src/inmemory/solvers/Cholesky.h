@@ -0,0 +1,87 @@
+/**
+ * \file Cholesky.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the Cholesky factorization of symmetric positive definite
+ * matrices.
+ * \details
+ *  The factorization is blocked and right-looking: each diagonal block is
+ *  factored directly, the block column below it is obtained by a triangular
+ *  solve, and the lower half of the trailing submatrix is updated on the
+ *  packed gemm kernel.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SOLVERS_CHOLESKY_H
+#define LINOPT_ERC_INMEMORY_SOLVERS_CHOLESKY_H
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief The factorization A = L*L^T of a symmetric positive definite A.
+ *
+ * Only the lower triangle of A is read.
+ */
+template <typename E> class CholeskyFactorization {
+private:
+  /**
+   * \brief L, zero above the diagonal.
+   */
+  Matrix<E> l;
+
+  void factor(int blockSize);
+
+public:
+  /**
+   * \brief Default block size, in columns.
+   */
+  static constexpr int defaultBlockSize = 64;
+
+  /**
+   * \brief Factors a copy of a.
+   *
+   * Throws a runtime_error if a is not square or not positive definite.
+   * \param a: the nxn matrix.
+   * \param blockSize: block size, in columns.
+   */
+  explicit CholeskyFactorization(const Matrix<E> &a,
+                                 int blockSize = defaultBlockSize);
+
+  /**
+   * \brief Factors a in place, without copying it.
+   */
+  explicit CholeskyFactorization(Matrix<E> &&a,
+                                 int blockSize = defaultBlockSize);
+
+  /**
+   * \brief Get the number of rows (and columns) of A.
+   */
+  int size() const;
+
+  /**
+   * \brief The lower triangular factor L.
+   */
+  const Matrix<E> &lower() const;
+
+  /**
+   * \brief Solves A*X = B for all the columns of B at once.
+   * \param b: the right hand sides, one per column.
+   * \return X.
+   */
+  Matrix<E> solve(const Matrix<E> &b) const;
+
+  /**
+   * \brief Overwrites B with the solution of A*X = B, \sa solve.
+   */
+  void solveInPlace(Matrix<E> &b) const;
+
+  /**
+   * \brief The determinant of A.
+   */
+  E determinant() const;
+};
+
+} // namespace linopt::inmemory
+
+#include "Cholesky.tpp"
+#endif
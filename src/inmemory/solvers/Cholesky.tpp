@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Gemm.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include "Transpose.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief B <- L^-1 * B for the kb x kb lower triangle L and the kb x r
+ * block B.
+ */
+template <typename E>
+void lowerSolve(int kb, int r, const E *l, std::size_t ldl, E *b,
+                std::size_t ldb) {
+  parallel::parallelFor(
+      0, r, static_cast<long>(kb) * kb * r / 2, [&](int c0, int c1) {
+        for (int i = 0; i < kb; i++) {
+          E *bi = b + i * ldb;
+          for (int k = 0; k < i; k++) {
+            const E f = l[i * ldl + k];
+            const E *bk = b + k * ldb;
+            for (int j = c0; j < c1; j++)
+              bi[j] -= f * bk[j];
+          }
+          const E d = l[i * ldl + i];
+          for (int j = c0; j < c1; j++)
+            bi[j] /= d;
+        }
+      });
+}
+
+/**
+ * \brief B <- L^-T * B for the kb x kb lower triangle L and the kb x r
+ * block B.
+ */
+template <typename E>
+void lowerTransposedSolve(int kb, int r, const E *l, std::size_t ldl, E *b,
+                          std::size_t ldb) {
+  parallel::parallelFor(
+      0, r, static_cast<long>(kb) * kb * r / 2, [&](int c0, int c1) {
+        for (int i = kb - 1; i >= 0; i--) {
+          E *bi = b + i * ldb;
+          const E d = l[i * ldl + i];
+          for (int j = c0; j < c1; j++)
+            bi[j] /= d;
+          // row i of L^T is column i of L: eliminate x_i from the rows above
+          for (int k = 0; k < i; k++) {
+            const E f = l[i * ldl + k];
+            E *bk = b + k * ldb;
+            for (int j = c0; j < c1; j++)
+              bk[j] -= f * bi[j];
+          }
+        }
+      });
+}
+
+} // namespace detail
+
+template <typename E>
+CholeskyFactorization<E>::CholeskyFactorization(const Matrix<E> &a,
+                                                int blockSize)
+    : l(a) {
+  factor(blockSize);
+}
+
+template <typename E>
+CholeskyFactorization<E>::CholeskyFactorization(Matrix<E> &&a, int blockSize)
+    : l(std::move(a)) {
+  factor(blockSize);
+}
+
+template <typename E> void CholeskyFactorization<E>::factor(int blockSize) {
+  using std::sqrt;
+  const int n = l.getN();
+  if (l.getM() != n)
+    throw std::runtime_error("Cholesky factorization of a non square matrix.");
+  LINOPT_METRICS_SCOPE("cholesky", n, 0, 0, static_cast<double>(n) * n * n / 3,
+                       static_cast<double>(n) * n * sizeof(E));
+  const int nb = std::max(1, blockSize);
+  const std::size_t ld = l.stride();
+  E *a = l.data();
+  std::vector<E> w;
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    // diagonal block, left-looking within the block
+    for (int j = k0; j < k1; j++) {
+      E *rj = a + j * ld;
+      E d = rj[j];
+      for (int k = k0; k < j; k++)
+        d -= rj[k] * rj[k];
+      if (!(d > E(0)))
+        throw std::runtime_error("Matrix is not positive definite.");
+      d = sqrt(d);
+      rj[j] = d;
+      for (int i = j + 1; i < k1; i++) {
+        E *ri = a + i * ld;
+        E s = ri[j];
+        for (int k = k0; k < j; k++)
+          s -= ri[k] * rj[k];
+        ri[j] = s / d;
+      }
+    }
+    if (k1 == n)
+      break;
+    // block column: L21 = A21 * L11^-T, row by row
+    const E *l11 = a + k0 * ld + k0;
+    parallel::parallelFor(
+        k1, n, static_cast<long>(n - k1) * kb * kb / 2, [&](int i0, int i1) {
+          for (int i = i0; i < i1; i++) {
+            E *row = a + i * ld + k0;
+            for (int j = 0; j < kb; j++) {
+              E s = row[j];
+              for (int k = 0; k < j; k++)
+                s -= row[k] * l11[j * ld + k];
+              row[j] = s / l11[j * ld + j];
+            }
+          }
+        });
+    // lower half of A22 -= L21 * L21^T, one row panel at a time
+    const int m = n - k1;
+    w.resize(static_cast<std::size_t>(kb) * m);
+    kernels::parallelTranspose(m, kb, a + k1 * ld + k0, static_cast<int>(ld),
+                               w.data(), m);
+    constexpr int panel = 256;
+    for (int r0 = 0; r0 < m; r0 += panel) {
+      const int r1 = std::min(m, r0 + panel);
+      kernels::parallelGemm(r1 - r0, r1, kb, a + (k1 + r0) * ld + k0,
+                            static_cast<int>(ld), w.data(), m,
+                            a + (k1 + r0) * ld + k1, static_cast<int>(ld),
+                            kernels::GemmUpdate::subtract);
+    }
+  }
+  for (int i = 0; i < n; i++)
+    std::fill(a + i * ld + i + 1, a + i * ld + n, E(0));
+}
+
+template <typename E> int CholeskyFactorization<E>::size() const {
+  return l.getN();
+}
+
+template <typename E>
+const Matrix<E> &CholeskyFactorization<E>::lower() const {
+  return l;
+}
+
+template <typename E>
+Matrix<E> CholeskyFactorization<E>::solve(const Matrix<E> &b) const {
+  Matrix<E> x(b);
+  solveInPlace(x);
+  return x;
+}
+
+template <typename E>
+void CholeskyFactorization<E>::solveInPlace(Matrix<E> &b) const {
+  const int n = size(), r = b.getM();
+  if (b.getN() != n)
+    throw std::runtime_error("Invalid dimensions for linear system.");
+  LINOPT_METRICS_SCOPE("choleskySolve", n, r, 0, 2.0 * n * n * r,
+                       (static_cast<double>(n) * n + 2.0 * n * r) * sizeof(E));
+  const std::size_t ld = l.stride(), ldb = b.stride();
+  const E *a = l.data();
+  E *x = b.data();
+  const int nb = defaultBlockSize;
+  // forward: L*Y = B
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    detail::lowerSolve(kb, r, a + k0 * ld + k0, ld, x + k0 * ldb, ldb);
+    if (k1 < n)
+      kernels::parallelGemm(n - k1, r, kb, a + k1 * ld + k0,
+                            static_cast<int>(ld), x + k0 * ldb,
+                            static_cast<int>(ldb), x + k1 * ldb,
+                            static_cast<int>(ldb),
+                            kernels::GemmUpdate::subtract);
+  }
+  // backward: L^T*X = Y, with L21^T transposed once per block
+  std::vector<E> w;
+  for (int k0 = (n - 1) / nb * nb; k0 >= 0; k0 -= nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    if (k1 < n) {
+      w.resize(static_cast<std::size_t>(kb) * (n - k1));
+      kernels::transpose(n - k1, kb, a + k1 * ld + k0, static_cast<int>(ld),
+                         w.data(), n - k1);
+      kernels::parallelGemm(kb, r, n - k1, w.data(), n - k1, x + k1 * ldb,
+                            static_cast<int>(ldb), x + k0 * ldb,
+                            static_cast<int>(ldb),
+                            kernels::GemmUpdate::subtract);
+    }
+    detail::lowerTransposedSolve(kb, r, a + k0 * ld + k0, ld, x + k0 * ldb,
+                                 ldb);
+  }
+}
+
+template <typename E> E CholeskyFactorization<E>::determinant() const {
+  E d(1);
+  for (int i = 0; i < size(); i++)
+    d *= l.coeff(i, i) * l.coeff(i, i);
+  return d;
+}
+
+} // namespace linopt::inmemory
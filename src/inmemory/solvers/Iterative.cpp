@@ -0,0 +1 @@
+#include "Iterative.h"
@@ -0,0 +1,165 @@
+/**
+ * \file Iterative.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the iterative linear system solvers.
+ * \details
+ *  Jacobi, Gauss-Seidel, SOR and preconditioned conjugate gradient, for
+ *  dense and sparse square systems a*x = b with a single right hand side.
+ *
+ *  All of them start from the x they are given (an empty x starts from 0),
+ *  stop when ||b - a*x|| <= tolerance*||b|| or after maxIterations
+ *  iterations, and return the \sa IterativeStats of the solve.
+ *
+ *  Jacobi and the conjugate gradient are made of parallel products and
+ *  vector updates. Gauss-Seidel and SOR sweep the rows by colors of a
+ *  greedy coloring of the sparsity pattern of a+a^T (red-black for the
+ *  usual 5 point stencil): the rows of a color do not depend on each other
+ *  and are updated in parallel.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SOLVERS_ITERATIVE_H
+#define LINOPT_ERC_INMEMORY_SOLVERS_ITERATIVE_H
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "Matrix.h"
+#include "SparseMatrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Preconditioners of \sa conjugateGradient.
+ */
+enum class Preconditioner {
+  /**
+   * \brief No preconditioning.
+   */
+  none,
+  /**
+   * \brief Division by the diagonal of a.
+   */
+  jacobi
+};
+
+/**
+ * \brief Stopping criteria and parameters of the iterative solvers.
+ */
+struct IterativeOptions {
+  /**
+   * \brief Relative residual ||b - a*x|| / ||b|| to reach.
+   */
+  double tolerance = 1e-10;
+  /**
+   * \brief Maximum number of iterations (sweeps).
+   */
+  int maxIterations = 1000;
+  /**
+   * \brief Relaxation factor of \sa sor, in (0, 2).
+   */
+  double relaxation = 1.5;
+  /**
+   * \brief Preconditioner of \sa conjugateGradient.
+   */
+  Preconditioner preconditioner = Preconditioner::jacobi;
+};
+
+/**
+ * \brief Outcome of an iterative solve.
+ */
+struct IterativeStats {
+  /**
+   * \brief Whether the tolerance was reached.
+   */
+  bool converged = false;
+  /**
+   * \brief Number of iterations run.
+   */
+  int iterations = 0;
+  /**
+   * \brief ||b - a*x|| of the returned x.
+   */
+  double residualNorm = 0;
+  /**
+   * \brief residualNorm / ||b||.
+   */
+  double relativeResidual = 0;
+  /**
+   * \brief Wall clock time of the solve, in seconds.
+   */
+  double seconds = 0;
+};
+
+/**
+ * \brief Solves a*x = b by Jacobi iterations.
+ *
+ * Converges for diagonally dominant a. Throws a runtime_error if a is not
+ * square, if the sizes of b or x do not match, or if a diagonal entry is 0.
+ * \param x: initial guess, overwritten by the solution.
+ */
+template <typename E>
+IterativeStats jacobi(const Matrix<E> &a, const std::vector<E> &b,
+                      std::vector<E> &x, const IterativeOptions &options = {});
+template <typename E>
+IterativeStats jacobi(const SparseMatrix<E> &a, const std::vector<E> &b,
+                      std::vector<E> &x, const IterativeOptions &options = {});
+
+/**
+ * \brief Solves a*x = b by multicolor Gauss-Seidel sweeps.
+ *
+ * Converges for diagonally dominant or symmetric positive definite a.
+ * Rows of a color are relaxed in parallel: a dense a is colored in
+ * O(n^2), and one without zeros is swept serially.
+ * \sa jacobi for the errors.
+ */
+template <typename E>
+IterativeStats gaussSeidel(const Matrix<E> &a, const std::vector<E> &b,
+                           std::vector<E> &x,
+                           const IterativeOptions &options = {});
+template <typename E>
+IterativeStats gaussSeidel(const SparseMatrix<E> &a, const std::vector<E> &b,
+                           std::vector<E> &x,
+                           const IterativeOptions &options = {});
+
+/**
+ * \brief Solves a*x = b by multicolor successive over-relaxation, with the
+ * factor options.relaxation.
+ */
+template <typename E>
+IterativeStats sor(const Matrix<E> &a, const std::vector<E> &b,
+                   std::vector<E> &x, const IterativeOptions &options = {});
+template <typename E>
+IterativeStats sor(const SparseMatrix<E> &a, const std::vector<E> &b,
+                   std::vector<E> &x, const IterativeOptions &options = {});
+
+/**
+ * \brief Solves a*x = b, a symmetric positive definite, by the conjugate
+ * gradient preconditioned with options.preconditioner.
+ */
+template <typename E>
+IterativeStats conjugateGradient(const Matrix<E> &a, const std::vector<E> &b,
+                                 std::vector<E> &x,
+                                 const IterativeOptions &options = {});
+template <typename E>
+IterativeStats conjugateGradient(const SparseMatrix<E> &a,
+                                 const std::vector<E> &b, std::vector<E> &x,
+                                 const IterativeOptions &options = {});
+
+/**
+ * \brief Same as \sa conjugateGradient with a custom preconditioner.
+ * \param precondition: callable (r, z) overwriting z with M^-1*r, M
+ * symmetric positive definite.
+ */
+template <typename A, typename E>
+IterativeStats conjugateGradient(
+    const A &a, const std::vector<E> &b, std::vector<E> &x,
+    const IterativeOptions &options,
+    const std::type_identity_t<
+        std::function<void(const std::vector<E> &, std::vector<E> &)>>
+        &precondition);
+
+} // namespace linopt::inmemory
+
+#include "Iterative.tpp"
+#endif
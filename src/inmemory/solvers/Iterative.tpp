@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Entries per partial sum of \sa dot: the sums do not depend on the
+ * number of threads.
+ */
+inline constexpr int dotBlock = 4096;
+
+template <typename E> E dot(const std::vector<E> &x, const std::vector<E> &y) {
+  const int n = static_cast<int>(x.size());
+  const int blocks = (n + dotBlock - 1) / dotBlock;
+  std::vector<E> partial(blocks, E(0));
+  parallel::parallelFor(0, blocks, 2L * n, [&](int b0, int b1) {
+    for (int b = b0; b < b1; b++) {
+      E s(0);
+      for (int i = b * dotBlock; i < std::min(n, (b + 1) * dotBlock); i++)
+        s += x[i] * y[i];
+      partial[b] = s;
+    }
+  });
+  E s(0);
+  for (E p : partial)
+    s += p;
+  return s;
+}
+
+template <typename E> double norm(const std::vector<E> &x) {
+  return std::sqrt(static_cast<double>(dot(x, x)));
+}
+
+/**
+ * \brief y = a*x, dense.
+ */
+template <typename E>
+void multiply(const Matrix<E> &a, const std::vector<E> &x,
+              std::vector<E> &y) {
+  const int n = a.getN(), m = a.getM();
+  parallel::parallelFor(0, n, 2L * n * m, [&](int i0, int i1) {
+    for (int i = i0; i < i1; i++) {
+      const E *row = a.data() + static_cast<std::size_t>(i) * a.stride();
+      E s(0);
+      for (int j = 0; j < m; j++)
+        s += row[j] * x[j];
+      y[i] = s;
+    }
+  });
+}
+
+/**
+ * \brief y = a*x, sparse.
+ */
+template <typename E>
+void multiply(const SparseMatrix<E> &a, const std::vector<E> &x,
+              std::vector<E> &y) {
+  a.multiply(x.data(), y.data());
+}
+
+template <typename E> std::vector<E> diagonalOf(const Matrix<E> &a) {
+  std::vector<E> d(a.getN());
+  for (int i = 0; i < a.getN(); i++)
+    d[i] = a.coeff(i, i);
+  return d;
+}
+
+template <typename E> std::vector<E> diagonalOf(const SparseMatrix<E> &a) {
+  return a.diagonal();
+}
+
+/**
+ * \brief Average work of a row of a.
+ */
+template <typename E> long rowWork(const Matrix<E> &a) { return a.getM(); }
+
+template <typename E> long rowWork(const SparseMatrix<E> &a) {
+  return std::max<long>(1, a.nonZeros() / a.getN());
+}
+
+/**
+ * \brief Throws unless a is square and b and x (x filled with 0 if empty)
+ * match it.
+ */
+template <typename A, typename E>
+void checkSystem(const A &a, const std::vector<E> &b, std::vector<E> &x) {
+  if (a.getN() != a.getM() || static_cast<int>(b.size()) != a.getN())
+    throw std::runtime_error("Invalid dimensions for linear system.");
+  if (x.empty())
+    x.assign(b.size(), E(0));
+  if (x.size() != b.size())
+    throw std::runtime_error("Invalid dimensions for initial guess.");
+}
+
+template <typename A, typename E>
+std::vector<E> checkedDiagonal(const A &a) {
+  std::vector<E> d = diagonalOf(a);
+  for (E v : d)
+    if (v == E(0))
+      throw std::runtime_error("Zero diagonal entry.");
+  return d;
+}
+
+/**
+ * \brief Times a solve and fills in its stats.
+ */
+class SolveClock {
+private:
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+
+public:
+  IterativeStats finish(IterativeStats stats, double residual,
+                        double reference) const {
+    stats.residualNorm = residual;
+    stats.relativeResidual = reference > 0 ? residual / reference : residual;
+    stats.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    return stats;
+  }
+};
+
+/**
+ * \brief Rows grouped by colors of a greedy coloring of the graph where i
+ * and j are adjacent iff a(i,j) or a(j,i) is nonzero.
+ * \param neighbors: callable (i, visit) calling visit(j) for the adjacent j.
+ */
+template <typename F>
+std::vector<std::vector<int>> colorClasses(int n, F &&neighbors) {
+  std::vector<int> color(n, -1), forbidden(n + 1, -1);
+  std::vector<std::vector<int>> classes;
+  for (int i = 0; i < n; i++) {
+    neighbors(i, [&](int j) {
+      if (color[j] >= 0)
+        forbidden[color[j]] = i;
+    });
+    int c = 0;
+    while (forbidden[c] == i)
+      c++;
+    color[i] = c;
+    if (c == static_cast<int>(classes.size()))
+      classes.emplace_back();
+    classes[c].push_back(i);
+  }
+  return classes;
+}
+
+/**
+ * \brief \sa colorClasses of a dense matrix, in O(n^2): a matrix without
+ * zeros gets one row per color, and its sweeps run serially.
+ */
+template <typename E>
+std::vector<std::vector<int>> colorClasses(const Matrix<E> &a) {
+  return colorClasses(a.getN(), [&](int i, auto &&visit) {
+    for (int j = 0; j < a.getN(); j++)
+      if (j != i && (a.coeff(i, j) != E(0) || a.coeff(j, i) != E(0)))
+        visit(j);
+  });
+}
+
+/**
+ * \brief \sa colorClasses of a csr matrix.
+ */
+template <typename E>
+std::vector<std::vector<int>> colorClasses(const SparseMatrix<E> &a) {
+  const SparseMatrix<E> t = a.toLayout(Layout::csc);
+  return colorClasses(a.getN(), [&](int i, auto &&visit) {
+    for (const SparseMatrix<E> *s : {&a, &t})
+      for (std::size_t p = s->offsets()[i]; p < s->offsets()[i + 1]; p++)
+        if (s->indices()[p] != i)
+          visit(s->indices()[p]);
+  });
+}
+
+/**
+ * \brief Sum of a(i,j)*x(j) over j != i, dense.
+ *
+ * x(j) is not read where a(i,j) is 0: rows of the same color update those
+ * entries concurrently.
+ */
+template <typename E>
+E offDiagonalDot(const Matrix<E> &a, int i, const std::vector<E> &x) {
+  const E *row = a.data() + static_cast<std::size_t>(i) * a.stride();
+  E s(0);
+  for (int j = 0; j < a.getM(); j++)
+    if (j != i && row[j] != E(0))
+      s += row[j] * x[j];
+  return s;
+}
+
+/**
+ * \brief Sum of a(i,j)*x(j) over j != i, a csr.
+ */
+template <typename E>
+E offDiagonalDot(const SparseMatrix<E> &a, int i, const std::vector<E> &x) {
+  E s(0);
+  for (std::size_t p = a.offsets()[i]; p < a.offsets()[i + 1]; p++)
+    if (a.indices()[p] != i)
+      s += a.values()[p] * x[a.indices()[p]];
+  return s;
+}
+
+template <typename A, typename E>
+IterativeStats jacobiSolve(const A &a, const std::vector<E> &b,
+                           std::vector<E> &x, const IterativeOptions &options) {
+  const SolveClock clock;
+  checkSystem(a, b, x);
+  const std::vector<E> d = checkedDiagonal<A, E>(a);
+  const int n = a.getN();
+  const double reference = norm(b);
+  std::vector<E> r(n);
+  IterativeStats stats;
+  double residual = 0;
+  for (;; stats.iterations++) {
+    // x += D^-1 * (b - a*x), the residual coming for free
+    multiply(a, x, r);
+    parallel::parallelFor(0, n, n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        r[i] = b[i] - r[i];
+    });
+    residual = norm(r);
+    if (residual <= options.tolerance * reference) {
+      stats.converged = true;
+      break;
+    }
+    if (stats.iterations == options.maxIterations)
+      break;
+    parallel::parallelFor(0, n, n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        x[i] += r[i] / d[i];
+    });
+  }
+  return clock.finish(stats, residual, reference);
+}
+
+/**
+ * \brief Multicolor SOR sweeps of the rows of a, csr if sparse.
+ */
+template <typename A, typename E>
+IterativeStats relaxationSolve(const A &a, const std::vector<E> &b,
+                               std::vector<E> &x,
+                               const IterativeOptions &options, E omega) {
+  const SolveClock clock;
+  checkSystem(a, b, x);
+  const std::vector<E> d = checkedDiagonal<A, E>(a);
+  const int n = a.getN();
+  const double reference = norm(b);
+  const std::vector<std::vector<int>> classes = colorClasses(a);
+  const long work = 2 * rowWork(a);
+  std::vector<E> r(n);
+  auto trueResidual = [&] {
+    multiply(a, x, r);
+    parallel::parallelFor(0, n, n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        r[i] = b[i] - r[i];
+    });
+    return norm(r);
+  };
+  IterativeStats stats;
+  double residual = trueResidual();
+  for (;; stats.iterations++) {
+    if (residual <= options.tolerance * reference) {
+      stats.converged = true;
+      break;
+    }
+    if (stats.iterations == options.maxIterations)
+      break;
+    for (const std::vector<int> &rows : classes)
+      parallel::parallelFor(
+          0, static_cast<int>(rows.size()), work * rows.size(),
+          [&](int k0, int k1) {
+            for (int k = k0; k < k1; k++) {
+              const int i = rows[k];
+              const E s = b[i] - offDiagonalDot(a, i, x);
+              r[i] = s - d[i] * x[i];
+              x[i] += omega * (s / d[i] - x[i]);
+            }
+          });
+    // the residual of each row as it was relaxed, a by-product of the
+    // sweep: a product with a confirms it once it is small enough, or at
+    // the last sweep
+    residual = norm(r);
+    if (residual <= options.tolerance * reference ||
+        stats.iterations + 1 == options.maxIterations)
+      residual = trueResidual();
+  }
+  return clock.finish(stats, residual, reference);
+}
+
+template <typename E>
+IterativeStats relaxationSolve(const SparseMatrix<E> &a,
+                               const std::vector<E> &b, std::vector<E> &x,
+                               const IterativeOptions &options, E omega) {
+  if (a.layout() == Layout::csr)
+    return relaxationSolve<SparseMatrix<E>, E>(a, b, x, options, omega);
+  return relaxationSolve<SparseMatrix<E>, E>(a.toLayout(Layout::csr), b, x,
+                                             options, omega);
+}
+
+} // namespace detail
+
+template <typename E>
+IterativeStats jacobi(const Matrix<E> &a, const std::vector<E> &b,
+                      std::vector<E> &x, const IterativeOptions &options) {
+  return detail::jacobiSolve(a, b, x, options);
+}
+
+template <typename E>
+IterativeStats jacobi(const SparseMatrix<E> &a, const std::vector<E> &b,
+                      std::vector<E> &x, const IterativeOptions &options) {
+  return detail::jacobiSolve(a, b, x, options);
+}
+
+template <typename E>
+IterativeStats gaussSeidel(const Matrix<E> &a, const std::vector<E> &b,
+                           std::vector<E> &x,
+                           const IterativeOptions &options) {
+  return detail::relaxationSolve(a, b, x, options, E(1));
+}
+
+template <typename E>
+IterativeStats gaussSeidel(const SparseMatrix<E> &a, const std::vector<E> &b,
+                           std::vector<E> &x,
+                           const IterativeOptions &options) {
+  return detail::relaxationSolve(a, b, x, options, E(1));
+}
+
+template <typename E>
+IterativeStats sor(const Matrix<E> &a, const std::vector<E> &b,
+                   std::vector<E> &x, const IterativeOptions &options) {
+  if (options.relaxation <= 0 || options.relaxation >= 2)
+    throw std::runtime_error("Relaxation factor out of (0, 2).");
+  return detail::relaxationSolve(a, b, x, options, E(options.relaxation));
+}
+
+template <typename E>
+IterativeStats sor(const SparseMatrix<E> &a, const std::vector<E> &b,
+                   std::vector<E> &x, const IterativeOptions &options) {
+  if (options.relaxation <= 0 || options.relaxation >= 2)
+    throw std::runtime_error("Relaxation factor out of (0, 2).");
+  return detail::relaxationSolve(a, b, x, options, E(options.relaxation));
+}
+
+template <typename A, typename E>
+IterativeStats conjugateGradient(
+    const A &a, const std::vector<E> &b, std::vector<E> &x,
+    const IterativeOptions &options,
+    const std::type_identity_t<
+        std::function<void(const std::vector<E> &, std::vector<E> &)>>
+        &precondition) {
+  const detail::SolveClock clock;
+  detail::checkSystem(a, b, x);
+  const int n = a.getN();
+  const double reference = detail::norm(b);
+  std::vector<E> r(n), z(n), p(n), q(n);
+  auto update = [n](std::vector<E> &y, E alpha, const std::vector<E> &v) {
+    parallel::parallelFor(0, n, 2L * n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        y[i] += alpha * v[i];
+    });
+  };
+  detail::multiply(a, x, r);
+  for (int i = 0; i < n; i++)
+    r[i] = b[i] - r[i];
+  precondition(r, z);
+  p = z;
+  E rz = detail::dot(r, z);
+  IterativeStats stats;
+  double residual = detail::norm(r);
+  while (residual > options.tolerance * reference &&
+         stats.iterations < options.maxIterations) {
+    detail::multiply(a, p, q);
+    const E pq = detail::dot(p, q);
+    if (pq <= E(0))
+      throw std::runtime_error("Matrix is not positive definite.");
+    const E alpha = rz / pq;
+    update(x, alpha, p);
+    update(r, -alpha, q);
+    stats.iterations++;
+    residual = detail::norm(r);
+    precondition(r, z);
+    const E next = detail::dot(r, z);
+    const E beta = next / rz;
+    rz = next;
+    parallel::parallelFor(0, n, 2L * n, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        p[i] = z[i] + beta * p[i];
+    });
+  }
+  // the recurrence drifts from b - a*x: report the true residual
+  detail::multiply(a, x, r);
+  for (int i = 0; i < n; i++)
+    r[i] = b[i] - r[i];
+  residual = detail::norm(r);
+  stats.converged = residual <= options.tolerance * reference;
+  return clock.finish(stats, residual, reference);
+}
+
+namespace detail {
+
+template <typename A, typename E>
+IterativeStats preconditionedSolve(const A &a, const std::vector<E> &b,
+                                   std::vector<E> &x,
+                                   const IterativeOptions &options) {
+  if (options.preconditioner == Preconditioner::none)
+    return conjugateGradient<A, E>(
+        a, b, x, options,
+        [](const std::vector<E> &r, std::vector<E> &z) { z = r; });
+  checkSystem(a, b, x);
+  const std::vector<E> d = checkedDiagonal<A, E>(a);
+  return conjugateGradient<A, E>(
+      a, b, x, options, [&d](const std::vector<E> &r, std::vector<E> &z) {
+        const int n = static_cast<int>(r.size());
+        parallel::parallelFor(0, n, n, [&](int i0, int i1) {
+          for (int i = i0; i < i1; i++)
+            z[i] = r[i] / d[i];
+        });
+      });
+}
+
+} // namespace detail
+
+template <typename E>
+IterativeStats conjugateGradient(const Matrix<E> &a, const std::vector<E> &b,
+                                 std::vector<E> &x,
+                                 const IterativeOptions &options) {
+  return detail::preconditionedSolve(a, b, x, options);
+}
+
+template <typename E>
+IterativeStats conjugateGradient(const SparseMatrix<E> &a,
+                                 const std::vector<E> &b, std::vector<E> &x,
+                                 const IterativeOptions &options) {
+  return detail::preconditionedSolve(a, b, x, options);
+}
+
+} // namespace linopt::inmemory
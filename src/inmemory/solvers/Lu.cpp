@@ -0,0 +1 @@
+#include "Lu.h"
@@ -0,0 +1,134 @@
+/**
+ * \file Lu.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the LU factorization with partial pivoting.
+ * \details
+ *  The factorization is blocked and right-looking: each panel of
+ *  blockSize columns is factored with partial pivoting, the matching block
+ *  row of U is obtained by a triangular solve, and the trailing submatrix
+ *  is updated by a single product on the packed gemm kernel, which does
+ *  almost all of the flops.
+ *
+ *  Solves against many right hand sides are blocked the same way.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SOLVERS_LU_H
+#define LINOPT_ERC_INMEMORY_SOLVERS_LU_H
+
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief The factorization P*A = L*U of a square matrix A.
+ *
+ * L is unit lower triangular, U upper triangular; both are stored in a
+ * single matrix. Factor once, then solve, take the determinant or the
+ * inverse as many times as needed.
+ */
+template <typename E> class LuFactorization {
+private:
+  /**
+   * \brief L below the diagonal (its unit diagonal implied), U on and above.
+   */
+  Matrix<E> lu;
+  /**
+   * \brief Row i was swapped with row pivotRows[i] at step i.
+   */
+  std::vector<int> pivotRows;
+  bool singular = false;
+  /**
+   * \brief Number of actual row swaps, odd or even.
+   */
+  bool oddPermutation = false;
+
+  void factor(int blockSize);
+  void checkRegular() const;
+
+public:
+  /**
+   * \brief Default panel width, in columns.
+   */
+  static constexpr int defaultBlockSize = 64;
+
+  /**
+   * \brief Factors a copy of a.
+   *
+   * Throws a runtime_error if a is not square. A singular a is factored
+   * nonetheless, \sa isSingular.
+   * \param a: the nxn matrix.
+   * \param blockSize: panel width, in columns.
+   */
+  explicit LuFactorization(const Matrix<E> &a,
+                           int blockSize = defaultBlockSize);
+
+  /**
+   * \brief Factors a in place, without copying it.
+   */
+  explicit LuFactorization(Matrix<E> &&a, int blockSize = defaultBlockSize);
+
+  /**
+   * \brief Get the number of rows (and columns) of A.
+   */
+  int size() const;
+
+  /**
+   * \brief The packed factors: L strictly below the diagonal, U on and above.
+   */
+  const Matrix<E> &factors() const;
+
+  /**
+   * \brief The row interchanges: row i was swapped with row pivots()[i],
+   * for i = 0, 1, ..., size()-1 in that order.
+   */
+  const std::vector<int> &pivots() const;
+
+  /**
+   * \brief Whether U has a zero on its diagonal.
+   */
+  bool isSingular() const;
+
+  /**
+   * \brief Solves A*X = B for all the columns of B at once.
+   *
+   * Throws a runtime_error if B has not size() rows or if A is singular.
+   * \param b: the right hand sides, one per column.
+   * \return X.
+   */
+  Matrix<E> solve(const Matrix<E> &b) const;
+
+  /**
+   * \brief Overwrites B with the solution of A*X = B, \sa solve.
+   */
+  void solveInPlace(Matrix<E> &b) const;
+
+  /**
+   * \brief The determinant of A.
+   */
+  E determinant() const;
+
+  /**
+   * \brief The inverse of A.
+   *
+   * Throws a runtime_error if A is singular.
+   */
+  Matrix<E> inverse() const;
+
+  /**
+   * \brief Updates the factorization to that of A + u*v^T in O(n^2).
+   *
+   * Uses Bennett's algorithm, which keeps the current pivots: it is
+   * accurate as long as the updated matrix does not need other row
+   * interchanges. Refactor when the growth of the factors matters.
+   * \param u: nx1 column.
+   * \param v: nx1 column.
+   */
+  void rankOneUpdate(const Matrix<E> &u, const Matrix<E> &v);
+};
+
+} // namespace linopt::inmemory
+
+#include "Lu.tpp"
+#endif
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "Gemm.h"
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief B <- L^-1 * B for the kb x kb unit lower triangle L and the
+ * kb x r block B; independent columns of B are solved in parallel.
+ */
+template <typename E>
+void lowerUnitSolve(int kb, int r, const E *l, std::size_t ldl, E *b,
+                    std::size_t ldb) {
+  parallel::parallelFor(
+      0, r, static_cast<long>(kb) * kb * r / 2, [&](int c0, int c1) {
+        for (int i = 1; i < kb; i++) {
+          E *bi = b + i * ldb;
+          for (int k = 0; k < i; k++) {
+            const E f = l[i * ldl + k];
+            const E *bk = b + k * ldb;
+            for (int j = c0; j < c1; j++)
+              bi[j] -= f * bk[j];
+          }
+        }
+      });
+}
+
+/**
+ * \brief B <- U^-1 * B for the kb x kb upper triangle U and the kb x r
+ * block B.
+ */
+template <typename E>
+void upperSolve(int kb, int r, const E *u, std::size_t ldu, E *b,
+                std::size_t ldb) {
+  parallel::parallelFor(
+      0, r, static_cast<long>(kb) * kb * r / 2, [&](int c0, int c1) {
+        for (int i = kb - 1; i >= 0; i--) {
+          E *bi = b + i * ldb;
+          for (int k = i + 1; k < kb; k++) {
+            const E f = u[i * ldu + k];
+            const E *bk = b + k * ldb;
+            for (int j = c0; j < c1; j++)
+              bi[j] -= f * bk[j];
+          }
+          const E d = u[i * ldu + i];
+          for (int j = c0; j < c1; j++)
+            bi[j] /= d;
+        }
+      });
+}
+
+} // namespace detail
+
+template <typename E>
+LuFactorization<E>::LuFactorization(const Matrix<E> &a, int blockSize)
+    : lu(a) {
+  factor(blockSize);
+}
+
+template <typename E>
+LuFactorization<E>::LuFactorization(Matrix<E> &&a, int blockSize)
+    : lu(std::move(a)) {
+  factor(blockSize);
+}
+
+template <typename E> void LuFactorization<E>::factor(int blockSize) {
+  using std::abs;
+  const int n = lu.getN();
+  if (lu.getM() != n)
+    throw std::runtime_error("LU factorization of a non square matrix.");
+  LINOPT_METRICS_SCOPE("lu", n, 0, 0, 2.0 * n * n * n / 3,
+                       static_cast<double>(n) * n * sizeof(E));
+  const int nb = std::max(1, blockSize);
+  const std::size_t ld = lu.stride();
+  E *a = lu.data();
+  pivotRows.assign(n, 0);
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    // panel: columns [k0, k1), unblocked with partial pivoting
+    for (int j = k0; j < k1; j++) {
+      int p = j;
+      for (int i = j + 1; i < n; i++)
+        if (abs(a[i * ld + j]) > abs(a[p * ld + j]))
+          p = i;
+      pivotRows[j] = p;
+      if (p != j) {
+        // whole rows: the left part holds L, the right part is yet to factor
+        std::swap_ranges(a + j * ld, a + j * ld + n, a + p * ld);
+        oddPermutation = !oddPermutation;
+      }
+      const E pivot = a[j * ld + j];
+      if (pivot == E(0)) {
+        singular = true; // nothing to eliminate in this column
+        continue;
+      }
+      const E *pivotRow = a + j * ld;
+      parallel::parallelFor(
+          j + 1, n, static_cast<long>(n - j) * (k1 - j), [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+              E *row = a + i * ld;
+              const E f = row[j] / pivot;
+              row[j] = f;
+              for (int c = j + 1; c < k1; c++)
+                row[c] -= f * pivotRow[c];
+            }
+          });
+    }
+    if (k1 == n)
+      break;
+    // block row of U: U12 = L11^-1 * A12
+    detail::lowerUnitSolve(kb, n - k1, a + k0 * ld + k0, ld, a + k0 * ld + k1,
+                           ld);
+    // trailing update A22 -= L21 * U12, on the gemm path
+    kernels::parallelGemm(n - k1, n - k1, kb, a + k1 * ld + k0,
+                          static_cast<int>(ld), a + k0 * ld + k1,
+                          static_cast<int>(ld), a + k1 * ld + k1,
+                          static_cast<int>(ld), kernels::GemmUpdate::subtract);
+  }
+}
+
+template <typename E> void LuFactorization<E>::checkRegular() const {
+  if (singular)
+    throw std::runtime_error("Singular matrix.");
+}
+
+template <typename E> int LuFactorization<E>::size() const {
+  return lu.getN();
+}
+
+template <typename E> const Matrix<E> &LuFactorization<E>::factors() const {
+  return lu;
+}
+
+template <typename E>
+const std::vector<int> &LuFactorization<E>::pivots() const {
+  return pivotRows;
+}
+
+template <typename E> bool LuFactorization<E>::isSingular() const {
+  return singular;
+}
+
+template <typename E>
+Matrix<E> LuFactorization<E>::solve(const Matrix<E> &b) const {
+  Matrix<E> x(b);
+  solveInPlace(x);
+  return x;
+}
+
+template <typename E>
+void LuFactorization<E>::solveInPlace(Matrix<E> &b) const {
+  const int n = size(), r = b.getM();
+  if (b.getN() != n)
+    throw std::runtime_error("Invalid dimensions for linear system.");
+  checkRegular();
+  LINOPT_METRICS_SCOPE("luSolve", n, r, 0, 2.0 * n * n * r,
+                       (static_cast<double>(n) * n + 2.0 * n * r) * sizeof(E));
+  const std::size_t ld = lu.stride(), ldb = b.stride();
+  const E *a = lu.data();
+  E *x = b.data();
+  for (int i = 0; i < n; i++)
+    if (pivotRows[i] != i)
+      std::swap_ranges(x + i * ldb, x + i * ldb + r, x + pivotRows[i] * ldb);
+  const int nb = defaultBlockSize;
+  // forward: L*Y = P*B, block row by block row
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    detail::lowerUnitSolve(kb, r, a + k0 * ld + k0, ld, x + k0 * ldb, ldb);
+    if (k1 < n)
+      kernels::parallelGemm(n - k1, r, kb, a + k1 * ld + k0,
+                            static_cast<int>(ld), x + k0 * ldb,
+                            static_cast<int>(ldb), x + k1 * ldb,
+                            static_cast<int>(ldb),
+                            kernels::GemmUpdate::subtract);
+  }
+  // backward: U*X = Y, from the last block row up
+  for (int k0 = (n - 1) / nb * nb; k0 >= 0; k0 -= nb) {
+    const int kb = std::min(nb, n - k0), k1 = k0 + kb;
+    if (k1 < n)
+      kernels::parallelGemm(kb, r, n - k1, a + k0 * ld + k1,
+                            static_cast<int>(ld), x + k1 * ldb,
+                            static_cast<int>(ldb), x + k0 * ldb,
+                            static_cast<int>(ldb),
+                            kernels::GemmUpdate::subtract);
+    detail::upperSolve(kb, r, a + k0 * ld + k0, ld, x + k0 * ldb, ldb);
+  }
+}
+
+template <typename E> E LuFactorization<E>::determinant() const {
+  E d = oddPermutation ? E(-1) : E(1);
+  for (int i = 0; i < size(); i++)
+    d *= lu.coeff(i, i);
+  return d;
+}
+
+template <typename E> Matrix<E> LuFactorization<E>::inverse() const {
+  const int n = size();
+  Matrix<E> x(n, n);
+  for (int i = 0; i < n; i++)
+    x.get(i, i) = E(1);
+  solveInPlace(x);
+  return x;
+}
+
+template <typename E>
+void LuFactorization<E>::rankOneUpdate(const Matrix<E> &u,
+                                       const Matrix<E> &v) {
+  const int n = size();
+  if (u.getN() != n || v.getN() != n || u.getM() != 1 || v.getM() != 1)
+    throw std::runtime_error("Invalid dimensions for rank one update.");
+  // P*(A + u*v^T) = L*U + (P*u)*v^T
+  std::vector<E> x(n), y(n);
+  for (int i = 0; i < n; i++) {
+    x[i] = u.coeff(i, 0);
+    y[i] = v.coeff(i, 0);
+  }
+  for (int i = 0; i < n; i++)
+    std::swap(x[i], x[pivotRows[i]]);
+  const std::size_t ld = lu.stride();
+  E *a = lu.data();
+  singular = false;
+  for (int p = 0; p < n; p++) {
+    E *row = a + p * ld;
+    row[p] += x[p] * y[p];
+    if (row[p] == E(0)) {
+      singular = true;
+      y[p] = E(0);
+    } else {
+      y[p] /= row[p];
+    }
+    for (int i = p + 1; i < n; i++) {
+      E &l = a[i * ld + p];
+      x[i] -= x[p] * l;
+      l += y[p] * x[i];
+    }
+    for (int j = p + 1; j < n; j++) {
+      row[j] += x[p] * y[j];
+      y[j] -= y[p] * row[j];
+    }
+  }
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1 @@
+#include "Qr.h"
@@ -0,0 +1,177 @@
+/**
+ * \file Qr.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the Householder QR factorization and the streaming least
+ * squares solver.
+ * \details
+ *  The reflectors are generated a panel of blockSize columns at a time and
+ *  accumulated in the compact WY form I - V*T*V^T, T upper triangular, so
+ *  that applying them to the trailing columns, or to right hand sides, is
+ *  made of two products on the packed gemm kernel.
+ *
+ *  \sa StreamingLeastSquares solves tall least squares problems a block of
+ *  rows at a time (TSQR): only an n x n triangle is kept between blocks.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SOLVERS_QR_H
+#define LINOPT_ERC_INMEMORY_SOLVERS_QR_H
+
+#include <optional>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+template <typename E> class StreamingLeastSquares;
+
+/**
+ * \brief The factorization A = Q*R of an mxn matrix A.
+ *
+ * Q is kept as its Householder reflectors: it is only formed on request
+ * (\sa thinQ), and applied without being formed (\sa applyQt, \sa applyQ).
+ */
+template <typename E> class QrFactorization {
+private:
+  friend class StreamingLeastSquares<E>;
+
+  /**
+   * \brief R on and above the diagonal, the reflectors below (their unit
+   * leading entries implied).
+   */
+  Matrix<E> qr;
+  std::vector<E> tau;
+  /**
+   * \brief The T factor of each panel of reflectors.
+   */
+  std::vector<Matrix<E>> triangular;
+  int blockSize;
+  /**
+   * \brief Number of reflectors.
+   */
+  int count = 0;
+
+  QrFactorization(Matrix<E> &&a, int blockSize, int columns);
+  void factor(int columns);
+  void applyPanel(int panel, Matrix<E> &b, bool transposed) const;
+
+public:
+  /**
+   * \brief Default panel width, in columns.
+   */
+  static constexpr int defaultBlockSize = 32;
+
+  /**
+   * \brief Factors a copy of a.
+   * \param a: the mxn matrix.
+   * \param blockSize: panel width, in columns.
+   */
+  explicit QrFactorization(const Matrix<E> &a,
+                           int blockSize = defaultBlockSize);
+
+  /**
+   * \brief Factors a in place, without copying it.
+   */
+  explicit QrFactorization(Matrix<E> &&a, int blockSize = defaultBlockSize);
+
+  /**
+   * \brief The packed factors: R on and above the diagonal, the Householder
+   * vectors below.
+   */
+  const Matrix<E> &factors() const;
+
+  /**
+   * \brief The min(m,n) x n upper triangular factor R.
+   */
+  Matrix<E> r() const;
+
+  /**
+   * \brief Forms the m x min(m,n) matrix Q with orthonormal columns.
+   */
+  Matrix<E> thinQ() const;
+
+  /**
+   * \brief Overwrites B (m rows) with Q^T*B.
+   */
+  void applyQt(Matrix<E> &b) const;
+
+  /**
+   * \brief Overwrites B (m rows) with Q*B.
+   */
+  void applyQ(Matrix<E> &b) const;
+
+  /**
+   * \brief Solves the least squares problem min ||A*X - B|| (m >= n).
+   *
+   * Throws a runtime_error if m < n, if B has not m rows, or if A does not
+   * have full column rank.
+   * \param b: the right hand sides, one per column.
+   * \return X: the n x r solutions.
+   */
+  Matrix<E> leastSquares(const Matrix<E> &b) const;
+};
+
+/**
+ * \brief Least squares min ||A*X - B|| for a tall A given a block of rows
+ * at a time.
+ *
+ * Each block is stacked under the current triangle [R | Q^T*B] and the
+ * stack is QR factored: memory stays O(n*(n+r)) whatever the number of
+ * rows, and the normal equations are never formed.
+ */
+template <typename E> class StreamingLeastSquares {
+private:
+  int columns, rightHandSides, blockSize;
+  /**
+   * \brief [R | Q^T*B], at most columns rows.
+   */
+  std::optional<Matrix<E>> top;
+  std::vector<E> residualSquares;
+  long rowCount = 0;
+
+public:
+  /**
+   * \brief Starts a problem with no rows yet.
+   * \param columns: number of columns n of A.
+   * \param rightHandSides: number of columns r of B.
+   * \param blockSize: panel width of the QR factorizations.
+   */
+  explicit StreamingLeastSquares(
+      int columns, int rightHandSides = 1,
+      int blockSize = QrFactorization<E>::defaultBlockSize);
+
+  /**
+   * \brief Adds the rows [a | b] to the problem.
+   * \param a: h x n block of rows of A.
+   * \param b: the matching h x r block of rows of B.
+   */
+  void push(const Matrix<E> &a, const Matrix<E> &b);
+
+  /**
+   * \brief Number of rows pushed so far.
+   */
+  long rows() const;
+
+  /**
+   * \brief The n x n triangular factor R of the rows pushed so far.
+   *
+   * Throws a runtime_error while fewer than n rows have been pushed.
+   */
+  Matrix<E> r() const;
+
+  /**
+   * \brief The least squares solution X of the rows pushed so far.
+   */
+  Matrix<E> solve() const;
+
+  /**
+   * \brief The residual norm ||A*x - b|| of the least squares solution x,
+   * for the given right hand side.
+   */
+  E residualNorm(int rightHandSide = 0) const;
+};
+
+} // namespace linopt::inmemory
+
+#include "Qr.tpp"
+#endif
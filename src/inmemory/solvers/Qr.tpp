@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "Gemm.h"
+#include "Lu.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include "Transpose.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Whether the n x n upper triangle R, of a matrix with rows rows, is
+ * numerically singular: a diagonal entry below rows*eps*max|r_ii|.
+ */
+template <typename E>
+bool rankDeficient(int n, long rows, const E *r, std::size_t ldr) {
+  using std::abs;
+  E largest(0);
+  for (int i = 0; i < n; i++)
+    largest = std::max<E>(largest, abs(r[i * ldr + i]));
+  const E threshold = largest * std::numeric_limits<E>::epsilon() *
+                      static_cast<E>(std::max<long>(rows, n));
+  for (int i = 0; i < n; i++)
+    if (abs(r[i * ldr + i]) <= threshold)
+      return true;
+  return false;
+}
+
+} // namespace detail
+
+template <typename E>
+QrFactorization<E>::QrFactorization(const Matrix<E> &a, int blockSize)
+    : qr(a), blockSize(std::max(1, blockSize)) {
+  factor(qr.getM());
+}
+
+template <typename E>
+QrFactorization<E>::QrFactorization(Matrix<E> &&a, int blockSize)
+    : qr(std::move(a)), blockSize(std::max(1, blockSize)) {
+  factor(qr.getM());
+}
+
+template <typename E>
+QrFactorization<E>::QrFactorization(Matrix<E> &&a, int blockSize, int columns)
+    : qr(std::move(a)), blockSize(std::max(1, blockSize)) {
+  factor(columns);
+}
+
+// reflectors for the first columns only; all the columns are transformed
+template <typename E> void QrFactorization<E>::factor(int columns) {
+  using std::sqrt;
+  const int m = qr.getN(), n = qr.getM();
+  const std::size_t ld = qr.stride();
+  E *a = qr.data();
+  count = std::min(m, columns);
+  LINOPT_METRICS_SCOPE("qr", m, n, 0,
+                       2.0 * m * n * count - 2.0 * count * count * count / 3,
+                       static_cast<double>(m) * n * sizeof(E));
+  tau.assign(count, E(0));
+  std::vector<E> w;
+  for (int k0 = 0; k0 < count; k0 += blockSize) {
+    const int k1 = std::min(count, k0 + blockSize);
+    for (int j = k0; j < k1; j++) {
+      const E alpha = a[j * ld + j];
+      E s(0);
+      for (int i = j + 1; i < m; i++)
+        s += a[i * ld + j] * a[i * ld + j];
+      if (s == E(0))
+        continue; // already zero below the diagonal: H_j = I
+      const E norm = sqrt(alpha * alpha + s);
+      const E beta = alpha >= E(0) ? -norm : norm;
+      tau[j] = (beta - alpha) / beta;
+      const E scale = E(1) / (alpha - beta);
+      for (int i = j + 1; i < m; i++)
+        a[i * ld + j] *= scale;
+      a[j * ld + j] = beta;
+      // H_j on the rest of the panel: w = v^T * A, A -= tau * v * w
+      w.assign(a + j * ld + j + 1, a + j * ld + k1);
+      for (int i = j + 1; i < m; i++) {
+        const E v = a[i * ld + j];
+        const E *row = a + i * ld;
+        for (int c = j + 1; c < k1; c++)
+          w[c - j - 1] += v * row[c];
+      }
+      for (int c = j + 1; c < k1; c++)
+        a[j * ld + c] -= tau[j] * w[c - j - 1];
+      for (int i = j + 1; i < m; i++) {
+        const E v = tau[j] * a[i * ld + j];
+        E *row = a + i * ld;
+        for (int c = j + 1; c < k1; c++)
+          row[c] -= v * w[c - j - 1];
+      }
+    }
+    // T of the panel: T(0:j,j) = -tau_j * T(0:j,0:j) * V(:,0:j)^T * v_j
+    const int kb = k1 - k0;
+    Matrix<E> t(kb, kb);
+    std::vector<E> z(kb);
+    for (int jj = 0; jj < kb; jj++) {
+      const int j = k0 + jj;
+      t.get(jj, jj) = tau[j];
+      for (int l = 0; l < jj; l++) {
+        E s = a[j * ld + k0 + l];
+        for (int i = j + 1; i < m; i++)
+          s += a[i * ld + k0 + l] * a[i * ld + j];
+        z[l] = s;
+      }
+      for (int l = 0; l < jj; l++) {
+        E s(0);
+        for (int p = l; p < jj; p++)
+          s += t.coeff(l, p) * z[p];
+        t.get(l, jj) = -tau[j] * s;
+      }
+    }
+    triangular.push_back(std::move(t));
+    if (k1 < n) {
+      // trailing columns: C -= V * T^T * V^T * C, on the gemm path
+      const int panel = static_cast<int>(triangular.size()) - 1;
+      const int mk = m - k0, nc = n - k1;
+      std::vector<E> v(static_cast<std::size_t>(mk) * kb, E(0));
+      for (int i = 0; i < mk; i++)
+        for (int l = 0; l < std::min(i + 1, kb); l++)
+          v[i * kb + l] = i == l ? E(1) : a[(k0 + i) * ld + k0 + l];
+      std::vector<E> vt(static_cast<std::size_t>(kb) * mk);
+      kernels::transpose(mk, kb, v.data(), kb, vt.data(), mk);
+      std::vector<E> wc(static_cast<std::size_t>(kb) * nc);
+      E *c = a + k0 * ld + k1;
+      kernels::parallelGemm(kb, nc, mk, vt.data(), mk, c, static_cast<int>(ld),
+                            wc.data(), nc, kernels::GemmUpdate::overwrite);
+      const Matrix<E> &tp = triangular[panel];
+      // W <- T^T * W, bottom row first: row i only needs rows <= i
+      for (int i = kb - 1; i >= 0; i--) {
+        E *wi = wc.data() + static_cast<std::size_t>(i) * nc;
+        const E d = tp.coeff(i, i);
+        for (int q = 0; q < nc; q++)
+          wi[q] *= d;
+        for (int l = 0; l < i; l++) {
+          const E f = tp.coeff(l, i);
+          const E *wl = wc.data() + static_cast<std::size_t>(l) * nc;
+          for (int q = 0; q < nc; q++)
+            wi[q] += f * wl[q];
+        }
+      }
+      kernels::parallelGemm(mk, nc, kb, v.data(), kb, wc.data(), nc, c,
+                            static_cast<int>(ld),
+                            kernels::GemmUpdate::subtract);
+    }
+  }
+}
+
+template <typename E>
+void QrFactorization<E>::applyPanel(int panel, Matrix<E> &b,
+                                    bool transposed) const {
+  const int m = qr.getN(), r = b.getM();
+  const int k0 = panel * blockSize, kb = triangular[panel].getN();
+  const int mk = m - k0;
+  const std::size_t ld = qr.stride();
+  const E *a = qr.data();
+  std::vector<E> v(static_cast<std::size_t>(mk) * kb, E(0));
+  for (int i = 0; i < mk; i++)
+    for (int l = 0; l < std::min(i + 1, kb); l++)
+      v[i * kb + l] = i == l ? E(1) : a[(k0 + i) * ld + k0 + l];
+  std::vector<E> vt(static_cast<std::size_t>(kb) * mk);
+  kernels::transpose(mk, kb, v.data(), kb, vt.data(), mk);
+  std::vector<E> w(static_cast<std::size_t>(kb) * r);
+  E *c = b.data() + static_cast<std::size_t>(k0) * b.stride();
+  kernels::parallelGemm(kb, r, mk, vt.data(), mk, c, b.stride(), w.data(), r,
+                        kernels::GemmUpdate::overwrite);
+  const Matrix<E> &t = triangular[panel];
+  if (transposed) {
+    for (int i = kb - 1; i >= 0; i--) {
+      E *wi = w.data() + static_cast<std::size_t>(i) * r;
+      const E d = t.coeff(i, i);
+      for (int q = 0; q < r; q++)
+        wi[q] *= d;
+      for (int l = 0; l < i; l++) {
+        const E f = t.coeff(l, i);
+        const E *wl = w.data() + static_cast<std::size_t>(l) * r;
+        for (int q = 0; q < r; q++)
+          wi[q] += f * wl[q];
+      }
+    }
+  } else {
+    // W <- T * W, top row first: row i only needs rows >= i
+    for (int i = 0; i < kb; i++) {
+      E *wi = w.data() + static_cast<std::size_t>(i) * r;
+      const E d = t.coeff(i, i);
+      for (int q = 0; q < r; q++)
+        wi[q] *= d;
+      for (int l = i + 1; l < kb; l++) {
+        const E f = t.coeff(i, l);
+        const E *wl = w.data() + static_cast<std::size_t>(l) * r;
+        for (int q = 0; q < r; q++)
+          wi[q] += f * wl[q];
+      }
+    }
+  }
+  kernels::parallelGemm(mk, r, kb, v.data(), kb, w.data(), r, c, b.stride(),
+                        kernels::GemmUpdate::subtract);
+}
+
+template <typename E> const Matrix<E> &QrFactorization<E>::factors() const {
+  return qr;
+}
+
+template <typename E> Matrix<E> QrFactorization<E>::r() const {
+  const int k = std::min(qr.getN(), qr.getM()), n = qr.getM();
+  Matrix<E> r(k, n);
+  for (int i = 0; i < k; i++)
+    for (int j = i; j < n; j++)
+      r.get(i, j) = qr.coeff(i, j);
+  return r;
+}
+
+template <typename E> Matrix<E> QrFactorization<E>::thinQ() const {
+  const int m = qr.getN(), k = std::min(m, qr.getM());
+  Matrix<E> q(m, k);
+  for (int i = 0; i < k; i++)
+    q.get(i, i) = E(1);
+  applyQ(q);
+  return q;
+}
+
+template <typename E> void QrFactorization<E>::applyQt(Matrix<E> &b) const {
+  if (b.getN() != qr.getN())
+    throw std::runtime_error("Invalid dimensions for Q^T*B.");
+  for (int p = 0; p < static_cast<int>(triangular.size()); p++)
+    applyPanel(p, b, true);
+}
+
+template <typename E> void QrFactorization<E>::applyQ(Matrix<E> &b) const {
+  if (b.getN() != qr.getN())
+    throw std::runtime_error("Invalid dimensions for Q*B.");
+  for (int p = static_cast<int>(triangular.size()) - 1; p >= 0; p--)
+    applyPanel(p, b, false);
+}
+
+template <typename E>
+Matrix<E> QrFactorization<E>::leastSquares(const Matrix<E> &b) const {
+  const int m = qr.getN(), n = qr.getM(), r = b.getM();
+  if (m < n)
+    throw std::runtime_error(
+        "Least squares needs at least as many rows as columns.");
+  if (detail::rankDeficient(n, m, qr.data(), qr.stride()))
+    throw std::runtime_error("Rank deficient matrix.");
+  Matrix<E> c(b);
+  applyQt(c);
+  Matrix<E> x(n, r);
+  for (int i = 0; i < n; i++)
+    std::copy(&c.coeff(i, 0), &c.coeff(i, 0) + r,
+              x.data() + static_cast<std::size_t>(i) * x.stride());
+  detail::upperSolve(n, r, qr.data(), qr.stride(), x.data(), x.stride());
+  return x;
+}
+
+template <typename E>
+StreamingLeastSquares<E>::StreamingLeastSquares(int columns,
+                                                int rightHandSides,
+                                                int blockSize)
+    : columns(columns), rightHandSides(rightHandSides), blockSize(blockSize),
+      residualSquares(std::max(rightHandSides, 0), E(0)) {
+  if (columns < 1 || rightHandSides < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+}
+
+template <typename E>
+void StreamingLeastSquares<E>::push(const Matrix<E> &a, const Matrix<E> &b) {
+  const int n = columns, r = rightHandSides, h = a.getN();
+  if (a.getM() != n || b.getM() != r || b.getN() != h)
+    throw std::runtime_error("Invalid dimensions for least squares rows.");
+  const int k = top ? top->getN() : 0;
+  // [R | Q^T*B] stacked over [A | B]
+  Matrix<E> stack(k + h, n + r);
+  for (int i = 0; i < k; i++)
+    std::copy(&top->coeff(i, 0), &top->coeff(i, 0) + n + r, &stack.get(i, 0));
+  for (int i = 0; i < h; i++) {
+    std::copy(&a.coeff(i, 0), &a.coeff(i, 0) + n, &stack.get(k + i, 0));
+    std::copy(&b.coeff(i, 0), &b.coeff(i, 0) + r, &stack.get(k + i, n));
+  }
+  const QrFactorization<E> f(std::move(stack), blockSize, n);
+  const Matrix<E> &packed = f.factors();
+  const int total = k + h, kept = std::min(total, n);
+  // the rows below R only carry residual
+  for (int i = kept; i < total; i++)
+    for (int j = 0; j < r; j++)
+      residualSquares[j] += packed.coeff(i, n + j) * packed.coeff(i, n + j);
+  Matrix<E> next(kept, n + r);
+  for (int i = 0; i < kept; i++)
+    std::copy(&packed.coeff(i, i), &packed.coeff(i, 0) + n + r,
+              &next.get(i, i));
+  top = std::move(next);
+  rowCount += h;
+}
+
+template <typename E> long StreamingLeastSquares<E>::rows() const {
+  return rowCount;
+}
+
+template <typename E> Matrix<E> StreamingLeastSquares<E>::r() const {
+  if (!top || top->getN() < columns)
+    throw std::runtime_error("Fewer rows than columns pushed so far.");
+  Matrix<E> r(columns, columns);
+  for (int i = 0; i < columns; i++)
+    std::copy(&top->coeff(i, i), &top->coeff(i, 0) + columns, &r.get(i, i));
+  return r;
+}
+
+template <typename E> Matrix<E> StreamingLeastSquares<E>::solve() const {
+  Matrix<E> r = this->r();
+  if (detail::rankDeficient(columns, rowCount, r.data(), r.stride()))
+    throw std::runtime_error("Rank deficient matrix.");
+  Matrix<E> x(columns, rightHandSides);
+  for (int i = 0; i < columns; i++)
+    std::copy(&top->coeff(i, columns),
+              &top->coeff(i, columns) + rightHandSides, &x.get(i, 0));
+  detail::upperSolve(columns, rightHandSides, r.data(), r.stride(), x.data(),
+                     x.stride());
+  return x;
+}
+
+template <typename E>
+E StreamingLeastSquares<E>::residualNorm(int rightHandSide) const {
+  using std::sqrt;
+  return sqrt(residualSquares.at(rightHandSide));
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1,17 @@
+#include "Refinement.h"
+
+#include <bit>
+#include <cstdint>
+
+namespace linopt::inmemory {
+
+float roundToBfloat16(float x) {
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(x);
+  if ((bits & 0x7f800000u) == 0x7f800000u)
+    return x; // infinities and NaNs
+  // round to nearest, ties to even, on the 16 bits dropped
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return std::bit_cast<float>(bits & 0xffff0000u);
+}
+
+} // namespace linopt::inmemory
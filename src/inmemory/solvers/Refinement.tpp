@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Gemm.h"
+#include "Lu.h"
+#include "Metrics.h"
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Copy of a with every entry converted to T (and rounded to
+ * bfloat16 if asked). Sets finite to false if an entry overflows.
+ * \param columnScales: if given, column j is multiplied by columnScales[j]
+ * in the wider of E and T before the conversion.
+ */
+template <typename T, typename E>
+Matrix<T> convertEntries(const Matrix<E> &a, bool bfloat16, bool &finite,
+                         const std::vector<double> *columnScales = nullptr) {
+  using W = std::common_type_t<T, E, double>;
+  const int n = a.getN(), m = a.getM();
+  Matrix<T> c(n, m);
+  std::atomic<bool> overflow = false;
+  parallel::parallelFor(0, n, static_cast<long>(n) * m, [&](int r0, int r1) {
+    bool local = false;
+    for (int i = r0; i < r1; i++) {
+      const E *s = a.data() + static_cast<std::size_t>(i) * a.stride();
+      T *d = c.data() + static_cast<std::size_t>(i) * c.stride();
+      for (int j = 0; j < m; j++) {
+        d[j] = columnScales ? static_cast<T>(static_cast<W>(s[j]) *
+                                             (*columnScales)[j])
+                            : static_cast<T>(s[j]);
+        if (bfloat16)
+          d[j] = roundToBfloat16(d[j]);
+        local = local || !std::isfinite(d[j]);
+      }
+    }
+    if (local)
+      overflow.store(true, std::memory_order_relaxed);
+  });
+  finite = !overflow;
+  return c;
+}
+
+/**
+ * \brief Solution of a*d = r through the float factors of a, in E.
+ *
+ * Each column of r is scaled by a power of two to a largest entry in
+ * [1, 2) before being rounded to float, so that small residuals neither
+ * flush to zero nor lose their low bits to subnormals.
+ * \return false if r or the correction overflow float.
+ */
+template <typename E>
+bool correction(const LuFactorization<float> &lu, const Matrix<E> &r,
+                Matrix<E> &d) {
+  const int n = r.getN(), k = r.getM();
+  std::vector<double> down(k, 1.0), up(k, 1.0);
+  for (int j = 0; j < k; j++) {
+    double largest = 0;
+    for (int i = 0; i < n; i++) {
+      const double v = std::abs(static_cast<double>(r.get(i, j)));
+      if (!(v <= largest)) // NaN included
+        largest = v;
+    }
+    if (!std::isfinite(largest))
+      return false;
+    if (largest > 0) {
+      const int e = std::ilogb(largest);
+      down[j] = std::ldexp(1.0, -e);
+      up[j] = std::ldexp(1.0, e);
+    }
+  }
+  bool finite = true;
+  Matrix<float> low = convertEntries<float>(r, false, finite, &down);
+  if (!finite)
+    return false;
+  lu.solveInPlace(low);
+  d = convertEntries<E>(low, false, finite, &up);
+  return finite;
+}
+
+/**
+ * \brief Largest absolute row sum of a, NaN if a has a NaN entry.
+ */
+template <typename E> double normInf(const Matrix<E> &a) {
+  double largest = 0;
+  for (int i = 0; i < a.getN(); i++) {
+    const E *row = a.data() + static_cast<std::size_t>(i) * a.stride();
+    double s = 0;
+    for (int j = 0; j < a.getM(); j++)
+      s += std::abs(static_cast<double>(row[j]));
+    if (!(s <= largest))
+      largest = s;
+  }
+  return largest;
+}
+
+/**
+ * \brief r <- b - a*x, and the backward error of x, worst column.
+ *
+ * +inf if a, b, x or r has a non-finite entry.
+ */
+template <typename E>
+double residual(const Matrix<E> &a, const Matrix<E> &b, const Matrix<E> &x,
+                double normA, Matrix<E> &r) {
+  const int n = a.getN(), k = b.getM();
+  r = b;
+  kernels::parallelGemm<E>(n, k, n, a.data(), a.stride(), x.data(),
+                           x.stride(), r.data(), r.stride(),
+                           kernels::GemmUpdate::subtract);
+  constexpr double infinity = std::numeric_limits<double>::infinity();
+  if (!std::isfinite(normA))
+    return infinity;
+  double worst = 0;
+  for (int j = 0; j < k; j++) {
+    double rj = 0, xj = 0, bj = 0;
+    for (int i = 0; i < n; i++) {
+      const double ri = std::abs(static_cast<double>(r.get(i, j)));
+      const double xi = std::abs(static_cast<double>(x.get(i, j)));
+      const double bi = std::abs(static_cast<double>(b.get(i, j)));
+      if (!std::isfinite(ri) || !std::isfinite(xi) || !std::isfinite(bi))
+        return infinity;
+      rj = std::max(rj, ri);
+      xj = std::max(xj, xi);
+      bj = std::max(bj, bi);
+    }
+    // rj is finite: an overflowing scale gives 0, not inf / inf
+    const double scale = normA * xj + bj;
+    worst = std::max(worst, scale > 0 ? rj / scale : rj);
+  }
+  return worst;
+}
+
+} // namespace detail
+
+template <typename E>
+RefinementStats refinedSolve(const Matrix<E> &a, const Matrix<E> &b,
+                             Matrix<E> &x, const RefinementOptions &options) {
+  static_assert(std::is_floating_point_v<E> && sizeof(E) > sizeof(float),
+                "Refinement needs a working precision wider than float.");
+  const auto start = std::chrono::steady_clock::now();
+  const int n = a.getN();
+  if (a.getM() != n || b.getN() != n)
+    throw std::runtime_error("Invalid dimensions for linear system.");
+  LINOPT_METRICS_SCOPE("refinedSolve", n, b.getM(), 0,
+                       2.0 * n * n * n / 3,
+                       static_cast<double>(n) * n * sizeof(float));
+  const double tolerance =
+      options.tolerance > 0
+          ? options.tolerance
+          : std::sqrt(static_cast<double>(n)) *
+                std::numeric_limits<E>::epsilon();
+  RefinementStats stats;
+  stats.backwardError = std::numeric_limits<double>::infinity();
+  const double normA = detail::normInf(a);
+  Matrix<E> r(b), d(b);
+
+  bool finite = true;
+  Matrix<float> low = detail::convertEntries<float>(
+      a, options.precision == FactorPrecision::bfloat16, finite);
+  if (finite) {
+    const LuFactorization<float> lu(std::move(low));
+    if (!lu.isSingular() && detail::correction(lu, b, d)) {
+      // the best iterate so far is kept in x, the candidate built in d
+      x = d;
+      stats.backwardError = detail::residual(a, b, x, normA, r);
+      while (!(stats.backwardError <= tolerance) &&
+             stats.iterations < options.maxIterations) {
+        if (!detail::correction(lu, r, d))
+          break;
+        d += x;
+        stats.iterations++;
+        Matrix<E> candidate(r);
+        const double error = detail::residual(a, b, d, normA, candidate);
+        // a contraction factor of 1 or more: cond(a) is too large for float
+        if (!(error < stats.backwardError))
+          break;
+        x.swap(d);
+        r.swap(candidate);
+        stats.backwardError = error;
+      }
+      stats.converged = stats.backwardError <= tolerance;
+    }
+  }
+  if (!stats.converged && options.fallback) {
+    x = LuFactorization<E>(a).solve(b);
+    stats.fellBack = true;
+    stats.backwardError = detail::residual(a, b, x, normA, r);
+    stats.converged = stats.backwardError <= tolerance;
+  }
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return stats;
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1 @@
+#include "Solve.h"
@@ -0,0 +1,30 @@
+/**
+ * \file Solve.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the dense linear system solvers.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SOLVERS_SOLVE_H
+#define LINOPT_ERC_INMEMORY_SOLVERS_SOLVE_H
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Solves a*x = b by LU factorization with partial pivoting.
+ *
+ * To solve several systems with the same a, keep a \sa LuFactorization.
+ *
+ * Throws a runtime_error if a is not square, if b has another number of
+ * rows, or if a is singular.
+ * \param a: the nxn matrix of the system.
+ * \param b: the nxr right hand sides, one per column.
+ * \return x: the nxr solutions.
+ */
+template <typename E> Matrix<E> solve(const Matrix<E> &a, const Matrix<E> &b);
+
+} // namespace linopt::inmemory
+
+#include "Solve.tpp"
+#endif
@@ -0,0 +1,13 @@
+#include <stdexcept>
+
+#include "Lu.h"
+
+namespace linopt::inmemory {
+
+template <typename E> Matrix<E> solve(const Matrix<E> &a, const Matrix<E> &b) {
+  if (a.getM() != a.getN() || b.getN() != a.getN())
+    throw std::runtime_error("Invalid dimensions for linear system.");
+  return LuFactorization<E>(a).solve(b);
+}
+
+} // namespace linopt::inmemory
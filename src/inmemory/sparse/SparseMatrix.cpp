@@ -0,0 +1 @@
+#include "SparseMatrix.h"
@@ -0,0 +1,208 @@
+/**
+ * \file SparseMatrix.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::inmemory::SparseMatrix class and its
+ * kernels.
+ * \details
+ *  A sparse matrix stores its nonzero entries in compressed rows (csr) or
+ *  compressed columns (csc): offsets[o] to offsets[o+1] delimit the entries
+ *  of row (column) o, indices holds their column (row) and values their
+ *  value, sorted by index without duplicates.
+ *
+ *  The parallel kernels split the rows (columns) into chunks holding about
+ *  the same number of nonzeros rather than the same number of rows, so a
+ *  few dense rows do not serialize a product.
+ */
+#ifndef LINOPT_ERC_INMEMORY_SPARSE_SPARSEMATRIX_H
+#define LINOPT_ERC_INMEMORY_SPARSE_SPARSEMATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Matrix.h"
+
+namespace linopt::inmemory {
+
+/**
+ * \brief Storage order of a \sa SparseMatrix.
+ */
+enum class Layout {
+  /**
+   * \brief Compressed sparse rows.
+   */
+  csr,
+  /**
+   * \brief Compressed sparse columns.
+   */
+  csc
+};
+
+/**
+ * \brief An entry (row, col, value) handed to \sa SparseMatrix::fromTriplets.
+ */
+template <typename E> struct Triplet {
+  int row;
+  int col;
+  E value;
+};
+
+/**
+ * \brief A sparse nxm matrix in compressed rows or columns.
+ */
+template <typename E> class SparseMatrix {
+private:
+  int rows, columns;
+  Layout storage;
+  std::vector<std::size_t> starts;
+  std::vector<int> inner;
+  std::vector<E> entries;
+
+  void check() const;
+
+public:
+  typedef E value_type;
+
+  /**
+   * \brief Constructs an nxm matrix with no nonzero entries.
+   */
+  SparseMatrix(int n, int m, Layout layout = Layout::csr);
+
+  /**
+   * \brief Constructs a matrix from its compressed arrays.
+   *
+   * Throws a runtime_error if the arrays are inconsistent, or if the indices
+   * of a row (column) are not strictly increasing.
+   * \param offsets: the getN()+1 (csr) or getM()+1 (csc) offsets.
+   * \param indices: the column (csr) or row (csc) of each entry.
+   * \param values: the value of each entry.
+   */
+  SparseMatrix(int n, int m, Layout layout, std::vector<std::size_t> offsets,
+               std::vector<int> indices, std::vector<E> values);
+
+  /**
+   * \brief Builds a matrix from (row, col, value) entries in any order.
+   *
+   * Entries at the same position are summed.
+   */
+  static SparseMatrix<E> fromTriplets(int n, int m,
+                                      const std::vector<Triplet<E>> &triplets,
+                                      Layout layout = Layout::csr);
+
+  /**
+   * \brief Builds a matrix holding the entries of a dense matrix.
+   * \param dropTolerance: entries of magnitude up to it are left out.
+   */
+  static SparseMatrix<E> fromDense(const Matrix<E> &a,
+                                   Layout layout = Layout::csr,
+                                   E dropTolerance = E(0));
+
+  /**
+   * \brief Get the number of rows.
+   */
+  int getN() const;
+
+  /**
+   * \brief Get the number of columns.
+   */
+  int getM() const;
+
+  /**
+   * \brief Get the storage order.
+   */
+  Layout layout() const;
+
+  /**
+   * \brief Get the number of stored entries.
+   */
+  std::size_t nonZeros() const;
+
+  const std::vector<std::size_t> &offsets() const;
+  const std::vector<int> &indices() const;
+  const std::vector<E> &values() const;
+
+  /**
+   * \brief The stored values, to be modified in place (the sparsity pattern
+   * cannot change).
+   */
+  std::vector<E> &values();
+
+  /**
+   * \brief Get the entry at (r, c), E() if it is not stored.
+   *
+   * A binary search over the row (column).
+   */
+  E coeff(int r, int c) const;
+
+  /**
+   * \brief Get the diagonal entries.
+   */
+  std::vector<E> diagonal() const;
+
+  /**
+   * \brief The same matrix stored in the given layout.
+   */
+  SparseMatrix<E> toLayout(Layout layout) const;
+
+  /**
+   * \brief The transpose, stored in the other layout.
+   *
+   * The compressed arrays are reinterpreted, not reordered: csr rows of the
+   * matrix are the csc columns of its transpose.
+   */
+  SparseMatrix<E> transpose() const;
+
+  /**
+   * \brief The dense copy of the matrix.
+   */
+  Matrix<E> toDense() const;
+
+  /**
+   * \brief Computes y = A*x (SpMV).
+   * \param x: getM() entries.
+   * \param y: getN() entries, overwritten.
+   */
+  void multiply(const E *x, E *y) const;
+
+  /**
+   * \brief Computes A*x (SpMV).
+   */
+  std::vector<E> operator*(const std::vector<E> &x) const;
+};
+
+/**
+ * \brief Sparse times dense product (SpMM).
+ */
+template <typename E>
+Matrix<E> operator*(const SparseMatrix<E> &a, const Matrix<E> &b);
+
+/**
+ * \brief Dense times sparse product.
+ */
+template <typename E>
+Matrix<E> operator*(const Matrix<E> &a, const SparseMatrix<E> &b);
+
+/**
+ * \brief Sparse times sparse product (Gustavson's row by row algorithm).
+ *
+ * The result has the layout of a.
+ */
+template <typename E>
+SparseMatrix<E> operator*(const SparseMatrix<E> &a, const SparseMatrix<E> &b);
+
+/**
+ * \brief Sparse sum. The result has the layout of a.
+ */
+template <typename E>
+SparseMatrix<E> operator+(const SparseMatrix<E> &a, const SparseMatrix<E> &b);
+
+/**
+ * \brief Sparse difference. The result has the layout of a.
+ */
+template <typename E>
+SparseMatrix<E> operator-(const SparseMatrix<E> &a, const SparseMatrix<E> &b);
+
+} // namespace linopt::inmemory
+
+#include "SparseMatrix.tpp"
+#endif
@@ -0,0 +1,552 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "Parallel.h"
+
+namespace linopt::inmemory {
+
+namespace detail {
+
+/**
+ * \brief Runs body(o0, o1) over chunks of the outer range [0, offsets.size()-1)
+ * holding about the same number of entries each.
+ */
+template <typename F>
+void balancedFor(const std::vector<std::size_t> &offsets, long work,
+                 F &&body) {
+  const int outer = static_cast<int>(offsets.size()) - 1;
+  const std::size_t total = offsets.back();
+  const int parts = std::min(outer, 256);
+  auto boundary = [&](int p) {
+    if (p >= parts)
+      return outer;
+    const std::size_t target = total * p / parts;
+    return static_cast<int>(
+        std::lower_bound(offsets.begin(), offsets.end(), target) -
+        offsets.begin());
+  };
+  parallel::parallelFor(0, parts, work, [&](int p0, int p1) {
+    const int o0 = std::min(boundary(p0), outer);
+    const int o1 = std::min(boundary(p1), outer);
+    if (o0 < o1)
+      body(o0, o1);
+  });
+}
+
+/**
+ * \brief Dot product of a compressed row with a dense vector, four partial
+ * sums deep so that the gathers overlap.
+ */
+template <typename E>
+E sparseDot(const int *index, const E *value, std::size_t count,
+            const E *x) {
+  E s0(0), s1(0), s2(0), s3(0);
+  std::size_t p = 0;
+  for (; p + 4 <= count; p += 4) {
+    s0 += value[p] * x[index[p]];
+    s1 += value[p + 1] * x[index[p + 1]];
+    s2 += value[p + 2] * x[index[p + 2]];
+    s3 += value[p + 3] * x[index[p + 3]];
+  }
+  for (; p < count; p++)
+    s0 += value[p] * x[index[p]];
+  return (s0 + s1) + (s2 + s3);
+}
+
+/**
+ * \brief Product of two csr matrices, a is nxk and b kxm.
+ */
+template <typename E>
+SparseMatrix<E> csrMultiply(const SparseMatrix<E> &a,
+                            const SparseMatrix<E> &b) {
+  const int n = a.getN(), m = b.getM();
+  const std::vector<std::size_t> &ao = a.offsets(), &bo = b.offsets();
+  const std::vector<int> &ai = a.indices(), &bi = b.indices();
+  const std::vector<E> &av = a.values(), &bv = b.values();
+  long flops = 0;
+  for (int k : ai)
+    flops += static_cast<long>(bo[k + 1] - bo[k]);
+  // symbolic pass: the number of entries of each row of the product
+  std::vector<std::size_t> offsets(n + 1, 0);
+  balancedFor(ao, flops, [&](int i0, int i1) {
+    std::vector<int> marker(m, -1);
+    for (int i = i0; i < i1; i++) {
+      std::size_t count = 0;
+      for (std::size_t p = ao[i]; p < ao[i + 1]; p++)
+        for (std::size_t q = bo[ai[p]]; q < bo[ai[p] + 1]; q++)
+          if (marker[bi[q]] != i) {
+            marker[bi[q]] = i;
+            count++;
+          }
+      offsets[i + 1] = count;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<int> indices(offsets.back());
+  std::vector<E> values(offsets.back());
+  // numeric pass: each row accumulated in a dense scratch row
+  balancedFor(ao, flops, [&](int i0, int i1) {
+    std::vector<int> marker(m, -1);
+    std::vector<E> accumulator(m);
+    for (int i = i0; i < i1; i++) {
+      std::size_t end = offsets[i];
+      for (std::size_t p = ao[i]; p < ao[i + 1]; p++) {
+        const E v = av[p];
+        for (std::size_t q = bo[ai[p]]; q < bo[ai[p] + 1]; q++) {
+          const int j = bi[q];
+          if (marker[j] != i) {
+            marker[j] = i;
+            indices[end++] = j;
+            accumulator[j] = v * bv[q];
+          } else {
+            accumulator[j] += v * bv[q];
+          }
+        }
+      }
+      std::sort(indices.begin() + offsets[i], indices.begin() + end);
+      for (std::size_t p = offsets[i]; p < end; p++)
+        values[p] = accumulator[indices[p]];
+    }
+  });
+  return SparseMatrix<E>(n, m, Layout::csr, std::move(offsets),
+                         std::move(indices), std::move(values));
+}
+
+/**
+ * \brief Merges a and b, of the same dimensions and layout, entry by entry:
+ * op(a(i,j), b(i,j)), missing entries being E().
+ */
+template <typename E, typename Op>
+SparseMatrix<E> merge(const SparseMatrix<E> &a, const SparseMatrix<E> &b,
+                      Op op) {
+  const std::vector<std::size_t> &ao = a.offsets(), &bo = b.offsets();
+  const std::vector<int> &ai = a.indices(), &bi = b.indices();
+  const std::vector<E> &av = a.values(), &bv = b.values();
+  const int outer = static_cast<int>(ao.size()) - 1;
+  const long work = static_cast<long>(a.nonZeros() + b.nonZeros());
+  std::vector<std::size_t> offsets(outer + 1, 0);
+  parallel::parallelFor(0, outer, work, [&](int o0, int o1) {
+    for (int o = o0; o < o1; o++) {
+      std::size_t p = ao[o], q = bo[o], count = 0;
+      while (p < ao[o + 1] || q < bo[o + 1]) {
+        if (q == bo[o + 1] || (p < ao[o + 1] && ai[p] < bi[q]))
+          p++;
+        else if (p == ao[o + 1] || bi[q] < ai[p])
+          q++;
+        else
+          p++, q++;
+        count++;
+      }
+      offsets[o + 1] = count;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<int> indices(offsets.back());
+  std::vector<E> values(offsets.back());
+  parallel::parallelFor(0, outer, work, [&](int o0, int o1) {
+    for (int o = o0; o < o1; o++) {
+      std::size_t p = ao[o], q = bo[o], r = offsets[o];
+      while (p < ao[o + 1] || q < bo[o + 1]) {
+        if (q == bo[o + 1] || (p < ao[o + 1] && ai[p] < bi[q])) {
+          indices[r] = ai[p];
+          values[r] = op(av[p++], E());
+        } else if (p == ao[o + 1] || bi[q] < ai[p]) {
+          indices[r] = bi[q];
+          values[r] = op(E(), bv[q++]);
+        } else {
+          indices[r] = ai[p];
+          values[r] = op(av[p++], bv[q++]);
+        }
+        r++;
+      }
+    }
+  });
+  return SparseMatrix<E>(a.getN(), a.getM(), a.layout(), std::move(offsets),
+                         std::move(indices), std::move(values));
+}
+
+} // namespace detail
+
+template <typename E>
+SparseMatrix<E>::SparseMatrix(int n, int m, Layout layout)
+    : rows(n), columns(m), storage(layout),
+      starts((layout == Layout::csr ? n : m) + 1, 0) {
+  if (n < 1 || m < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+}
+
+template <typename E>
+SparseMatrix<E>::SparseMatrix(int n, int m, Layout layout,
+                              std::vector<std::size_t> offsets,
+                              std::vector<int> indices, std::vector<E> values)
+    : rows(n), columns(m), storage(layout), starts(std::move(offsets)),
+      inner(std::move(indices)), entries(std::move(values)) {
+  if (n < 1 || m < 1)
+    throw std::runtime_error("Invalid matrix dimension (<1).");
+  check();
+}
+
+template <typename E> void SparseMatrix<E>::check() const {
+  const int outer = storage == Layout::csr ? rows : columns;
+  const int size = storage == Layout::csr ? columns : rows;
+  if (static_cast<int>(starts.size()) != outer + 1 || starts.front() != 0 ||
+      starts.back() != inner.size() || inner.size() != entries.size())
+    throw std::runtime_error("Invalid compressed sparse arrays.");
+  for (int o = 0; o < outer; o++) {
+    if (starts[o] > starts[o + 1])
+      throw std::runtime_error("Invalid compressed sparse arrays.");
+    for (std::size_t p = starts[o]; p < starts[o + 1]; p++)
+      if (inner[p] < 0 || inner[p] >= size ||
+          (p > starts[o] && inner[p] <= inner[p - 1]))
+        throw std::runtime_error("Invalid compressed sparse indices.");
+  }
+}
+
+template <typename E>
+SparseMatrix<E>
+SparseMatrix<E>::fromTriplets(int n, int m,
+                              const std::vector<Triplet<E>> &triplets,
+                              Layout layout) {
+  SparseMatrix<E> r(n, m, layout);
+  const bool csr = layout == Layout::csr;
+  const int outer = csr ? n : m;
+  for (const Triplet<E> &t : triplets)
+    if (t.row < 0 || t.row >= n || t.col < 0 || t.col >= m)
+      throw std::runtime_error("Triplet out of bounds.");
+  // counting sort by outer index, then sort and sum within each
+  std::vector<std::size_t> cursor(outer + 1, 0);
+  for (const Triplet<E> &t : triplets)
+    cursor[(csr ? t.row : t.col) + 1]++;
+  std::partial_sum(cursor.begin(), cursor.end(), cursor.begin());
+  const std::vector<std::size_t> bucket(cursor);
+  std::vector<std::pair<int, E>> sorted(triplets.size());
+  for (const Triplet<E> &t : triplets)
+    sorted[cursor[csr ? t.row : t.col]++] = {csr ? t.col : t.row, t.value};
+  for (int o = 0; o < outer; o++) {
+    auto first = sorted.begin() + bucket[o],
+         last = sorted.begin() + bucket[o + 1];
+    std::stable_sort(first, last, [](const auto &x, const auto &y) {
+      return x.first < y.first;
+    });
+    for (auto it = first; it != last; ++it) {
+      if (it != first && it->first == (it - 1)->first) {
+        r.entries.back() += it->second;
+        continue;
+      }
+      r.inner.push_back(it->first);
+      r.entries.push_back(it->second);
+    }
+    r.starts[o + 1] = r.inner.size();
+  }
+  return r;
+}
+
+template <typename E>
+SparseMatrix<E> SparseMatrix<E>::fromDense(const Matrix<E> &a, Layout layout,
+                                           E dropTolerance) {
+  using std::abs;
+  const int n = a.getN(), m = a.getM();
+  SparseMatrix<E> r(n, m, Layout::csr);
+  for (int i = 0; i < n; i++) {
+    const E *row = a.data() + static_cast<std::size_t>(i) * a.stride();
+    for (int j = 0; j < m; j++)
+      if (row[j] != E(0) && abs(row[j]) > dropTolerance) {
+        r.inner.push_back(j);
+        r.entries.push_back(row[j]);
+      }
+    r.starts[i + 1] = r.inner.size();
+  }
+  return layout == Layout::csr ? r : r.toLayout(layout);
+}
+
+template <typename E> int SparseMatrix<E>::getN() const { return rows; }
+
+template <typename E> int SparseMatrix<E>::getM() const { return columns; }
+
+template <typename E> Layout SparseMatrix<E>::layout() const {
+  return storage;
+}
+
+template <typename E> std::size_t SparseMatrix<E>::nonZeros() const {
+  return entries.size();
+}
+
+template <typename E>
+const std::vector<std::size_t> &SparseMatrix<E>::offsets() const {
+  return starts;
+}
+
+template <typename E> const std::vector<int> &SparseMatrix<E>::indices() const {
+  return inner;
+}
+
+template <typename E> const std::vector<E> &SparseMatrix<E>::values() const {
+  return entries;
+}
+
+template <typename E> std::vector<E> &SparseMatrix<E>::values() {
+  return entries;
+}
+
+template <typename E> E SparseMatrix<E>::coeff(int r, int c) const {
+  if (r < 0 || r >= rows || c < 0 || c >= columns)
+    throw std::runtime_error("Out of bounds matrix access.");
+  const int o = storage == Layout::csr ? r : c;
+  const int i = storage == Layout::csr ? c : r;
+  auto first = inner.begin() + starts[o], last = inner.begin() + starts[o + 1];
+  auto it = std::lower_bound(first, last, i);
+  return it != last && *it == i ? entries[it - inner.begin()] : E();
+}
+
+template <typename E> std::vector<E> SparseMatrix<E>::diagonal() const {
+  std::vector<E> d(std::min(rows, columns));
+  for (int o = 0; o < static_cast<int>(d.size()); o++) {
+    auto first = inner.begin() + starts[o],
+         last = inner.begin() + starts[o + 1];
+    auto it = std::lower_bound(first, last, o);
+    if (it != last && *it == o)
+      d[o] = entries[it - inner.begin()];
+  }
+  return d;
+}
+
+template <typename E>
+SparseMatrix<E> SparseMatrix<E>::toLayout(Layout layout) const {
+  if (layout == storage)
+    return *this;
+  // counting sort by inner index; outer indices come out sorted
+  const int size = storage == Layout::csr ? columns : rows;
+  const int outer = static_cast<int>(starts.size()) - 1;
+  SparseMatrix<E> r(rows, columns, layout);
+  std::vector<std::size_t> cursor(size + 1, 0);
+  for (int i : inner)
+    cursor[i + 1]++;
+  std::partial_sum(cursor.begin(), cursor.end(), cursor.begin());
+  r.starts = cursor;
+  r.inner.resize(inner.size());
+  r.entries.resize(entries.size());
+  for (int o = 0; o < outer; o++)
+    for (std::size_t p = starts[o]; p < starts[o + 1]; p++) {
+      const std::size_t q = cursor[inner[p]]++;
+      r.inner[q] = o;
+      r.entries[q] = entries[p];
+    }
+  return r;
+}
+
+template <typename E> SparseMatrix<E> SparseMatrix<E>::transpose() const {
+  SparseMatrix<E> r(*this);
+  std::swap(r.rows, r.columns);
+  r.storage = storage == Layout::csr ? Layout::csc : Layout::csr;
+  return r;
+}
+
+template <typename E> Matrix<E> SparseMatrix<E>::toDense() const {
+  Matrix<E> r(rows, columns);
+  E *out = r.data();
+  const std::size_t ld = r.stride();
+  if (storage == Layout::csr) {
+    detail::balancedFor(starts, static_cast<long>(nonZeros()),
+                        [&](int i0, int i1) {
+                          for (int i = i0; i < i1; i++)
+                            for (std::size_t p = starts[i]; p < starts[i + 1];
+                                 p++)
+                              out[i * ld + inner[p]] = entries[p];
+                        });
+  } else {
+    for (int j = 0; j < columns; j++)
+      for (std::size_t p = starts[j]; p < starts[j + 1]; p++)
+        out[inner[p] * ld + j] = entries[p];
+  }
+  return r;
+}
+
+template <typename E> void SparseMatrix<E>::multiply(const E *x, E *y) const {
+  const long work = 2 * static_cast<long>(nonZeros()) + rows;
+  if (storage == Layout::csr) {
+    detail::balancedFor(starts, work, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++)
+        y[i] = detail::sparseDot(inner.data() + starts[i],
+                                 entries.data() + starts[i],
+                                 starts[i + 1] - starts[i], x);
+    });
+    return;
+  }
+  // csc scatters into y
+  auto scatter = [&](int j0, int j1, E *out) {
+    for (int j = j0; j < j1; j++) {
+      const E xj = x[j];
+      for (std::size_t p = starts[j]; p < starts[j + 1]; p++)
+        out[inner[p]] += entries[p] * xj;
+    }
+  };
+  std::fill(y, y + rows, E(0));
+  if (!parallel::shouldParallelize(work)) {
+    scatter(0, columns, y);
+    return;
+  }
+  // one chunk of columns per thread, of about the same number of entries,
+  // each into its own copy of y (the first one into y itself)
+  const int chunks =
+      std::min(columns, parallel::ThreadPool::shared().size() + 1);
+  std::vector<E> partials(static_cast<std::size_t>(chunks - 1) * rows, E(0));
+  auto boundary = [&](int c) {
+    if (c >= chunks)
+      return columns;
+    const std::size_t target = starts.back() * c / chunks;
+    return static_cast<int>(
+        std::lower_bound(starts.begin(), starts.end(), target) -
+        starts.begin());
+  };
+  parallel::parallelFor(0, chunks, work, [&](int c0, int c1) {
+    for (int c = c0; c < c1; c++) {
+      E *out = c == 0 ? y
+                      : partials.data() + static_cast<std::size_t>(c - 1) * rows;
+      scatter(boundary(c), boundary(c + 1), out);
+    }
+  });
+  // then summed over ranges of rows
+  parallel::parallelFor(
+      0, rows, static_cast<long>(chunks) * rows, [&](int i0, int i1) {
+        for (int c = 1; c < chunks; c++) {
+          const E *partial =
+              partials.data() + static_cast<std::size_t>(c - 1) * rows;
+          for (int i = i0; i < i1; i++)
+            y[i] += partial[i];
+        }
+      });
+}
+
+template <typename E>
+std::vector<E> SparseMatrix<E>::operator*(const std::vector<E> &x) const {
+  if (static_cast<int>(x.size()) != columns)
+    throw std::runtime_error("Invalid dimensions for matrix vector product.");
+  std::vector<E> y(rows);
+  multiply(x.data(), y.data());
+  return y;
+}
+
+template <typename E>
+Matrix<E> operator*(const SparseMatrix<E> &a, const Matrix<E> &b) {
+  if (a.getM() != b.getN())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  const int m = b.getM();
+  Matrix<E> c(a.getN(), m);
+  const std::vector<std::size_t> &offsets = a.offsets();
+  const std::vector<int> &indices = a.indices();
+  const std::vector<E> &values = a.values();
+  const std::size_t ldb = b.stride(), ldc = c.stride();
+  const long work = 2 * static_cast<long>(a.nonZeros()) * m;
+  if (a.layout() == Layout::csr) {
+    // row i of C is a combination of rows of B: contiguous, vectorized axpys
+    detail::balancedFor(offsets, work, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++) {
+        E *ci = c.data() + i * ldc;
+        for (std::size_t p = offsets[i]; p < offsets[i + 1]; p++) {
+          const E v = values[p];
+          const E *bk = b.data() + indices[p] * ldb;
+          for (int j = 0; j < m; j++)
+            ci[j] += v * bk[j];
+        }
+      }
+    });
+    return c;
+  }
+  // csc: column k of A times row k of B, split over strips of columns of C
+  const int strip = std::max(1, static_cast<int>(cacheLineSize / sizeof(E)));
+  parallel::parallelFor(0, (m + strip - 1) / strip, work, [&](int s0, int s1) {
+    const int j0 = s0 * strip, j1 = std::min(m, s1 * strip);
+    for (int k = 0; k < a.getM(); k++) {
+      const E *bk = b.data() + k * ldb;
+      for (std::size_t p = offsets[k]; p < offsets[k + 1]; p++) {
+        const E v = values[p];
+        E *ci = c.data() + indices[p] * ldc;
+        for (int j = j0; j < j1; j++)
+          ci[j] += v * bk[j];
+      }
+    }
+  });
+  return c;
+}
+
+template <typename E>
+Matrix<E> operator*(const Matrix<E> &a, const SparseMatrix<E> &b) {
+  if (a.getM() != b.getN())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  const int n = a.getN(), m = b.getM();
+  Matrix<E> c(n, m);
+  const std::vector<std::size_t> &offsets = b.offsets();
+  const std::vector<int> &indices = b.indices();
+  const std::vector<E> &values = b.values();
+  const std::size_t lda = a.stride(), ldc = c.stride();
+  const long work = 2 * static_cast<long>(b.nonZeros()) * n;
+  if (b.layout() == Layout::csr) {
+    // row i of C is a combination of rows of B, weighted by row i of A
+    parallel::parallelFor(0, n, work, [&](int i0, int i1) {
+      for (int i = i0; i < i1; i++) {
+        const E *ai = a.data() + i * lda;
+        E *ci = c.data() + i * ldc;
+        for (int k = 0; k < a.getM(); k++) {
+          const E v = ai[k];
+          for (std::size_t p = offsets[k]; p < offsets[k + 1]; p++)
+            ci[indices[p]] += v * values[p];
+        }
+      }
+    });
+    return c;
+  }
+  // csc: entry (i, j) of C is row i of A gathered by column j of B
+  parallel::parallelFor(0, n, work, [&](int i0, int i1) {
+    for (int i = i0; i < i1; i++) {
+      const E *ai = a.data() + i * lda;
+      E *ci = c.data() + i * ldc;
+      for (int j = 0; j < m; j++)
+        ci[j] = detail::sparseDot(indices.data() + offsets[j],
+                                  values.data() + offsets[j],
+                                  offsets[j + 1] - offsets[j], ai);
+    }
+  });
+  return c;
+}
+
+template <typename E>
+SparseMatrix<E> operator*(const SparseMatrix<E> &a,
+                          const SparseMatrix<E> &b) {
+  if (a.getM() != b.getN())
+    throw std::runtime_error("Invalid dimensions for matrix multiplication.");
+  if (a.layout() == Layout::csr)
+    return b.layout() == Layout::csr
+               ? detail::csrMultiply(a, b)
+               : detail::csrMultiply(a, b.toLayout(Layout::csr));
+  // csc: (A*B)^T = B^T * A^T, both csr
+  const SparseMatrix<E> bt = b.layout() == Layout::csc
+                                 ? b.transpose()
+                                 : b.toLayout(Layout::csc).transpose();
+  return detail::csrMultiply(bt, a.transpose()).transpose();
+}
+
+template <typename E>
+SparseMatrix<E> operator+(const SparseMatrix<E> &a,
+                          const SparseMatrix<E> &b) {
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    throw std::runtime_error("Invalid dimensions for matrix addition.");
+  if (b.layout() == a.layout())
+    return detail::merge(a, b, std::plus<E>());
+  return detail::merge(a, b.toLayout(a.layout()), std::plus<E>());
+}
+
+template <typename E>
+SparseMatrix<E> operator-(const SparseMatrix<E> &a,
+                          const SparseMatrix<E> &b) {
+  if (a.getN() != b.getN() || a.getM() != b.getM())
+    throw std::runtime_error("Invalid dimensions for matrix subtraction.");
+  if (b.layout() == a.layout())
+    return detail::merge(a, b, std::minus<E>());
+  return detail::merge(a, b.toLayout(a.layout()), std::minus<E>());
+}
+
+} // namespace linopt::inmemory
@@ -0,0 +1,134 @@
+#include "Lmf.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace linopt::io {
+
+namespace {
+
+template <typename T> T swapped(T value) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  std::reverse(bytes, bytes + sizeof(T));
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+std::uint32_t littleEndianWord(const unsigned char *bytes) {
+  std::uint32_t word;
+  std::memcpy(&word, bytes, sizeof(word));
+  if constexpr (std::endian::native == std::endian::big)
+    word = swapped(word);
+  return word;
+}
+
+// a*b, throwing if it does not fit in a size_t (hence in a uint64)
+std::uint64_t checkedProduct(std::uint64_t a, std::uint64_t b) {
+  constexpr std::uint64_t limit = std::numeric_limits<std::size_t>::max();
+  if (b != 0 && a > limit / b)
+    throw std::runtime_error("Invalid lmf file: payload size overflows.");
+  return a * b;
+}
+
+} // namespace
+
+std::uint64_t LmfHeader::payloadBytes() const {
+  return checkedProduct(checkedProduct(rows, rowStride), elementSize);
+}
+
+std::uint64_t LmfHeader::fileBytes() const {
+  constexpr std::uint64_t limit = std::numeric_limits<std::size_t>::max();
+  const std::uint64_t payload = payloadBytes();
+  if (payload > limit - headerSize)
+    throw std::runtime_error("Invalid lmf file: payload size overflows.");
+  return headerSize + payload;
+}
+
+Endianness nativeEndianness() {
+  return std::endian::native == std::endian::big ? Endianness::big
+                                                 : Endianness::little;
+}
+
+std::uint64_t checksum(const void *bytes, std::size_t size) {
+  constexpr std::uint64_t modulus = 0xFFFFFFFFull;
+  // a, b < 2^32 at the start of a block: b stays below 2^64 over 2^16 words
+  constexpr std::size_t block = std::size_t(1) << 16;
+  const unsigned char *p = static_cast<const unsigned char *>(bytes);
+  std::size_t words = size / 4;
+  std::uint64_t a = 0, b = 0;
+  while (words > 0) {
+    const std::size_t n = std::min(words, block);
+    for (std::size_t i = 0; i < n; i++, p += 4) {
+      a += littleEndianWord(p);
+      b += a;
+    }
+    a %= modulus;
+    b %= modulus;
+    words -= n;
+  }
+  if (size % 4 != 0) {
+    unsigned char last[4] = {0, 0, 0, 0};
+    std::memcpy(last, p, size % 4);
+    a = (a + littleEndianWord(last)) % modulus;
+    b = (b + a) % modulus;
+  }
+  return b << 32 | a;
+}
+
+void swapBytes(void *entries, std::size_t count, std::size_t size) {
+  unsigned char *p = static_cast<unsigned char *>(entries);
+  for (std::size_t i = 0; i < count; i++, p += size)
+    std::reverse(p, p + size);
+}
+
+LmfHeader readHeader(std::istream &is) {
+  char bytes[sizeof(LmfHeader)];
+  is.read(bytes, sizeof(bytes));
+  if (static_cast<std::size_t>(is.gcount()) != sizeof(bytes))
+    throw std::runtime_error("Invalid lmf file: truncated header.");
+  return decodeHeader(bytes);
+}
+
+LmfHeader decodeHeader(const void *bytes) {
+  LmfHeader header;
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.magic, LmfHeader().magic, sizeof(header.magic)) != 0)
+    throw std::runtime_error("Invalid lmf file: bad magic number.");
+  if (header.endianness != Endianness::little &&
+      header.endianness != Endianness::big)
+    throw std::runtime_error("Invalid lmf file: bad byte order flag.");
+  if (header.endianness != nativeEndianness()) {
+    header.version = swapped(header.version);
+    header.elementSize = swapped(header.elementSize);
+    header.alignment = swapped(header.alignment);
+    header.flags = swapped(header.flags);
+    header.headerSize = swapped(header.headerSize);
+    header.rows = swapped(header.rows);
+    header.cols = swapped(header.cols);
+    header.rowStride = swapped(header.rowStride);
+    header.checksum = swapped(header.checksum);
+  }
+  if (header.version == 0 || header.version > lmfVersion)
+    throw std::runtime_error("Invalid lmf file: unsupported version.");
+  if (header.headerSize < sizeof(LmfHeader) || header.elementSize == 0)
+    throw std::runtime_error("Invalid lmf file: bad header fields.");
+  if (header.rows < 1 || header.cols < 1 || header.rows > INT_MAX ||
+      header.cols > INT_MAX || header.rowStride < header.cols ||
+      header.rowStride > INT_MAX)
+    throw std::runtime_error("Invalid lmf file: bad matrix dimensions.");
+  header.fileBytes(); // the sizes derived from the header must not wrap
+  return header;
+}
+
+void writeHeader(std::ostream &os, const LmfHeader &header) {
+  os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (!os)
+    throw std::runtime_error("Could not write lmf header.");
+}
+
+} // namespace linopt::io
@@ -0,0 +1,235 @@
+/**
+ * \file Lmf.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the binary linopt matrix format (.lmf) readers and writers.
+ * \details
+ *  An .lmf file is a fixed 64 byte \sa linopt::io::LmfHeader followed by
+ *  the raw entries, row-major, each row padded to the row stride recorded
+ *  in the header. The payload is exactly the buffer of a
+ *  \sa linopt::inmemory::Matrix<E>: writing is a single bulk write from
+ *  Matrix<E>::data(), reading a single bulk read into it, with no parsing.
+ *  Because the header is 64 bytes long, rows stay 64-byte aligned when the
+ *  file is memory-mapped.
+ *
+ *  Header fields and entries are stored in the byte order of the writer,
+ *  recorded in the header; readers on a machine of the other byte order
+ *  swap them. An optional checksum covers the payload.
+ */
+#ifndef LINOPT_ERC_IO_LMF_H
+#define LINOPT_ERC_IO_LMF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "Matrix.h"
+
+namespace linopt::io {
+
+/**
+ * \brief Current version of the format.
+ */
+inline constexpr std::uint16_t lmfVersion = 1;
+
+/**
+ * \brief Entry types recorded in the header.
+ *
+ * other stands for any trivially copyable type: only its size is checked.
+ */
+enum class ElementType : std::uint8_t {
+  other = 0,
+  int8,
+  uint8,
+  int16,
+  uint16,
+  int32,
+  uint32,
+  int64,
+  uint64,
+  float32,
+  float64
+};
+
+/**
+ * \brief Byte order of the header fields and of the entries.
+ */
+enum class Endianness : std::uint8_t { little = 1, big = 2 };
+
+/**
+ * \brief Header flag: the checksum field holds the payload checksum.
+ */
+inline constexpr std::uint32_t lmfHasChecksum = 1u << 0;
+
+/**
+ * \brief The 64 byte header at the start of every .lmf file.
+ */
+struct LmfHeader {
+  char magic[4] = {'L', 'M', 'F', '\0'};
+  std::uint16_t version = lmfVersion;
+  Endianness endianness = Endianness::little;
+  ElementType elementType = ElementType::other;
+  std::uint32_t elementSize = 0;
+  /**
+   * \brief Alignment, in bytes, of the payload and of every row within the file.
+   */
+  std::uint32_t alignment = 64;
+  std::uint32_t flags = 0;
+  /**
+   * \brief Offset of the payload from the start of the file.
+   */
+  std::uint32_t headerSize = 64;
+  std::uint64_t rows = 0;
+  std::uint64_t cols = 0;
+  /**
+   * \brief Distance, in entries, between the starts of two consecutive rows.
+   */
+  std::uint64_t rowStride = 0;
+  std::uint64_t checksum = 0;
+  std::uint64_t reserved = 0;
+
+  /**
+   * \brief Size of the payload, in bytes.
+   *
+   * Throws a runtime_error if it does not fit in a size_t.
+   */
+  std::uint64_t payloadBytes() const;
+
+  /**
+   * \brief Size of the whole file, header included, in bytes.
+   *
+   * Throws a runtime_error if it does not fit in a size_t.
+   */
+  std::uint64_t fileBytes() const;
+};
+static_assert(sizeof(LmfHeader) == 64, "The lmf header must be 64 bytes.");
+
+/**
+ * \brief Options of the writers.
+ */
+struct WriteOptions {
+  /**
+   * \brief Compute and store a checksum of the payload (one extra pass in cache).
+   */
+  bool checksum = false;
+};
+
+/**
+ * \brief Byte order of the host.
+ */
+Endianness nativeEndianness();
+
+/**
+ * \brief Fletcher-64 checksum of a block of bytes.
+ *
+ * Bytes are summed as 32-bit little-endian words, the last one zero padded.
+ * \param bytes: pointer to the first byte.
+ * \param size: number of bytes.
+ * \return the checksum.
+ */
+std::uint64_t checksum(const void *bytes, std::size_t size);
+
+/**
+ * \brief Reads and validates a header, converted to the host byte order.
+ *
+ * Throws a runtime_error if the magic, version or fields are invalid.
+ * \param is: stream positioned at the start of the file.
+ * \return the header; header.endianness still tells the payload byte order.
+ */
+LmfHeader readHeader(std::istream &is);
+
+/**
+ * \brief Validates the 64 header bytes at the start of an .lmf file and
+ * converts them to the host byte order, \sa readHeader.
+ * \param bytes: pointer to the first byte of the file.
+ * \return the header.
+ */
+LmfHeader decodeHeader(const void *bytes);
+
+/**
+ * \brief Writes a header (in host byte order).
+ */
+void writeHeader(std::ostream &os, const LmfHeader &header);
+
+/**
+ * \brief Reverses the byte order of count entries of size bytes each, in place.
+ */
+void swapBytes(void *entries, std::size_t count, std::size_t size);
+
+/**
+ * \brief The header code of entry type E.
+ */
+template <typename E> constexpr ElementType elementTypeOf();
+
+/**
+ * \brief Builds the header describing a rows x cols matrix of E with the given stride.
+ */
+template <typename E>
+LmfHeader makeHeader(std::uint64_t rows, std::uint64_t cols,
+                     std::uint64_t rowStride);
+
+/**
+ * \brief Throws a runtime_error unless header describes entries of type E.
+ */
+template <typename E> void checkElementType(const LmfHeader &header);
+
+/**
+ * \brief Copies a payload written with another row stride into matrix,
+ * whose padding is reset to E().
+ * \param header: header of the payload.
+ * \param payload: the header.payloadBytes() bytes of the payload.
+ * \param matrix: destination, of dimensions header.rows x header.cols.
+ */
+template <typename E, typename A>
+void copyPayload(const LmfHeader &header, const char *payload,
+                 inmemory::Matrix<E, A> &matrix);
+
+/**
+ * \brief Swaps the entries of a freshly read matrix to the host byte
+ * order, if header says they were written in the other one.
+ */
+template <typename E, typename A>
+void toNativeOrder(const LmfHeader &header, inmemory::Matrix<E, A> &matrix);
+
+/**
+ * \brief Writes matrix to os in the .lmf format, payload in one bulk write.
+ * \param os: binary output stream.
+ * \param matrix: the matrix to write.
+ * \param options: write options.
+ */
+template <typename E, typename A>
+void write(std::ostream &os, const inmemory::Matrix<E, A> &matrix,
+           WriteOptions options = {});
+
+/**
+ * \brief Reads an .lmf matrix of entries E from is.
+ *
+ * Throws a runtime_error if the file is malformed, truncated, holds
+ * another entry type or fails its checksum.
+ * \param is: binary input stream positioned at the start of the file.
+ * \param allocator: allocator of the entry buffer.
+ * \return the matrix.
+ */
+template <typename E, typename A = inmemory::AlignedAllocator<E>>
+inmemory::Matrix<E, A> read(std::istream &is, const A &allocator = A());
+
+/**
+ * \brief Writes matrix to the file at path, \sa write.
+ */
+template <typename E, typename A>
+void save(const std::string &path, const inmemory::Matrix<E, A> &matrix,
+          WriteOptions options = {});
+
+/**
+ * \brief Reads the matrix stored in the file at path, \sa read.
+ */
+template <typename E, typename A = inmemory::AlignedAllocator<E>>
+inmemory::Matrix<E, A> load(const std::string &path, const A &allocator = A());
+
+} // namespace linopt::io
+
+#include "Lmf.tpp"
+#endif
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace linopt::io {
+
+template <typename E> constexpr ElementType elementTypeOf() {
+  if constexpr (std::is_same_v<E, float>)
+    return ElementType::float32;
+  else if constexpr (std::is_same_v<E, double>)
+    return ElementType::float64;
+  else if constexpr (std::is_integral_v<E> && !std::is_same_v<E, bool>) {
+    constexpr bool s = std::is_signed_v<E>;
+    if constexpr (sizeof(E) == 1)
+      return s ? ElementType::int8 : ElementType::uint8;
+    else if constexpr (sizeof(E) == 2)
+      return s ? ElementType::int16 : ElementType::uint16;
+    else if constexpr (sizeof(E) == 4)
+      return s ? ElementType::int32 : ElementType::uint32;
+    else if constexpr (sizeof(E) == 8)
+      return s ? ElementType::int64 : ElementType::uint64;
+    else
+      return ElementType::other;
+  } else
+    return ElementType::other;
+}
+
+template <typename E>
+LmfHeader makeHeader(std::uint64_t rows, std::uint64_t cols,
+                     std::uint64_t rowStride) {
+  static_assert(std::is_trivially_copyable_v<E>,
+                "Only trivially copyable entries can be stored in lmf files.");
+  LmfHeader header;
+  header.endianness = nativeEndianness();
+  header.elementType = elementTypeOf<E>();
+  header.elementSize = sizeof(E);
+  header.alignment = inmemory::cacheLineSize;
+  header.rows = rows;
+  header.cols = cols;
+  header.rowStride = rowStride;
+  return header;
+}
+
+template <typename E> void checkElementType(const LmfHeader &header) {
+  if (header.elementType != elementTypeOf<E>() ||
+      header.elementSize != sizeof(E))
+    throw std::runtime_error("Invalid lmf file: entry type mismatch.");
+}
+
+template <typename E, typename A>
+void copyPayload(const LmfHeader &header, const char *payload,
+                 inmemory::Matrix<E, A> &matrix) {
+  for (int i = 0; i < matrix.getN(); i++) {
+    const char *source =
+        payload + static_cast<std::size_t>(i) * header.rowStride * sizeof(E);
+    E *row = matrix.data() + static_cast<std::size_t>(i) * matrix.stride();
+    std::memcpy(row, source, header.cols * sizeof(E));
+    std::fill(row + header.cols, row + matrix.stride(), E());
+  }
+}
+
+template <typename E, typename A>
+void toNativeOrder(const LmfHeader &header, inmemory::Matrix<E, A> &matrix) {
+  if (header.endianness != nativeEndianness() && sizeof(E) > 1)
+    swapBytes(matrix.data(),
+              static_cast<std::size_t>(matrix.getN()) * matrix.stride(),
+              sizeof(E));
+}
+
+template <typename E, typename A>
+void write(std::ostream &os, const inmemory::Matrix<E, A> &matrix,
+           WriteOptions options) {
+  LmfHeader header = makeHeader<E>(matrix.getN(), matrix.getM(),
+                                   matrix.stride());
+  const char *payload = reinterpret_cast<const char *>(matrix.data());
+  if (options.checksum) {
+    header.flags |= lmfHasChecksum;
+    header.checksum = checksum(payload, header.payloadBytes());
+  }
+  writeHeader(os, header);
+  os.write(payload, static_cast<std::streamsize>(header.payloadBytes()));
+  if (!os)
+    throw std::runtime_error("Could not write lmf payload.");
+}
+
+template <typename E, typename A>
+inmemory::Matrix<E, A> read(std::istream &is, const A &allocator) {
+  const LmfHeader header = readHeader(is);
+  checkElementType<E>(header);
+  is.ignore(header.headerSize - sizeof(LmfHeader));
+  inmemory::Matrix<E, A> matrix = inmemory::Matrix<E, A>::uninitialized(
+      static_cast<int>(header.rows), static_cast<int>(header.cols), allocator);
+  const bool samePadding =
+      header.rowStride == static_cast<std::uint64_t>(matrix.stride());
+  // same padding as the file: straight into the buffer, one bulk read
+  std::vector<char> staging(samePadding ? 0 : header.payloadBytes());
+  char *payload = samePadding ? reinterpret_cast<char *>(matrix.data())
+                              : staging.data();
+  is.read(payload, static_cast<std::streamsize>(header.payloadBytes()));
+  if (static_cast<std::uint64_t>(is.gcount()) != header.payloadBytes())
+    throw std::runtime_error("Invalid lmf file: truncated payload.");
+  if ((header.flags & lmfHasChecksum) &&
+      checksum(payload, header.payloadBytes()) != header.checksum)
+    throw std::runtime_error("Invalid lmf file: checksum mismatch.");
+  if (!samePadding)
+    copyPayload(header, payload, matrix);
+  toNativeOrder(header, matrix);
+  return matrix;
+}
+
+template <typename E, typename A>
+void save(const std::string &path, const inmemory::Matrix<E, A> &matrix,
+          WriteOptions options) {
+  std::ofstream os(path, std::ios_base::binary | std::ios_base::trunc);
+  if (!os)
+    throw std::runtime_error("Could not open " + path + " for writing.");
+  write(os, matrix, options);
+}
+
+template <typename E, typename A>
+inmemory::Matrix<E, A> load(const std::string &path, const A &allocator) {
+  std::ifstream is(path, std::ios_base::binary);
+  if (!is)
+    throw std::runtime_error("Could not open " + path + " for reading.");
+  return read<E, A>(is, allocator);
+}
+
+} // namespace linopt::io
@@ -0,0 +1,122 @@
+#include "MemoryResource.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace linopt::memory {
+
+namespace {
+thread_local std::pmr::memory_resource *scopedResource = nullptr;
+
+/**
+ * \brief mbind policy preferring the given nodes (MPOL_PREFERRED).
+ */
+constexpr int preferredPolicy = 1;
+
+std::size_t pageSize() {
+  static const std::size_t size =
+      static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+bool isHuge(std::size_t bytes) { return bytes >= hugePageSize / 2; }
+
+/**
+ * \brief Length of the mapping holding a block of bytes bytes.
+ */
+std::size_t mappedLength(std::size_t bytes) {
+  const std::size_t unit = isHuge(bytes) ? hugePageSize : pageSize();
+  return (std::max<std::size_t>(bytes, 1) + unit - 1) / unit * unit;
+}
+
+/**
+ * \brief Asks the kernel to place [p, p+length) on node, ignoring failures.
+ */
+void preferNode(void *p, std::size_t length, int node) {
+#ifdef SYS_mbind
+  unsigned long mask = 0;
+  if (node < 0 || node >= static_cast<int>(8 * sizeof(mask)))
+    return;
+  mask = 1UL << node;
+  // the kernel reads maxnode-1 bits of the mask
+  syscall(SYS_mbind, p, length, preferredPolicy, &mask, 8 * sizeof(mask) + 1,
+          0);
+#else
+  (void)p;
+  (void)length;
+  (void)node;
+#endif
+}
+} // namespace
+
+HugePageResource::HugePageResource(int node) : numaNode(node) {}
+
+void *HugePageResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  const std::size_t length = mappedLength(bytes);
+  const std::size_t align = std::max(
+      {alignment, pageSize(), isHuge(bytes) ? hugePageSize : std::size_t(0)});
+  // mmap is only page aligned: over-map, then trim both ends
+  const std::size_t slack = align - pageSize();
+  void *mapping = mmap(nullptr, length + slack, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+    throw std::bad_alloc();
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(mapping);
+  const std::uintptr_t aligned = (begin + align - 1) & ~(align - 1);
+  if (aligned > begin)
+    munmap(mapping, aligned - begin);
+  const std::uintptr_t end = begin + length + slack;
+  if (end > aligned + length)
+    munmap(reinterpret_cast<void *>(aligned + length),
+           end - (aligned + length));
+  void *p = reinterpret_cast<void *>(aligned);
+  if (isHuge(bytes))
+    madvise(p, length, MADV_HUGEPAGE);
+  if (numaNode >= 0)
+    preferNode(p, length, numaNode);
+  return p;
+}
+
+void HugePageResource::do_deallocate(void *p, std::size_t bytes,
+                                     std::size_t) {
+  munmap(p, mappedLength(bytes));
+}
+
+bool HugePageResource::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  const auto *resource = dynamic_cast<const HugePageResource *>(&other);
+  return resource != nullptr && resource->numaNode == numaNode;
+}
+
+HugePageResource *hugePageResource() {
+  static HugePageResource resource;
+  return &resource;
+}
+
+PoolResource::PoolResource(std::size_t largestBlock,
+                           std::pmr::memory_resource *upstream)
+    : std::pmr::synchronized_pool_resource(
+          std::pmr::pool_options{0, largestBlock}, upstream) {}
+
+ArenaResource::ArenaResource(std::size_t initialSize,
+                             std::pmr::memory_resource *upstream)
+    : std::pmr::monotonic_buffer_resource(initialSize, upstream) {}
+
+std::pmr::memory_resource *currentResource() {
+  return scopedResource != nullptr ? scopedResource
+                                   : std::pmr::get_default_resource();
+}
+
+ScopedResource::ScopedResource(std::pmr::memory_resource *resource)
+    : previous(scopedResource) {
+  scopedResource = resource;
+}
+
+ScopedResource::~ScopedResource() { scopedResource = previous; }
+
+} // namespace linopt::memory
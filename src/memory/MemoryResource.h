@@ -0,0 +1,139 @@
+/**
+ * \file MemoryResource.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the memory resources backing matrix buffers.
+ * \details
+ *  Large matrices live in \sa linopt::memory::HugePageResource blocks:
+ *  anonymous mappings aligned on 2 MiB and advised for transparent huge
+ *  pages, optionally bound to a NUMA node, which cuts TLB misses in the
+ *  bandwidth-bound kernels. \sa PoolResource recycles blocks of matrices of
+ *  recurring sizes and \sa ArenaResource hands out short-lived buffers that
+ *  are released all at once. All of them are std::pmr::memory_resource,
+ *  plugged into \sa linopt::inmemory::Matrix<E, A> through
+ *  \sa ResourceAllocator; which resource a default-constructed allocator
+ *  draws from is chosen per scope (and thread) with a \sa ScopedResource.
+ */
+#ifndef LINOPT_ERC_MEMORY_MEMORYRESOURCE_H
+#define LINOPT_ERC_MEMORY_MEMORYRESOURCE_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace linopt::memory {
+
+/**
+ * \brief Size in bytes of a (transparent) huge page.
+ */
+inline constexpr std::size_t hugePageSize = std::size_t(1) << 21;
+
+/**
+ * \brief Memory resource mapping its blocks directly from the kernel.
+ *
+ * Every block is a private anonymous mapping. Blocks of at least half a
+ * huge page are aligned on \sa hugePageSize and advised with MADV_HUGEPAGE,
+ * smaller ones are page aligned. When a NUMA node is given, the pages are
+ * preferably placed on it (mbind, MPOL_PREFERRED); placement is best
+ * effort and silently ignored where unsupported. Blocks are returned to
+ * the kernel on deallocation: put a \sa PoolResource or an
+ * \sa ArenaResource in front of it for frequent allocations.
+ */
+class HugePageResource : public std::pmr::memory_resource {
+private:
+  int numaNode;
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+public:
+  /**
+   * \brief Constructs a resource.
+   * \param node: NUMA node the pages should live on, -1 for no preference
+   *     (first touch).
+   */
+  explicit HugePageResource(int node = -1);
+
+  /**
+   * \brief Get the preferred NUMA node, -1 if none.
+   */
+  int node() const { return numaNode; }
+};
+
+/**
+ * \brief The process wide \sa HugePageResource, without node preference.
+ */
+HugePageResource *hugePageResource();
+
+/**
+ * \brief Thread-safe pool of blocks of recurring sizes.
+ *
+ * Blocks up to largestBlock bytes are carved out of chunks obtained from
+ * upstream and recycled on deallocation; larger ones go straight to
+ * upstream.
+ */
+class PoolResource : public std::pmr::synchronized_pool_resource {
+public:
+  /**
+   * \brief Constructs a pool.
+   * \param largestBlock: size in bytes of the largest pooled block.
+   * \param upstream: resource the chunks come from.
+   */
+  explicit PoolResource(std::size_t largestBlock = std::size_t(1) << 24,
+                        std::pmr::memory_resource *upstream =
+                            hugePageResource());
+};
+
+/**
+ * \brief Monotonic arena: allocation bumps a pointer, deallocation is a
+ * no-op and \sa reset() releases everything at once. Not thread-safe.
+ */
+class ArenaResource : public std::pmr::monotonic_buffer_resource {
+public:
+  /**
+   * \brief Constructs an arena.
+   * \param initialSize: size in bytes of the first chunk; the following
+   *     ones grow geometrically.
+   * \param upstream: resource the chunks come from.
+   */
+  explicit ArenaResource(std::size_t initialSize = hugePageSize,
+                         std::pmr::memory_resource *upstream =
+                             hugePageResource());
+
+  /**
+   * \brief Releases every block handed out by the arena.
+   *
+   * Buffers allocated from the arena must not be used afterwards.
+   */
+  void reset() { release(); }
+};
+
+/**
+ * \brief Get the resource default-constructed allocators draw from.
+ * \return the innermost \sa ScopedResource of this thread, or
+ *     std::pmr::get_default_resource().
+ */
+std::pmr::memory_resource *currentResource();
+
+/**
+ * \brief Overrides the resource of the calling thread until destroyed.
+ *
+ * Only allocators constructed in the scope are affected: a matrix keeps
+ * the resource it was built with.
+ */
+class ScopedResource {
+private:
+  std::pmr::memory_resource *previous;
+
+public:
+  explicit ScopedResource(std::pmr::memory_resource *resource);
+  ScopedResource(const ScopedResource &) = delete;
+  ScopedResource &operator=(const ScopedResource &) = delete;
+  ~ScopedResource();
+};
+
+} // namespace linopt::memory
+#endif
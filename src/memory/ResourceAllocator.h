@@ -0,0 +1,131 @@
+/**
+ * \file ResourceAllocator.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::memory::ResourceAllocator<T, A> allocator.
+ * \details
+ *  Stateful counterpart of \sa linopt::inmemory::AlignedAllocator: blocks
+ *  come from a std::pmr::memory_resource, aligned on A bytes, and
+ *  value-less construction default-initializes. Giving it to a matrix,
+ *  \code
+ *  using FastMatrix = Matrix<double, memory::ResourceAllocator<double>>;
+ *  memory::PoolResource pool;
+ *  FastMatrix a(n, m, &pool);
+ *  \endcode
+ *  puts the entry buffer in that resource.
+ */
+#ifndef LINOPT_ERC_MEMORY_RESOURCEALLOCATOR_H
+#define LINOPT_ERC_MEMORY_RESOURCEALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "AlignedAllocator.h"
+#include "MemoryResource.h"
+#include "Metrics.h"
+
+namespace linopt::memory {
+
+/**
+ * \brief Allocator drawing A-byte aligned blocks of T from a memory resource.
+ *
+ * A default-constructed allocator uses \sa currentResource(). The resource
+ * follows the buffer on moves and swaps, not on copies: a copied container
+ * gets the current resource of the copying thread, like a new one.
+ */
+template <typename T, std::size_t A = inmemory::cacheLineSize>
+class ResourceAllocator {
+  static_assert((A & (A - 1)) == 0, "Alignment must be a power of two.");
+
+private:
+  template <typename U, std::size_t B> friend class ResourceAllocator;
+
+  std::pmr::memory_resource *source;
+
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template <typename U> struct rebind {
+    using other = ResourceAllocator<U, A>;
+  };
+
+  /**
+   * \brief Allocator of the resource of the current scope.
+   */
+  ResourceAllocator() noexcept : source(currentResource()) {}
+
+  /**
+   * \brief Allocator of resource r, which must outlive the allocations.
+   */
+  ResourceAllocator(std::pmr::memory_resource *r) noexcept : source(r) {}
+
+  template <typename U>
+  ResourceAllocator(const ResourceAllocator<U, A> &other) noexcept
+      : source(other.source) {}
+
+  /**
+   * \brief Get the memory resource of the allocator.
+   */
+  std::pmr::memory_resource *resource() const noexcept { return source; }
+
+  /**
+   * \brief Allocates uninitialized storage for n objects of type T.
+   * \param n: the number of objects.
+   * \return pointer to the first object, aligned on A bytes.
+   */
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    T *p = static_cast<T *>(
+        source->allocate(n * sizeof(T), std::max(A, alignof(T))));
+    LINOPT_METRICS_ALLOCATE(n * sizeof(T));
+    return p;
+  }
+
+  /**
+   * \brief Releases storage obtained from allocate.
+   */
+  void deallocate(T *p, std::size_t n) noexcept {
+    LINOPT_METRICS_DEALLOCATE(n * sizeof(T));
+    source->deallocate(p, n * sizeof(T), std::max(A, alignof(T)));
+  }
+
+  /**
+   * \brief Default-initializes *p (no-op for trivial types).
+   */
+  template <typename U>
+  void construct(U *p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void *>(p)) U;
+  }
+
+  /**
+   * \brief Constructs *p from args.
+   */
+  template <typename U, typename... Args>
+  void construct(U *p, Args &&...args) {
+    ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+  }
+
+  /**
+   * \brief Copies are allocated from the resource of the copying scope.
+   */
+  ResourceAllocator select_on_container_copy_construction() const {
+    return ResourceAllocator();
+  }
+
+  template <typename U>
+  bool operator==(const ResourceAllocator<U, A> &other) const noexcept {
+    return source == other.source || source->is_equal(*other.source);
+  }
+};
+
+} // namespace linopt::memory
+#endif
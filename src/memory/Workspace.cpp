@@ -0,0 +1,98 @@
+#include "Workspace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace linopt::memory {
+
+namespace {
+/**
+ * \brief Minimum alignment of the borrowed blocks: a cache line.
+ */
+constexpr std::size_t blockAlignment = 64;
+
+constexpr std::size_t firstChunkSize = std::size_t(1) << 16;
+
+std::uintptr_t alignUp(std::uintptr_t x, std::size_t alignment) {
+  return (x + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+}
+} // namespace
+
+Workspace::~Workspace() {
+  for (const Chunk &chunk : chunks)
+    ::operator delete(chunk.data, std::align_val_t(blockAlignment));
+}
+
+Workspace &Workspace::local() {
+  thread_local Workspace workspace;
+  return workspace;
+}
+
+void *Workspace::do_allocate(std::size_t bytes, std::size_t alignment) {
+  alignment = std::max(alignment, blockAlignment);
+  for (;;) {
+    if (current == chunks.size()) {
+      // chunk sizes grow geometrically: few chunks, bounded wasted tails
+      const std::size_t size =
+          std::max(bytes + alignment,
+                   chunks.empty() ? firstChunkSize : 2 * chunks.back().size);
+      chunks.push_back({static_cast<std::byte *>(::operator new(
+                            size, std::align_val_t(blockAlignment))),
+                        size});
+    }
+    const Chunk &chunk = chunks[current];
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data);
+    const std::size_t start = alignUp(base + used, alignment) - base;
+    if (start + bytes <= chunk.size) {
+      used = start + bytes;
+      blocks++;
+      return chunk.data + start;
+    }
+    below += chunk.size;
+    used = 0;
+    current++;
+  }
+}
+
+void Workspace::do_deallocate(void *p, std::size_t bytes, std::size_t) {
+  if (--blocks == 0) {
+    rewind(0);
+    return;
+  }
+  // the most recent block is popped, the others wait for a rewind
+  if (current < chunks.size() &&
+      static_cast<std::byte *>(p) + bytes == chunks[current].data + used)
+    used = static_cast<std::byte *>(p) - chunks[current].data;
+}
+
+bool Workspace::do_is_equal(
+    const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+void Workspace::rewind(std::size_t mark) {
+  if (mark >= top())
+    return;
+  while (mark < below) {
+    current--;
+    below -= chunks[current].size;
+  }
+  used = mark - below;
+}
+
+std::size_t Workspace::capacity() const {
+  std::size_t size = 0;
+  for (const Chunk &chunk : chunks)
+    size += chunk.size;
+  return size;
+}
+
+void Workspace::trim() {
+  const std::size_t keep = used == 0 ? current : current + 1;
+  for (std::size_t k = keep; k < chunks.size(); k++)
+    ::operator delete(chunks[k].data, std::align_val_t(blockAlignment));
+  chunks.resize(keep);
+}
+
+} // namespace linopt::memory
@@ -0,0 +1,156 @@
+/**
+ * \file Workspace.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::memory::Workspace scratch allocator.
+ * \details
+ *  Algorithms need temporaries (packing panels, pivots, product rows) whose
+ *  lifetime is one call. Each thread owns a workspace, a stack of 64-byte
+ *  aligned chunks kept across calls: borrowing bumps a pointer, returning
+ *  pops it, and after the first calls of a given size no temporary touches
+ *  the heap anymore.
+ */
+#ifndef LINOPT_ERC_MEMORY_WORKSPACE_H
+#define LINOPT_ERC_MEMORY_WORKSPACE_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace linopt::memory {
+
+class Workspace;
+
+/**
+ * \brief n objects of type T borrowed from a \sa Workspace, returned when
+ * the lease is destroyed.
+ *
+ * Leases of a workspace must be destroyed in the reverse order of their
+ * creation, which scoped leases do naturally. The objects are
+ * default-initialized: arithmetic entries hold garbage until written.
+ */
+template <typename T> class Lease {
+private:
+  friend class Workspace;
+
+  Workspace *owner = nullptr;
+  T *first = nullptr;
+  std::size_t count = 0;
+  std::size_t mark = 0;
+
+  Lease(Workspace &owner, std::size_t n);
+
+public:
+  Lease(Lease &&other) noexcept;
+  Lease(const Lease &) = delete;
+  Lease &operator=(const Lease &) = delete;
+  Lease &operator=(Lease &&) = delete;
+  ~Lease();
+
+  /**
+   * \brief Pointer to the first object, aligned on 64 bytes.
+   */
+  T *data() const { return first; }
+
+  /**
+   * \brief Number of objects.
+   */
+  std::size_t size() const { return count; }
+
+  T *begin() const { return first; }
+  T *end() const { return first + count; }
+  T &operator[](std::size_t i) const { return first[i]; }
+};
+
+/**
+ * \brief Per-thread stack of scratch memory.
+ *
+ * Also a memory resource, so that containers and matrices can be built
+ * into it (\sa ResourceAllocator); deallocating the most recent block pops
+ * it, other deallocations are deferred until the blocks above are popped.
+ * Chunks are never shrunk, see \sa trim(). Not thread-safe: a workspace is
+ * used by the thread that owns it, through \sa local().
+ */
+class Workspace : public std::pmr::memory_resource {
+private:
+  template <typename T> friend class Lease;
+
+  struct Chunk {
+    std::byte *data;
+    std::size_t size;
+  };
+
+  /**
+   * \brief The chunks, in stacking order; chunks past current are free.
+   */
+  std::vector<Chunk> chunks;
+  std::size_t current = 0;
+  /**
+   * \brief Bytes used in chunks[current].
+   */
+  std::size_t used = 0;
+  /**
+   * \brief Bytes used in the chunks below current, skipped tails included.
+   */
+  std::size_t below = 0;
+  /**
+   * \brief Number of live blocks; the stack is emptied when it drops to 0.
+   */
+  std::size_t blocks = 0;
+
+  /**
+   * \brief Position of the top of the stack, as a byte count.
+   */
+  std::size_t top() const { return below + used; }
+
+  /**
+   * \brief Pops every block above position mark.
+   */
+  void rewind(std::size_t mark);
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+public:
+  Workspace() = default;
+  Workspace(const Workspace &) = delete;
+  Workspace &operator=(const Workspace &) = delete;
+  ~Workspace() override;
+
+  /**
+   * \brief The workspace of the calling thread.
+   */
+  static Workspace &local();
+
+  /**
+   * \brief Borrows n default-initialized objects of type T.
+   * \return the lease, to be destroyed before the leases borrowed earlier.
+   */
+  template <typename T> Lease<T> borrow(std::size_t n) {
+    return Lease<T>(*this, n);
+  }
+
+  /**
+   * \brief Total size in bytes of the chunks held.
+   */
+  std::size_t capacity() const;
+
+  /**
+   * \brief Size in bytes of the blocks currently borrowed.
+   */
+  std::size_t inUse() const { return top(); }
+
+  /**
+   * \brief Returns the chunks above the borrowed blocks to the heap.
+   */
+  void trim();
+};
+
+} // namespace linopt::memory
+
+#include "Workspace.tpp"
+#endif
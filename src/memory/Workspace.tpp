@@ -0,0 +1,27 @@
+#include <memory>
+#include <utility>
+
+namespace linopt::memory {
+
+template <typename T>
+Lease<T>::Lease(Workspace &owner, std::size_t n)
+    : owner(&owner), count(n), mark(owner.top()) {
+  first = static_cast<T *>(owner.allocate(n * sizeof(T), alignof(T)));
+  std::uninitialized_default_construct_n(first, n);
+}
+
+template <typename T>
+Lease<T>::Lease(Lease &&other) noexcept
+    : owner(std::exchange(other.owner, nullptr)),
+      first(std::exchange(other.first, nullptr)),
+      count(std::exchange(other.count, 0)), mark(other.mark) {}
+
+template <typename T> Lease<T>::~Lease() {
+  if (owner == nullptr)
+    return;
+  std::destroy_n(first, count);
+  owner->deallocate(first, count * sizeof(T), alignof(T));
+  owner->rewind(mark);
+}
+
+} // namespace linopt::memory
@@ -0,0 +1,189 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace linopt::metrics {
+
+namespace {
+
+struct Key {
+  std::string_view operation;
+  Shape shape;
+
+  auto operator<=>(const Key &) const = default;
+};
+
+// the lock is only contended while a snapshot reads the shard; the name and
+// shape of the counters are left out, they are in the key
+struct Shard {
+  std::mutex mutex;
+  std::map<Key, OperationMetrics> counters;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // kept past the exit of their thread: its calls still count
+  std::vector<std::shared_ptr<Shard>> shards;
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> deallocations{0};
+  std::atomic<std::uint64_t> allocatedBytes{0};
+  std::atomic<std::int64_t> liveBytes{0};
+};
+
+Registry &registry() {
+  static Registry instance;
+  return instance;
+}
+
+Shard &localShard() {
+  thread_local const std::shared_ptr<Shard> shard = [] {
+    auto s = std::make_shared<Shard>();
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.shards.push_back(s);
+    return s;
+  }();
+  return *shard;
+}
+
+int shapeClass(int d) {
+  return d <= 0 ? 0 : static_cast<int>(std::bit_ceil(static_cast<unsigned>(d)));
+}
+
+int latencyBucket(std::uint64_t nanoseconds) {
+  return std::min(latencyBuckets - 1,
+                  static_cast<int>(std::bit_width(nanoseconds)));
+}
+
+void add(OperationMetrics &to, const OperationMetrics &from) {
+  to.calls += from.calls;
+  to.flops += from.flops;
+  to.bytes += from.bytes;
+  to.nanoseconds += from.nanoseconds;
+  for (int i = 0; i < latencyBuckets; i++)
+    to.latency[i] += from.latency[i];
+}
+
+} // namespace
+
+std::uint64_t OperationMetrics::quantile(double q) const {
+  const double rank = std::clamp(q, 0.0, 1.0) * static_cast<double>(calls);
+  std::uint64_t seen = 0;
+  for (int i = 0; i < latencyBuckets; i++) {
+    seen += latency[i];
+    if (latency[i] != 0 && static_cast<double>(seen) >= rank)
+      return std::uint64_t(1) << i;
+  }
+  return std::uint64_t(1) << (latencyBuckets - 1);
+}
+
+OperationMetrics Snapshot::total(std::string_view operation) const {
+  OperationMetrics sum;
+  sum.operation = operation;
+  for (const OperationMetrics &o : operations)
+    if (o.operation == operation)
+      add(sum, o);
+  return sum;
+}
+
+void record(std::string_view operation, Shape shape, std::uint64_t flops,
+            std::uint64_t bytes, std::uint64_t nanoseconds) {
+  const Key key{operation,
+                {shapeClass(shape.n), shapeClass(shape.m), shapeClass(shape.k)}};
+  Shard &shard = localShard();
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  OperationMetrics &c = shard.counters[key];
+  c.calls++;
+  c.flops += flops;
+  c.bytes += bytes;
+  c.nanoseconds += nanoseconds;
+  c.latency[latencyBucket(nanoseconds)]++;
+}
+
+void recordAllocation(std::size_t bytes) {
+  Registry &r = registry();
+  r.allocations.fetch_add(1, std::memory_order_relaxed);
+  r.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+  r.liveBytes.fetch_add(static_cast<std::int64_t>(bytes),
+                        std::memory_order_relaxed);
+}
+
+void recordDeallocation(std::size_t bytes) {
+  Registry &r = registry();
+  r.deallocations.fetch_add(1, std::memory_order_relaxed);
+  r.liveBytes.fetch_sub(static_cast<std::int64_t>(bytes),
+                        std::memory_order_relaxed);
+}
+
+Snapshot snapshot() {
+  Registry &r = registry();
+  std::map<Key, OperationMetrics> merged;
+  {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const std::shared_ptr<Shard> &shard : r.shards) {
+      std::lock_guard<std::mutex> shardLock(shard->mutex);
+      for (const auto &[key, counters] : shard->counters) {
+        OperationMetrics &o = merged[key];
+        o.operation = key.operation;
+        o.shape = key.shape;
+        add(o, counters);
+      }
+    }
+  }
+  Snapshot s;
+  for (auto &[key, o] : merged)
+    s.operations.push_back(std::move(o));
+  std::stable_sort(s.operations.begin(), s.operations.end(),
+                   [](const OperationMetrics &a, const OperationMetrics &b) {
+                     return a.nanoseconds > b.nanoseconds;
+                   });
+  s.allocations.allocations = r.allocations.load(std::memory_order_relaxed);
+  s.allocations.deallocations = r.deallocations.load(std::memory_order_relaxed);
+  s.allocations.bytes = r.allocatedBytes.load(std::memory_order_relaxed);
+  s.allocations.liveBytes = r.liveBytes.load(std::memory_order_relaxed);
+  return s;
+}
+
+void reset() {
+  Registry &r = registry();
+  {
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const std::shared_ptr<Shard> &shard : r.shards) {
+      std::lock_guard<std::mutex> shardLock(shard->mutex);
+      shard->counters.clear();
+    }
+  }
+  r.allocations.store(0, std::memory_order_relaxed);
+  r.deallocations.store(0, std::memory_order_relaxed);
+  r.allocatedBytes.store(0, std::memory_order_relaxed);
+}
+
+std::ostream &operator<<(std::ostream &os, const Snapshot &snapshot) {
+  for (const OperationMetrics &o : snapshot.operations) {
+    const double seconds = static_cast<double>(o.nanoseconds) * 1e-9;
+    os << o.operation << ' ' << o.shape.n;
+    if (o.shape.m != 0)
+      os << 'x' << o.shape.m;
+    if (o.shape.k != 0)
+      os << 'x' << o.shape.k;
+    os << ": calls=" << o.calls << " time=" << seconds << "s";
+    if (seconds > 0) {
+      os << " gflop/s=" << static_cast<double>(o.flops) * 1e-9 / seconds
+         << " gb/s=" << static_cast<double>(o.bytes) * 1e-9 / seconds;
+    }
+    os << " p50<=" << o.quantile(0.5) << "ns p99<=" << o.quantile(0.99)
+       << "ns\n";
+  }
+  const AllocationMetrics &a = snapshot.allocations;
+  os << "allocations=" << a.allocations << " deallocations=" << a.deallocations
+     << " bytes=" << a.bytes << " live=" << a.liveBytes << '\n';
+  return os;
+}
+
+} // namespace linopt::metrics
@@ -0,0 +1,204 @@
+/**
+ * \file Metrics.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the instrumentation of the hot paths and its snapshots.
+ * \details
+ *  The kernels and factorizations open a \sa LINOPT_METRICS_SCOPE naming
+ *  the operation, its dimensions and its flop and byte counts; the matrix
+ *  allocators report their blocks through \sa LINOPT_METRICS_ALLOCATE. The
+ *  hooks only exist when the code is compiled with LINOPT_METRICS defined
+ *  (cmake -DLINOPT_METRICS=ON): otherwise they expand to nothing and their
+ *  arguments are not even evaluated.
+ *
+ *  Each thread records into its own shard, so recording never contends
+ *  with the other threads; \sa snapshot() merges the shards. Operations are
+ *  aggregated per name and shape class, each dimension rounded up to a
+ *  power of two, so that the number of records stays bounded whatever the
+ *  workload. Scopes nest: the time of a factorization includes the time of
+ *  the gemm calls it makes, which are recorded too.
+ */
+#ifndef LINOPT_ERC_METRICS_METRICS_H
+#define LINOPT_ERC_METRICS_METRICS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace linopt::metrics {
+
+/**
+ * \brief Whether the hooks are compiled in.
+ */
+#ifdef LINOPT_METRICS
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+/**
+ * \brief Number of latency buckets: bucket 0 holds the calls under 1ns,
+ * bucket i > 0 those in [2^(i-1), 2^i) ns, the last one everything above.
+ */
+inline constexpr int latencyBuckets = 40;
+
+/**
+ * \brief Dimensions of an operation, 0 where irrelevant.
+ *
+ * A gemm records m, n and k; most other operations only the first one or
+ * two. In a \sa Snapshot every dimension is rounded up to a power of two.
+ */
+struct Shape {
+  int n = 0;
+  int m = 0;
+  int k = 0;
+
+  auto operator<=>(const Shape &) const = default;
+};
+
+/**
+ * \brief Counters of one operation on one shape class.
+ */
+struct OperationMetrics {
+  std::string operation;
+  Shape shape;
+  std::uint64_t calls = 0;
+  std::uint64_t flops = 0;
+  /**
+   * \brief Bytes read and written, counting each operand once.
+   */
+  std::uint64_t bytes = 0;
+  /**
+   * \brief Total wall clock time of the calls.
+   */
+  std::uint64_t nanoseconds = 0;
+  std::array<std::uint64_t, latencyBuckets> latency{};
+
+  /**
+   * \brief Upper bound of the q-quantile of the call latencies, in ns.
+   * \param q: in [0, 1], 0.5 for the median.
+   * \return the upper bound of the bucket the quantile falls in.
+   */
+  std::uint64_t quantile(double q) const;
+};
+
+/**
+ * \brief Counters of the blocks handed out by the matrix allocators.
+ */
+struct AllocationMetrics {
+  std::uint64_t allocations = 0;
+  std::uint64_t deallocations = 0;
+  std::uint64_t bytes = 0;
+  /**
+   * \brief Bytes allocated and not yet released.
+   */
+  std::int64_t liveBytes = 0;
+};
+
+/**
+ * \brief Everything recorded since the start or the last \sa reset().
+ */
+struct Snapshot {
+  /**
+   * \brief Sorted by decreasing total time.
+   */
+  std::vector<OperationMetrics> operations;
+  AllocationMetrics allocations;
+
+  /**
+   * \brief Counters of an operation, summed over the shape classes.
+   */
+  OperationMetrics total(std::string_view operation) const;
+};
+
+/**
+ * \brief Merges the counters of all threads.
+ *
+ * Always empty when the hooks are not compiled in.
+ */
+Snapshot snapshot();
+
+/**
+ * \brief Clears the operation and allocation counters (not the live bytes).
+ */
+void reset();
+
+/**
+ * \brief Records one call.
+ *
+ * Called by \sa ScopedOperation; operation must outlive the program (a
+ * string literal).
+ */
+void record(std::string_view operation, Shape shape, std::uint64_t flops,
+            std::uint64_t bytes, std::uint64_t nanoseconds);
+
+/**
+ * \brief Records a block handed out by a matrix allocator.
+ */
+void recordAllocation(std::size_t bytes);
+
+/**
+ * \brief Records a block given back to a matrix allocator.
+ */
+void recordDeallocation(std::size_t bytes);
+
+/**
+ * \brief Times its own lifetime and records it as one call of an operation.
+ */
+class ScopedOperation {
+private:
+  std::string_view operation;
+  Shape shape;
+  std::uint64_t flops;
+  std::uint64_t bytes;
+  std::chrono::steady_clock::time_point start;
+
+public:
+  ScopedOperation(std::string_view operation, Shape shape,
+                  std::uint64_t flops, std::uint64_t bytes)
+      : operation(operation), shape(shape), flops(flops), bytes(bytes),
+        start(std::chrono::steady_clock::now()) {}
+  ScopedOperation(const ScopedOperation &) = delete;
+  ScopedOperation &operator=(const ScopedOperation &) = delete;
+
+  ~ScopedOperation() {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    record(operation, shape, flops, bytes,
+           std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+               .count());
+  }
+};
+
+/**
+ * \brief One line per operation, by decreasing total time, then the
+ * allocation counters.
+ */
+std::ostream &operator<<(std::ostream &os, const Snapshot &snapshot);
+
+} // namespace linopt::metrics
+
+#ifdef LINOPT_METRICS
+/**
+ * \brief Records the rest of the enclosing block as one call of operation
+ * on shape {n, m, k}, performing flops operations over bytes bytes.
+ */
+#define LINOPT_METRICS_SCOPE(operation, n, m, k, flops, bytes)                 \
+  const ::linopt::metrics::ScopedOperation linoptMetricsScope(                 \
+      operation, ::linopt::metrics::Shape{(n), (m), (k)},                      \
+      static_cast<std::uint64_t>(flops), static_cast<std::uint64_t>(bytes))
+#define LINOPT_METRICS_ALLOCATE(bytes)                                         \
+  ::linopt::metrics::recordAllocation(bytes)
+#define LINOPT_METRICS_DEALLOCATE(bytes)                                       \
+  ::linopt::metrics::recordDeallocation(bytes)
+#else
+#define LINOPT_METRICS_SCOPE(operation, n, m, k, flops, bytes) ((void)0)
+#define LINOPT_METRICS_ALLOCATE(bytes) ((void)0)
+#define LINOPT_METRICS_DEALLOCATE(bytes) ((void)0)
+#endif
+
+#endif
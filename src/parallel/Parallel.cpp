@@ -0,0 +1,47 @@
+#include "Parallel.h"
+
+#include <atomic>
+
+namespace linopt::parallel {
+
+namespace {
+// read on every kernel entry: atomics rather than a lock. A policy set
+// concurrently may be seen half applied, which is still a valid policy.
+std::atomic<Execution> processMode{ExecutionPolicy{}.mode};
+std::atomic<long> processThreshold{ExecutionPolicy{}.threshold};
+
+thread_local bool hasScopedPolicy = false;
+thread_local ExecutionPolicy scopedPolicy;
+} // namespace
+
+ExecutionPolicy defaultPolicy() {
+  return {processMode.load(std::memory_order_relaxed),
+          processThreshold.load(std::memory_order_relaxed)};
+}
+
+void setDefaultPolicy(ExecutionPolicy policy) {
+  processThreshold.store(policy.threshold, std::memory_order_relaxed);
+  processMode.store(policy.mode, std::memory_order_relaxed);
+}
+
+ExecutionPolicy currentPolicy() {
+  return hasScopedPolicy ? scopedPolicy : defaultPolicy();
+}
+
+ScopedPolicy::ScopedPolicy(ExecutionPolicy policy)
+    : hadPolicy(hasScopedPolicy), previous(scopedPolicy) {
+  hasScopedPolicy = true;
+  scopedPolicy = policy;
+}
+
+ScopedPolicy::~ScopedPolicy() {
+  hasScopedPolicy = hadPolicy;
+  scopedPolicy = previous;
+}
+
+bool shouldParallelize(long work) {
+  const ExecutionPolicy policy = currentPolicy();
+  return policy.mode == Execution::parallel && work >= policy.threshold;
+}
+
+} // namespace linopt::parallel
@@ -0,0 +1,174 @@
+/**
+ * \file Parallel.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the execution policies and the parallel loop helpers.
+ * \details
+ *  Bulk matrix operations are serial unless the caller opts in, either
+ *  globally with \sa linopt::parallel::setDefaultPolicy() or for a scope
+ *  (and thread) with a \sa linopt::parallel::ScopedPolicy. Even in
+ *  parallel mode, operations whose work is under the policy threshold
+ *  stay serial. The parallel loops run on \sa ThreadPool::shared().
+ */
+#ifndef LINOPT_ERC_PARALLEL_PARALLEL_H
+#define LINOPT_ERC_PARALLEL_PARALLEL_H
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace linopt::parallel {
+
+/**
+ * \brief Whether bulk operations may use the shared thread pool.
+ */
+enum class Execution { sequential, parallel };
+
+/**
+ * \brief Execution mode plus the amount of work below which an operation stays serial.
+ */
+struct ExecutionPolicy {
+  Execution mode = Execution::sequential;
+  /**
+   * \brief Minimum work, in elementary operations (entries touched or
+   * multiply-adds), for an operation to be split across threads.
+   */
+  long threshold = 1L << 16;
+};
+
+/**
+ * \brief Shorthand for the default parallel policy.
+ */
+inline constexpr ExecutionPolicy par{Execution::parallel};
+
+/**
+ * \brief Shorthand for the serial policy.
+ */
+inline constexpr ExecutionPolicy seq{Execution::sequential};
+
+/**
+ * \brief Get the process wide policy.
+ * \return the policy used where no \sa ScopedPolicy is active.
+ */
+ExecutionPolicy defaultPolicy();
+
+/**
+ * \brief Set the process wide policy.
+ * \param policy: the new default policy.
+ */
+void setDefaultPolicy(ExecutionPolicy policy);
+
+/**
+ * \brief Get the policy in effect on the calling thread.
+ * \return the innermost \sa ScopedPolicy of this thread, or \sa defaultPolicy().
+ */
+ExecutionPolicy currentPolicy();
+
+/**
+ * \brief Overrides the policy of the calling thread until destroyed.
+ *
+ * Scopes nest; the previous policy is restored on destruction.
+ */
+class ScopedPolicy {
+private:
+  bool hadPolicy;
+  ExecutionPolicy previous;
+
+public:
+  explicit ScopedPolicy(ExecutionPolicy policy);
+  ScopedPolicy(const ScopedPolicy &) = delete;
+  ScopedPolicy &operator=(const ScopedPolicy &) = delete;
+  ~ScopedPolicy();
+};
+
+/**
+ * \brief Whether an operation of the given amount of work should run in parallel.
+ * \param work: the amount of work of the operation, \sa ExecutionPolicy::threshold.
+ * \return true iff the current policy is parallel and the work reaches its
+ * threshold.
+ */
+bool shouldParallelize(long work);
+
+/**
+ * \brief Runs body(b, e) over a partition of [begin, end) into chunks.
+ *
+ * Serial (a single body(begin, end) call) unless \sa shouldParallelize(work).
+ * The calling thread runs chunks too.
+ * \param begin: first index.
+ * \param end: one past the last index.
+ * \param work: total work of the loop.
+ * \param body: callable taking a sub range (int b, int e).
+ */
+template <typename F>
+void parallelFor(int begin, int end, long work, F &&body) {
+  const int n = end - begin;
+  if (n <= 0)
+    return;
+  if (n == 1 || !shouldParallelize(work)) {
+    body(begin, end);
+    return;
+  }
+  ThreadPool &pool = ThreadPool::shared();
+  // a few chunks per thread so that stealing can even out the load
+  const int chunks = std::min(n, 4 * (pool.size() + 1));
+  const ExecutionPolicy policy = currentPolicy();
+  TaskGroup group(pool);
+  for (int c = 1; c < chunks; c++) {
+    const int b = begin + static_cast<int>(static_cast<long>(n) * c / chunks);
+    const int e =
+        begin + static_cast<int>(static_cast<long>(n) * (c + 1) / chunks);
+    group.run([&body, policy, b, e] {
+      ScopedPolicy scope(policy); // nested operations inherit the caller's
+      body(b, e);
+    });
+  }
+  body(begin, begin + n / chunks);
+  group.wait();
+}
+
+/**
+ * \brief Runs body(r0, r1, c0, c1) over a 2D tiling of [0, rows) x [0, cols).
+ *
+ * Tile dimensions are multiples of rowQuantum and colQuantum (the last
+ * ones excepted). Serial unless \sa shouldParallelize(work).
+ * \param rows: number of rows to cover.
+ * \param cols: number of columns to cover.
+ * \param rowQuantum: tile heights are multiples of it.
+ * \param colQuantum: tile widths are multiples of it.
+ * \param work: total work of the loop.
+ * \param body: callable taking a tile (int r0, int r1, int c0, int c1).
+ */
+template <typename F>
+void parallelFor2D(int rows, int cols, int rowQuantum, int colQuantum,
+                   long work, F &&body) {
+  if (rows <= 0 || cols <= 0)
+    return;
+  if (!shouldParallelize(work)) {
+    body(0, rows, 0, cols);
+    return;
+  }
+  ThreadPool &pool = ThreadPool::shared();
+  const int target = 4 * (pool.size() + 1);
+  const int rowBlocks = (rows + rowQuantum - 1) / rowQuantum;
+  const int colBlocks = (cols + colQuantum - 1) / colQuantum;
+  // split the rows first: row tiles share the packed panels of B
+  const int tr = std::min(rowBlocks, target);
+  const int tc = std::min(colBlocks, std::max(1, target / tr));
+  const int tileRows = (rowBlocks + tr - 1) / tr * rowQuantum;
+  const int tileCols = (colBlocks + tc - 1) / tc * colQuantum;
+  const ExecutionPolicy policy = currentPolicy();
+  TaskGroup group(pool);
+  for (int r0 = 0; r0 < rows; r0 += tileRows)
+    for (int c0 = 0; c0 < cols; c0 += tileCols) {
+      const int r1 = std::min(rows, r0 + tileRows);
+      const int c1 = std::min(cols, c0 + tileCols);
+      group.run([&body, policy, r0, r1, c0, c1] {
+        ScopedPolicy scope(policy);
+        body(r0, r1, c0, c1);
+      });
+    }
+  group.wait();
+}
+
+} // namespace linopt::parallel
+#endif
@@ -0,0 +1,183 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace linopt::parallel {
+
+namespace {
+// index of the current thread's queue in its pool, -1 outside of any pool
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local int currentWorker = -1;
+} // namespace
+
+TaskGroup::TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+    // wait() must be called explicitly to observe task failures
+  }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+  pending.fetch_add(1, std::memory_order_relaxed);
+  pool.push({std::move(task), this});
+  signal(0); // a sleeping waiter can run it
+}
+
+void TaskGroup::signal(long finished) {
+  // counted and notified under the lock: the waiter only sees pending reach
+  // zero, and destroys the group, once it is released
+  std::lock_guard<std::mutex> lock(waitMutex);
+  pending.fetch_sub(finished, std::memory_order_acq_rel);
+  signals++;
+  done.notify_all();
+}
+
+void TaskGroup::wait() {
+  // yields before sleeping: the last chunks of a parallel loop usually
+  // finish within a few scheduler quanta
+  constexpr int spinRounds = 64;
+  ThreadPool::Task task;
+  int idle = 0;
+  for (;;) {
+    if (pool.tryPop(task, this)) {
+      pool.execute(task);
+      idle = 0;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex);
+    if (pending.load(std::memory_order_acquire) == 0)
+      break;
+    if (idle < spinRounds) {
+      lock.unlock();
+      idle++;
+      std::this_thread::yield();
+      continue;
+    }
+    const long seen = signals;
+    done.wait(lock, [&] { return signals != seen; });
+  }
+  std::exception_ptr e;
+  {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    std::swap(e, error);
+  }
+  if (e)
+    std::rethrow_exception(e);
+}
+
+ThreadPool::ThreadPool(int threads) {
+  threads = std::max(1, threads);
+  for (int i = 0; i <= threads; i++)
+    queues.push_back(std::make_unique<Queue>());
+  for (int i = 0; i < threads; i++)
+    workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (std::thread &t : workers)
+    t.join();
+}
+
+int ThreadPool::size() const { return static_cast<int>(workers.size()); }
+
+ThreadPool &ThreadPool::shared() {
+  static ThreadPool pool(
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+  return pool;
+}
+
+void ThreadPool::push(Task task) {
+  const int index =
+      currentPool == this ? currentWorker : static_cast<int>(workers.size());
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(task));
+  }
+  {
+    // taken so that a worker cannot miss the wake up between its check and its wait
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    queued.fetch_add(1, std::memory_order_release);
+  }
+  wakeUp.notify_one();
+}
+
+bool ThreadPool::tryPop(Task &task, const TaskGroup *group) {
+  if (queued.load(std::memory_order_acquire) == 0)
+    return false;
+  const int self = currentPool == this ? currentWorker : -1;
+  auto matches = [group](const Task &t) {
+    return group == nullptr || t.group == group;
+  };
+  // own work first, newest first: it is the hottest in cache
+  if (self >= 0) {
+    Queue &q = *queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    const auto it = std::find_if(q.tasks.rbegin(), q.tasks.rend(), matches);
+    if (it != q.tasks.rend()) {
+      task = std::move(*it);
+      q.tasks.erase(std::next(it).base());
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  // then steal the oldest task of the others, injection queue included
+  const int n = static_cast<int>(queues.size());
+  const int start = self >= 0 ? self + 1 : 0;
+  for (int k = 0; k < n; k++) {
+    const int victim = (start + k) % n;
+    if (victim == self)
+      continue;
+    Queue &q = *queues[victim];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    const auto it = std::find_if(q.tasks.begin(), q.tasks.end(), matches);
+    if (it != q.tasks.end()) {
+      task = std::move(*it);
+      q.tasks.erase(it);
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::execute(Task &task) {
+  TaskGroup *group = task.group;
+  try {
+    task.work();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(group->errorMutex);
+    if (!group->error)
+      group->error = std::current_exception();
+  }
+  task.work = nullptr;
+  group->signal(1);
+}
+
+void ThreadPool::workerLoop(int index) {
+  currentPool = this;
+  currentWorker = index;
+  Task task;
+  for (;;) {
+    if (tryPop(task)) {
+      execute(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wakeUp.wait(lock, [this] {
+      return stopping || queued.load(std::memory_order_acquire) > 0;
+    });
+    if (stopping && queued.load(std::memory_order_acquire) == 0)
+      return;
+  }
+}
+
+} // namespace linopt::parallel
@@ -0,0 +1,148 @@
+/**
+ * \file ThreadPool.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the \sa linopt::parallel::ThreadPool class.
+ * \details
+ *  A fixed size, work-stealing pool of worker threads. Each worker owns a
+ *  deque of tasks: it pops its own tasks LIFO and steals the oldest tasks
+ *  of the other workers when it runs out. Threads that are not part of the
+ *  pool push to a shared injection queue. A thread waiting on a
+ *  \sa linopt::parallel::TaskGroup runs the queued tasks of that group,
+ *  then sleeps until the others are done, so nested and concurrent
+ *  parallel calls never add threads to the machine nor deadlock the pool.
+ */
+#ifndef LINOPT_ERC_PARALLEL_THREADPOOL_H
+#define LINOPT_ERC_PARALLEL_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace linopt::parallel {
+
+class ThreadPool;
+
+/**
+ * \brief A set of tasks submitted together and waited upon together.
+ *
+ * The group must outlive its tasks: \sa wait() must be called before it is
+ * destroyed (the destructor waits as a last resort).
+ */
+class TaskGroup {
+private:
+  friend class ThreadPool;
+  ThreadPool &pool;
+  std::atomic<long> pending{0};
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  // a waiter sleeps on done until signals moves: a task of the group was
+  // queued or has finished
+  std::mutex waitMutex;
+  std::condition_variable done;
+  long signals = 0;
+
+  void signal(long finished);
+
+public:
+  /**
+   * \brief Creates an empty group whose tasks run on pool.
+   * \param pool: the pool running the tasks.
+   */
+  explicit TaskGroup(ThreadPool &pool);
+
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+
+  /**
+   * \brief Waits for the remaining tasks.
+   */
+  ~TaskGroup();
+
+  /**
+   * \brief Queues task for execution on the pool.
+   * \param task: the callable to run.
+   */
+  void run(std::function<void()> task);
+
+  /**
+   * \brief Runs the queued tasks of this group until all of them are done.
+   *
+   * Tasks of the group running on other threads are waited for, after a
+   * short spin, without holding a core. If a task threw, the first
+   * exception is rethrown here.
+   */
+  void wait();
+};
+
+/**
+ * \brief Work-stealing pool of worker threads.
+ */
+class ThreadPool {
+private:
+  friend class TaskGroup;
+
+  struct Task {
+    std::function<void()> work;
+    TaskGroup *group = nullptr;
+  };
+
+  /**
+   * \brief The task deque of one worker. Owner pops at the back, thieves at the front.
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues; // one per worker, then the injection queue
+  std::vector<std::thread> workers;
+  std::atomic<long> queued{0};
+  std::atomic<bool> stopping{false};
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+
+  void push(Task task);
+  bool tryPop(Task &task, const TaskGroup *group = nullptr);
+  void execute(Task &task);
+  void workerLoop(int index);
+
+public:
+  /**
+   * \brief Starts a pool of threads workers.
+   * \param threads: number of worker threads, at least 1.
+   */
+  explicit ThreadPool(int threads);
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * \brief Joins the workers. Pending tasks are run first.
+   */
+  ~ThreadPool();
+
+  /**
+   * \brief Get the number of worker threads.
+   * \return the number of workers (callers waiting on a group come on top).
+   */
+  int size() const;
+
+  /**
+   * \brief The pool shared by the whole library.
+   *
+   * Started on first use with one worker less than the hardware threads,
+   * the calling thread being the last one.
+   * \return reference to the shared pool.
+   */
+  static ThreadPool &shared();
+};
+
+} // namespace linopt::parallel
+#endif
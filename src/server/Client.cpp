@@ -0,0 +1,53 @@
+#include "Client.h"
+
+#include <utility> // boost 1.74 asio uses std::exchange without including it
+
+#include <boost/asio.hpp>
+
+namespace linopt::server {
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+
+struct Client::State {
+  asio::io_context io;
+  tcp::socket socket{io};
+};
+
+Client::Client(const std::string &host, int port)
+    : state(std::make_unique<State>()) {
+  try {
+    tcp::resolver resolver(state->io);
+    asio::connect(state->socket,
+                  resolver.resolve(host, std::to_string(port)));
+    state->socket.set_option(tcp::no_delay(true));
+  } catch (const boost::system::system_error &e) {
+    throw std::runtime_error("Could not connect to " + host + ":" +
+                             std::to_string(port) + ": " + e.what());
+  }
+}
+
+Client::~Client() = default;
+
+void Client::writeAll(const std::vector<Chunk> &chunks) {
+  std::vector<asio::const_buffer> buffers;
+  for (const Chunk &c : chunks)
+    buffers.push_back(asio::buffer(c.data, c.size));
+  try {
+    asio::write(state->socket, buffers);
+  } catch (const boost::system::system_error &e) {
+    throw std::runtime_error(std::string("Could not send request: ") +
+                             e.what());
+  }
+}
+
+void Client::readAll(void *bytes, std::size_t size) {
+  try {
+    asio::read(state->socket, asio::buffer(bytes, size));
+  } catch (const boost::system::system_error &e) {
+    throw std::runtime_error(std::string("Could not receive response: ") +
+                             e.what());
+  }
+}
+
+} // namespace linopt::server
@@ -0,0 +1,96 @@
+/**
+ * \file Client.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares a blocking client of the matrix compute server.
+ */
+#ifndef LINOPT_ERC_SERVER_CLIENT_H
+#define LINOPT_ERC_SERVER_CLIENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Lmf.h"
+#include "Matrix.h"
+#include "Protocol.h"
+
+namespace linopt::server {
+
+/**
+ * \brief A response, as received by a \sa Client.
+ */
+template <typename E> struct Response {
+  std::uint64_t id = 0;
+  Status status = Status::ok;
+  /**
+   * \brief Why the request failed, if status is error.
+   */
+  std::string message;
+  /**
+   * \brief The result, if status is ok.
+   */
+  std::optional<inmemory::Matrix<E>> result;
+};
+
+/**
+ * \brief A blocking connection to a matrix compute server.
+ *
+ * Requests may be pipelined: send several, then receive the responses,
+ * which come back in completion order.
+ */
+class Client {
+private:
+  struct State;
+  std::unique_ptr<State> state;
+
+  /**
+   * \brief A block of bytes to be sent.
+   */
+  struct Chunk {
+    const void *data;
+    std::size_t size;
+  };
+
+  void writeAll(const std::vector<Chunk> &chunks);
+  void readAll(void *bytes, std::size_t size);
+
+public:
+  /**
+   * \brief Connects to the server.
+   *
+   * Throws a runtime_error if the connection fails.
+   */
+  Client(const std::string &host, int port);
+
+  Client(const Client &) = delete;
+  Client &operator=(const Client &) = delete;
+  ~Client();
+
+  /**
+   * \brief Sends a one operand request (transpose).
+   */
+  template <typename E>
+  void send(std::uint64_t id, Operation operation,
+            const inmemory::Matrix<E> &a);
+
+  /**
+   * \brief Sends a two operands request (multiply, solve).
+   */
+  template <typename E>
+  void send(std::uint64_t id, Operation operation,
+            const inmemory::Matrix<E> &a, const inmemory::Matrix<E> &b);
+
+  /**
+   * \brief Waits for the next response, whose result holds entries E.
+   */
+  template <typename E> Response<E> receive();
+};
+
+} // namespace linopt::server
+
+#include "Client.tpp"
+#endif
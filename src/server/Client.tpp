@@ -0,0 +1,68 @@
+#include <cstring>
+#include <stdexcept>
+
+namespace linopt::server {
+
+template <typename E>
+void Client::send(std::uint64_t id, Operation operation,
+                  const inmemory::Matrix<E> &a) {
+  RequestHeader header;
+  header.operation = operation;
+  header.operands = 1;
+  header.id = id;
+  const io::LmfHeader lmf = io::makeHeader<E>(a.getN(), a.getM(), a.stride());
+  // the matrix buffer is sent as is: gathered, not copied
+  writeAll({{&header, sizeof(header)},
+            {&lmf, sizeof(lmf)},
+            {a.data(), lmf.payloadBytes()}});
+}
+
+template <typename E>
+void Client::send(std::uint64_t id, Operation operation,
+                  const inmemory::Matrix<E> &a, const inmemory::Matrix<E> &b) {
+  RequestHeader header;
+  header.operation = operation;
+  header.operands = 2;
+  header.id = id;
+  const io::LmfHeader la = io::makeHeader<E>(a.getN(), a.getM(), a.stride());
+  const io::LmfHeader lb = io::makeHeader<E>(b.getN(), b.getM(), b.stride());
+  writeAll({{&header, sizeof(header)},
+            {&la, sizeof(la)},
+            {a.data(), la.payloadBytes()},
+            {&lb, sizeof(lb)},
+            {b.data(), lb.payloadBytes()}});
+}
+
+template <typename E> Response<E> Client::receive() {
+  ResponseHeader header;
+  readAll(&header, sizeof(header));
+  if (std::memcmp(header.magic, ResponseHeader().magic,
+                  sizeof(header.magic)) != 0)
+    throw std::runtime_error("Invalid response from server.");
+  Response<E> response;
+  response.id = header.id;
+  response.status = header.status;
+  if (header.status != Status::ok) {
+    response.message.resize(header.messageBytes);
+    readAll(response.message.data(), header.messageBytes);
+    return response;
+  }
+  char bytes[sizeof(io::LmfHeader)];
+  readAll(bytes, sizeof(bytes));
+  const io::LmfHeader lmf = io::decodeHeader(bytes);
+  io::checkElementType<E>(lmf);
+  inmemory::Matrix<E> result = inmemory::Matrix<E>::uninitialized(
+      static_cast<int>(lmf.rows), static_cast<int>(lmf.cols));
+  if (lmf.rowStride == static_cast<std::uint64_t>(result.stride())) {
+    readAll(result.data(), lmf.payloadBytes());
+  } else {
+    std::vector<char> staging(lmf.payloadBytes());
+    readAll(staging.data(), staging.size());
+    io::copyPayload(lmf, staging.data(), result);
+  }
+  io::toNativeOrder(lmf, result);
+  response.result = std::move(result);
+  return response;
+}
+
+} // namespace linopt::server
@@ -0,0 +1,105 @@
+/**
+ * \file Protocol.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Declares the wire format of the matrix compute server.
+ * \details
+ *  A connection carries a stream of requests and a stream of responses.
+ *  A request is a \sa RequestHeader followed by its operands, each a
+ *  complete .lmf matrix (\sa Lmf.h). A response is a \sa ResponseHeader
+ *  followed, on success, by the result as an .lmf matrix, or, on failure,
+ *  by an error message.
+ *
+ *  A client may send several requests without waiting for the responses
+ *  (pipelining). Responses come back in completion order and carry the id
+ *  of their request. All operands of a request must hold entries of the
+ *  same type, float or double; the result has that type too.
+ *
+ *  Header fields are little-endian.
+ */
+#ifndef LINOPT_ERC_SERVER_PROTOCOL_H
+#define LINOPT_ERC_SERVER_PROTOCOL_H
+
+#include <bit>
+#include <cstdint>
+
+namespace linopt::server {
+
+static_assert(std::endian::native == std::endian::little,
+              "The server protocol assumes a little-endian host.");
+
+/**
+ * \brief Operations a request may ask for.
+ */
+enum class Operation : std::uint8_t {
+  /**
+   * \brief a*b, two operands.
+   */
+  multiply = 1,
+  /**
+   * \brief x such that a*x = b, two operands.
+   */
+  solve = 2,
+  /**
+   * \brief transpose of a, one operand.
+   */
+  transpose = 3
+};
+
+/**
+ * \brief Outcome of a request.
+ */
+enum class Status : std::uint8_t { ok = 0, error = 1 };
+
+/**
+ * \brief Number of operands an operation takes, 0 for an unknown operation.
+ */
+constexpr int operandCount(Operation operation) {
+  switch (operation) {
+  case Operation::multiply:
+  case Operation::solve:
+    return 2;
+  case Operation::transpose:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * \brief Header of a request.
+ */
+struct RequestHeader {
+  char magic[4] = {'L', 'O', 'P', 'Q'};
+  Operation operation = Operation::multiply;
+  /**
+   * \brief Number of .lmf operands following the header.
+   */
+  std::uint8_t operands = 0;
+  std::uint16_t reserved = 0;
+  /**
+   * \brief Chosen by the client, echoed in the response.
+   */
+  std::uint64_t id = 0;
+};
+static_assert(sizeof(RequestHeader) == 16);
+
+/**
+ * \brief Header of a response.
+ */
+struct ResponseHeader {
+  char magic[4] = {'L', 'O', 'P', 'R'};
+  Status status = Status::ok;
+  std::uint8_t reserved[3] = {0, 0, 0};
+  /**
+   * \brief Length of the error message following the header, if status is error.
+   */
+  std::uint32_t messageBytes = 0;
+  std::uint32_t reserved2 = 0;
+  std::uint64_t id = 0;
+};
+static_assert(sizeof(ResponseHeader) == 24);
+
+} // namespace linopt::server
+
+#endif
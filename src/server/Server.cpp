@@ -1,3 +1,580 @@
 #include "Server.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility> // boost 1.74 asio uses std::exchange without including it
+#include <variant>
+#include <vector>
 
+#include <boost/asio.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "Lmf.h"
+#include "Matrix.h"
+#include "Metrics.h"
+#include "Protocol.h"
+#include "Solve.h"
+#include "ThreadPool.h"
+
+namespace asio = boost::asio;
+using asio::ip::tcp;
+using linopt::inmemory::Matrix;
+using linopt::server::Operation;
+using linopt::server::RequestHeader;
+using linopt::server::ResponseHeader;
+using linopt::server::Status;
+
+namespace {
+
+using Operand = std::variant<Matrix<double>, Matrix<float>>;
+
+// rows * rowBytes <= limit, without overflowing
+bool fitsIn(std::uint64_t rows, std::uint64_t rowBytes, std::uint64_t limit) {
+  return rowBytes == 0 || rows <= limit / rowBytes;
+}
+
+// operand bytes held by all connections, \sa ServerOptions::maxBufferedBytes
+class Budget {
+private:
+  std::atomic<std::uint64_t> used{0};
+  const std::uint64_t limit;
+
+public:
+  explicit Budget(std::uint64_t limit) : limit(limit) {}
+
+  bool tryReserve(std::uint64_t bytes) {
+    std::uint64_t current = used.load(std::memory_order_relaxed);
+    do {
+      if (bytes > limit - current)
+        return false;
+    } while (!used.compare_exchange_weak(current, current + bytes,
+                                         std::memory_order_relaxed));
+    return true;
+  }
+
+  void release(std::uint64_t bytes) {
+    used.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+};
+
+// the share of the budget taken by the operands of one request, given
+// back when destroyed
+class Reservation {
+private:
+  Budget *budget = nullptr;
+  std::uint64_t bytes = 0;
+
+public:
+  Reservation() = default;
+  Reservation(const Reservation &) = delete;
+  Reservation &operator=(Reservation &&other) noexcept {
+    std::swap(budget, other.budget);
+    std::swap(bytes, other.bytes);
+    return *this;
+  }
+  ~Reservation() { reset(); }
+
+  bool add(Budget &from, std::uint64_t n) {
+    if (!from.tryReserve(n))
+      return false;
+    budget = &from;
+    bytes += n;
+    return true;
+  }
+
+  void reset() {
+    if (budget != nullptr)
+      budget->release(bytes);
+    budget = nullptr;
+    bytes = 0;
+  }
+};
+
+// a response and the storage its buffers point to, until written
+struct Response {
+  ResponseHeader header;
+  Reservation operandBytes;
+  linopt::io::LmfHeader lmf;
+  std::optional<Operand> result;
+  std::string message;
+
+  void fail(std::string what) {
+    header.status = Status::error;
+    message = std::move(what);
+    header.messageBytes = static_cast<std::uint32_t>(message.size());
+    result.reset();
+  }
+
+  void succeed(Operand matrix) {
+    result = std::move(matrix);
+    std::visit(
+        [this](const auto &m) {
+          using E = typename std::decay_t<decltype(m)>::value_type;
+          lmf = linopt::io::makeHeader<E>(m.getN(), m.getM(), m.stride());
+        },
+        *result);
+  }
+
+  // header, .lmf header and the result buffer itself: no copy
+  std::vector<asio::const_buffer> buffers() const {
+    std::vector<asio::const_buffer> b{asio::buffer(&header, sizeof(header))};
+    if (result) {
+      b.push_back(asio::buffer(&lmf, sizeof(lmf)));
+      std::visit(
+          [&](const auto &m) {
+            b.push_back(asio::buffer(m.data(), lmf.payloadBytes()));
+          },
+          *result);
+    } else {
+      b.push_back(asio::buffer(message));
+    }
+    return b;
+  }
+};
+
+Operand compute(Operation operation, const std::vector<Operand> &operands) {
+  return std::visit(
+      [&](const auto &a) -> Operand {
+        using M = std::decay_t<decltype(a)>;
+        if (operation == Operation::transpose)
+          return a.transpose();
+        const M *b = std::get_if<M>(&operands[1]);
+        if (b == nullptr)
+          throw std::runtime_error("Operands of different entry types.");
+        if (operation == Operation::multiply)
+          return a * *b;
+        return linopt::inmemory::solve(a, *b);
+      },
+      operands[0]);
+}
+
+void logMetrics() {
+  std::ostringstream report;
+  report << linopt::metrics::snapshot();
+  BOOST_LOG_TRIVIAL(info) << "Metrics:\n" << report.str();
+}
+
+} // namespace
+
+struct Server::State {
+  // outlives the sessions and responses owned by the io_context's handlers
+  Budget budget;
+  // declared before the jobs and the handlers' objects, destroyed after
+  // them: the jobs post their completion to it
+  asio::io_context io;
+  tcp::acceptor acceptor{asio::make_strand(io)};
+  asio::steady_timer metricsTimer{acceptor.get_executor()};
+  std::vector<std::thread> ioThreads;
+  // null when the requests run on the shared pool
+  std::unique_ptr<linopt::parallel::ThreadPool> dedicated;
+  linopt::parallel::TaskGroup jobs;
+  std::atomic<int> queuedJobs{0};
+  std::mutex mutex;
+  // sessions waiting for room on the worker pool
+  std::vector<std::weak_ptr<Session>> parked;
+  std::vector<std::weak_ptr<Session>> sessions;
+
+  State(int workerCount, std::uint64_t bufferedBytes)
+      : budget(bufferedBytes),
+        dedicated(workerCount > 0
+                      ? std::make_unique<linopt::parallel::ThreadPool>(workerCount)
+                      : nullptr),
+        jobs(dedicated ? *dedicated : linopt::parallel::ThreadPool::shared()) {}
+};
+
+class Server::Session : public std::enable_shared_from_this<Session> {
+private:
+  Server &server;
+  tcp::socket socket;
+  RequestHeader request;
+  std::array<char, sizeof(linopt::io::LmfHeader)> lmfBytes;
+  linopt::io::LmfHeader lmf;
+  std::vector<Operand> operands;
+  std::optional<Operand> current;
+  // the operand buffers of the request being read
+  Reservation reserved;
+  std::vector<char> staging;
+  // the payload of a rejected operand is read into it and dropped
+  std::vector<char> scrap;
+  std::string requestError;
+  std::deque<std::shared_ptr<Response>> outbox;
+  int inFlight = 0;
+  bool paused = false, writing = false, closed = false;
+
+  void readRequest();
+  void readOperand();
+  void onOperandHeader();
+  void drain(std::uint64_t remaining);
+  void onOperandPayload();
+  void dispatch();
+  void complete(std::shared_ptr<Response> response);
+  void write();
+
+public:
+  Session(Server &server, tcp::socket socket)
+      : server(server), socket(std::move(socket)) {}
+
+  // all the members are only touched from the socket's strand
+  template <typename F> void post(F &&f) {
+    asio::post(socket.get_executor(),
+               [self = shared_from_this(), f = std::forward<F>(f)] { f(); });
+  }
+
+  void start() { readRequest(); }
+
+  void resume() {
+    if (paused)
+      readRequest();
+  }
+
+  void close();
+};
+
+void Server::Session::close() {
+  if (closed)
+    return;
+  closed = true;
+  boost::system::error_code ignored;
+  socket.shutdown(tcp::socket::shutdown_both, ignored);
+  socket.close(ignored);
+}
+
+void Server::Session::readRequest() {
+  if (closed)
+    return;
+  paused = true;
+  if (inFlight >= server.options.maxPipelined)
+    return; // resumed when one of our requests completes
+  {
+    std::lock_guard<std::mutex> lock(server.state->mutex);
+    if (server.state->queuedJobs.load() >= server.options.maxQueuedJobs) {
+      server.state->parked.push_back(weak_from_this());
+      return; // resumed when a job of any connection completes
+    }
+  }
+  paused = false;
+  asio::async_read(
+      socket, asio::buffer(&request, sizeof(request)),
+      [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+        if (ec)
+          return self->close();
+        const RequestHeader expected;
+        if (std::memcmp(self->request.magic, expected.magic,
+                        sizeof(expected.magic)) != 0 ||
+            self->request.operands > 2) {
+          BOOST_LOG_TRIVIAL(warning) << "Closing connection: bad request.";
+          return self->close();
+        }
+        self->operands.clear();
+        self->reserved.reset();
+        self->requestError.clear();
+        if (linopt::server::operandCount(self->request.operation) !=
+            self->request.operands)
+          self->requestError = "Invalid operation or operand count.";
+        self->readOperand();
+      });
+}
+
+void Server::Session::readOperand() {
+  if (operands.size() == request.operands)
+    return dispatch();
+  asio::async_read(
+      socket, asio::buffer(lmfBytes),
+      [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+        if (ec)
+          return self->close();
+        self->onOperandHeader();
+      });
+}
+
+void Server::Session::onOperandHeader() {
+  try {
+    lmf = linopt::io::decodeHeader(lmfBytes.data());
+  } catch (const std::exception &e) {
+    BOOST_LOG_TRIVIAL(warning) << "Closing connection: " << e.what();
+    return close();
+  }
+  const std::uint64_t limit = server.options.maxOperandBytes;
+  const bool isDouble = lmf.elementType == linopt::io::ElementType::float64 &&
+                        lmf.elementSize == sizeof(double);
+  const bool isFloat = lmf.elementType == linopt::io::ElementType::float32 &&
+                       lmf.elementSize == sizeof(float);
+  // the matrix pads its rows again: bound what is allocated, not what is sent
+  using linopt::inmemory::paddedStride;
+  const std::uint64_t rowBytes =
+      isDouble  ? paddedStride<double>(lmf.cols) * sizeof(double)
+      : isFloat ? paddedStride<float>(lmf.cols) * sizeof(float)
+                : 0;
+  if (lmf.headerSize != sizeof(linopt::io::LmfHeader) ||
+      !fitsIn(lmf.rows, lmf.rowStride * lmf.elementSize, limit) ||
+      !fitsIn(lmf.rows, rowBytes, limit)) {
+    BOOST_LOG_TRIVIAL(warning) << "Closing connection: unsupported operand.";
+    return close();
+  }
+  current.reset();
+  const int n = static_cast<int>(lmf.rows), m = static_cast<int>(lmf.cols);
+  // the matrix, plus a staging copy of the payload when the padding differs
+  const std::uint64_t bytes =
+      lmf.rows * rowBytes +
+      (lmf.rowStride * lmf.elementSize != rowBytes ? lmf.payloadBytes() : 0);
+  // a request that already failed only needs its framing
+  if (!requestError.empty())
+    return drain(lmf.payloadBytes());
+  if (rowBytes != 0 && !reserved.add(server.state->budget, bytes)) {
+    requestError = "Server busy: operand memory exhausted.";
+    return drain(lmf.payloadBytes());
+  }
+  void *target = nullptr;
+  try {
+    if (isDouble)
+      current.emplace(Matrix<double>::uninitialized(n, m));
+    else if (isFloat)
+      current.emplace(Matrix<float>::uninitialized(n, m));
+    else if (requestError.empty())
+      requestError = "Unsupported entry type.";
+    if (!current)
+      return drain(lmf.payloadBytes());
+    // straight into the matrix buffer when the padding matches
+    std::visit(
+        [&](auto &matrix) {
+          if (static_cast<std::uint64_t>(matrix.stride()) == lmf.rowStride)
+            target = matrix.data();
+        },
+        *current);
+    if (target == nullptr) {
+      staging.resize(lmf.payloadBytes());
+      target = staging.data();
+    }
+  } catch (const std::bad_alloc &) {
+    BOOST_LOG_TRIVIAL(warning) << "Closing connection: out of memory.";
+    current.reset();
+    std::vector<char>().swap(staging);
+    return close();
+  }
+  asio::async_read(
+      socket, asio::buffer(target, lmf.payloadBytes()),
+      [self = shared_from_this()](boost::system::error_code ec, std::size_t) {
+        if (ec)
+          return self->close();
+        self->onOperandPayload();
+      });
+}
+
+void Server::Session::drain(std::uint64_t remaining) {
+  if (remaining == 0)
+    return onOperandPayload();
+  constexpr std::size_t chunk = std::size_t(1) << 16;
+  scrap.resize(chunk);
+  asio::async_read(
+      socket, asio::buffer(scrap.data(), std::min<std::uint64_t>(remaining, chunk)),
+      [self = shared_from_this(), remaining](boost::system::error_code ec,
+                                             std::size_t n) {
+        if (ec)
+          return self->close();
+        self->drain(remaining - n);
+      });
+}
+
+void Server::Session::onOperandPayload() {
+  if (current) {
+    std::visit(
+        [&](auto &matrix) {
+          if (static_cast<std::uint64_t>(matrix.stride()) != lmf.rowStride)
+            linopt::io::copyPayload(lmf, staging.data(), matrix);
+          linopt::io::toNativeOrder(lmf, matrix);
+        },
+        *current);
+    operands.push_back(std::move(*current));
+    current.reset();
+  } else {
+    // operand rejected: keep the framing, drop its entries
+    operands.emplace_back(Matrix<double>(1, 1));
+  }
+  // an idle session holds no operand sized buffer
+  std::vector<char>().swap(staging);
+  std::vector<char>().swap(scrap);
+  readOperand();
+}
+
+void Server::Session::dispatch() {
+  auto response = std::make_shared<Response>();
+  response->header.id = request.id;
+  response->operandBytes = std::move(reserved);
+  inFlight++; // until the response is written
+  if (!requestError.empty()) {
+    response->fail(requestError);
+    complete(std::move(response));
+    return readRequest();
+  }
+  State &state = *server.state;
+  state.queuedJobs++;
+  const linopt::parallel::ExecutionPolicy policy = server.options.policy;
+  state.jobs.run([self = shared_from_this(), &state, policy,
+                  operation = request.operation,
+                  operands = std::move(operands), response]() mutable {
+    try {
+      linopt::parallel::ScopedPolicy scope(policy);
+      response->succeed(compute(operation, operands));
+    } catch (const std::exception &e) {
+      response->fail(e.what());
+    }
+    operands.clear(); // before the reply gives their budget back
+    std::vector<std::weak_ptr<Session>> resumed;
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.queuedJobs--;
+      std::swap(resumed, state.parked);
+    }
+    for (const std::weak_ptr<Session> &w : resumed)
+      if (std::shared_ptr<Session> s = w.lock())
+        s->post([s = s.get()] { s->resume(); });
+    self->post([s = self.get(), response] { s->complete(response); });
+  });
+  operands.clear();
+  readRequest(); // pipelining: the next request is read meanwhile
+}
+
+void Server::Session::complete(std::shared_ptr<Response> response) {
+  if (closed)
+    return;
+  outbox.push_back(std::move(response));
+  if (!writing)
+    write();
+}
+
+void Server::Session::write() {
+  writing = true;
+  std::shared_ptr<Response> response = outbox.front();
+  asio::async_write(socket, response->buffers(),
+                    [self = shared_from_this(), response](
+                        boost::system::error_code ec, std::size_t) {
+                      self->writing = false;
+                      response->operandBytes.reset();
+                      if (ec)
+                        return self->close();
+                      self->outbox.pop_front();
+                      self->inFlight--;
+                      if (!self->outbox.empty())
+                        self->write();
+                      self->resume();
+                    });
+}
+
+Server::Server(int port) : Server(port, ServerOptions()) {}
+
+Server::Server(int port, ServerOptions options)
+    : p(port), options(std::move(options)) {}
+
+Server::~Server() { stop(); }
+
+int Server::port() const { return p; }
+
+void Server::start() {
+  if (state)
+    return;
+  state = std::make_unique<State>(options.workers, options.maxBufferedBytes);
+  tcp::endpoint endpoint(asio::ip::make_address(options.address),
+                         static_cast<unsigned short>(p));
+  try {
+    state->acceptor.open(endpoint.protocol());
+    state->acceptor.set_option(tcp::acceptor::reuse_address(true));
+    state->acceptor.bind(endpoint);
+    state->acceptor.listen();
+  } catch (const boost::system::system_error &e) {
+    state.reset();
+    throw std::runtime_error("Could not listen on " + options.address + ":" +
+                             std::to_string(p) + ": " + e.what());
+  }
+  p = state->acceptor.local_endpoint().port();
+  accept();
+  if (linopt::metrics::enabled && options.metricsInterval.count() > 0)
+    scheduleMetrics();
+  for (int i = 0; i < std::max(1, options.ioThreads); i++)
+    state->ioThreads.emplace_back([this] { state->io.run(); });
+  BOOST_LOG_TRIVIAL(info) << "Listening on " << options.address << ":" << p;
+}
+
+void Server::accept() {
+  state->acceptor.async_accept(
+      asio::make_strand(state->io),
+      [this](boost::system::error_code ec, tcp::socket socket) {
+        if (ec == asio::error::operation_aborted)
+          return;
+        if (ec) {
+          BOOST_LOG_TRIVIAL(warning) << "Accept failed: " << ec.message();
+        } else {
+          socket.set_option(tcp::no_delay(true));
+          auto session = std::make_shared<Session>(*this, std::move(socket));
+          {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            std::erase_if(state->sessions,
+                          [](const std::weak_ptr<Session> &s) {
+                            return s.expired();
+                          });
+            state->sessions.push_back(session);
+          }
+          session->post([s = session.get()] { s->start(); });
+        }
+        accept();
+      });
+}
+
+void Server::scheduleMetrics() {
+  state->metricsTimer.expires_after(options.metricsInterval);
+  state->metricsTimer.async_wait([this](boost::system::error_code ec) {
+    if (ec)
+      return;
+    logMetrics();
+    scheduleMetrics();
+  });
+}
+
+void Server::run() {
+  start();
+  {
+    std::promise<void> signalled;
+    asio::signal_set signals(state->io, SIGINT, SIGTERM);
+    signals.async_wait([&signalled](boost::system::error_code ec, int) {
+      if (!ec)
+        signalled.set_value();
+    });
+    signalled.get_future().wait();
+  }
+  BOOST_LOG_TRIVIAL(info) << "Stopping.";
+  stop();
+}
+
+void Server::stop() {
+  if (!state)
+    return;
+  asio::post(state->acceptor.get_executor(), [this] {
+    boost::system::error_code ignored;
+    state->acceptor.close(ignored);
+    state->metricsTimer.cancel();
+  });
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (const std::weak_ptr<Session> &w : state->sessions)
+      if (std::shared_ptr<Session> s = w.lock())
+        s->post([s = s.get()] { s->close(); });
+  }
+  state->jobs.wait();
+  state->io.stop();
+  for (std::thread &t : state->ioThreads)
+    t.join();
+  state.reset();
+  if (linopt::metrics::enabled && options.metricsInterval.count() > 0)
+    logMetrics();
+}
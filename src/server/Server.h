@@ -1,6 +1,78 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Parallel.h"
+
+/**
+ * \brief Tuning knobs of the \sa Server.
+ */
+struct ServerOptions {
+  /**
+   * \brief Address the server listens on.
+   */
+  std::string address = "0.0.0.0";
+  /**
+   * \brief Number of threads running the network event loop.
+   */
+  int ioThreads = 1;
+  /**
+   * \brief Number of threads of a dedicated pool running the requests, 0
+   * to run them on the library's shared pool.
+   *
+   * On the shared pool, the parallel kernels of a request and the other
+   * requests share the same threads: the machine is never oversubscribed.
+   * A dedicated pool comes on top of the shared one.
+   */
+  int workers = 0;
+  /**
+   * \brief Maximum number of requests of one connection read but not yet
+   * answered; the connection is not read from while it is reached.
+   */
+  int maxPipelined = 16;
+  /**
+   * \brief Maximum number of requests queued on the worker pool; no
+   * connection is read from while it is reached.
+   */
+  int maxQueuedJobs = 64;
+  /**
+   * \brief Operands larger than this, in bytes, get the connection closed.
+   */
+  std::uint64_t maxOperandBytes = std::uint64_t(1) << 32;
+  /**
+   * \brief Bound, in bytes, on the operand buffers of all connections
+   * together, held from their allocation until the reply is written.
+   * Operands beyond it are drained and their request answered with an
+   * error.
+   */
+  std::uint64_t maxBufferedBytes = std::uint64_t(1) << 34;
+  /**
+   * \brief Execution policy the requests are computed with.
+   */
+  linopt::parallel::ExecutionPolicy policy = linopt::parallel::par;
+  /**
+   * \brief Period of the metrics reports written to the log, 0 for none.
+   *
+   * Only effective when the metrics hooks are compiled in, \sa Metrics.h;
+   * a last report is written when the server stops.
+   */
+  std::chrono::seconds metricsInterval{0};
+};
+
+/**
+ * \brief Matrix compute server.
+ *
+ * Accepts tcp connections speaking the protocol of \sa Protocol.h, reads
+ * the operands straight into matrix buffers, runs the requests on a pool
+ * of worker threads and writes the results back straight from the result
+ * buffers. Reads are paused when the worker pool or a connection has too
+ * many requests in flight, so that clients are throttled by tcp flow
+ * control instead of filling the server's memory.
+ */
 class Server{
 private:
   /**
@@ -8,7 +80,54 @@ private:
    * listens for incoming tcp requests.
   */
   int p;
+  ServerOptions options;
+
+  struct State;
+  class Session;
+  std::unique_ptr<State> state;
+
+  void accept();
+  void scheduleMetrics();
+
 public:
-  Server(int port):p(port){}
+  Server(int port);
+
+  /**
+   * \brief Constructs a server, not yet listening.
+   * \param port: tcp port to listen on, 0 for any free port.
+   * \param options: tuning knobs.
+   */
+  Server(int port, ServerOptions options);
+
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+
+  /**
+   * \brief Stops the server if it is running.
+   */
+  ~Server();
+
+  /**
+   * \brief Starts listening and serving on background threads.
+   *
+   * Throws a runtime_error if the address cannot be bound.
+   */
+  void start();
+
+  /**
+   * \brief Starts the server and serves until SIGINT or SIGTERM.
+   */
+  void run();
+
+  /**
+   * \brief Closes the listener and all connections, after the requests
+   * being computed have completed.
+   */
+  void stop();
+
+  /**
+   * \brief The port the server listens on (the actual one once started).
+   */
+  int port() const;
 };
 #endif
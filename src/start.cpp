@@ -1,4 +1,7 @@
 #include "Server.h"
+#include <chrono>
+#include <cstdlib>
+#include <exception>
 // https://stackoverflow.com/questions/69967084/how-to-set-the-severity-level-of-boost-log-library
 #include <boost/log/trivial.hpp>
 #include <boost/log/core.hpp>
@@ -15,13 +18,17 @@ void init()
 }
 
 
-int main(int, char *[]) {
+int main(int argc, char *argv[]) {
   init();
-  BOOST_LOG_TRIVIAL(trace) << "A trace severity message";
-  BOOST_LOG_TRIVIAL(debug) << "A debug severity message";
-  BOOST_LOG_TRIVIAL(info) << "An informational severity message";
-  BOOST_LOG_TRIVIAL(warning) << "A warning severity message";
-  BOOST_LOG_TRIVIAL(error) << "An error severity message";
-  BOOST_LOG_TRIVIAL(fatal) << "A fatal severity message";
+  const int port = argc > 1 ? std::atoi(argv[1]) : 4242;
+  try {
+    ServerOptions options;
+    options.metricsInterval = std::chrono::minutes(1);
+    Server server(port, options);
+    server.run();
+  } catch (const std::exception &e) {
+    BOOST_LOG_TRIVIAL(fatal) << e.what();
+    return 1;
+  }
   return 0;
 }
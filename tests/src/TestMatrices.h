@@ -0,0 +1,113 @@
+/**
+ * \file TestMatrices.h
+ * \author mk8bk
+ * \date 16/10/2026
+ * \brief Fixtures and assertions shared by the unit tests.
+ * \details
+ *  Every test target has tests/src on its include path. Fixtures that
+ *  only make sense for one algorithm (spectra, sparsity patterns) stay in
+ *  their test file.
+ */
+#ifndef LINOPT_ERC_TESTS_TEST_MATRICES_H
+#define LINOPT_ERC_TESTS_TEST_MATRICES_H
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include "Matrix.h"
+
+namespace linopt::test {
+
+using inmemory::Matrix;
+
+/**
+ * \brief Small integers in [-5, 5]: sums and products of a few hundred
+ * terms are exact in every entry type, whatever the summation order.
+ */
+template <typename E> Matrix<E> patterned(int n, int m, int seed = 0) {
+    Matrix<E> a(n, m);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            a.get(i, j) = static_cast<E>((i * 7 + j * 13 + seed) % 11) - E(5);
+    return a;
+}
+
+/**
+ * \brief Smooth dense entries in [-1, 1], full rank for moderate sizes.
+ */
+inline Matrix<double> smooth(int n, int m, double shift = 0) {
+    Matrix<double> a(n, m);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            a.get(i, j) = std::sin(1.3 * i + 0.7 * j * j + shift);
+    return a;
+}
+
+/**
+ * \brief Square system with entries in [-1, 1] plus diagonal on the
+ * diagonal; a diagonal of n makes it diagonally dominant.
+ */
+inline Matrix<double> wellConditioned(int n, double shift,
+                                      double diagonal = 3.0) {
+    Matrix<double> a(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            a.get(i, j) = std::sin(i * 1.7 + j * 0.3 + shift) + (i == j ? diagonal : 0.0);
+    return a;
+}
+
+/**
+ * \brief Symmetric with smooth entries in [-1, 1], plus spread*i on
+ * diagonal entry i to pull its eigenvalues apart.
+ */
+inline Matrix<double> symmetric(int n, double shift = 0, double spread = 0) {
+    Matrix<double> a(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            a.get(i, j) = a.get(j, i) = std::sin(0.7 * i * j + i + j + shift);
+    for (int i = 0; i < n; i++)
+        a.get(i, i) += spread * i;
+    return a;
+}
+
+template <typename E = double> Matrix<E> identity(int n) {
+    Matrix<E> r(n, n);
+    for (int i = 0; i < n; i++)
+        r.get(i, i) = E(1);
+    return r;
+}
+
+/**
+ * \brief Asserts equal dimensions and entries within tolerance; b may be
+ * an expression.
+ */
+template <typename E>
+void expectNear(const Matrix<E> &a, const std::type_identity_t<Matrix<E>> &b,
+                double tolerance) {
+    ASSERT_EQ(a.getN(), b.getN());
+    ASSERT_EQ(a.getM(), b.getM());
+    for (int i = 0; i < a.getN(); i++)
+        for (int j = 0; j < a.getM(); j++)
+            ASSERT_NEAR(a.get(i, j), b.get(i, j), tolerance) << i << "," << j;
+}
+
+/**
+ * \brief Largest absolute difference between entries of a and b, of the
+ * same dimensions.
+ */
+template <typename E>
+double maxDifference(const Matrix<E> &a,
+                     const std::type_identity_t<Matrix<E>> &b) {
+    double r = 0;
+    for (int i = 0; i < a.getN(); i++)
+        for (int j = 0; j < a.getM(); j++)
+            r = std::max(r, static_cast<double>(std::abs(a.get(i, j) - b.get(i, j))));
+    return r;
+}
+
+} // namespace linopt::test
+
+#endif
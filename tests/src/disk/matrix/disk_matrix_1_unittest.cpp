@@ -1,11 +1,131 @@
 #include "DiskMatrix.h"
+#include "TestMatrices.h"
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace linopt::disk;
+using linopt::inmemory::Matrix;
+using namespace linopt::test;
+
+namespace {
+
+// removes the files it names when the test ends
+struct TemporaryFiles {
+  std::vector<std::string> paths;
+  ~TemporaryFiles() {
+    for (const std::string &p : paths)
+      std::remove(p.c_str());
+  }
+  const std::string &operator()(const std::string &path) {
+    paths.push_back(path);
+    return paths.back();
+  }
+};
+
+} // namespace
 
 
 TEST(DiskMatrix, Constructor){
+  linopt::io::save("m.lmf", Matrix<double>(5, 3, 2.0));
   EXPECT_NO_THROW(DiskMatrix<double> d("m.lmf"));
+  DiskMatrix<double> d("m.lmf", Access::readOnly);
+  const DiskMatrix<double> &c = d;
+  ASSERT_EQ(c.getN(), 5);
+  ASSERT_EQ(c.getM(), 3);
+  ASSERT_EQ(c.get(4, 2), 2.0);
+  EXPECT_THROW(c.get(5, 0), std::runtime_error);
+  EXPECT_THROW(d.get(0, 0), std::runtime_error);
+  EXPECT_THROW(DiskMatrix<float> f("m.lmf"), std::runtime_error);
+  EXPECT_THROW(DiskMatrix<double> missing("missing.lmf"), std::runtime_error);
+  std::remove("m.lmf");
 }
 
+TEST(DiskMatrix, TestOverflowingHeader) {
+  TemporaryFiles files;
+  // rows*rowStride*8 wraps to 2^33 - 8 bytes: a sparse file of that size
+  // would pass a wrapped size check while get() reads far beyond it
+  linopt::io::LmfHeader header = linopt::io::makeHeader<double>(2, 2, 2);
+  header.rows = 0x7fffffff;
+  header.cols = 0x40000001;
+  header.rowStride = 0x40000001;
+  const std::string &path = files("overflow.lmf");
+  {
+    std::ofstream os(path, std::ios::binary);
+    linopt::io::writeHeader(os, header);
+  }
+  std::filesystem::resize_file(path, header.headerSize + (1ull << 33));
+  EXPECT_THROW(DiskMatrix<double> d(path), std::runtime_error);
+}
 
+TEST(DiskMatrix, TestReadWrite) {
+  TemporaryFiles files;
+  Matrix<double> a = patterned<double>(40, 70, 1);
+  {
+    DiskMatrix<double> d = DiskMatrix<double>::create(files("rw.lmf"), a);
+    ASSERT_EQ(d.toMatrix(), a);
+    d.get(3, 4) = 100.0;
+    d.write(10, 20, Matrix<double>(2, 3, -1.0));
+    ASSERT_EQ(d.read(10, 20, 2, 3), Matrix<double>(2, 3, -1.0));
+    Tile<double> t = d.tile(30, 60, 4, 10);
+    t(3, 9) = 7.0;
+    d.flush();
+  }
+  a.get(3, 4) = 100.0;
+  for (int i = 10; i < 12; i++)
+    for (int j = 20; j < 23; j++)
+      a.get(i, j) = -1.0;
+  a.get(33, 69) = 7.0;
+  // the stores reached the file
+  ASSERT_EQ(linopt::io::load<double>("rw.lmf"), a);
+  DiskMatrix<double> d("rw.lmf");
+  EXPECT_THROW(d.tile(38, 0, 3, 1), std::runtime_error);
+}
+
+TEST(DiskMatrix, TestSweeps) {
+  TemporaryFiles files;
+  Matrix<int> a = patterned<int>(37, 29, 2);
+  DiskMatrix<int> d = DiskMatrix<int>::create(files("sweep.lmf"), a);
+  long sum = 0, expected = 0;
+  int bands = 0;
+  d.sweepRows(8, [&](int r0, int r1) {
+    bands++;
+    for (int i = r0; i < r1; i++)
+      for (int j = 0; j < d.getM(); j++)
+        sum += d.coeff(i, j);
+  });
+  for (int i = 0; i < a.getN(); i++)
+    for (int j = 0; j < a.getM(); j++)
+      expected += a.get(i, j);
+  ASSERT_EQ(bands, 5);
+  ASSERT_EQ(sum, expected);
+  long covered = 0;
+  d.sweepTiles(10, 7, [&](int r0, int r1, int c0, int c1) {
+    covered += static_cast<long>(r1 - r0) * (c1 - c0);
+  });
+  ASSERT_EQ(covered, 37L * 29);
+}
 
+TEST(DiskMatrix, TestOutOfCoreOperations) {
+  TemporaryFiles files;
+  Matrix<double> a = patterned<double>(150, 90, 3);
+  Matrix<double> b = patterned<double>(90, 130, 4);
+  Matrix<double> c = patterned<double>(150, 90, 5);
+  DiskMatrix<double> da = DiskMatrix<double>::create(files("a.lmf"), a);
+  DiskMatrix<double> db = DiskMatrix<double>::create(files("b.lmf"), b);
+  DiskMatrix<double> dc = DiskMatrix<double>::create(files("c.lmf"), c);
+  // a budget of a few tiles of 64x64 entries forces many passes
+  const std::size_t budget = 3 * 64 * 64 * sizeof(double);
 
+  ASSERT_EQ(multiply(da, db, files("ab.lmf"), budget).toMatrix(), a * b);
+  ASSERT_EQ(transpose(da, files("at.lmf"), budget).toMatrix(), a.transpose());
+  ASSERT_EQ(add(da, dc, files("sum.lmf"), budget).toMatrix(), a + c);
+  ASSERT_EQ(subtract(da, dc, files("diff.lmf"), budget).toMatrix(), a - c);
+  ASSERT_EQ(scale(da, 3.0, files("s.lmf"), budget).toMatrix(), a * 3.0);
+  EXPECT_THROW(multiply(da, dc, files("bad.lmf"), budget), std::runtime_error);
+  EXPECT_THROW(add(da, db, files("bad.lmf"), budget), std::runtime_error);
+}
@@ -0,0 +1,118 @@
+#include "BatchFactorizations.h"
+#include "Cholesky.h"
+#include "Lu.h"
+#include "MatrixBatch.h"
+#include "Parallel.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// not a multiple of the lanes: the last pack is partly padding
+constexpr int count = 37;
+
+double entry(int b, int i, int j) {
+    return std::sin(b * 0.37 + i * 1.3 + j * j * 0.7 + i * j * 0.5);
+}
+
+MatrixBatch<double> sample(int n, int m) {
+    MatrixBatch<double> a(count, n, m);
+    for (int b = 0; b < count; b++)
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < m; j++)
+                a.get(b, i, j) = entry(b, i, j);
+    return a;
+}
+
+} // namespace
+
+TEST(MatrixBatch, TestLayout) {
+    MatrixBatch<float> a(20, 2, 3);
+    ASSERT_EQ(MatrixBatch<float>::lanes, 16);
+    ASSERT_EQ(a.packs(), 2);
+    a.get(17, 1, 2) = 5;
+    ASSERT_EQ(a.pack(1)[(1 * 3 + 2) * 16 + 1], 5);
+    a.fill(1);
+    ASSERT_EQ(a.get(19, 0, 0), 1);
+    ASSERT_EQ(a.pack(1)[4], 0); // padding lane
+    ASSERT_THROW(a.get(20, 0, 0), std::runtime_error);
+    ASSERT_THROW(a.get(0, 2, 0), std::runtime_error);
+    ASSERT_THROW(MatrixBatch<float>(0, 2, 2), std::runtime_error);
+
+    const Matrix<float> m({{1, 2, 3},
+                           {4, 5, 6}});
+    a.set(3, m * 2.0f);
+    ASSERT_EQ(a.matrix(3), m * 2.0f);
+    ASSERT_EQ(a.transpose().matrix(3), (m * 2.0f).eval().transpose());
+    ASSERT_THROW(a.set(3, m.transpose()), std::runtime_error);
+}
+
+TEST(MatrixBatch, TestMultiply) {
+    linopt::parallel::ScopedPolicy policy(linopt::parallel::par);
+    const MatrixBatch<double> a = sample(3, 5), b = sample(5, 4);
+    MatrixBatch<double> c = a * b;
+    for (int k = 0; k < count; k++)
+        expectNear(c.matrix(k), a.matrix(k) * b.matrix(k), 1e-13);
+    multiply(a, b, c, kernels::GemmUpdate::subtract);
+    for (int k = 0; k < count; k++)
+        expectNear(c.matrix(k), Matrix<double>(3, 4), 1e-13);
+
+    MatrixBatch<double> s = sample(4, 4);
+    const MatrixBatch<double> s0 = s;
+    multiply(s, s0, s, kernels::GemmUpdate::accumulate);
+    for (int k = 0; k < count; k++)
+        expectNear(s.matrix(k), s0.matrix(k) * s0.matrix(k) + s0.matrix(k),
+                   1e-13);
+    ASSERT_THROW(multiply(a, a, c), std::runtime_error);
+    ASSERT_THROW(multiply(a, MatrixBatch<double>(count + 1, 5, 4), c),
+                 std::runtime_error);
+}
+
+TEST(MatrixBatch, TestLuSolve) {
+    const int n = 6;
+    MatrixBatch<double> a = sample(n, n);
+    const MatrixBatch<double> b = sample(n, 2);
+    const BatchLuFactorization<double> lu(a);
+    const MatrixBatch<double> x = lu.solve(b);
+    for (int k = 0; k < count; k++) {
+        ASSERT_FALSE(lu.isSingular(k));
+        const LuFactorization<double> reference(a.matrix(k));
+        expectNear(x.matrix(k), reference.solve(b.matrix(k)), 1e-10);
+        expectNear(a.matrix(k) * x.matrix(k), b.matrix(k), 1e-10);
+        for (int s = 0; s < n; s++)
+            ASSERT_EQ(lu.pivot(k, s), reference.pivots()[s]);
+    }
+    // a singular matrix is flagged, the others are unaffected
+    a.set(30, Matrix<double>(n, n));
+    const BatchLuFactorization<double> singular(a);
+    ASSERT_TRUE(singular.isSingular(30));
+    ASSERT_FALSE(singular.isSingular(29));
+    ASSERT_THROW(singular.solve(b), std::runtime_error);
+    ASSERT_THROW(lu.solve(sample(n + 1, 2)), std::runtime_error);
+    ASSERT_THROW(BatchLuFactorization<double>(sample(2, 3)),
+                 std::runtime_error);
+}
+
+TEST(MatrixBatch, TestCholeskySolve) {
+    const int n = 5;
+    const MatrixBatch<double> g = sample(n, n);
+    MatrixBatch<double> a = g * g.transpose();
+    for (int k = 0; k < count; k++)
+        for (int i = 0; i < n; i++)
+            a.get(k, i, i) += 1;
+    const MatrixBatch<double> b = sample(n, 3);
+    const BatchCholeskyFactorization<double> c(a);
+    const MatrixBatch<double> x = c.solve(b);
+    for (int k = 0; k < count; k++) {
+        const CholeskyFactorization<double> reference(a.matrix(k));
+        expectNear(c.lower().matrix(k), reference.lower(), 1e-12);
+        expectNear(a.matrix(k) * x.matrix(k), b.matrix(k), 1e-10);
+    }
+    a.get(12, 2, 2) = -1;
+    ASSERT_THROW(BatchCholeskyFactorization<double>{a}, std::runtime_error);
+}
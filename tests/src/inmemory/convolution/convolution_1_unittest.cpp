@@ -0,0 +1,105 @@
+#include "Convolution.h"
+#include "Parallel.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// straight from the definition, on the full result
+template <typename E>
+Matrix<E> reference(const Matrix<E> &image, const Matrix<E> &kernel,
+                    ConvolutionMode mode) {
+    const int n = image.getN(), m = image.getM();
+    const int p = kernel.getN(), q = kernel.getM();
+    Matrix<E> full(n + p - 1, m + q - 1);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            for (int a = 0; a < p; a++)
+                for (int b = 0; b < q; b++)
+                    full.get(i + a, j + b) += image.get(i, j) * kernel.get(a, b);
+    if (mode == ConvolutionMode::full)
+        return full;
+    const int i0 = mode == ConvolutionMode::same ? (p - 1) / 2 : p - 1;
+    const int j0 = mode == ConvolutionMode::same ? (q - 1) / 2 : q - 1;
+    const int rows = mode == ConvolutionMode::same ? n : n - p + 1;
+    const int columns = mode == ConvolutionMode::same ? m : m - q + 1;
+    return Matrix<E>(full.block(i0, j0, rows, columns));
+}
+
+constexpr ConvolutionMode modes[] = {ConvolutionMode::full,
+                                     ConvolutionMode::same,
+                                     ConvolutionMode::valid};
+
+} // namespace
+
+TEST(Convolution, TestDirectMatchesDefinition) {
+    linopt::parallel::ScopedPolicy policy(linopt::parallel::par);
+    const Matrix<double> image = patterned<double>(41, 57, 1);
+    for (const auto &[p, q] : {std::pair{1, 1}, {3, 3}, {4, 7}, {6, 2}})
+        for (ConvolutionMode mode : modes) {
+            const Matrix<double> kernel = patterned<double>(p, q, 2);
+            expectNear(convolve(image, kernel, mode, ConvolutionMethod::direct),
+                       reference(image, kernel, mode), 1e-12);
+        }
+}
+
+TEST(Convolution, TestFftMatchesDirect) {
+    linopt::parallel::ScopedPolicy policy(linopt::parallel::par);
+    // several tile rows and columns: exercises the overlap-add
+    const Matrix<double> image = patterned<double>(300, 270, 3);
+    for (const auto &[p, q] : {std::pair{5, 7}, {33, 20}, {2, 1}})
+        for (ConvolutionMode mode : modes) {
+            const Matrix<double> kernel = patterned<double>(p, q, 4);
+            expectNear(convolve(image, kernel, mode, ConvolutionMethod::fft),
+                       convolve(image, kernel, mode, ConvolutionMethod::direct),
+                       1e-8);
+        }
+}
+
+TEST(Convolution, TestIntegerFrames) {
+    const Matrix<int> image = patterned<int>(108, 192, 5);
+    const Matrix<int> kernel = patterned<int>(9, 9, 6);
+    const Matrix<int> direct = convolve(image, kernel);
+    ASSERT_EQ(direct, reference(image, kernel, ConvolutionMode::same));
+    // rounded back exactly
+    ASSERT_EQ(convolve(image, kernel, ConvolutionMode::same,
+                       ConvolutionMethod::fft),
+              direct);
+}
+
+TEST(Convolution, TestCorrelate) {
+    const Matrix<float> image = patterned<float>(20, 30, 7);
+    const Matrix<float> kernel = patterned<float>(3, 4, 8);
+    const Matrix<float> c = correlate(image, kernel, ConvolutionMode::valid);
+    ASSERT_EQ(c.getN(), 18);
+    ASSERT_EQ(c.getM(), 27);
+    for (int i = 0; i < c.getN(); i++)
+        for (int j = 0; j < c.getM(); j++) {
+            float s = 0;
+            for (int a = 0; a < 3; a++)
+                for (int b = 0; b < 4; b++)
+                    s += kernel.get(a, b) * image.get(i + a, j + b);
+            ASSERT_NEAR(c.get(i, j), s, 1e-3);
+        }
+    expectNear(correlate(image, kernel, ConvolutionMode::full,
+                         ConvolutionMethod::fft),
+               correlate(image, kernel, ConvolutionMode::full,
+                         ConvolutionMethod::direct),
+               1e-3);
+}
+
+TEST(Convolution, TestMethodChoice) {
+    ASSERT_EQ(chooseConvolutionMethod(1080, 1920, 3, 3, ConvolutionMode::same),
+              ConvolutionMethod::direct);
+    ASSERT_EQ(chooseConvolutionMethod(1080, 1920, 63, 63,
+                                      ConvolutionMode::same),
+              ConvolutionMethod::fft);
+    ASSERT_THROW(convolve(patterned<double>(4, 4, 0), patterned<double>(5, 2, 0),
+                          ConvolutionMode::valid),
+                 std::runtime_error);
+}
@@ -0,0 +1,80 @@
+#include "Eigen.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+void expectDecomposition(const Matrix<double> &a, const EigenDecomposition<double> &e,
+                         double tolerance) {
+    const int n = a.getN();
+    ASSERT_EQ(static_cast<int>(e.values.size()), n);
+    for (int i = 1; i < n; i++)
+        EXPECT_LE(e.values[i - 1], e.values[i]);
+    EXPECT_LT(maxDifference(e.vectors.transpose() * e.vectors, identity(n)), tolerance);
+    Matrix<double> lambda(n, n);
+    for (int i = 0; i < n; i++)
+        lambda.get(i, i) = e.values[i];
+    EXPECT_LT(maxDifference(a * e.vectors, e.vectors * lambda), tolerance);
+}
+
+} // namespace
+
+TEST(Eigen, TestSmall) {
+    Matrix<double> a = {{2, 1}, {1, 2}};
+    EigenDecomposition<double> e = symmetricEigen(a);
+    EXPECT_NEAR(e.values[0], 1.0, 1e-14);
+    EXPECT_NEAR(e.values[1], 3.0, 1e-14);
+    expectDecomposition(a, e, 1e-14);
+    Matrix<double> one = {{5}};
+    EXPECT_EQ(symmetricEigen(one).values[0], 5.0);
+}
+
+TEST(Eigen, TestLeaf) {
+    Matrix<double> a = symmetric(20, 0.0);
+    expectDecomposition(a, symmetricEigen(a), 1e-12);
+}
+
+TEST(Eigen, TestDivideAndConquer) {
+    Matrix<double> a = symmetric(230, 1.0);
+    EigenDecomposition<double> e = symmetricEigen(a);
+    expectDecomposition(a, e, 1e-10);
+    std::vector<double> values = symmetricEigenvalues(a);
+    for (int i = 0; i < 230; i++)
+        EXPECT_NEAR(values[i], e.values[i], 1e-10);
+}
+
+TEST(Eigen, TestClusteredSpectrum) {
+    // the 1D laplacian has its eigenvalues packed near 0 and 4, and a
+    // block diagonal matrix has repeated eigenvalues: both deflate
+    const int n = 150;
+    Matrix<double> a(n, n);
+    for (int i = 0; i < n; i++) {
+        a.get(i, i) = 2.0;
+        if (i + 1 < n && i != n / 2 - 1)
+            a.get(i, i + 1) = a.get(i + 1, i) = -1.0;
+    }
+    EigenDecomposition<double> e = symmetricEigen(a);
+    expectDecomposition(a, e, 1e-10);
+    // two identical blocks: each eigenvalue twice
+    for (int i = 0; i < n; i += 2)
+        EXPECT_NEAR(e.values[i], e.values[i + 1], 1e-12);
+    Matrix<double> scaled = identity(64);
+    expectDecomposition(scaled, symmetricEigen(scaled), 1e-12);
+}
+
+TEST(Eigen, TestReadsLowerTriangle) {
+    Matrix<double> a = symmetric(40, 2.0), lower(a);
+    for (int i = 0; i < 40; i++)
+        for (int j = i + 1; j < 40; j++)
+            lower.get(i, j) = 0.0;
+    EigenDecomposition<double> e = symmetricEigen(lower);
+    expectDecomposition(a, e, 1e-11);
+    Matrix<double> rectangular(3, 4);
+    EXPECT_THROW(symmetricEigen(rectangular), std::runtime_error);
+}
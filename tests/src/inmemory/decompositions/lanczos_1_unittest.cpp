@@ -0,0 +1,107 @@
+#include "Lanczos.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// 5 point laplacian of a rows x cols grid
+SparseMatrix<double> laplacian(int rows, int cols) {
+    std::vector<Triplet<double>> t;
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) {
+            int i = r * cols + c;
+            t.push_back({i, i, 4.0});
+            if (r > 0) t.push_back({i, i - cols, -1.0});
+            if (r + 1 < rows) t.push_back({i, i + cols, -1.0});
+            if (c > 0) t.push_back({i, i - 1, -1.0});
+            if (c + 1 < cols) t.push_back({i, i + 1, -1.0});
+        }
+    return SparseMatrix<double>::fromTriplets(rows * cols, rows * cols, t);
+}
+
+void expectEigenpairs(const std::function<void(const double *, double *)> &multiply,
+                      const LanczosResult<double> &r, double tolerance) {
+    const int n = r.vectors.getN();
+    std::vector<double> x(n), y(n);
+    for (int k = 0; k < static_cast<int>(r.values.size()); k++) {
+        for (int i = 0; i < n; i++)
+            x[i] = r.vectors.get(i, k);
+        multiply(x.data(), y.data());
+        for (int i = 0; i < n; i++)
+            ASSERT_NEAR(y[i], r.values[k] * x[i], tolerance);
+    }
+}
+
+} // namespace
+
+TEST(Lanczos, TestDenseLargest) {
+    const int n = 300;
+    Matrix<double> a = symmetric(n, 0.0, 0.05);
+    std::vector<double> all = symmetricEigen(a).values;
+    LanczosResult<double> r = lanczos(a, 6);
+    ASSERT_TRUE(r.converged);
+    for (int k = 0; k < 6; k++)
+        EXPECT_NEAR(r.values[k], all[n - 1 - k], 1e-8);
+    Matrix<double> gram = r.vectors.transpose() * r.vectors;
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 6; j++)
+            EXPECT_NEAR(gram.get(i, j), i == j ? 1.0 : 0.0, 1e-10);
+}
+
+TEST(Lanczos, TestSparseSmallest) {
+    // not square: a single start vector cannot find repeated eigenvalues
+    const int rows = 30, cols = 23;
+    SparseMatrix<double> a = laplacian(rows, cols);
+    std::vector<double> exact;
+    for (int p = 1; p <= rows; p++)
+        for (int q = 1; q <= cols; q++)
+            exact.push_back(4 - 2 * std::cos(p * M_PI / (rows + 1)) -
+                            2 * std::cos(q * M_PI / (cols + 1)));
+    std::sort(exact.begin(), exact.end());
+    LanczosOptions options;
+    options.target = EigenTarget::smallest;
+    options.basisSize = 40;
+    LanczosResult<double> r = lanczos(a, 5, options);
+    ASSERT_TRUE(r.converged);
+    EXPECT_GT(r.restarts, 0);
+    for (int k = 0; k < 5; k++)
+        EXPECT_NEAR(r.values[k], exact[k], 1e-8);
+    expectEigenpairs([&](const double *x, double *y) { a.multiply(x, y); }, r, 1e-7);
+}
+
+TEST(Lanczos, TestMatrixFree) {
+    // diag(1..n) - 2000: the largest magnitudes are the smallest entries
+    const int n = 2000;
+    auto multiply = [n](const double *x, double *y) {
+        for (int i = 0; i < n; i++)
+            y[i] = (i + 1 - 2000.5) * x[i];
+    };
+    LanczosOptions options;
+    options.target = EigenTarget::largestMagnitude;
+    options.maxRestarts = 2000;
+    LanczosResult<double> r = lanczos<double>(n, 3, multiply, options);
+    ASSERT_TRUE(r.converged);
+    EXPECT_NEAR(r.values[0], -1999.5, 1e-6);
+    EXPECT_NEAR(r.values[1], -1998.5, 1e-6);
+    EXPECT_NEAR(r.values[2], -1997.5, 1e-6);
+    EXPECT_GT(r.products, 0);
+    expectEigenpairs(multiply, r, 1e-6);
+}
+
+TEST(Lanczos, TestSmallOperator) {
+    // the basis spans the whole space: exact after one pass
+    Matrix<double> a = {{2, 1, 0}, {1, 2, 1}, {0, 1, 2}};
+    LanczosResult<double> r = lanczos(a, 2);
+    ASSERT_TRUE(r.converged);
+    EXPECT_NEAR(r.values[0], 2 + std::sqrt(2.0), 1e-12);
+    EXPECT_NEAR(r.values[1], 2.0, 1e-12);
+    EXPECT_THROW(lanczos(a, 3), std::runtime_error);
+    EXPECT_THROW(lanczos(a, 0), std::runtime_error);
+}
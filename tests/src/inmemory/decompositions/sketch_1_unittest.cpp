@@ -0,0 +1,78 @@
+#include "Sketch.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+double rowNorm(const Matrix<double> &a, int i) {
+    double s = 0;
+    for (int j = 0; j < a.getM(); j++)
+        s += a.get(i, j) * a.get(i, j);
+    return std::sqrt(s);
+}
+
+} // namespace
+
+TEST(Sketch, TestWalshHadamard) {
+    std::vector<double> x = {1, 0, 0, 0, 0, 0, 0, 0};
+    linopt::inmemory::detail::walshHadamard(x.data(), 8);
+    for (double v : x)
+        EXPECT_EQ(v, 1.0);
+    std::vector<double> y = {1, 2, 3, 4};
+    linopt::inmemory::detail::walshHadamard(y.data(), 4);
+    EXPECT_EQ(y, (std::vector<double>{10, -2, -4, 0}));
+}
+
+TEST(Sketch, TestMatchesDenseOperator) {
+    Matrix<double> a = smooth(20, 100);
+    for (SketchKind kind : {SketchKind::gaussian, SketchKind::sparseSign, SketchKind::srht}) {
+        Sketch<double> s(kind, 100, 24, 7);
+        Matrix<double> omega = s.toMatrix();
+        ASSERT_EQ(omega.getN(), 100);
+        ASSERT_EQ(omega.getM(), 24);
+        Matrix<double> expected = a * omega, right = s.applyRight(a);
+        Matrix<double> left = s.applyLeft(a.transpose());
+        for (int i = 0; i < 20; i++)
+            for (int j = 0; j < 24; j++) {
+                ASSERT_NEAR(right.get(i, j), expected.get(i, j), 1e-10);
+                ASSERT_NEAR(left.get(j, i), expected.get(i, j), 1e-10);
+            }
+    }
+}
+
+TEST(Sketch, TestParallelApplyLeft) {
+    linopt::parallel::ScopedPolicy policy(
+        {linopt::parallel::Execution::parallel, 1});
+    Matrix<double> a = smooth(70, 45);
+    for (SketchKind kind : {SketchKind::gaussian, SketchKind::sparseSign, SketchKind::srht}) {
+        Sketch<double> s(kind, 70, 16, 11);
+        expectNear(s.applyLeft(a), s.toMatrix().transpose() * a, 1e-10);
+    }
+}
+
+TEST(Sketch, TestPreservesNorms) {
+    // averaged over many rows, ||x*Omega|| ~ ||x||
+    Matrix<double> a = smooth(200, 300);
+    for (SketchKind kind : {SketchKind::gaussian, SketchKind::sparseSign, SketchKind::srht}) {
+        Matrix<double> y = Sketch<double>(kind, 300, 150, 3).applyRight(a);
+        double ratio = 0;
+        for (int i = 0; i < 200; i++)
+            ratio += rowNorm(y, i) / rowNorm(a, i);
+        EXPECT_NEAR(ratio / 200, 1.0, 0.1);
+    }
+}
+
+TEST(Sketch, TestSeed) {
+    Sketch<double> a(SketchKind::sparseSign, 50, 10, 1), b(SketchKind::sparseSign, 50, 10, 1);
+    Sketch<double> c(SketchKind::sparseSign, 50, 10, 2);
+    EXPECT_TRUE(a.toMatrix() == b.toMatrix());
+    EXPECT_FALSE(a.toMatrix() == c.toMatrix());
+    EXPECT_THROW(Sketch<double>(SketchKind::gaussian, 0, 10), std::runtime_error);
+    EXPECT_THROW(Sketch<double>(SketchKind::srht, 5, 10), std::runtime_error);
+}
@@ -0,0 +1,93 @@
+#include "Svd.h"
+#include "DiskMatrix.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// u*diag(s)*v^T with orthonormal u, v and the given spectrum
+Matrix<double> withSpectrum(int n, int m, const std::vector<double> &s) {
+    const int k = static_cast<int>(s.size());
+    Matrix<double> u = QrFactorization<double>(smooth(n, k, 0.1)).thinQ();
+    Matrix<double> v = QrFactorization<double>(smooth(m, k, 0.9)).thinQ();
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < k; j++)
+            u.get(i, j) *= s[j];
+    return u * v.transpose();
+}
+
+Matrix<double> reconstruct(const Svd<double> &d) {
+    Matrix<double> us(d.u);
+    for (int i = 0; i < us.getN(); i++)
+        for (int j = 0; j < us.getM(); j++)
+            us.get(i, j) *= d.s[j];
+    return us * d.v.transpose();
+}
+
+} // namespace
+
+TEST(Svd, TestThin) {
+    for (auto [n, m] : {std::pair{60, 35}, std::pair{25, 70}}) {
+        Matrix<double> a = smooth(n, m, 0.0);
+        Svd<double> d = svd(a);
+        const int k = std::min(n, m);
+        ASSERT_EQ(d.u.getM(), k);
+        ASSERT_EQ(d.v.getM(), k);
+        for (int i = 1; i < k; i++)
+            EXPECT_GE(d.s[i - 1], d.s[i]);
+        EXPECT_LT(maxDifference(reconstruct(d), a), 1e-10);
+        EXPECT_LT(maxDifference(d.u.transpose() * d.u, identity(k)), 1e-10);
+        EXPECT_LT(maxDifference(d.v.transpose() * d.v, identity(k)), 1e-10);
+    }
+}
+
+TEST(Svd, TestRandomizedRecoversSpectrum) {
+    std::vector<double> spectrum;
+    for (int i = 0; i < 40; i++)
+        spectrum.push_back(std::pow(0.7, i));
+    Matrix<double> a = withSpectrum(400, 150, spectrum);
+    for (SketchKind kind : {SketchKind::gaussian, SketchKind::sparseSign, SketchKind::srht}) {
+        RandomizedSvdOptions options;
+        options.sketch = kind;
+        options.blockRows = 64;
+        Svd<double> d = randomizedSvd(a, 10, options);
+        ASSERT_EQ(d.u.getN(), 400);
+        ASSERT_EQ(d.u.getM(), 10);
+        ASSERT_EQ(d.v.getN(), 150);
+        for (int i = 0; i < 10; i++)
+            EXPECT_NEAR(d.s[i], spectrum[i], 1e-6 * spectrum[0]);
+        // the rank 10 error is about the 11th singular value
+        EXPECT_LT(maxDifference(reconstruct(d), a), 2 * spectrum[10]);
+    }
+}
+
+TEST(Svd, TestRandomizedExactRank) {
+    Matrix<double> a = withSpectrum(120, 90, {5, 3, 2, 1});
+    Svd<double> d = randomizedSvd(a, 4);
+    EXPECT_LT(maxDifference(reconstruct(d), a), 1e-10);
+    EXPECT_THROW(randomizedSvd(a, 0), std::runtime_error);
+    EXPECT_THROW(randomizedSvd(a, 91), std::runtime_error);
+}
+
+TEST(Svd, TestDiskSource) {
+    const std::string path = "svd_source.lmf";
+    Matrix<double> a = withSpectrum(300, 80, {9, 4, 2, 1, 0.5, 0.25});
+    RandomizedSvdOptions options;
+    options.blockRows = 37;
+    {
+        linopt::disk::DiskMatrix<double> d = linopt::disk::DiskMatrix<double>::create(path, a);
+        Svd<double> fromDisk = randomizedSvd(d, 6, options);
+        Svd<double> fromMemory = randomizedSvd(a, 6, options);
+        for (int i = 0; i < 6; i++)
+            EXPECT_NEAR(fromDisk.s[i], fromMemory.s[i], 1e-10);
+        EXPECT_LT(maxDifference(reconstruct(fromDisk), a), 1e-10);
+    }
+    std::filesystem::remove(path);
+}
@@ -1,9 +1,13 @@
 #include "Matrix.h"
+#include "TestMatrices.h"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <fstream>
+#include <cstdint>
+#include <tuple>
 
 using namespace linopt::inmemory;
+using namespace linopt::test;
 
 TEST(Matrix, TestConstructor) {
     ASSERT_NO_THROW(Matrix<int> fr(1080, 1920););
@@ -168,3 +172,171 @@ TEST(Matrix, TestStreams) {
 
 
 
+
+TEST(Matrix, TestContiguousStorage) {
+    Matrix<double> m(7, 5, 1.5);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(m.data()) % 64, 0u);
+    ASSERT_GE(m.stride(), m.getM());
+    ASSERT_EQ(m.stride() * sizeof(double) % 64, 0u);
+    m.data()[3 * m.stride() + 4] = 2.5;
+    ASSERT_EQ(m.get(3, 4), 2.5);
+    Matrix<double> copy(m);
+    ASSERT_EQ(copy, m);
+    ASSERT_NE(copy.data(), m.data());
+    Matrix<char> odd(3, 3, 'x');
+    ASSERT_EQ(odd.stride() % 64, 0);
+    ASSERT_EQ(odd.get(2, 2), 'x');
+}
+
+template <typename E> Matrix<E> naiveProduct(const Matrix<E> &a, const Matrix<E> &b) {
+    Matrix<E> r(a.getN(), b.getM());
+    for (int i = 0; i < a.getN(); i++)
+        for (int j = 0; j < b.getM(); j++)
+            for (int k = 0; k < a.getM(); k++)
+                r.get(i, j) += a.get(i, k) * b.get(k, j);
+    return r;
+}
+
+template <typename E> void checkGemm() {
+    using linopt::inmemory::kernels::Isa;
+    const Isa detected = linopt::inmemory::kernels::detectedIsa();
+    for (Isa isa : {Isa::scalar, Isa::avx2, Isa::avx512}) {
+        linopt::inmemory::kernels::setActiveIsa(isa);
+        for (auto [n, k, m] : {std::tuple{1, 1, 1}, {3, 5, 7}, {67, 300, 45},
+                               {130, 257, 129}}) {
+            Matrix<E> a = patterned<E>(n, k, 1), b = patterned<E>(k, m, 2);
+            ASSERT_EQ(a * b, naiveProduct(a, b));
+        }
+    }
+    linopt::inmemory::kernels::setActiveIsa(detected);
+}
+
+TEST(Matrix, TestGemmKernels) {
+    checkGemm<float>();
+    checkGemm<double>();
+    checkGemm<int>();
+    checkGemm<long long>();
+    checkGemm<short>();
+}
+
+TEST(Matrix, TestInplaceMatrixMultiplication) {
+    Matrix<double> a = patterned<double>(200, 40, 3);
+    Matrix<double> wide = patterned<double>(40, 90, 4);
+    Matrix<double> narrow = patterned<double>(90, 3, 5);
+    Matrix<double> expected = naiveProduct(naiveProduct(a, wide), narrow);
+    a *= wide;
+    ASSERT_EQ(a.getM(), 90);
+    a *= narrow;
+    ASSERT_EQ(a, expected);
+    // the row padding of the product is still zero
+    for (int i = 0; i < a.getN(); i++)
+        for (int j = a.getM(); j < a.stride(); j++)
+            ASSERT_EQ(a.data()[i * a.stride() + j], 0.0);
+    Matrix<int> s = patterned<int>(20, 20, 6);
+    Matrix<int> squared = naiveProduct(s, s);
+    ASSERT_EQ(s *= s, squared);
+}
+
+TEST(Matrix, TestParallelExecution) {
+    Matrix<double> a = patterned<double>(301, 257, 7);
+    Matrix<double> b = patterned<double>(257, 199, 8);
+    Matrix<double> product = naiveProduct(a, b);
+    Matrix<double> sum = a + a, scaled = a * 3.0, t = a.transpose();
+    linopt::parallel::ScopedPolicy scope({linopt::parallel::Execution::parallel, 1});
+    ASSERT_EQ(a * b, product);
+    ASSERT_EQ(a + a, sum);
+    ASSERT_EQ(a * 3.0, scaled);
+    ASSERT_EQ(a.transpose(), t);
+    Matrix<double> c(a);
+    c *= b;
+    ASSERT_EQ(c, product);
+    ASSERT_EQ(Matrix<double>(500, 300).fill(2.0), Matrix<double>(500, 300, 2.0));
+}
+
+TEST(Matrix, TestExpressionFusion) {
+    Matrix<double> a = patterned<double>(40, 30, 1);
+    Matrix<double> b = patterned<double>(40, 30, 2);
+    Matrix<double> c = patterned<double>(40, 30, 3);
+    Matrix<double> r = a + b - c * 2.0;
+    for (int i = 0; i < 40; i++)
+        for (int j = 0; j < 30; j++)
+            ASSERT_EQ(r.get(i, j), a.get(i, j) + b.get(i, j) - 2.0 * c.get(i, j));
+    // same dimensions: evaluated straight into the existing buffer
+    const double *before = r.data();
+    r = a * 3.0 + b;
+    ASSERT_EQ(r.data(), before);
+    ASSERT_EQ(r.get(5, 7), 3.0 * a.get(5, 7) + b.get(5, 7));
+    ASSERT_EQ((a + b).get(1, 2), a.get(1, 2) + b.get(1, 2));
+    ASSERT_THROW((a + b).get(40, 0), std::runtime_error);
+    ASSERT_THROW(a + Matrix<double>(30, 40), std::runtime_error);
+    Matrix<double> product = (a + b) * c.transposed();
+    ASSERT_EQ(product, naiveProduct(Matrix<double>(a + b), c.transpose()));
+}
+
+TEST(Matrix, TestCompoundAssignment) {
+    Matrix<int> a = patterned<int>(25, 25, 1);
+    Matrix<int> b = patterned<int>(25, 25, 2);
+    Matrix<int> expected = a + b * 2;
+    const int *before = a.data();
+    a += b * 2;
+    ASSERT_EQ(a, expected);
+    a -= b * 2;
+    ASSERT_EQ(a, patterned<int>(25, 25, 1));
+    ASSERT_EQ(a.data(), before);
+    // transposed reads of the destination are evaluated through a temporary
+    Matrix<int> symmetric = a + a.transpose();
+    a += a.transposed();
+    ASSERT_EQ(a, symmetric);
+    a = a.transposed();
+    ASSERT_EQ(a, symmetric);
+    Matrix<int> wide(2, 3, 1);
+    wide = wide.transposed();
+    ASSERT_EQ(wide, Matrix<int>(3, 2, 1));
+}
+
+template <typename E> void checkTranspose(int n, int m) {
+    Matrix<E> a = patterned<E>(n, m, 9);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            a.get(i, j) = E(i * 1000 + j);
+    Matrix<E> t = a.transpose();
+    ASSERT_EQ(t.getN(), m);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            ASSERT_EQ(t.get(j, i), a.get(i, j));
+    Matrix<E> inplace(a);
+    inplace.inplaceTranspose();
+    ASSERT_EQ(inplace, t);
+    inplace.inplaceTranspose();
+    ASSERT_EQ(inplace, a);
+}
+
+TEST(Matrix, TestInplaceTransposeKeepsBuffer) {
+    // the padded transpose fits the capacity reserved at allocation
+    for (auto [n, m] : {std::pair{130, 257}, {257, 130}, {1000, 61}}) {
+        Matrix<double> a = patterned<double>(n, m, 2);
+        const Matrix<double> t = a.transpose();
+        const double *before = a.data();
+        a.inplaceTranspose();
+        ASSERT_EQ(a.data(), before);
+        ASSERT_EQ(a, t);
+        Matrix<double> copy(t);
+        before = copy.data();
+        copy.inplaceTranspose();
+        ASSERT_EQ(copy.data(), before);
+    }
+}
+
+TEST(Matrix, TestTransposeKernels) {
+    for (auto [n, m] : {std::pair{1, 1}, {1, 37}, {37, 1}, {8, 8}, {9, 17},
+                        {64, 64}, {100, 3}, {3, 100}, {130, 257}, {301, 301},
+                        {5, 16}, {16, 5}}) {
+        checkTranspose<float>(n, m);
+        checkTranspose<double>(n, m);
+        checkTranspose<long long>(n, m);
+        checkTranspose<short>(n, m);
+    }
+    linopt::inmemory::kernels::setActiveIsa(linopt::inmemory::kernels::Isa::scalar);
+    checkTranspose<int>(130, 77);
+    linopt::inmemory::kernels::setActiveIsa(linopt::inmemory::kernels::detectedIsa());
+}
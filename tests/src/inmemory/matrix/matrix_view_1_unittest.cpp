@@ -0,0 +1,150 @@
+#include "MatrixView.h"
+#include "Parallel.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+Matrix<int> numbered(int n, int m) {
+    Matrix<int> a(n, m);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            a.get(i, j) = 100 * i + j;
+    return a;
+}
+
+} // namespace
+
+TEST(MatrixView, TestSlices) {
+    Matrix<int> a = numbered(6, 5);
+    MatrixView<int> b = a.block(1, 2, 3, 2);
+    ASSERT_EQ(b, Matrix<int>({{102, 103},
+                              {202, 203},
+                              {302, 303}}));
+    ASSERT_EQ(a.rowRange(4, 6), Matrix<int>({{400, 401, 402, 403, 404},
+                                             {500, 501, 502, 503, 504}}));
+    ASSERT_EQ(a.columnRange(4, 5).transposedView(),
+              Matrix<int>({{4, 104, 204, 304, 404, 504}}));
+    MatrixView<int> s = MatrixView<int>(a).strided(2, 3);
+    ASSERT_EQ(s, Matrix<int>({{0, 3},
+                              {200, 203},
+                              {400, 403}}));
+    ASSERT_EQ(s.block(1, 1, 2, 1), Matrix<int>({{203}, {403}}));
+    ASSERT_EQ(b.get(2, 1), 303);
+    ASSERT_THROW(b.get(3, 0), std::runtime_error);
+    ASSERT_THROW(a.block(4, 0, 3, 1), std::runtime_error);
+    ASSERT_THROW(b.rowRange(2, 2), std::runtime_error);
+    ASSERT_THROW(b.strided(0, 1), std::runtime_error);
+}
+
+TEST(MatrixView, TestWritesThrough) {
+    Matrix<int> a = numbered(4, 4);
+    MatrixSpan<int> t = a.block(1, 1, 2, 3).transposedView();
+    t.get(2, 1) = -1;
+    ASSERT_EQ(a.get(2, 3), -1);
+    a.block(0, 0, 2, 2).fill(7);
+    ASSERT_EQ(a.get(1, 1), 7);
+    ASSERT_EQ(a.get(1, 2), 102);
+    a.columnRange(3, 4).fillRow(0, 9).fillColumn(0, 8);
+    ASSERT_EQ(a.get(0, 3), 8);
+    ASSERT_EQ(a.get(3, 3), 8);
+    MatrixSpan<int>(a).strided(2, 1).fillRow(1, 5);
+    ASSERT_EQ(a.get(2, 0), 5);
+    ASSERT_THROW(MatrixSpan<int>(a).fillColumn(4, 0), std::runtime_error);
+}
+
+TEST(MatrixView, TestRowColumnOperations) {
+    Matrix<int> a = numbered(4, 4);
+    Matrix<int> b = a;
+    a.block(1, 1, 3, 3).combineRows(0, 2, 1, -1, 2);
+    b.combineRows(1, 2, 2, -1, 3);
+    b.block(3, 0, 1, 1).fill(300);
+    ASSERT_EQ(a, b);
+    a.block(0, 0, 2, 4).transposedView().combineColumns(0, 1, 1, 1, 1);
+    for (int j = 0; j < 4; j++)
+        ASSERT_EQ(a.get(1, j), 2 * j + 100);
+    a.columnRange(2, 4).multiplyColumn(1, 2).multiplyRow(0, 3);
+    ASSERT_EQ(a.get(0, 3), 18);
+    ASSERT_EQ(a.get(0, 2), 6);
+    ASSERT_EQ(a.get(2, 3), 2 * 203);
+    ASSERT_THROW(a.rowRange(0, 2).multiplyRow(2, 1), std::runtime_error);
+    ASSERT_THROW(a.rowRange(0, 2).combineRows(0, 1, 2, 1, 0),
+                 std::runtime_error);
+}
+
+TEST(MatrixView, TestArithmetic) {
+    Matrix<int> a = numbered(5, 5);
+    const Matrix<int> expected =
+            a.block(0, 0, 2, 2) + a.block(3, 3, 2, 2) * 2;
+    ASSERT_EQ(expected, Matrix<int>({{606, 609},
+                                     {906, 909}}));
+    // overlapping views of the same matrix
+    a.block(1, 1, 3, 3) = a.block(0, 0, 3, 3);
+    ASSERT_EQ(a.block(1, 1, 3, 3), numbered(5, 5).block(0, 0, 3, 3));
+    a = numbered(5, 5);
+    a.block(0, 0, 2, 3) += a.block(1, 0, 2, 3);
+    ASSERT_EQ(a.get(0, 1), 102);
+    ASSERT_EQ(a.get(1, 2), 304);
+    a.block(2, 0, 1, 5) -= a.rowRange(2, 3);
+    ASSERT_EQ(a.rowRange(2, 3), Matrix<int>(1, 5));
+    a.columnRange(0, 1) *= 3;
+    ASSERT_EQ(a.get(4, 0), 1200);
+    a += a.block(0, 0, 5, 5).transposedView();
+    ASSERT_EQ(a.get(0, 4), 4 + 1200);
+    ASSERT_THROW(a.block(0, 0, 2, 2) = a.block(0, 0, 3, 3),
+                 std::runtime_error);
+    // span to span assignment copies entries, it does not rebind
+    Matrix<int> c(2, 2);
+    MatrixSpan<int> d(c);
+    d = a.block(0, 0, 2, 2);
+    ASSERT_EQ(c, a.block(0, 0, 2, 2));
+}
+
+TEST(MatrixView, TestExternalBuffer) {
+    std::vector<double> buffer(12);
+    for (int k = 0; k < 12; k++)
+        buffer[k] = k;
+    // 3x4 row-major and, through the column stride, its transpose
+    MatrixSpan<double> a(buffer.data(), 3, 4, 4);
+    MatrixView<double> t(buffer.data(), 4, 3, 1, 4);
+    ASSERT_EQ(t, a.transposedView());
+    Matrix<double> b = a * t;
+    ASSERT_EQ(b.get(0, 0), 0 + 1 + 4 + 9);
+    ASSERT_EQ(b.get(2, 1), 8 * 4 + 9 * 5 + 10 * 6 + 11 * 7);
+    a.block(0, 0, 2, 2).fill(1);
+    ASSERT_EQ(buffer[5], 1);
+    ASSERT_THROW(MatrixView<double>(buffer.data(), 0, 3, 3),
+                 std::runtime_error);
+    ASSERT_THROW(MatrixView<double>(buffer.data(), 3, 3, 0),
+                 std::runtime_error);
+}
+
+TEST(MatrixView, TestMultiplyIntoBlock) {
+    linopt::parallel::ScopedPolicy policy(linopt::parallel::seq);
+    Matrix<double> a(6, 6);
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 6; j++)
+            a.get(i, j) = (i * 7 + j * 3) % 5 - 2;
+    const Matrix<double> x = a.block(0, 0, 3, 4);
+    const Matrix<double> y = a.block(2, 2, 4, 2);
+    const Matrix<double> product = x * y;
+
+    Matrix<double> c(5, 5, 1.0);
+    multiply(a.block(0, 0, 3, 4), a.block(2, 2, 4, 2), c.block(1, 2, 3, 2));
+    ASSERT_EQ(c.block(1, 2, 3, 2), product);
+    multiply(x, y, c.block(1, 2, 3, 2), kernels::GemmUpdate::subtract);
+    Matrix<double> expected(5, 5, 1.0);
+    expected.block(1, 2, 3, 2).fill(0.0);
+    ASSERT_EQ(c, expected);
+    // strided destination and a destination overlapping an operand
+    const Matrix<double> before = c.block(0, 0, 2, 3).transposedView();
+    multiply(x, y, c.block(0, 0, 2, 3).transposedView(),
+             kernels::GemmUpdate::accumulate);
+    ASSERT_EQ(c.block(0, 0, 2, 3).transposedView(), product + before);
+    multiply(a.block(0, 0, 3, 4), a.block(2, 2, 4, 2), a.block(0, 4, 3, 2));
+    ASSERT_EQ(a.block(0, 4, 3, 2), product);
+    ASSERT_THROW(multiply(x, y, c.block(0, 0, 2, 2)), std::runtime_error);
+}
@@ -0,0 +1,160 @@
+#include "SMatrix.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+template <int N> SMatrix<double, N, N> randomSquare(unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    SMatrix<double, N, N> a;
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            a(i, j) = dist(gen) + (i == j ? N : 0.0);
+    return a;
+}
+
+template <int N> double maxDistance(const SMatrix<double, N, N> &a,
+                                    const SMatrix<double, N, N> &b) {
+    double d = 0;
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            d = std::max(d, std::abs(a(i, j) - b(i, j)));
+    return d;
+}
+
+template <int N> void checkInverse(unsigned seed) {
+    const SMatrix<double, N, N> a = randomSquare<N>(seed);
+    const SMatrix<double, N, N> inv = a.inverse();
+    ASSERT_LT(maxDistance<N>(a * inv, SMatrix<double, N, N>::identity()),
+              1e-12);
+    // against the LU of the dynamic matrix
+    const Matrix<double> d = a.toMatrix();
+    double det = 1;
+    Matrix<double> u = d;
+    for (int k = 0; k < N; k++) {
+        int p = k;
+        for (int i = k + 1; i < N; i++)
+            if (std::abs(u.get(i, k)) > std::abs(u.get(p, k)))
+                p = i;
+        if (p != k) {
+            for (int j = 0; j < N; j++)
+                std::swap(u.get(p, j), u.get(k, j));
+            det = -det;
+        }
+        det *= u.get(k, k);
+        for (int i = k + 1; i < N; i++) {
+            const double l = u.get(i, k) / u.get(k, k);
+            for (int j = k; j < N; j++)
+                u.get(i, j) -= l * u.get(k, j);
+        }
+    }
+    ASSERT_NEAR(a.determinant(), det, 1e-10 * std::abs(det));
+}
+
+} // namespace
+
+TEST(SMatrix, TestConstexpr) {
+    constexpr SMatrix<int, 2, 3> a{{1, 2, 3},
+                                   {4, 5, 6}};
+    constexpr SMatrix<int, 3, 2> b = a.transpose();
+    static_assert(b.get<2, 1>() == 6);
+    constexpr SMatrix<int, 2, 2> c = a * b;
+    static_assert(c == SMatrix<int, 2, 2>{{14, 32},
+                                          {32, 77}});
+    static_assert(c.determinant() == 14 * 77 - 32 * 32);
+    static_assert(c.trace() == 91);
+    static_assert((2 * c - c * 2) == SMatrix<int, 2, 2>());
+    constexpr SMatrix<double, 3, 3> r{{0, -1, 0},
+                                      {1, 0, 0},
+                                      {0, 0, 1}};
+    static_assert(r.inverse() == r.transpose());
+    static_assert(SMatrix<double, 3, 3>::identity().determinant() == 1);
+    static_assert(sizeof(SMatrix<float, 4, 4>) == 16 * sizeof(float));
+    static_assert(alignof(SMatrix<double, 4, 4>) == 64);
+}
+
+TEST(SMatrix, TestArithmetic) {
+    SMatrix<long long, 2, 2> a{{1, 2},
+                               {3, 4}};
+    SMatrix<long long, 2, 2> b = a;
+    b += a;
+    ASSERT_EQ(b, a * 2LL);
+    b -= a;
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(-a + a, (SMatrix<long long, 2, 2>()));
+    b *= SMatrix<long long, 2, 2>::identity();
+    ASSERT_EQ(b, a);
+    b *= a;
+    ASSERT_EQ(b, (SMatrix<long long, 2, 2>{{7, 10},
+                                           {15, 22}}));
+    b(0, 1) = 5;
+    ASSERT_EQ((b.get<0, 1>()), 5);
+}
+
+TEST(SMatrix, TestMultiplicationMatchesMatrix) {
+    const SMatrix<double, 6, 6> a = randomSquare<6>(1);
+    const SMatrix<double, 6, 3> b = SMatrix<double, 6, 3>::block(
+            randomSquare<6>(2).toMatrix(), 0, 2);
+    const Matrix<double> expected = a.toMatrix() * b.toMatrix();
+    const SMatrix<double, 6, 3> c = a * b;
+    for (int i = 0; i < 6; i++)
+        for (int j = 0; j < 3; j++)
+            ASSERT_NEAR(c(i, j), expected.get(i, j), 1e-12);
+}
+
+TEST(SMatrix, TestDeterminant) {
+    SMatrix<int, 4, 4> a{{2, 0, 1, 3},
+                         {1, 1, 0, 2},
+                         {0, 3, 1, 1},
+                         {1, 0, 2, 1}};
+    ASSERT_EQ(a.determinant(), -1);
+    SMatrix<double, 5, 5> singular;
+    singular(0, 0) = 1;
+    ASSERT_EQ(singular.determinant(), 0.0);
+}
+
+TEST(SMatrix, TestInverse) {
+    checkInverse<1>(3);
+    checkInverse<2>(4);
+    checkInverse<3>(5);
+    checkInverse<4>(6);
+    checkInverse<6>(7);
+    checkInverse<9>(8);
+    ASSERT_THROW((SMatrix<double, 3, 3>().inverse()), std::runtime_error);
+    ASSERT_THROW((SMatrix<double, 4, 4>{{1, 2, 3, 4},
+                                        {2, 4, 6, 8},
+                                        {0, 1, 0, 1},
+                                        {1, 0, 1, 0}}.inverse()),
+                 std::runtime_error);
+    ASSERT_THROW((SMatrix<double, 5, 5>().inverse()), std::runtime_error);
+}
+
+TEST(SMatrix, TestMatrixInterop) {
+    Matrix<double> m(5, 7);
+    for (int i = 0; i < 5; i++)
+        for (int j = 0; j < 7; j++)
+            m.get(i, j) = 10 * i + j;
+    const SMatrix<double, 2, 3> b = SMatrix<double, 2, 3>::block(m, 3, 4);
+    ASSERT_EQ(b, (SMatrix<double, 2, 3>{{34, 35, 36},
+                                        {44, 45, 46}}));
+    ASSERT_THROW((SMatrix<double, 2, 3>::block(m, 4, 4)), std::runtime_error);
+    ASSERT_THROW((SMatrix<double, 2, 3>(m)), std::runtime_error);
+    ASSERT_EQ((SMatrix<double, 5, 7>(m)).toMatrix(), m);
+
+    (b * 2.0).store(m, 0, 0);
+    ASSERT_EQ(m.get(1, 2), 92);
+    ASSERT_EQ(m.get(2, 0), 20);
+    ASSERT_THROW(b.store(m, 0, 5), std::runtime_error);
+
+    std::stringstream ss;
+    ss << b;
+    Matrix<double> read(1, 1);
+    ss >> read;
+    ASSERT_EQ(read, b.toMatrix());
+}
@@ -0,0 +1,73 @@
+#include "Cholesky.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+Matrix<double> positiveDefinite(int n) {
+    Matrix<double> g(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            g.get(i, j) = std::sin(i * 1.3 + j * 0.7);
+    Matrix<double> a = g * g.transpose();
+    for (int i = 0; i < n; i++)
+        a.get(i, i) += n;
+    return a;
+}
+
+} // namespace
+
+TEST(Cholesky, TestFactors) {
+    const int n = 170;
+    Matrix<double> a = positiveDefinite(n);
+    CholeskyFactorization<double> c(a, 16);
+    const Matrix<double> &l = c.lower();
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            ASSERT_EQ(l.get(i, j), 0.0);
+    expectNear(l * l.transpose(), a, 1e-9);
+}
+
+TEST(Cholesky, TestReadsLowerTriangleOnly) {
+    const int n = 40;
+    Matrix<double> a = positiveDefinite(n);
+    Matrix<double> lowerOnly(a);
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            lowerOnly.get(i, j) = 1e6;
+    CholeskyFactorization<double> c(std::move(lowerOnly), 8);
+    expectNear(c.lower() * c.lower().transpose(), a, 1e-9);
+}
+
+TEST(Cholesky, TestSolve) {
+    const int n = 150, r = 70;
+    Matrix<double> a = positiveDefinite(n), b(n, r);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < r; j++)
+            b.get(i, j) = std::cos(i * 0.2 + j);
+    CholeskyFactorization<double> c(a, 32);
+    expectNear(a * c.solve(b), b, 1e-9);
+    Matrix<double> x(b);
+    c.solveInPlace(x);
+    expectNear(a * x, b, 1e-9);
+}
+
+TEST(Cholesky, TestDeterminant) {
+    Matrix<double> a = {{4, 2}, {2, 3}};
+    EXPECT_NEAR(CholeskyFactorization<double>(a).determinant(), 8.0, 1e-12);
+}
+
+TEST(Cholesky, TestThrows) {
+    Matrix<double> indefinite = {{1, 2}, {2, 1}};
+    EXPECT_THROW(CholeskyFactorization<double>{indefinite}, std::runtime_error);
+    Matrix<double> rectangular(2, 3);
+    EXPECT_THROW(CholeskyFactorization<double>{rectangular}, std::runtime_error);
+    CholeskyFactorization<double> c(positiveDefinite(5));
+    Matrix<double> b(4, 1);
+    EXPECT_THROW(c.solve(b), std::runtime_error);
+}
@@ -0,0 +1,160 @@
+#include "Iterative.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+
+namespace {
+
+// 5 point laplacian of a side x side grid
+SparseMatrix<double> laplacian(int side, Layout layout) {
+    std::vector<Triplet<double>> t;
+    for (int r = 0; r < side; r++)
+        for (int c = 0; c < side; c++) {
+            int i = r * side + c;
+            t.push_back({i, i, 4.0});
+            if (r > 0) t.push_back({i, i - side, -1.0});
+            if (r + 1 < side) t.push_back({i, i + side, -1.0});
+            if (c > 0) t.push_back({i, i - 1, -1.0});
+            if (c + 1 < side) t.push_back({i, i + 1, -1.0});
+        }
+    return SparseMatrix<double>::fromTriplets(side * side, side * side, t, layout);
+}
+
+Matrix<double> diagonallyDominant(int n) {
+    Matrix<double> a(n, n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            a.get(i, j) = std::sin(i + 2.0 * j) / n;
+        a.get(i, i) = 2.0;
+    }
+    return a;
+}
+
+std::vector<double> rightHandSide(int n) {
+    std::vector<double> b(n);
+    for (int i = 0; i < n; i++)
+        b[i] = std::cos(0.3 * i);
+    return b;
+}
+
+template <typename A>
+double residual(const A &a, const std::vector<double> &b, const std::vector<double> &x) {
+    std::vector<double> r(b.size());
+    linopt::inmemory::detail::multiply(a, x, r);
+    double s = 0;
+    for (std::size_t i = 0; i < b.size(); i++)
+        s += (b[i] - r[i]) * (b[i] - r[i]);
+    return std::sqrt(s);
+}
+
+} // namespace
+
+TEST(Iterative, TestRedBlackColoring) {
+    auto classes = linopt::inmemory::detail::colorClasses(laplacian(10, Layout::csr));
+    ASSERT_EQ(classes.size(), 2u);
+    EXPECT_EQ(classes[0].size(), 50u);
+}
+
+TEST(Iterative, TestDense) {
+    const int n = 120;
+    Matrix<double> a = diagonallyDominant(n);
+    std::vector<double> b = rightHandSide(n);
+    IterativeOptions options;
+    options.relaxation = 1.1;
+    typedef IterativeStats (*Solver)(const Matrix<double> &, const std::vector<double> &,
+                                     std::vector<double> &, const IterativeOptions &);
+    Solver solvers[] = {jacobi<double>, gaussSeidel<double>, sor<double>,
+                        conjugateGradient<double>};
+    for (Solver solver : solvers) {
+        if (solver == solvers[3])
+            a = a + a.transpose();
+        std::vector<double> x;
+        IterativeStats stats = solver(a, b, x, options);
+        EXPECT_TRUE(stats.converged);
+        EXPECT_GT(stats.iterations, 0);
+        EXPECT_LE(stats.relativeResidual, 1e-10);
+        EXPECT_NEAR(residual(a, b, x), stats.residualNorm, 1e-12);
+        EXPECT_GE(stats.seconds, 0.0);
+    }
+}
+
+TEST(Iterative, TestSparse) {
+    const int side = 24, n = side * side;
+    std::vector<double> b = rightHandSide(n);
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        SparseMatrix<double> a = laplacian(side, layout);
+        IterativeOptions options;
+        options.maxIterations = 5000;
+        options.relaxation = 1.8;
+        std::vector<double> xj, xg, xs, xc;
+        IterativeStats j = jacobi(a, b, xj, options);
+        IterativeStats g = gaussSeidel(a, b, xg, options);
+        IterativeStats s = sor(a, b, xs, options);
+        IterativeStats c = conjugateGradient(a, b, xc, options);
+        EXPECT_TRUE(j.converged && g.converged && s.converged && c.converged);
+        // the usual ordering of their rates on a poisson problem
+        EXPECT_LT(g.iterations, j.iterations);
+        EXPECT_LT(s.iterations, g.iterations);
+        EXPECT_LT(c.iterations, s.iterations);
+        EXPECT_LE(residual(a, b, xs), 1e-10 * std::sqrt(n));
+    }
+}
+
+TEST(Iterative, TestPreconditioners) {
+    const int side = 20, n = side * side;
+    SparseMatrix<double> a = laplacian(side, Layout::csr);
+    std::vector<double> b = rightHandSide(n);
+    IterativeOptions options;
+    options.preconditioner = Preconditioner::none;
+    std::vector<double> x;
+    EXPECT_TRUE(conjugateGradient(a, b, x, options).converged);
+    std::vector<double> y;
+    IterativeStats custom = conjugateGradient<SparseMatrix<double>, double>(
+        a, b, y, options,
+        [](const std::vector<double> &r, std::vector<double> &z) {
+            for (std::size_t i = 0; i < r.size(); i++)
+                z[i] = r[i] / 4.0;
+        });
+    EXPECT_TRUE(custom.converged);
+    for (int i = 0; i < n; i++)
+        ASSERT_NEAR(x[i], y[i], 1e-8);
+}
+
+TEST(Iterative, TestIterationCap) {
+    SparseMatrix<double> a = laplacian(30, Layout::csr);
+    std::vector<double> b = rightHandSide(900), x;
+    IterativeOptions options;
+    options.maxIterations = 3;
+    IterativeStats stats = jacobi(a, b, x, options);
+    EXPECT_FALSE(stats.converged);
+    EXPECT_EQ(stats.iterations, 3);
+    EXPECT_GT(stats.relativeResidual, 1e-3);
+    // the residual reported after the last sweep is that of x
+    std::vector<double> y;
+    IterativeStats sweeps = gaussSeidel(a, b, y, options);
+    EXPECT_FALSE(sweeps.converged);
+    EXPECT_EQ(sweeps.iterations, 3);
+    EXPECT_NEAR(sweeps.relativeResidual,
+                residual(a, b, y) / residual(a, b, std::vector<double>(900)), 1e-12);
+}
+
+TEST(Iterative, TestThrows) {
+    Matrix<double> a = {{0, 1}, {1, 0}};
+    std::vector<double> b = {1, 1}, x;
+    EXPECT_THROW(jacobi(a, b, x), std::runtime_error);
+    Matrix<double> rectangular(2, 3);
+    EXPECT_THROW(gaussSeidel(rectangular, b, x), std::runtime_error);
+    Matrix<double> ok = {{2, 0}, {0, 2}};
+    std::vector<double> wrong = {1, 2, 3};
+    EXPECT_THROW(conjugateGradient(ok, b, wrong), std::runtime_error);
+    IterativeOptions options;
+    options.relaxation = 2.5;
+    EXPECT_THROW(sor(ok, b, x, options), std::runtime_error);
+    Matrix<double> indefinite = {{1, 0}, {0, -1}};
+    options.preconditioner = Preconditioner::none;
+    std::vector<double> y;
+    EXPECT_THROW(conjugateGradient(indefinite, {0.0, 1.0}, y, options), std::runtime_error);
+}
@@ -0,0 +1,85 @@
+#include "Lu.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+TEST(Lu, TestFactors) {
+    const int n = 150;
+    Matrix<double> a = wellConditioned(n, 0.5);
+    LuFactorization<double> lu(a, 16);
+    Matrix<double> l(n, n), u(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            if (j < i)
+                l.get(i, j) = lu.factors().get(i, j);
+            else
+                u.get(i, j) = lu.factors().get(i, j);
+        }
+    for (int i = 0; i < n; i++)
+        l.get(i, i) = 1.0;
+    Matrix<double> pa(a);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            std::swap(pa.get(i, j), pa.get(lu.pivots()[i], j));
+    expectNear(l * u, pa, 1e-10);
+}
+
+TEST(Lu, TestSolveManyRightHandSides) {
+    const int n = 130, r = 300;
+    Matrix<double> a = wellConditioned(n, 1.0), b(n, r);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < r; j++)
+            b.get(i, j) = std::cos(i * 0.1 + j);
+    LuFactorization<double> lu(a);
+    expectNear(a * lu.solve(b), b, 1e-10);
+    Matrix<double> x(b);
+    lu.solveInPlace(x);
+    expectNear(a * x, b, 1e-10);
+    EXPECT_THROW(lu.solve(Matrix<double>(n + 1, 1)), std::runtime_error);
+}
+
+TEST(Lu, TestDeterminantAndInverse) {
+    ASSERT_NEAR(LuFactorization<double>(Matrix<double>{{2, 1}, {1, 3}}).determinant(), 5.0, 1e-14);
+    ASSERT_NEAR(LuFactorization<double>(Matrix<double>{{0, 1}, {1, 0}}).determinant(), -1.0, 1e-14);
+    ASSERT_NEAR(LuFactorization<double>(Matrix<double>{{1, 2, 3}, {4, 5, 6}, {7, 8, 10}}).determinant(),
+                -3.0, 1e-12);
+    const int n = 70;
+    Matrix<double> a = wellConditioned(n, 2.0), identity(n, n);
+    for (int i = 0; i < n; i++)
+        identity.get(i, i) = 1.0;
+    expectNear(a * LuFactorization<double>(a, 8).inverse(), identity, 1e-10);
+}
+
+TEST(Lu, TestSingularMatrix) {
+    LuFactorization<double> lu(Matrix<double>{{1, 2, 3}, {2, 4, 6}, {1, 0, 1}});
+    ASSERT_TRUE(lu.isSingular());
+    ASSERT_EQ(lu.determinant(), 0.0);
+    EXPECT_THROW(lu.solve(Matrix<double>(3, 1, 1.0)), std::runtime_error);
+    EXPECT_THROW(lu.inverse(), std::runtime_error);
+    EXPECT_THROW(LuFactorization<double>(Matrix<double>(2, 3)), std::runtime_error);
+}
+
+TEST(Lu, TestRankOneUpdate) {
+    const int n = 90;
+    Matrix<double> a = wellConditioned(n, 3.0), u(n, 1), v(n, 1), b(n, 2);
+    for (int i = 0; i < n; i++) {
+        u.get(i, 0) = 0.1 * std::cos(i);
+        v.get(i, 0) = 0.1 * std::sin(2.0 * i);
+        b.get(i, 0) = i % 7;
+        b.get(i, 1) = 1.0;
+    }
+    LuFactorization<double> lu(a);
+    lu.rankOneUpdate(u, v);
+    Matrix<double> updated(a);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            updated.get(i, j) += u.get(i, 0) * v.get(j, 0);
+    expectNear(updated * lu.solve(b), b, 1e-9);
+    ASSERT_NEAR(lu.determinant() / LuFactorization<double>(updated).determinant(), 1.0, 1e-9);
+    EXPECT_THROW(lu.rankOneUpdate(u, Matrix<double>(n, 2)), std::runtime_error);
+}
@@ -0,0 +1,102 @@
+#include "Qr.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+Matrix<double> tall(int m, int n, double shift) {
+    Matrix<double> a(m, n);
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            a.get(i, j) = std::sin(i * 0.9 + j * 1.9 + shift) + (i == j ? 2.0 : 0.0);
+    return a;
+}
+
+} // namespace
+
+TEST(Qr, TestFactors) {
+    const int m = 190, n = 110;
+    Matrix<double> a = tall(m, n, 0.3);
+    QrFactorization<double> qr(a, 16);
+    Matrix<double> q = qr.thinQ(), r = qr.r();
+    ASSERT_EQ(q.getM(), n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < i; j++)
+            ASSERT_EQ(r.get(i, j), 0.0);
+    expectNear(q * r, a, 1e-10);
+    expectNear(q.transpose() * q, identity(n), 1e-12);
+}
+
+TEST(Qr, TestWide) {
+    const int m = 30, n = 70;
+    Matrix<double> a = tall(m, n, 1.1);
+    QrFactorization<double> qr(a, 8);
+    expectNear(qr.thinQ() * qr.r(), a, 1e-10);
+}
+
+TEST(Qr, TestApplyQ) {
+    const int m = 80, n = 50;
+    QrFactorization<double> qr(tall(m, n, 0.0), 12);
+    Matrix<double> b = tall(m, 7, 2.0), c(b);
+    qr.applyQt(c);
+    qr.applyQ(c);
+    expectNear(c, b, 1e-12);
+}
+
+TEST(Qr, TestLeastSquares) {
+    const int m = 300, n = 60;
+    Matrix<double> a = tall(m, n, 0.7), b = tall(m, 3, 4.0);
+    Matrix<double> x = QrFactorization<double>(a).leastSquares(b);
+    // the residual is orthogonal to the columns of a
+    Matrix<double> residual = a * x - b;
+    Matrix<double> normal = a.transpose() * residual;
+    expectNear(normal, Matrix<double>(n, 3), 1e-9);
+}
+
+TEST(Qr, TestStreamingLeastSquares) {
+    const int m = 500, n = 40;
+    Matrix<double> a = tall(m, n, 0.2), b = tall(m, 2, 3.0);
+    StreamingLeastSquares<double> stream(n, 2, 8);
+    // blocks shorter and taller than n
+    const int heights[] = {7, 33, 100, 60, 300};
+    int r0 = 0;
+    for (int h : heights) {
+        Matrix<double> ab(h, n), bb(h, 2);
+        for (int i = 0; i < h; i++) {
+            for (int j = 0; j < n; j++)
+                ab.get(i, j) = a.get(r0 + i, j);
+            for (int j = 0; j < 2; j++)
+                bb.get(i, j) = b.get(r0 + i, j);
+        }
+        stream.push(ab, bb);
+        r0 += h;
+    }
+    ASSERT_EQ(stream.rows(), m);
+    Matrix<double> expected = QrFactorization<double>(a).leastSquares(b);
+    Matrix<double> x = stream.solve();
+    expectNear(x, expected, 1e-9);
+    Matrix<double> residual = a * x - b;
+    for (int j = 0; j < 2; j++) {
+        double s = 0;
+        for (int i = 0; i < m; i++)
+            s += residual.get(i, j) * residual.get(i, j);
+        EXPECT_NEAR(stream.residualNorm(j), std::sqrt(s), 1e-9);
+    }
+}
+
+TEST(Qr, TestThrows) {
+    Matrix<double> a = tall(3, 5, 0.0), b(3, 1);
+    EXPECT_THROW(QrFactorization<double>(a).leastSquares(b), std::runtime_error);
+    Matrix<double> deficient = {{1, 2}, {2, 4}, {3, 6}};
+    Matrix<double> c(3, 1);
+    EXPECT_THROW(QrFactorization<double>(deficient).leastSquares(c),
+                 std::runtime_error);
+    StreamingLeastSquares<double> stream(4);
+    stream.push(tall(2, 4, 0.0), Matrix<double>(2, 1));
+    EXPECT_THROW(stream.solve(), std::runtime_error);
+}
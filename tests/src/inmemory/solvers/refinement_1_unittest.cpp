@@ -0,0 +1,178 @@
+#include "Refinement.h"
+#include "Parallel.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// cond(a) is about 10^16 for n = 12: hopeless in float
+Matrix<double> hilbert(int n) {
+    Matrix<double> a(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            a.get(i, j) = 1.0 / (i + j + 1);
+    return a;
+}
+
+Matrix<double> rightHandSides(int n, int r) {
+    Matrix<double> b(n, r);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < r; j++)
+            b.get(i, j) = std::cos(i * 0.7 + j * 1.3);
+    return b;
+}
+
+double backwardError(const Matrix<double> &a, const Matrix<double> &b,
+                     const Matrix<double> &x) {
+    const Matrix<double> r = b - a * x;
+    double normA = 0, worst = 0;
+    for (int i = 0; i < a.getN(); i++) {
+        double s = 0;
+        for (int j = 0; j < a.getM(); j++)
+            s += std::abs(a.get(i, j));
+        normA = std::max(normA, s);
+    }
+    for (int j = 0; j < b.getM(); j++) {
+        double rj = 0, xj = 0, bj = 0;
+        for (int i = 0; i < b.getN(); i++) {
+            rj = std::max(rj, std::abs(r.get(i, j)));
+            xj = std::max(xj, std::abs(x.get(i, j)));
+            bj = std::max(bj, std::abs(b.get(i, j)));
+        }
+        worst = std::max(worst, rj / (normA * xj + bj));
+    }
+    return worst;
+}
+
+} // namespace
+
+TEST(Refinement, TestSinglePrecisionFactors) {
+    linopt::parallel::ScopedPolicy policy(linopt::parallel::par);
+    const int n = 300;
+    const Matrix<double> a = wellConditioned(n, 0.5, n);
+    const Matrix<double> b = rightHandSides(n, 3);
+    Matrix<double> x(n, 3);
+    const RefinementStats stats = refinedSolve(a, b, x);
+    ASSERT_TRUE(stats.converged);
+    ASSERT_FALSE(stats.fellBack);
+    ASSERT_GT(stats.iterations, 0);
+    ASSERT_LE(stats.backwardError,
+              std::sqrt(n) * std::numeric_limits<double>::epsilon());
+    const Matrix<double> reference = LuFactorization<double>(a).solve(b);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < 3; j++)
+            ASSERT_NEAR(x.get(i, j), reference.get(i, j), 1e-13);
+}
+
+TEST(Refinement, TestBfloat16Factors) {
+    const int n = 120;
+    // diagonally dominant: cond(a) is small enough for bfloat16 factors
+    const Matrix<double> a = wellConditioned(n, 1.5, n);
+    const Matrix<double> b = rightHandSides(n, 1);
+    Matrix<double> x(n, 1);
+    RefinementOptions options;
+    options.precision = FactorPrecision::bfloat16;
+    const RefinementStats single = refinedSolve(a, b, x);
+    const RefinementStats stats = refinedSolve(a, b, x, options);
+    ASSERT_TRUE(stats.converged);
+    ASSERT_FALSE(stats.fellBack);
+    // 8 significant bits gain less per step than 24
+    ASSERT_GT(stats.iterations, single.iterations);
+    const Matrix<double> reference = LuFactorization<double>(a).solve(b);
+    for (int i = 0; i < n; i++)
+        ASSERT_NEAR(x.get(i, 0), reference.get(i, 0), 1e-13);
+}
+
+TEST(Refinement, TestFallback) {
+    const Matrix<double> a = hilbert(12);
+    const Matrix<double> b = rightHandSides(12, 2);
+    Matrix<double> x(12, 2);
+    const RefinementStats stats = refinedSolve(a, b, x);
+    ASSERT_TRUE(stats.fellBack);
+    ASSERT_TRUE(stats.converged);
+    const Matrix<double> reference = LuFactorization<double>(a).solve(b);
+    ASSERT_EQ(x, reference);
+
+    // without the fallback: the best iterate, no worse than the first
+    RefinementOptions options;
+    options.fallback = false;
+    const RefinementStats refined = refinedSolve(a, b, x, options);
+    ASSERT_FALSE(refined.fellBack);
+    ASSERT_FALSE(refined.converged);
+    // the same error up to the rounding of the residual
+    ASSERT_NEAR(refined.backwardError, backwardError(a, b, x),
+                1e-6 * refined.backwardError);
+    options.maxIterations = 0;
+    Matrix<double> first(12, 2);
+    const RefinementStats unrefined = refinedSolve(a, b, first, options);
+    ASSERT_NEAR(unrefined.backwardError, backwardError(a, b, first),
+                1e-6 * unrefined.backwardError);
+    ASSERT_LE(refined.backwardError, unrefined.backwardError);
+}
+
+TEST(Refinement, TestOutOfFloatRange) {
+    const int n = 40;
+    const Matrix<double> b = rightHandSides(n, 1);
+    // entries beyond float: no float factors, and no x without the fallback
+    const Matrix<double> huge = wellConditioned(n, 0.2, n) * 1e40;
+    Matrix<double> x(n, 1, 7.0);
+    RefinementOptions options;
+    options.fallback = false;
+    const RefinementStats stats = refinedSolve(huge, b, x, options);
+    ASSERT_FALSE(stats.converged);
+    ASSERT_TRUE(std::isinf(stats.backwardError));
+    ASSERT_EQ(x, Matrix<double>(n, 1, 7.0));
+    ASSERT_TRUE(refinedSolve(huge, b, x).fellBack);
+
+    // residuals far below float's normal range are scaled before rounding
+    const Matrix<double> tiny = wellConditioned(n, 0.2, n) * 1e-36;
+    const RefinementStats scaled = refinedSolve(tiny, Matrix<double>(b * 1e-36), x);
+    ASSERT_TRUE(scaled.converged);
+    ASSERT_FALSE(scaled.fellBack);
+}
+
+TEST(Refinement, TestNonFiniteIterate) {
+    const int n = 30;
+    const Matrix<double> b = rightHandSides(n, 2);
+    // a NaN entry: no float factors, and a fallback iterate full of NaNs
+    Matrix<double> a = wellConditioned(n, 0.2, n);
+    a.get(3, 17) = std::numeric_limits<double>::quiet_NaN();
+    Matrix<double> x(n, 2);
+    const RefinementStats stats = refinedSolve(a, b, x);
+    ASSERT_TRUE(stats.fellBack);
+    ASSERT_FALSE(stats.converged);
+    ASSERT_FALSE(stats.backwardError <= 1.0);
+
+    // finite entries, but an iterate overflowing double
+    const Matrix<double> tiny = wellConditioned(n, 0.2, n) * 1e-300;
+    const RefinementStats overflow =
+        refinedSolve(tiny, Matrix<double>(b * 1e300), x);
+    ASSERT_FALSE(overflow.converged);
+    ASSERT_FALSE(overflow.backwardError <= 1.0);
+}
+
+TEST(Refinement, TestRoundToBfloat16) {
+    ASSERT_EQ(roundToBfloat16(1.0f), 1.0f);
+    ASSERT_EQ(roundToBfloat16(-3.5f), -3.5f);
+    // 1 + 2^-8 is halfway between 1 and 1 + 2^-7: ties to even
+    ASSERT_EQ(roundToBfloat16(1.0f + 0x1p-8f), 1.0f);
+    ASSERT_EQ(roundToBfloat16(1.0f + 0x1p-8f + 0x1p-20f), 1.0f + 0x1p-7f);
+    ASSERT_EQ(roundToBfloat16(1.0f + 3 * 0x1p-8f), 1.0f + 0x1p-6f);
+    ASSERT_TRUE(std::isinf(roundToBfloat16(std::numeric_limits<float>::infinity())));
+    ASSERT_TRUE(std::isnan(roundToBfloat16(std::numeric_limits<float>::quiet_NaN())));
+}
+
+TEST(Refinement, TestDimensions) {
+    Matrix<double> x(1, 1);
+    ASSERT_THROW(refinedSolve(Matrix<double>(3, 4), Matrix<double>(3, 1), x),
+                 std::runtime_error);
+    ASSERT_THROW(refinedSolve(identity(3), Matrix<double>(4, 1), x),
+                 std::runtime_error);
+}
@@ -0,0 +1,43 @@
+#include "Solve.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace linopt::inmemory;
+
+TEST(Solve, TestSmallSystem) {
+    Matrix<double> a{{0, 2, 1}, {1, 1, 1}, {2, 1, 0}};
+    Matrix<double> b{{7, 1}, {6, 0}, {4, 2}};
+    Matrix<double> x = solve(a, b);
+    Matrix<double> r = a * x;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 2; j++)
+            ASSERT_NEAR(r.get(i, j), b.get(i, j), 1e-12);
+    ASSERT_NEAR(x.get(0, 0), 1.0, 1e-12);
+    ASSERT_NEAR(x.get(1, 0), 2.0, 1e-12);
+    ASSERT_NEAR(x.get(2, 0), 3.0, 1e-12);
+}
+
+TEST(Solve, TestLargeSystem) {
+    const int n = 150;
+    Matrix<double> a(n, n), b(n, 3);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            a.get(i, j) = std::sin(i * 0.7 + j * 1.3) + (i == j ? 4.0 : 0.0);
+        for (int j = 0; j < 3; j++)
+            b.get(i, j) = std::cos(i + j);
+    }
+    Matrix<double> r = a * solve(a, b);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < 3; j++)
+            ASSERT_NEAR(r.get(i, j), b.get(i, j), 1e-10);
+}
+
+TEST(Solve, TestInvalidSystems) {
+    Matrix<double> singular{{1, 2}, {2, 4}};
+    EXPECT_THROW(solve(singular, Matrix<double>(2, 1, 1.0)), std::runtime_error);
+    EXPECT_THROW(solve(Matrix<double>(2, 3), Matrix<double>(2, 1)),
+                 std::runtime_error);
+    EXPECT_THROW(solve(Matrix<double>(2, 2, 1.0), Matrix<double>(3, 1)),
+                 std::runtime_error);
+}
@@ -0,0 +1,134 @@
+#include "SparseMatrix.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::test;
+
+namespace {
+
+// about one entry in seven, and a dense row to unbalance the rows
+Matrix<double> sparseDense(int n, int m, int seed) {
+    Matrix<double> a(n, m);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            if ((i * 31 + j * 17 + seed) % 7 == 0 || i == n / 2)
+                a.get(i, j) = std::sin(i + 0.5 * j + seed);
+    return a;
+}
+
+} // namespace
+
+TEST(SparseMatrix, TestFromTriplets) {
+    std::vector<Triplet<double>> triplets = {
+        {2, 1, 4.0}, {0, 0, 1.0}, {2, 1, 0.5}, {1, 2, -3.0}, {0, 2, 2.0}};
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        SparseMatrix<double> s = SparseMatrix<double>::fromTriplets(3, 3, triplets, layout);
+        EXPECT_EQ(s.nonZeros(), 4u);
+        EXPECT_EQ(s.coeff(2, 1), 4.5);
+        EXPECT_EQ(s.coeff(0, 2), 2.0);
+        EXPECT_EQ(s.coeff(1, 2), -3.0);
+        EXPECT_EQ(s.coeff(1, 1), 0.0);
+        EXPECT_EQ(s.diagonal(), (std::vector<double>{1.0, 0.0, 0.0}));
+    }
+    std::vector<Triplet<double>> outside = {{3, 0, 1.0}};
+    EXPECT_THROW(SparseMatrix<double>::fromTriplets(3, 3, outside), std::runtime_error);
+}
+
+TEST(SparseMatrix, TestDenseRoundTrip) {
+    Matrix<double> a = sparseDense(60, 45, 1);
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        SparseMatrix<double> s = SparseMatrix<double>::fromDense(a, layout);
+        EXPECT_EQ(s.layout(), layout);
+        expectNear(s.toDense(), a, 0.0);
+        expectNear(s.transpose().toDense(), a.transpose(), 0.0);
+        Layout other = layout == Layout::csr ? Layout::csc : Layout::csr;
+        expectNear(s.toLayout(other).toDense(), a, 0.0);
+    }
+}
+
+TEST(SparseMatrix, TestInvalidArrays) {
+    EXPECT_THROW(SparseMatrix<double>(2, 2, Layout::csr, {0, 1, 2}, {1, 0, 1}, {1, 1, 1}),
+                 std::runtime_error);
+    EXPECT_THROW(SparseMatrix<double>(2, 2, Layout::csr, {0, 2, 2}, {1, 0}, {1, 1}),
+                 std::runtime_error);
+    EXPECT_THROW(SparseMatrix<double>(2, 2, Layout::csr, {0, 1, 2}, {0, 2}, {1, 1}),
+                 std::runtime_error);
+}
+
+TEST(SparseMatrix, TestSpmv) {
+    const int n = 700, m = 500;
+    Matrix<double> a = sparseDense(n, m, 2);
+    Matrix<double> x(m, 1);
+    std::vector<double> xv(m);
+    for (int j = 0; j < m; j++)
+        xv[j] = x.get(j, 0) = std::cos(j);
+    Matrix<double> expected = a * x;
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        std::vector<double> y = SparseMatrix<double>::fromDense(a, layout) * xv;
+        for (int i = 0; i < n; i++)
+            ASSERT_NEAR(y[i], expected.get(i, 0), 1e-10);
+    }
+}
+
+TEST(SparseMatrix, TestParallelSpmv) {
+    linopt::parallel::ScopedPolicy policy(
+        {linopt::parallel::Execution::parallel, 1});
+    const int n = 300, m = 900;
+    Matrix<double> a = sparseDense(n, m, 9);
+    Matrix<double> x(m, 1);
+    std::vector<double> xv(m);
+    for (int j = 0; j < m; j++)
+        xv[j] = x.get(j, 0) = std::sin(0.3 * j);
+    Matrix<double> expected = a * x;
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        std::vector<double> y = SparseMatrix<double>::fromDense(a, layout) * xv;
+        for (int i = 0; i < n; i++)
+            ASSERT_NEAR(y[i], expected.get(i, 0), 1e-10);
+    }
+}
+
+TEST(SparseMatrix, TestSpmm) {
+    Matrix<double> a = sparseDense(90, 70, 3), b = sparseDense(70, 40, 4);
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        expectNear(SparseMatrix<double>::fromDense(a, layout) * b, a * b, 1e-10);
+        expectNear(a * SparseMatrix<double>::fromDense(b, layout), a * b, 1e-10);
+    }
+}
+
+TEST(SparseMatrix, TestParallelSpmm) {
+    linopt::parallel::ScopedPolicy policy(
+        {linopt::parallel::Execution::parallel, 1});
+    Matrix<double> a = sparseDense(120, 80, 10), b = sparseDense(80, 60, 11);
+    for (Layout layout : {Layout::csr, Layout::csc}) {
+        expectNear(SparseMatrix<double>::fromDense(a, layout) * b, a * b, 1e-10);
+        expectNear(a * SparseMatrix<double>::fromDense(b, layout), a * b, 1e-10);
+    }
+}
+
+TEST(SparseMatrix, TestSparseProduct) {
+    Matrix<double> a = sparseDense(80, 60, 5), b = sparseDense(60, 50, 6);
+    for (Layout la : {Layout::csr, Layout::csc})
+        for (Layout lb : {Layout::csr, Layout::csc}) {
+            SparseMatrix<double> c = SparseMatrix<double>::fromDense(a, la) *
+                                     SparseMatrix<double>::fromDense(b, lb);
+            EXPECT_EQ(c.layout(), la);
+            expectNear(c.toDense(), a * b, 1e-10);
+        }
+    SparseMatrix<double> s(3, 4);
+    EXPECT_THROW(s * s, std::runtime_error);
+}
+
+TEST(SparseMatrix, TestSum) {
+    Matrix<double> a = sparseDense(50, 30, 7), b = sparseDense(50, 30, 8);
+    for (Layout la : {Layout::csr, Layout::csc})
+        for (Layout lb : {Layout::csr, Layout::csc}) {
+            SparseMatrix<double> sa = SparseMatrix<double>::fromDense(a, la);
+            SparseMatrix<double> sb = SparseMatrix<double>::fromDense(b, lb);
+            expectNear((sa + sb).toDense(), a + b, 1e-12);
+            expectNear((sa - sb).toDense(), a - b, 1e-12);
+        }
+}
@@ -0,0 +1,111 @@
+#include "Lmf.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace linopt::inmemory;
+using namespace linopt::io;
+using namespace linopt::test;
+
+TEST(Lmf, TestRoundTrip) {
+    std::stringstream ss;
+    Matrix<double> a = patterned<double>(17, 13);
+    write(ss, a);
+    EXPECT_EQ(ss.str().size(), 64 + sizeof(double) * 17 * a.stride());
+    Matrix<double> b = read<double>(ss);
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(b.stride(), a.stride());
+
+    std::stringstream si;
+    Matrix<std::int32_t> c = patterned<std::int32_t>(3, 40);
+    write(si, c, WriteOptions{.checksum = true});
+    ASSERT_EQ(c, read<std::int32_t>(si));
+}
+
+TEST(Lmf, TestSaveLoad) {
+    const std::string path = "lmf_1_unittest.lmf";
+    Matrix<float> a = patterned<float>(65, 33);
+    save(path, a, WriteOptions{.checksum = true});
+    ASSERT_EQ(a, load<float>(path));
+    EXPECT_THROW(load<double>(path), std::runtime_error);
+    EXPECT_THROW(load<float>("does/not/exist.lmf"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(Lmf, TestCorruption) {
+    std::stringstream ss;
+    write(ss, patterned<double>(8, 8), WriteOptions{.checksum = true});
+    std::string bytes = ss.str();
+
+    std::string flipped = bytes;
+    flipped[64 + 3 * 8 + 2] ^= 0x10;
+    std::istringstream corrupted(flipped);
+    EXPECT_THROW(read<double>(corrupted), std::runtime_error);
+
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 8));
+    EXPECT_THROW(read<double>(truncated), std::runtime_error);
+
+    std::string magic = bytes;
+    magic[0] = 'X';
+    std::istringstream badMagic(magic);
+    EXPECT_THROW(read<double>(badMagic), std::runtime_error);
+}
+
+TEST(Lmf, TestPayloadOverflow) {
+    // rows*rowStride*elementSize is 2^64 + 2^33 - 8: wraps to about 8 GiB
+    LmfHeader header = makeHeader<double>(2, 2, 2);
+    header.rows = 0x7fffffff;
+    header.cols = 0x40000001;
+    header.rowStride = 0x40000001;
+    ASSERT_THROW(decodeHeader(&header), std::runtime_error);
+    std::istringstream is(std::string(reinterpret_cast<const char *>(&header),
+                                      sizeof(header)));
+    ASSERT_THROW(read<double>(is), std::runtime_error);
+    ASSERT_THROW(header.payloadBytes(), std::runtime_error);
+
+    header.rows = header.cols = header.rowStride = 2;
+    ASSERT_EQ(header.payloadBytes(), 32u);
+    ASSERT_EQ(header.fileBytes(), 96u);
+}
+
+TEST(Lmf, TestForeignLayout) {
+    // a 2x3 int32 matrix written by a big-endian host, rows padded to 5
+    LmfHeader header = makeHeader<std::int32_t>(2, 3, 5);
+    std::int32_t entries[10] = {1, 2, 3, 0, 0, -4, 5, 6, 0, 0};
+    header.flags = lmfHasChecksum;
+    if (nativeEndianness() == Endianness::little) {
+        header.endianness = Endianness::big;
+        swapBytes(entries, 10, sizeof(std::int32_t));
+    }
+    header.checksum = checksum(entries, sizeof(entries));
+    if (nativeEndianness() == Endianness::little) {
+        swapBytes(&header.version, 1, 2);
+        for (std::uint32_t *f : {&header.elementSize, &header.alignment,
+                                 &header.flags, &header.headerSize})
+            swapBytes(f, 1, 4);
+        for (std::uint64_t *f : {&header.rows, &header.cols,
+                                 &header.rowStride, &header.checksum})
+            swapBytes(f, 1, 8);
+    }
+    std::string bytes(reinterpret_cast<const char *>(&header), sizeof(header));
+    bytes.append(reinterpret_cast<const char *>(entries), sizeof(entries));
+    std::istringstream is(bytes);
+    Matrix<std::int32_t> a = read<std::int32_t>(is);
+    ASSERT_EQ(a, Matrix<std::int32_t>({{1, 2, 3}, {-4, 5, 6}}));
+    for (int j = 3; j < a.stride(); j++)
+        ASSERT_EQ(a.data()[a.stride() + j], 0);
+}
+
+TEST(Lmf, TestChecksum) {
+    const char text[] = "abcde";
+    ASSERT_EQ(checksum(text, 0), 0u);
+    // words 0x64636261, 0x00000065
+    const std::uint64_t a1 = 0x64636261, a2 = a1 + 0x65;
+    ASSERT_EQ(checksum(text, 5), (a1 + a2) << 32 | a2);
+    ASSERT_NE(checksum(text, 4), checksum(text + 1, 4));
+}
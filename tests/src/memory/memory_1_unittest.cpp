@@ -0,0 +1,155 @@
+#include "Lmf.h"
+#include "Matrix.h"
+#include "MemoryResource.h"
+#include "ResourceAllocator.h"
+#include "Workspace.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+using namespace linopt::inmemory;
+using namespace linopt::memory;
+
+namespace {
+
+template <typename E> using ResourceMatrix = Matrix<E, ResourceAllocator<E>>;
+
+bool isAligned(const void *p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(Memory, TestHugePageResource) {
+    HugePageResource resource;
+    void *small = resource.allocate(100, 64);
+    void *large = resource.allocate(3 * hugePageSize + 5, 64);
+    ASSERT_TRUE(isAligned(small, 4096));
+    ASSERT_TRUE(isAligned(large, hugePageSize));
+    static_cast<char *>(large)[3 * hugePageSize + 4] = 1;
+    resource.deallocate(large, 3 * hugePageSize + 5, 64);
+    resource.deallocate(small, 100, 64);
+    // an unavailable node is only a preference
+    HugePageResource far(63);
+    void *p = far.allocate(hugePageSize, 64);
+    static_cast<char *>(p)[0] = 1;
+    far.deallocate(p, hugePageSize, 64);
+    ASSERT_TRUE(resource.is_equal(*hugePageResource()));
+    ASSERT_FALSE(resource.is_equal(far));
+}
+
+TEST(Memory, TestResourceMatrix) {
+    PoolResource pool;
+    ResourceMatrix<double> a(13, 7, &pool);
+    ASSERT_EQ(a.getAllocator().resource(), &pool);
+    ASSERT_TRUE(isAligned(a.data(), 64));
+    for (int i = 0; i < 13; i++)
+        for (int j = 0; j < 7; j++)
+            a.get(i, j) = i - j;
+    const Matrix<double> b = a;
+    ResourceMatrix<double> c = a + b;
+    ASSERT_EQ(c, b * 2.0);
+    c *= a.transpose();
+    ASSERT_EQ(c.getM(), 13);
+    ASSERT_EQ(c, (b * 2.0) * b.transpose());
+    ASSERT_EQ(a.transpose().getAllocator().resource(), &pool);
+
+    ArenaResource arena;
+    {
+        ScopedResource scope(&arena);
+        ResourceMatrix<float> d(200, 300);
+        ASSERT_EQ(d.getAllocator().resource(), &arena);
+        ASSERT_TRUE(isAligned(d.data(), 64));
+        // copies follow the scope, moves keep their resource
+        ResourceMatrix<double> e = a;
+        ASSERT_EQ(e.getAllocator().resource(), &arena);
+        ResourceMatrix<double> f = std::move(a);
+        ASSERT_EQ(f.getAllocator().resource(), &pool);
+    }
+    ASSERT_EQ(ResourceMatrix<int>(2, 2).getAllocator().resource(),
+              std::pmr::get_default_resource());
+    arena.reset();
+}
+
+TEST(Memory, TestAllocatorPropagation) {
+    PoolResource pool;
+    ResourceMatrix<double> a(9, 5, 1.0, &pool);
+    a.get(2, 3) = 4.0;
+    // expressions evaluate with the allocator of their first matrix
+    ASSERT_EQ((a + a).eval().getAllocator().resource(), &pool);
+    ASSERT_EQ((a.transposed() * 2.0).eval().getAllocator().resource(), &pool);
+    auto product = a * a.transposed();
+    static_assert(std::is_same_v<decltype(product), ResourceMatrix<double>>);
+    ASSERT_EQ(product.getAllocator().resource(), &pool);
+    ASSERT_EQ(product.get(2, 2), 20.0);
+    // so do stream extraction and lmf reads
+    std::stringstream text;
+    text << a;
+    ResourceMatrix<double> b(1, 1, &pool);
+    text >> b;
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(b.getAllocator().resource(), &pool);
+    std::stringstream binary;
+    linopt::io::write(binary, a);
+    ResourceMatrix<double> c =
+        linopt::io::read<double>(binary, ResourceAllocator<double>(&pool));
+    ASSERT_EQ(c, a);
+    ASSERT_EQ(c.getAllocator().resource(), &pool);
+}
+
+TEST(Memory, TestWorkspace) {
+    Workspace workspace;
+    {
+        auto a = workspace.borrow<double>(1000);
+        ASSERT_TRUE(isAligned(a.data(), 64));
+        ASSERT_EQ(a.size(), 1000u);
+        {
+            auto b = workspace.borrow<char>(3);
+            auto c = workspace.borrow<int>(1 << 20);
+            ASSERT_TRUE(isAligned(c.data(), 64));
+            ASSERT_GE(workspace.inUse(), (1u << 22) + 8000u);
+            c[(1 << 20) - 1] = 1;
+        }
+        ASSERT_LT(workspace.inUse(), 8200u);
+    }
+    ASSERT_EQ(workspace.inUse(), 0u);
+    // the chunks are kept: borrowing again does not grow the workspace
+    const std::size_t capacity = workspace.capacity();
+    {
+        auto a = workspace.borrow<double>(1000);
+        auto b = workspace.borrow<int>(1 << 20);
+    }
+    ASSERT_EQ(workspace.capacity(), capacity);
+    workspace.trim();
+    ASSERT_EQ(workspace.capacity(), 0u);
+
+    // as a memory resource, out of order releases included
+    std::vector<ResourceMatrix<double>> matrices;
+    for (int k = 1; k < 20; k++)
+        matrices.emplace_back(k, k, 1.0, &workspace);
+    matrices.erase(matrices.begin() + 3);
+    ASSERT_EQ(matrices[3].get(3, 3), 1.0);
+    matrices.clear();
+    ASSERT_EQ(workspace.inUse(), 0u);
+}
+
+TEST(Memory, TestLocalWorkspace) {
+    {
+        // leave garbage behind for the product's scratch rows
+        auto dirty = Workspace::local().borrow<double>(1 << 20);
+        std::fill(dirty.begin(), dirty.end(), 1.0);
+    }
+    Matrix<double> a(150, 40, 1.0);
+    const Matrix<double> b(40, 90, 2.0);
+    a *= b;
+    ASSERT_EQ(a, Matrix<double>(150, 90, 80.0));
+    // the row padding is still zero
+    for (int i = 0; i < 150; i++)
+        for (int j = 90; j < a.stride(); j++)
+            ASSERT_EQ(a.data()[i * a.stride() + j], 0.0);
+    ASSERT_EQ(Workspace::local().inUse(), 0u);
+    ASSERT_GT(Workspace::local().capacity(), 0u);
+}
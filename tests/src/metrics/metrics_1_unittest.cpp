@@ -0,0 +1,82 @@
+#include "Lu.h"
+#include "Matrix.h"
+#include "Metrics.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace linopt::inmemory;
+namespace metrics = linopt::metrics;
+
+TEST(Metrics, TestGemmIsRecorded) {
+    ASSERT_TRUE(metrics::enabled);
+    const Matrix<double> a(100, 60, 1.0), b(60, 30, 2.0);
+    a * b; // sizes the packing buffers of the gemm kernel
+    metrics::reset();
+    const Matrix<double> c = a * b;
+    ASSERT_EQ(c.get(99, 29), 120.0);
+    const metrics::Snapshot s = metrics::snapshot();
+    const metrics::OperationMetrics gemm = s.total("gemm");
+    ASSERT_EQ(gemm.calls, 1u);
+    ASSERT_EQ(gemm.flops, 2u * 100 * 60 * 30);
+    ASSERT_EQ(gemm.bytes, (100u * 60 + 60 * 30 + 100 * 30) * sizeof(double));
+    ASSERT_EQ(s.operations.size(), 1u);
+    // dimensions rounded up to their shape class
+    ASSERT_EQ(s.operations[0].shape, (metrics::Shape{128, 32, 64}));
+    ASSERT_EQ(s.allocations.allocations, 1u); // the product
+    ASSERT_GE(s.allocations.bytes, 100u * 30 * sizeof(double));
+
+    std::ostringstream os;
+    os << s;
+    ASSERT_NE(os.str().find("gemm 128x32x64: calls=1"), std::string::npos);
+}
+
+TEST(Metrics, TestFactorizationNestsGemm) {
+    Matrix<double> a(300, 300);
+    for (int i = 0; i < 300; i++)
+        for (int j = 0; j < 300; j++)
+            a.get(i, j) = (i == j ? 300.0 : 0.0) + (i * 7 + j * 3) % 5;
+    metrics::reset();
+    const LuFactorization<double> lu(a);
+    lu.solve(Matrix<double>(300, 2, 1.0));
+    const metrics::Snapshot s = metrics::snapshot();
+    ASSERT_EQ(s.total("lu").calls, 1u);
+    ASSERT_EQ(s.total("luSolve").calls, 1u);
+    ASSERT_GT(s.total("gemm").calls, 0u); // the trailing updates
+    ASSERT_GE(s.total("lu").nanoseconds, s.total("gemm").nanoseconds);
+    for (std::size_t i = 1; i < s.operations.size(); i++)
+        ASSERT_GE(s.operations[i - 1].nanoseconds, s.operations[i].nanoseconds);
+}
+
+TEST(Metrics, TestThreadsAreMerged) {
+    metrics::reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([] {
+            for (int i = 0; i < 10; i++)
+                metrics::record("custom", {5, 0, 0}, 1, 2, 1000);
+        });
+    for (std::thread &t : threads)
+        t.join();
+    const metrics::OperationMetrics custom =
+        metrics::snapshot().total("custom");
+    ASSERT_EQ(custom.calls, 40u);
+    ASSERT_EQ(custom.flops, 40u);
+    ASSERT_EQ(custom.bytes, 80u);
+    ASSERT_EQ(custom.nanoseconds, 40000u);
+    // 1000ns lies in [512, 1024)
+    ASSERT_EQ(custom.quantile(0.5), 1024u);
+    metrics::reset();
+    ASSERT_EQ(metrics::snapshot().total("custom").calls, 0u);
+}
+
+TEST(Metrics, TestLiveBytes) {
+    const std::int64_t before = metrics::snapshot().allocations.liveBytes;
+    {
+        const Matrix<float> a(64, 64);
+        ASSERT_GE(metrics::snapshot().allocations.liveBytes - before,
+                  static_cast<std::int64_t>(64 * 64 * sizeof(float)));
+    }
+    ASSERT_EQ(metrics::snapshot().allocations.liveBytes, before);
+}
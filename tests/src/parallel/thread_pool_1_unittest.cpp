@@ -0,0 +1,95 @@
+#include "Parallel.h"
+#include "ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace linopt::parallel;
+
+TEST(ThreadPool, TestTaskGroup) {
+    ThreadPool pool(3);
+    std::atomic<int> sum{0};
+    TaskGroup group(pool);
+    for (int i = 1; i <= 100; i++)
+        group.run([&sum, i] { sum += i; });
+    group.wait();
+    ASSERT_EQ(sum, 5050);
+}
+
+TEST(ThreadPool, TestExceptionPropagation) {
+    ThreadPool pool(2);
+    TaskGroup group(pool);
+    group.run([] { throw std::runtime_error("task failure"); });
+    group.run([] {});
+    ASSERT_THROW(group.wait(), std::runtime_error);
+}
+
+TEST(ThreadPool, TestWaitRunsItsOwnTasks) {
+    ThreadPool pool(1);
+    std::atomic<bool> started{false}, release{false}, ranOther{false};
+    TaskGroup blocker(pool), other(pool), mine(pool);
+    // keep the only worker busy
+    blocker.run([&] {
+        started = true;
+        while (!release)
+            std::this_thread::yield();
+    });
+    while (!started)
+        std::this_thread::yield();
+    other.run([&] { ranOther = true; });
+    int ranMine = 0;
+    mine.run([&] { ranMine++; });
+    mine.wait();
+    ASSERT_EQ(ranMine, 1);
+    ASSERT_FALSE(ranOther);
+    release = true;
+    blocker.wait();
+    other.wait();
+    ASSERT_TRUE(ranOther);
+}
+
+TEST(ThreadPool, TestScopedPolicy) {
+    ASSERT_EQ(currentPolicy().mode, Execution::sequential);
+    {
+        ScopedPolicy outer(par);
+        ASSERT_EQ(currentPolicy().mode, Execution::parallel);
+        {
+            ScopedPolicy inner(seq);
+            ASSERT_FALSE(shouldParallelize(1L << 30));
+        }
+        ASSERT_TRUE(shouldParallelize(1L << 30));
+        ASSERT_FALSE(shouldParallelize(10));
+    }
+    ASSERT_EQ(currentPolicy().mode, Execution::sequential);
+}
+
+TEST(ThreadPool, TestParallelForCoversRange) {
+    ScopedPolicy scope({Execution::parallel, 1});
+    std::vector<int> hits(10007, 0);
+    parallelFor(0, static_cast<int>(hits.size()), 1L << 20, [&](int b, int e) {
+        for (int i = b; i < e; i++)
+            hits[i]++;
+    });
+    for (int h : hits)
+        ASSERT_EQ(h, 1);
+    std::vector<int> tiles(300 * 70, 0);
+    parallelFor2D(300, 70, 16, 8, 1L << 20, [&](int r0, int r1, int c0, int c1) {
+        for (int i = r0; i < r1; i++)
+            for (int j = c0; j < c1; j++)
+                tiles[i * 70 + j]++;
+    });
+    for (int h : tiles)
+        ASSERT_EQ(h, 1);
+}
+
+TEST(ThreadPool, TestNestedParallelFor) {
+    ScopedPolicy scope({Execution::parallel, 1});
+    std::atomic<long> count{0};
+    parallelFor(0, 64, 1L << 20, [&](int b, int e) {
+        for (int i = b; i < e; i++)
+            parallelFor(0, 64, 1L << 20, [&](int b2, int e2) { count += e2 - b2; });
+    });
+    ASSERT_EQ(count, 64 * 64);
+}
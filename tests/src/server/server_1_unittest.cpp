@@ -0,0 +1,215 @@
+#include "Client.h"
+#include "Lmf.h"
+#include "Server.h"
+#include "TestMatrices.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace linopt::server;
+using linopt::inmemory::Matrix;
+using namespace linopt::test;
+
+namespace {
+
+ServerOptions testOptions() {
+    ServerOptions options;
+    options.address = "127.0.0.1";
+    options.workers = 2;
+    return options;
+}
+
+} // namespace
+
+TEST(Server, TestOperations) {
+    Server server(0, testOptions());
+    server.start();
+    ASSERT_NE(server.port(), 0);
+    Client client("127.0.0.1", server.port());
+
+    Matrix<double> a = patterned<double>(30, 20, 1), b = patterned<double>(20, 9, 2);
+    client.send(1, Operation::multiply, a, b);
+    Response<double> r = client.receive<double>();
+    ASSERT_EQ(r.id, 1u);
+    ASSERT_EQ(r.status, Status::ok);
+    ASSERT_EQ(*r.result, a * b);
+
+    Matrix<float> f = patterned<float>(5, 70, 3);
+    client.send(2, Operation::transpose, f);
+    Response<float> t = client.receive<float>();
+    ASSERT_EQ(t.id, 2u);
+    ASSERT_EQ(*t.result, f.transpose());
+
+    Matrix<double> s{{4, 1}, {1, 3}}, rhs{{1}, {2}};
+    client.send(3, Operation::solve, s, rhs);
+    Response<double> x = client.receive<double>();
+    ASSERT_EQ(x.status, Status::ok);
+    ASSERT_NEAR(x.result->get(0, 0), 1.0 / 11.0, 1e-12);
+    ASSERT_NEAR(x.result->get(1, 0), 7.0 / 11.0, 1e-12);
+}
+
+TEST(Server, TestErrors) {
+    Server server(0, testOptions());
+    server.start();
+    Client client("127.0.0.1", server.port());
+
+    client.send(1, Operation::multiply, Matrix<double>(2, 3), Matrix<double>(2, 3));
+    Response<double> r = client.receive<double>();
+    ASSERT_EQ(r.status, Status::error);
+    ASSERT_FALSE(r.result);
+    ASSERT_EQ(r.message, "Invalid dimensions for matrix multiplication.");
+
+    client.send(2, Operation::solve, Matrix<double>(2, 2, 1.0), Matrix<double>(2, 1));
+    ASSERT_EQ(client.receive<double>().message, "Singular matrix.");
+
+    client.send(3, Operation::transpose, Matrix<double>(2, 2), Matrix<double>(2, 2));
+    ASSERT_EQ(client.receive<double>().status, Status::error);
+
+    // the connection survives failed requests
+    client.send(4, Operation::transpose, Matrix<double>({{1, 2}}));
+    Response<double> t = client.receive<double>();
+    ASSERT_EQ(t.id, 4u);
+    ASSERT_EQ(*t.result, Matrix<double>({{1}, {2}}));
+}
+
+TEST(Server, TestOversizedOperand) {
+    ServerOptions options = testOptions();
+    options.maxOperandBytes = 1 << 20;
+    Server server(0, options);
+    server.start();
+    {
+        // 1 MiB as sent, but 8 MiB once every row is padded to 64 bytes
+        boost::asio::io_context io;
+        boost::asio::ip::tcp::socket socket(io);
+        socket.connect({boost::asio::ip::make_address("127.0.0.1"),
+                        static_cast<unsigned short>(server.port())});
+        RequestHeader request;
+        request.operation = Operation::transpose;
+        request.operands = 1;
+        const linopt::io::LmfHeader lmf =
+            linopt::io::makeHeader<double>(1 << 17, 1, 1);
+        boost::asio::write(socket, boost::asio::buffer(&request, sizeof(request)));
+        boost::asio::write(socket, boost::asio::buffer(&lmf, sizeof(lmf)));
+        char byte;
+        boost::system::error_code ec;
+        boost::asio::read(socket, boost::asio::buffer(&byte, 1), ec);
+        ASSERT_EQ(ec, boost::asio::error::eof);
+    }
+    // the server survives
+    Client client("127.0.0.1", server.port());
+    client.send(1, Operation::transpose, Matrix<double>({{1, 2}}));
+    ASSERT_EQ(client.receive<double>().status, Status::ok);
+}
+
+TEST(Server, TestUnsupportedEntryType) {
+    Server server(0, testOptions());
+    server.start();
+    Client client("127.0.0.1", server.port());
+    // a payload of several drain chunks, read and dropped
+    client.send(1, Operation::transpose, patterned<std::int32_t>(300, 200, 1));
+    Response<double> r = client.receive<double>();
+    ASSERT_EQ(r.status, Status::error);
+    ASSERT_EQ(r.message, "Unsupported entry type.");
+    // the framing is kept
+    client.send(2, Operation::transpose, Matrix<double>({{1, 2}}));
+    Response<double> t = client.receive<double>();
+    ASSERT_EQ(t.id, 2u);
+    ASSERT_EQ(*t.result, Matrix<double>({{1}, {2}}));
+}
+
+TEST(Server, TestMemoryBudget) {
+    ServerOptions options = testOptions();
+    options.maxBufferedBytes = 100 * 1024;
+    Server server(0, options);
+    server.start();
+    Client client("127.0.0.1", server.port());
+    // 2 x 48 KiB fits, once the previous reply has given its share back
+    const Matrix<double> a = patterned<double>(96, 64, 1);
+    for (std::uint64_t id = 1; id <= 3; id++) {
+        client.send(id, Operation::multiply, a, a.transpose());
+        ASSERT_EQ(client.receive<double>().status, Status::ok);
+    }
+    // 200 KiB does not
+    client.send(4, Operation::transpose, patterned<double>(400, 64, 2));
+    Response<double> r = client.receive<double>();
+    ASSERT_EQ(r.status, Status::error);
+    ASSERT_EQ(r.message, "Server busy: operand memory exhausted.");
+    client.send(5, Operation::transpose, a);
+    ASSERT_EQ(*client.receive<double>().result, a.transpose());
+}
+
+TEST(Server, TestPipeliningAndBackPressure) {
+    ServerOptions options = testOptions();
+    options.maxPipelined = 3;
+    options.maxQueuedJobs = 2;
+    Server server(0, options);
+    server.start();
+    Client client("127.0.0.1", server.port());
+
+    const int count = 40;
+    std::map<std::uint64_t, Matrix<double>> expected;
+    for (int i = 0; i < count; i++) {
+        Matrix<double> a = patterned<double>(8 + i, 16, i), b = patterned<double>(16, 5, 2 * i);
+        expected.emplace(i, a * b);
+        client.send(i, Operation::multiply, a, b);
+    }
+    for (int i = 0; i < count; i++) {
+        Response<double> r = client.receive<double>();
+        ASSERT_EQ(r.status, Status::ok);
+        auto it = expected.find(r.id);
+        ASSERT_NE(it, expected.end());
+        ASSERT_EQ(*r.result, it->second);
+        expected.erase(it);
+    }
+}
+
+TEST(Server, TestLoopbackLatency) {
+    ServerOptions options = testOptions();
+    options.ioThreads = 2;
+    options.workers = 0; // the requests share the kernels' pool
+    Server server(0, options);
+    server.start();
+
+    const int clients = 3, requests = 200, window = 8;
+    std::vector<std::vector<double>> latencies(clients);
+    std::vector<std::thread> threads;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; c++)
+        threads.emplace_back([&, c] {
+            using clock = std::chrono::steady_clock;
+            Client client("127.0.0.1", server.port());
+            Matrix<double> a = patterned<double>(64, 64, c), b = patterned<double>(64, 64, c + 1);
+            std::map<std::uint64_t, clock::time_point> sent;
+            int next = 0;
+            for (int received = 0; received < requests; received++) {
+                while (next < requests && next - received < window) {
+                    sent[next] = clock::now();
+                    client.send(next++, Operation::multiply, a, b);
+                }
+                Response<double> r = client.receive<double>();
+                const std::chrono::duration<double, std::micro> d = clock::now() - sent[r.id];
+                latencies[c].push_back(d.count());
+                if (r.status != Status::ok)
+                    latencies[c].push_back(-1.0);
+            }
+        });
+    for (std::thread &t : threads)
+        t.join();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::vector<double> all;
+    for (const std::vector<double> &l : latencies)
+        all.insert(all.end(), l.begin(), l.end());
+    ASSERT_EQ(all.size(), static_cast<std::size_t>(clients * requests));
+    ASSERT_GE(*std::min_element(all.begin(), all.end()), 0.0);
+    std::sort(all.begin(), all.end());
+    const double p99 = all[all.size() * 99 / 100];
+    RecordProperty("requests_per_second", static_cast<int>(all.size() / elapsed.count()));
+    RecordProperty("p99_latency_us", static_cast<int>(p99));
+}